@@ -0,0 +1,102 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/audiochunkscheduler.h"
+#include <stdlib.h>
+#include <algorithm>
+#if defined(WEBRTC_POSIX)
+#include <errno.h>
+#include <time.h>
+#endif
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+namespace owt {
+namespace base {
+// Duration of each chunk exchanged with AudioDeviceBuffer or audio sinks.
+static const int64_t kChunkNs = 10 * rtc::kNumNanosecsPerMillisec;
+// If a pacing thread is behind schedule by more than this, it stops catching
+// up and re-anchors the schedule to current time.
+static const int64_t kMaxCatchUpNs = 20 * kChunkNs;
+#if defined(WEBRTC_WIN)
+// Windows timers are not precise enough, so the last part of the wait spins.
+static const int64_t kSpinThresholdNs = 2 * rtc::kNumNanosecsPerMillisec;
+#endif
+void AudioCaptureTimingStats::RecordWakeUp(int64_t wakeup_ns,
+                                           int64_t deadline_ns) {
+  int64_t lateness_us =
+      (wakeup_ns - deadline_ns) / rtc::kNumNanosecsPerMicrosec;
+  jitter_us += (llabs(lateness_us) - jitter_us) / 16;
+  max_lateness_us = std::max(max_lateness_us, lateness_us);
+  last_lateness_us = lateness_us;
+}
+AudioChunkScheduler::AudioChunkScheduler()
+    : start_ns_(0), chunks_since_start_(0) {}
+void AudioChunkScheduler::Reset() {
+  start_ns_ = 0;
+  chunks_since_start_ = 0;
+}
+int64_t AudioChunkScheduler::NextChunk(int64_t now_ns, bool* resynced) {
+  if (start_ns_ == 0) {
+    start_ns_ = now_ns;
+    chunks_since_start_ = 0;
+  }
+  int64_t deadline_ns = start_ns_ + chunks_since_start_ * kChunkNs;
+  if (now_ns - deadline_ns > kMaxCatchUpNs) {
+    RTC_LOG(LS_WARNING) << "Audio thread is "
+                        << (now_ns - deadline_ns) /
+                               rtc::kNumNanosecsPerMillisec
+                        << "ms behind schedule, re-anchoring.";
+    start_ns_ = now_ns;
+    chunks_since_start_ = 0;
+    deadline_ns = now_ns;
+    *resynced = true;
+  }
+  // Each chunk owns a slot of the schedule whether or not it is delivered, so
+  // a failure does not push later chunks back.
+  chunks_since_start_++;
+  return deadline_ns;
+}
+int64_t AudioChunkScheduler::NextDeadline() const {
+  return start_ns_ + chunks_since_start_ * kChunkNs;
+}
+int64_t AudioChunkScheduler::MonotonicNanos() {
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * rtc::kNumNanosecsPerSec +
+         ts.tv_nsec;
+#else
+  return rtc::TimeNanos();
+#endif
+}
+void AudioChunkScheduler::SleepUntilNanos(int64_t deadline_ns) {
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  struct timespec ts;
+  ts.tv_sec = deadline_ns / rtc::kNumNanosecsPerSec;
+  ts.tv_nsec = deadline_ns % rtc::kNumNanosecsPerSec;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) ==
+         EINTR) {
+  }
+#elif defined(WEBRTC_POSIX)
+  int64_t remaining_ns = deadline_ns - MonotonicNanos();
+  while (remaining_ns > 0) {
+    struct timespec ts;
+    ts.tv_sec = remaining_ns / rtc::kNumNanosecsPerSec;
+    ts.tv_nsec = remaining_ns % rtc::kNumNanosecsPerSec;
+    nanosleep(&ts, nullptr);
+    remaining_ns = deadline_ns - MonotonicNanos();
+  }
+#else
+  int64_t remaining_ns = deadline_ns - MonotonicNanos();
+  if (remaining_ns > kSpinThresholdNs) {
+    webrtc::SleepMs(static_cast<int>((remaining_ns - kSpinThresholdNs) /
+                                     rtc::kNumNanosecsPerMillisec));
+  }
+  while (MonotonicNanos() < deadline_ns) {
+    webrtc::SleepMs(0);
+  }
+#endif
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,55 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOCHUNKSCHEDULER_H_
+#define OWT_BASE_AUDIOCHUNKSCHEDULER_H_
+#include <stdint.h>
+namespace owt {
+namespace base {
+// Timing counters of a pacing thread. Deadlines are absolute, so a late chunk
+// does not shift the schedule of the following ones.
+struct AudioCaptureTimingStats {
+  // Records a wake up at |wakeup_ns| for a chunk due at |deadline_ns|.
+  void RecordWakeUp(int64_t wakeup_ns, int64_t deadline_ns);
+  // Number of 10ms chunks delivered to AudioDeviceBuffer or audio sinks.
+  uint64_t delivered_chunks = 0;
+  // Number of times a generator failed to provide a full chunk.
+  uint64_t underruns = 0;
+  // Number of chunks that started after the deadline of the next chunk had
+  // already passed.
+  uint64_t overruns = 0;
+  // Number of times the schedule was re-anchored because the thread fell too
+  // far behind (e.g. the process was suspended).
+  uint64_t resyncs = 0;
+  // Absolute wake up lateness averaged with an exponential moving average of
+  // gain 1/16, and the largest wake up lateness observed, in microseconds.
+  int64_t jitter_us = 0;
+  int64_t max_lateness_us = 0;
+  // Lateness of the latest wake up, in microseconds.
+  int64_t last_lateness_us = 0;
+};
+// Schedule of 10ms audio chunks on absolute monotonic deadlines. Deadline of
+// chunk n is start + n * 10ms, so a late chunk does not shift the ones after
+// it. Not thread safe; each pacing thread owns its own scheduler.
+class AudioChunkScheduler {
+ public:
+  AudioChunkScheduler();
+  // Restarts the schedule from the next call to NextChunk.
+  void Reset();
+  // Claims the next chunk and returns its deadline. If the schedule is too
+  // far behind |now_ns|, it is re-anchored to |now_ns| instead of catching
+  // up, and |*resynced| is set to true.
+  int64_t NextChunk(int64_t now_ns, bool* resynced);
+  // Deadline of the chunk after the last claimed one.
+  int64_t NextDeadline() const;
+  // Monotonic clock used for pacing.
+  static int64_t MonotonicNanos();
+  // Sleeps until the monotonic clock reaches |deadline_ns|.
+  static void SleepUntilNanos(int64_t deadline_ns);
+ private:
+  int64_t start_ns_;
+  uint64_t chunks_since_start_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOCHUNKSCHEDULER_H_
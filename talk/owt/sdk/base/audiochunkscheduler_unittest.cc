@@ -0,0 +1,65 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/audiochunkscheduler.h"
+#include "testing/gtest/include/gtest/gtest.h"
+namespace owt {
+namespace base {
+static const int64_t kChunkNs = 10000000;
+static const int64_t kStartNs = 1000 * kChunkNs;
+TEST(AudioChunkSchedulerTest, DeadlinesAreAnchoredToStart) {
+  AudioChunkScheduler scheduler;
+  bool resynced = false;
+  EXPECT_EQ(kStartNs, scheduler.NextChunk(kStartNs, &resynced));
+  EXPECT_EQ(kStartNs + kChunkNs, scheduler.NextDeadline());
+  // Waking up late does not move the deadlines of later chunks.
+  EXPECT_EQ(kStartNs + kChunkNs,
+            scheduler.NextChunk(kStartNs + kChunkNs + 3000000, &resynced));
+  EXPECT_EQ(kStartNs + 2 * kChunkNs,
+            scheduler.NextChunk(kStartNs + 2 * kChunkNs, &resynced));
+  EXPECT_EQ(kStartNs + 3 * kChunkNs, scheduler.NextDeadline());
+  EXPECT_FALSE(resynced);
+}
+TEST(AudioChunkSchedulerTest, CatchesUpWithinLimit) {
+  AudioChunkScheduler scheduler;
+  bool resynced = false;
+  scheduler.NextChunk(kStartNs, &resynced);
+  // 200ms behind is still caught up chunk by chunk.
+  int64_t now_ns = kStartNs + 21 * kChunkNs;
+  for (int i = 1; i <= 21; i++) {
+    EXPECT_EQ(kStartNs + i * kChunkNs, scheduler.NextChunk(now_ns, &resynced));
+  }
+  EXPECT_FALSE(resynced);
+}
+TEST(AudioChunkSchedulerTest, ResyncsWhenTooFarBehind) {
+  AudioChunkScheduler scheduler;
+  bool resynced = false;
+  scheduler.NextChunk(kStartNs, &resynced);
+  int64_t now_ns = kStartNs + 100 * kChunkNs;
+  EXPECT_EQ(now_ns, scheduler.NextChunk(now_ns, &resynced));
+  EXPECT_TRUE(resynced);
+  EXPECT_EQ(now_ns + kChunkNs, scheduler.NextDeadline());
+}
+TEST(AudioChunkSchedulerTest, ResetRestartsSchedule) {
+  AudioChunkScheduler scheduler;
+  bool resynced = false;
+  scheduler.NextChunk(kStartNs, &resynced);
+  scheduler.NextChunk(kStartNs, &resynced);
+  scheduler.Reset();
+  EXPECT_EQ(5 * kStartNs, scheduler.NextChunk(5 * kStartNs, &resynced));
+  EXPECT_FALSE(resynced);
+}
+TEST(AudioCaptureTimingStatsTest, RecordsLateness) {
+  AudioCaptureTimingStats stats;
+  stats.RecordWakeUp(kStartNs + 2000000, kStartNs);
+  EXPECT_EQ(2000, stats.last_lateness_us);
+  EXPECT_EQ(2000, stats.max_lateness_us);
+  EXPECT_EQ(125, stats.jitter_us);
+  // Early wake ups count towards jitter but not maximum lateness.
+  stats.RecordWakeUp(kStartNs - 1000000, kStartNs);
+  EXPECT_EQ(-1000, stats.last_lateness_us);
+  EXPECT_EQ(2000, stats.max_lateness_us);
+  EXPECT_EQ(179, stats.jitter_us);
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,132 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/include/cpp/owt/base/audiofileframegenerator.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "webrtc/rtc_base/logging.h"
+#include "talk/owt/sdk/base/audiofilemapping.h"
+namespace owt {
+namespace base {
+// Plays PCM data of a shared file mapping in a loop. Each generator only owns
+// its read position, so any number of them can read the same mapping.
+class AudioFileFrameGeneratorImpl : public AudioFrameGeneratorInterface {
+ public:
+  AudioFileFrameGeneratorImpl(std::shared_ptr<AudioFileMapping> mapping,
+                              const AudioFileFormat& format,
+                              int start_offset_ms)
+      : mapping_(mapping), format_(format) {
+    const size_t sample_size =
+        format_.sample_format == AudioSampleFormat::kFloat32 ? sizeof(float)
+                                                             : sizeof(int16_t);
+    frame_size_ = sample_size * format_.channel_number;
+    // Partial frame at the end of file is ignored.
+    format_.data_size -= format_.data_size % frame_size_;
+    chunk_size_ = frame_size_ * (format_.sample_rate / 100);
+    data_ = mapping_->data() + format_.data_offset;
+    // Samples are read in place only if they are properly aligned.
+    in_place_ = reinterpret_cast<uintptr_t>(data_) % sample_size == 0;
+    uint64_t start_frame =
+        static_cast<uint64_t>(start_offset_ms) * format_.sample_rate / 1000;
+    position_ = static_cast<size_t>((start_frame * frame_size_) %
+                                    format_.data_size);
+    chunk_buffer_.resize(chunk_size_);
+  }
+  uint32_t GenerateFramesForNext10Ms(uint8_t* buffer,
+                                     const uint32_t capacity) override {
+    if (capacity < chunk_size_)
+      return 0;
+    const uint8_t* frames = ReadFramesForNext10Ms(chunk_size_);
+    memcpy(buffer, frames, chunk_size_);
+    return static_cast<uint32_t>(chunk_size_);
+  }
+  const uint8_t* ReadFramesForNext10Ms(const uint32_t size) override {
+    if (size != chunk_size_)
+      return nullptr;
+    if (in_place_ && position_ + chunk_size_ <= format_.data_size) {
+      const uint8_t* frames = data_ + position_;
+      Advance(chunk_size_);
+      return frames;
+    }
+    // The chunk wraps around the end of file, so it is stitched together.
+    size_t copied = 0;
+    while (copied < chunk_size_) {
+      size_t bytes =
+          std::min(chunk_size_ - copied, format_.data_size - position_);
+      memcpy(chunk_buffer_.data() + copied, data_ + position_, bytes);
+      Advance(bytes);
+      copied += bytes;
+    }
+    return chunk_buffer_.data();
+  }
+  int GetSampleRate() override { return format_.sample_rate; }
+  int GetChannelNumber() override { return format_.channel_number; }
+  AudioSampleFormat GetSampleFormat() override {
+    return format_.sample_format;
+  }
+ private:
+  void Advance(size_t bytes) {
+    position_ += bytes;
+    if (position_ == format_.data_size)
+      position_ = 0;
+  }
+  std::shared_ptr<AudioFileMapping> mapping_;
+  AudioFileFormat format_;
+  const uint8_t* data_;
+  size_t frame_size_;
+  size_t chunk_size_;
+  size_t position_;
+  bool in_place_;
+  std::vector<uint8_t> chunk_buffer_;
+};
+static std::unique_ptr<AudioFrameGeneratorInterface> CreateGenerator(
+    std::shared_ptr<AudioFileMapping> mapping,
+    const AudioFileFormat& format,
+    int start_offset_ms) {
+  if (format.sample_rate < 100 || format.sample_rate % 100 != 0 ||
+      format.channel_number <= 0 || start_offset_ms < 0) {
+    RTC_LOG(LS_ERROR) << "Unsupported audio file, sample rate "
+                      << format.sample_rate << ", channel number "
+                      << format.channel_number << ".";
+    return nullptr;
+  }
+  const size_t frame_size =
+      (format.sample_format == AudioSampleFormat::kFloat32 ? sizeof(float)
+                                                           : sizeof(int16_t)) *
+      format.channel_number;
+  if (format.data_size < frame_size) {
+    RTC_LOG(LS_ERROR) << "Audio file does not contain any frame.";
+    return nullptr;
+  }
+  return std::unique_ptr<AudioFrameGeneratorInterface>(
+      new AudioFileFrameGeneratorImpl(mapping, format, start_offset_ms));
+}
+std::unique_ptr<AudioFrameGeneratorInterface>
+AudioFileFrameGenerator::CreateFromWavFile(const std::string& path,
+                                           int start_offset_ms) {
+  std::shared_ptr<AudioFileMapping> mapping = AudioFileMapping::Open(path);
+  AudioFileFormat format;
+  if (!mapping || !ParseWavHeader(mapping->data(), mapping->size(), &format))
+    return nullptr;
+  return CreateGenerator(mapping, format, start_offset_ms);
+}
+std::unique_ptr<AudioFrameGeneratorInterface>
+AudioFileFrameGenerator::CreateFromRawFile(const std::string& path,
+                                           AudioSampleFormat format,
+                                           int sample_rate,
+                                           int channel_number,
+                                           int start_offset_ms) {
+  std::shared_ptr<AudioFileMapping> mapping = AudioFileMapping::Open(path);
+  if (!mapping)
+    return nullptr;
+  AudioFileFormat file_format;
+  file_format.sample_format = format;
+  file_format.sample_rate = sample_rate;
+  file_format.channel_number = channel_number;
+  file_format.data_offset = 0;
+  file_format.data_size = mapping->size();
+  return CreateGenerator(mapping, file_format, start_offset_ms);
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,100 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "talk/owt/sdk/base/audiofilemapping.h"
+#include "talk/owt/sdk/include/cpp/owt/base/audiofileframegenerator.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+static const char kWavPath[] = "audiofileframegenerator_unittest.wav";
+static void AppendLittleEndian(std::vector<uint8_t>* out,
+                               uint32_t value,
+                               int bytes) {
+  for (int i = 0; i < bytes; i++)
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+// Writes a mono 8kHz WAV file whose n-th sample is n.
+static void WriteWavFile(int frames) {
+  std::vector<uint8_t> file;
+  file.insert(file.end(), {'R', 'I', 'F', 'F'});
+  AppendLittleEndian(&file, 36 + frames * 2, 4);
+  file.insert(file.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  AppendLittleEndian(&file, 16, 4);
+  AppendLittleEndian(&file, 1, 2);         // PCM
+  AppendLittleEndian(&file, 1, 2);         // Channels
+  AppendLittleEndian(&file, 8000, 4);      // Sample rate
+  AppendLittleEndian(&file, 8000 * 2, 4);  // Byte rate
+  AppendLittleEndian(&file, 2, 2);         // Block align
+  AppendLittleEndian(&file, 16, 2);        // Bits per sample
+  file.insert(file.end(), {'d', 'a', 't', 'a'});
+  AppendLittleEndian(&file, frames * 2, 4);
+  for (int i = 0; i < frames; i++)
+    AppendLittleEndian(&file, i, 2);
+  FILE* f = fopen(kWavPath, "wb");
+  ASSERT_TRUE(f != nullptr);
+  fwrite(file.data(), 1, file.size(), f);
+  fclose(f);
+}
+TEST(AudioFileFrameGeneratorTest, ParsesWavHeader) {
+  WriteWavFile(200);
+  std::shared_ptr<AudioFileMapping> mapping = AudioFileMapping::Open(kWavPath);
+  ASSERT_TRUE(mapping != nullptr);
+  AudioFileFormat format;
+  EXPECT_TRUE(ParseWavHeader(mapping->data(), mapping->size(), &format));
+  EXPECT_EQ(format.sample_format, AudioSampleFormat::kInt16);
+  EXPECT_EQ(format.sample_rate, 8000);
+  EXPECT_EQ(format.channel_number, 1);
+  EXPECT_EQ(format.data_offset, 44u);
+  EXPECT_EQ(format.data_size, 400u);
+  mapping.reset();
+  remove(kWavPath);
+}
+TEST(AudioFileFrameGeneratorTest, LoopsWithoutGap) {
+  // 2.5 chunks of 10ms, so every other chunk wraps around the end.
+  WriteWavFile(200);
+  std::unique_ptr<AudioFrameGeneratorInterface> generator =
+      AudioFileFrameGenerator::CreateFromWavFile(kWavPath);
+  ASSERT_TRUE(generator != nullptr);
+  EXPECT_EQ(generator->GetSampleRate(), 8000);
+  int expected = 0;
+  for (int chunk = 0; chunk < 10; chunk++) {
+    const int16_t* samples = reinterpret_cast<const int16_t*>(
+        generator->ReadFramesForNext10Ms(160));
+    ASSERT_TRUE(samples != nullptr);
+    for (int i = 0; i < 80; i++) {
+      ASSERT_EQ(samples[i], expected);
+      expected = (expected + 1) % 200;
+    }
+  }
+  generator.reset();
+  remove(kWavPath);
+}
+TEST(AudioFileFrameGeneratorTest, GeneratorsShareMappingAtDifferentOffsets) {
+  WriteWavFile(200);
+  std::unique_ptr<AudioFrameGeneratorInterface> first =
+      AudioFileFrameGenerator::CreateFromWavFile(kWavPath);
+  std::unique_ptr<AudioFrameGeneratorInterface> second =
+      AudioFileFrameGenerator::CreateFromWavFile(kWavPath, 5);
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_TRUE(second != nullptr);
+  const uint8_t* first_frames = first->ReadFramesForNext10Ms(160);
+  const uint8_t* second_frames = second->ReadFramesForNext10Ms(160);
+  // Both read in place from the same mapping, 5ms (40 frames) apart.
+  EXPECT_EQ(second_frames - first_frames, 80);
+  std::vector<uint8_t> buffer(160);
+  EXPECT_EQ(second->GenerateFramesForNext10Ms(buffer.data(), 160), 160u);
+  EXPECT_EQ(reinterpret_cast<int16_t*>(buffer.data())[0], 120);
+  first.reset();
+  second.reset();
+  remove(kWavPath);
+}
+TEST(AudioFileFrameGeneratorTest, RejectsMissingFile) {
+  EXPECT_TRUE(AudioFileFrameGenerator::CreateFromWavFile(
+                  "audiofileframegenerator_unittest_missing.wav") == nullptr);
+}
+}
+}
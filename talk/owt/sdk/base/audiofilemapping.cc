@@ -0,0 +1,172 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/audiofilemapping.h"
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "webrtc/rtc_base/logging.h"
+namespace owt {
+namespace base {
+static const uint16_t kWavFormatPcm = 1;
+static const uint16_t kWavFormatIeeeFloat = 3;
+static const uint16_t kWavFormatExtensible = 0xFFFE;
+static uint16_t ReadLittleEndian16(const uint8_t* data) {
+  return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+static uint32_t ReadLittleEndian32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) |
+         (static_cast<uint32_t>(data[1]) << 8) |
+         (static_cast<uint32_t>(data[2]) << 16) |
+         (static_cast<uint32_t>(data[3]) << 24);
+}
+bool ParseWavHeader(const uint8_t* data, size_t size, AudioFileFormat* format) {
+  if (size < 12 || memcmp(data, "RIFF", 4) != 0 ||
+      memcmp(data + 8, "WAVE", 4) != 0) {
+    RTC_LOG(LS_ERROR) << "Not a WAV file.";
+    return false;
+  }
+  bool has_format = false;
+  uint16_t bits_per_sample = 0;
+  size_t offset = 12;
+  while (offset + 8 <= size) {
+    const uint8_t* chunk = data + offset;
+    size_t chunk_size = ReadLittleEndian32(chunk + 4);
+    size_t body_offset = offset + 8;
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunk_size < 16 || body_offset + chunk_size > size)
+        return false;
+      const uint8_t* body = data + body_offset;
+      uint16_t tag = ReadLittleEndian16(body);
+      if (tag == kWavFormatExtensible && chunk_size >= 26) {
+        // First two bytes of sub format GUID are the actual format tag.
+        tag = ReadLittleEndian16(body + 24);
+      }
+      format->channel_number = ReadLittleEndian16(body + 2);
+      format->sample_rate = static_cast<int>(ReadLittleEndian32(body + 4));
+      bits_per_sample = ReadLittleEndian16(body + 14);
+      if (tag == kWavFormatPcm && bits_per_sample == 16) {
+        format->sample_format = AudioSampleFormat::kInt16;
+      } else if (tag == kWavFormatIeeeFloat && bits_per_sample == 32) {
+        format->sample_format = AudioSampleFormat::kFloat32;
+      } else {
+        RTC_LOG(LS_ERROR) << "Unsupported WAV format " << tag << " with "
+                          << bits_per_sample << " bits per sample.";
+        return false;
+      }
+      has_format = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (!has_format)
+        return false;
+      format->data_offset = body_offset;
+      // Size of data chunk is not reliable for files still being written, so
+      // it is clamped to the file.
+      format->data_size = std::min(chunk_size, size - body_offset);
+      return true;
+    }
+    // Chunks are padded to an even size.
+    offset = body_offset + chunk_size + (chunk_size & 1);
+  }
+  RTC_LOG(LS_ERROR) << "No data chunk found in WAV file.";
+  return false;
+}
+std::shared_ptr<AudioFileMapping> AudioFileMapping::Open(
+    const std::string& path) {
+  static std::mutex mappings_mutex;
+  static std::unordered_map<std::string, std::weak_ptr<AudioFileMapping>>
+      mappings;
+  std::lock_guard<std::mutex> lock(mappings_mutex);
+  auto it = mappings.find(path);
+  if (it != mappings.end()) {
+    std::shared_ptr<AudioFileMapping> mapping = it->second.lock();
+    if (mapping)
+      return mapping;
+    mappings.erase(it);
+  }
+  std::shared_ptr<AudioFileMapping> mapping(new AudioFileMapping());
+  if (!mapping->Map(path))
+    return nullptr;
+  mappings[path] = mapping;
+  return mapping;
+}
+#if defined(WEBRTC_WIN)
+AudioFileMapping::AudioFileMapping()
+    : data_(nullptr),
+      size_(0),
+      file_handle_(INVALID_HANDLE_VALUE),
+      mapping_handle_(nullptr) {}
+AudioFileMapping::~AudioFileMapping() {
+  if (data_)
+    UnmapViewOfFile(data_);
+  if (mapping_handle_)
+    CloseHandle(mapping_handle_);
+  if (file_handle_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_handle_);
+}
+bool AudioFileMapping::Map(const std::string& path) {
+  file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+  LARGE_INTEGER file_size;
+  if (file_handle_ == INVALID_HANDLE_VALUE ||
+      !GetFileSizeEx(file_handle_, &file_size) || file_size.QuadPart == 0) {
+    RTC_LOG(LS_ERROR) << "Failed to open " << path << ".";
+    return false;
+  }
+  mapping_handle_ =
+      CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle_) {
+    RTC_LOG(LS_ERROR) << "Failed to map " << path << ".";
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(
+      MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (!data_) {
+    RTC_LOG(LS_ERROR) << "Failed to map " << path << ".";
+    return false;
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+#else
+AudioFileMapping::AudioFileMapping() : data_(nullptr), size_(0) {}
+AudioFileMapping::~AudioFileMapping() {
+  if (data_)
+    munmap(const_cast<uint8_t*>(data_), size_);
+}
+bool AudioFileMapping::Map(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    RTC_LOG(LS_ERROR) << "Failed to open " << path << ".";
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file referenced.
+  close(fd);
+  if (data == MAP_FAILED) {
+    RTC_LOG(LS_ERROR) << "Failed to map " << path << ".";
+    return false;
+  }
+  // The whole file is played in a loop, so ask for all of it to be paged in
+  // rather than read ahead sequentially.
+  madvise(data, size, MADV_WILLNEED);
+  data_ = static_cast<const uint8_t*>(data);
+  size_ = size;
+  return true;
+}
+#endif
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,46 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOFILEMAPPING_H_
+#define OWT_BASE_AUDIOFILEMAPPING_H_
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "talk/owt/sdk/include/cpp/owt/base/framegeneratorinterface.h"
+namespace owt {
+namespace base {
+// Layout of PCM data in an audio file.
+struct AudioFileFormat {
+  AudioSampleFormat sample_format = AudioSampleFormat::kInt16;
+  int sample_rate = 0;
+  int channel_number = 0;
+  // Offset and size of PCM data in the file, in bytes.
+  size_t data_offset = 0;
+  size_t data_size = 0;
+};
+// Parses the header of a WAV file in |data|. Only 16 bit integer and 32 bit
+// float PCM are supported.
+bool ParseWavHeader(const uint8_t* data, size_t size, AudioFileFormat* format);
+// A read-only memory mapping of a file. All users of the same file share one
+// mapping, which is unmapped when the last user releases it.
+class AudioFileMapping {
+ public:
+  // Returns the mapping of |path|, or nullptr if it cannot be mapped.
+  static std::shared_ptr<AudioFileMapping> Open(const std::string& path);
+  ~AudioFileMapping();
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+ private:
+  AudioFileMapping();
+  bool Map(const std::string& path);
+  const uint8_t* data_;
+  size_t size_;
+#if defined(WEBRTC_WIN)
+  void* file_handle_;
+  void* mapping_handle_;
+#endif
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOFILEMAPPING_H_
@@ -0,0 +1,122 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/audioframeconverter.h"
+#include <string.h>
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/rtc_base/arraysize.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+namespace owt {
+namespace base {
+static const int kNativeSampleRates[] = {8000, 16000, 32000, 48000};
+static size_t BytesPerSample(AudioSampleFormat format) {
+  return format == AudioSampleFormat::kFloat32 ? sizeof(float)
+                                               : sizeof(int16_t);
+}
+bool AudioFrameConverter::IsSupported(AudioSampleFormat format,
+                                      int sample_rate,
+                                      int channel_number) {
+  if (format != AudioSampleFormat::kInt16 &&
+      format != AudioSampleFormat::kFloat32) {
+    return false;
+  }
+  return sample_rate >= 100 && sample_rate % 100 == 0 && channel_number > 0;
+}
+int AudioFrameConverter::NativeSampleRate(int sample_rate) {
+  for (int native_rate : kNativeSampleRates) {
+    if (sample_rate <= native_rate)
+      return native_rate;
+  }
+  return kNativeSampleRates[arraysize(kNativeSampleRates) - 1];
+}
+AudioFrameConverter::AudioFrameConverter(AudioSampleFormat format,
+                                         int sample_rate,
+                                         int channel_number)
+    : format_(format),
+      input_sample_rate_(sample_rate),
+      input_channel_number_(channel_number),
+      input_frames_in_10ms_(static_cast<size_t>(sample_rate / 100)),
+      input_size_in_10ms_(input_frames_in_10ms_ * channel_number *
+                          BytesPerSample(format)),
+      output_sample_rate_(NativeSampleRate(sample_rate)),
+      output_channel_number_(channel_number > 2 ? 1 : channel_number),
+      needs_conversion_(format != AudioSampleFormat::kInt16 ||
+                        output_sample_rate_ != sample_rate ||
+                        output_channel_number_ != channel_number) {
+  RTC_DCHECK(IsSupported(format, sample_rate, channel_number));
+  if (output_channel_number_ != input_channel_number_) {
+    int16_buffer_.resize(input_frames_in_10ms_);
+    float_buffer_.resize(input_frames_in_10ms_);
+  }
+  if (output_sample_rate_ != input_sample_rate_) {
+    if (format_ == AudioSampleFormat::kFloat32) {
+      float_resampler_.InitializeIfNeeded(
+          input_sample_rate_, output_sample_rate_, output_channel_number_);
+      float_resampled_.resize(OutputFramesIn10Ms() * output_channel_number_);
+    } else {
+      int16_resampler_.InitializeIfNeeded(
+          input_sample_rate_, output_sample_rate_, output_channel_number_);
+    }
+  }
+  if (needs_conversion_) {
+    RTC_LOG(LS_INFO) << "Convert customized audio from " << input_sample_rate_
+                     << "Hz " << input_channel_number_ << " channel(s) to "
+                     << output_sample_rate_ << "Hz " << output_channel_number_
+                     << " channel(s).";
+  }
+}
+bool AudioFrameConverter::Convert(const uint8_t* input,
+                                  size_t input_size,
+                                  int16_t* output) {
+  if (input_size != input_size_in_10ms_) {
+    RTC_LOG(LS_ERROR) << "Unexpected audio frame size " << input_size
+                      << ", expected " << input_size_in_10ms_ << ".";
+    return false;
+  }
+  if (format_ == AudioSampleFormat::kFloat32) {
+    return ConvertFloat(reinterpret_cast<const float*>(input), output);
+  }
+  return ConvertInt16(reinterpret_cast<const int16_t*>(input), output);
+}
+bool AudioFrameConverter::ConvertInt16(const int16_t* input, int16_t* output) {
+  const int16_t* source = input;
+  if (output_channel_number_ != input_channel_number_) {
+    webrtc::DownmixInterleavedToMono(input, input_frames_in_10ms_,
+                                     input_channel_number_,
+                                     int16_buffer_.data());
+    source = int16_buffer_.data();
+  }
+  const size_t output_samples = OutputFramesIn10Ms() * output_channel_number_;
+  if (output_sample_rate_ == input_sample_rate_) {
+    memcpy(output, source, output_samples * sizeof(int16_t));
+    return true;
+  }
+  return int16_resampler_.Resample(
+             source, input_frames_in_10ms_ * output_channel_number_, output,
+             output_samples) == static_cast<int>(output_samples);
+}
+bool AudioFrameConverter::ConvertFloat(const float* input, int16_t* output) {
+  const float* source = input;
+  if (output_channel_number_ != input_channel_number_) {
+    webrtc::DownmixInterleavedToMono(input, input_frames_in_10ms_,
+                                     input_channel_number_,
+                                     float_buffer_.data());
+    source = float_buffer_.data();
+  }
+  const size_t output_samples = OutputFramesIn10Ms() * output_channel_number_;
+  if (output_sample_rate_ != input_sample_rate_) {
+    // Resample before quantization so resampler works on full precision.
+    if (float_resampler_.Resample(
+            source, input_frames_in_10ms_ * output_channel_number_,
+            float_resampled_.data(),
+            output_samples) != static_cast<int>(output_samples)) {
+      return false;
+    }
+    source = float_resampled_.data();
+  }
+  webrtc::FloatToS16(source, output_samples, output);
+  return true;
+}
+}  // namespace base
+}  // namespace owt
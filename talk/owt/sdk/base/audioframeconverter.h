@@ -0,0 +1,61 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOFRAMECONVERTER_H_
+#define OWT_BASE_AUDIOFRAMECONVERTER_H_
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "talk/owt/sdk/include/cpp/owt/base/framegeneratorinterface.h"
+namespace owt {
+namespace base {
+// Converts 10ms chunks of PCM audio in any sample format, sample rate and
+// channel number to interleaved 16 bit PCM at a rate and channel number
+// natively supported by WebRTC. Float input is resampled before it is
+// quantized, and all steps use WebRTC's SIMD optimized routines. Not thread
+// safe.
+class AudioFrameConverter {
+ public:
+  // Returns true if 10ms of audio in this format has an integer number of
+  // frames and can be converted.
+  static bool IsSupported(AudioSampleFormat format,
+                          int sample_rate,
+                          int channel_number);
+  AudioFrameConverter(AudioSampleFormat format,
+                      int sample_rate,
+                      int channel_number);
+  // Size in bytes of 10ms input audio.
+  size_t InputSizeIn10Ms() const { return input_size_in_10ms_; }
+  int OutputSampleRate() const { return output_sample_rate_; }
+  int OutputChannelNumber() const { return output_channel_number_; }
+  size_t OutputFramesIn10Ms() const {
+    return static_cast<size_t>(output_sample_rate_ / 100);
+  }
+  // Returns false if input can be handed to WebRTC as is.
+  bool NeedsConversion() const { return needs_conversion_; }
+  // Converts 10ms of audio. |input_size| must be InputSizeIn10Ms(), and
+  // |output| must hold OutputFramesIn10Ms() * OutputChannelNumber() samples.
+  bool Convert(const uint8_t* input, size_t input_size, int16_t* output);
+ private:
+  static int NativeSampleRate(int sample_rate);
+  bool ConvertInt16(const int16_t* input, int16_t* output);
+  bool ConvertFloat(const float* input, int16_t* output);
+  const AudioSampleFormat format_;
+  const int input_sample_rate_;
+  const int input_channel_number_;
+  const size_t input_frames_in_10ms_;
+  const size_t input_size_in_10ms_;
+  const int output_sample_rate_;
+  const int output_channel_number_;
+  const bool needs_conversion_;
+  webrtc::PushResampler<int16_t> int16_resampler_;
+  webrtc::PushResampler<float> float_resampler_;
+  // Scratch buffers for downmixed and resampled audio.
+  std::vector<int16_t> int16_buffer_;
+  std::vector<float> float_buffer_;
+  std::vector<float> float_resampled_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOFRAMECONVERTER_H_
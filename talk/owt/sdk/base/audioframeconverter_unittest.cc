@@ -0,0 +1,50 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <vector>
+#include "talk/owt/sdk/base/audioframeconverter.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+TEST(AudioFrameConverterTest, NativeInt16IsNotConverted) {
+  AudioFrameConverter converter(AudioSampleFormat::kInt16, 48000, 2);
+  EXPECT_FALSE(converter.NeedsConversion());
+  EXPECT_EQ(converter.OutputSampleRate(), 48000);
+  EXPECT_EQ(converter.OutputChannelNumber(), 2);
+  EXPECT_EQ(converter.InputSizeIn10Ms(), 480u * 2 * 2);
+}
+TEST(AudioFrameConverterTest, RejectsRatesWithoutWhole10MsFrames) {
+  EXPECT_FALSE(AudioFrameConverter::IsSupported(AudioSampleFormat::kInt16,
+                                                22050, 2));
+  EXPECT_FALSE(AudioFrameConverter::IsSupported(AudioSampleFormat::kFloat32,
+                                                44100, 0));
+  EXPECT_TRUE(AudioFrameConverter::IsSupported(AudioSampleFormat::kFloat32,
+                                               44100, 6));
+}
+TEST(AudioFrameConverterTest, ConvertsFloatToInt16) {
+  AudioFrameConverter converter(AudioSampleFormat::kFloat32, 16000, 1);
+  EXPECT_TRUE(converter.NeedsConversion());
+  std::vector<float> input(160, 0.5f);
+  input[0] = 1.0f;
+  input[1] = -1.0f;
+  std::vector<int16_t> output(converter.OutputFramesIn10Ms());
+  EXPECT_TRUE(converter.Convert(reinterpret_cast<uint8_t*>(input.data()),
+                                input.size() * sizeof(float), output.data()));
+  EXPECT_EQ(output[0], 32767);
+  EXPECT_EQ(output[1], -32768);
+  EXPECT_NEAR(output[2], 16384, 1);
+}
+TEST(AudioFrameConverterTest, DownmixesAndResamples) {
+  AudioFrameConverter converter(AudioSampleFormat::kFloat32, 44100, 6);
+  EXPECT_EQ(converter.OutputSampleRate(), 48000);
+  EXPECT_EQ(converter.OutputChannelNumber(), 1);
+  std::vector<float> input(441 * 6, 0.25f);
+  std::vector<int16_t> output(converter.OutputFramesIn10Ms());
+  EXPECT_TRUE(converter.Convert(reinterpret_cast<uint8_t*>(input.data()),
+                                input.size() * sizeof(float), output.data()));
+  EXPECT_FALSE(converter.Convert(reinterpret_cast<uint8_t*>(input.data()),
+                                 input.size(), output.data()));
+}
+}
+}
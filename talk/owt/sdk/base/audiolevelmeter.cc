@@ -0,0 +1,77 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/audiolevelmeter.h"
+#include <math.h>
+#include <algorithm>
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/rtc_base/checks.h"
+namespace owt {
+namespace base {
+// Lowest level reported, in dBFS.
+static const int kMinLevelDbfs = -127;
+// Without WebRTC VAD, a chunk whose peak is above -40dBFS counts as voice.
+static const int16_t kVoicePeakThreshold = 328;
+// Interval is reported as voice active if at least 1/kVoiceChunkRatio of its
+// chunks have voice, so short pauses between words do not toggle it.
+static const int kVoiceChunkRatio = 3;
+static int PeakToDbfs(int16_t peak) {
+  if (peak <= 0)
+    return kMinLevelDbfs;
+  int dbfs = static_cast<int>(floorf(20.0f * log10f(peak / 32768.0f) + 0.5f));
+  return std::max(kMinLevelDbfs, std::min(0, dbfs));
+}
+AudioLevelMeter::AudioLevelMeter(AudioLevelObserverInterface* observer,
+                                 int interval_ms,
+                                 int sample_rate,
+                                 int channel_number)
+    : observer_(observer),
+      chunks_per_interval_(std::max(1, interval_ms / 10)),
+      sample_rate_(sample_rate),
+      channel_number_(channel_number),
+      peak_(0),
+      chunks_(0),
+      voice_chunks_(0) {
+  if (sample_rate_ == 8000 || sample_rate_ == 16000 || sample_rate_ == 32000 ||
+      sample_rate_ == 48000) {
+    vad_ = webrtc::CreateVad(webrtc::Vad::kVadNormal);
+  }
+  if (channel_number_ > 1)
+    mono_buffer_.resize(static_cast<size_t>(sample_rate_ / 100));
+}
+void AudioLevelMeter::Process(const int16_t* audio, size_t frames) {
+  RTC_DCHECK_EQ(frames, static_cast<size_t>(sample_rate_ / 100));
+  const size_t samples = frames * channel_number_;
+  rms_level_.Analyze(rtc::ArrayView<const int16_t>(audio, samples));
+  int16_t chunk_peak = WebRtcSpl_MaxAbsValueW16(audio, samples);
+  peak_ = std::max(peak_, chunk_peak);
+  bool voice = false;
+  if (vad_) {
+    const int16_t* mono = audio;
+    if (channel_number_ > 1) {
+      webrtc::DownmixInterleavedToMono(audio, frames, channel_number_,
+                                       mono_buffer_.data());
+      mono = mono_buffer_.data();
+    }
+    voice = vad_->VoiceActivity(mono, frames, sample_rate_) ==
+            webrtc::Vad::kActive;
+  } else {
+    voice = chunk_peak >= kVoicePeakThreshold;
+  }
+  if (voice)
+    voice_chunks_++;
+  if (++chunks_ < chunks_per_interval_)
+    return;
+  AudioLevel level;
+  // RmsLevel reports positive attenuation relative to full scale.
+  level.rms_dbfs = -rms_level_.Average();
+  level.peak_dbfs = PeakToDbfs(peak_);
+  level.voice_active = voice_chunks_ * kVoiceChunkRatio >= chunks_;
+  peak_ = 0;
+  chunks_ = 0;
+  voice_chunks_ = 0;
+  observer_->OnAudioLevel(level);
+}
+}  // namespace base
+}  // namespace owt
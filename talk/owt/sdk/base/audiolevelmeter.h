@@ -0,0 +1,43 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOLEVELMETER_H_
+#define OWT_BASE_AUDIOLEVELMETER_H_
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include "webrtc/common_audio/vad/include/vad.h"
+#include "webrtc/modules/audio_processing/rms_level.h"
+#include "talk/owt/sdk/include/cpp/owt/base/audiolevelobserverinterface.h"
+namespace owt {
+namespace base {
+// Measures RMS level, peak level and voice activity of 10ms chunks of 16 bit
+// PCM, and reports them to an observer once per interval. All work happens on
+// the calling thread without locks. Not thread safe.
+class AudioLevelMeter {
+ public:
+  // |interval_ms| is rounded down to a multiple of 10ms, with 10ms minimum.
+  AudioLevelMeter(AudioLevelObserverInterface* observer,
+                  int interval_ms,
+                  int sample_rate,
+                  int channel_number);
+  // Analyzes 10ms of interleaved audio.
+  void Process(const int16_t* audio, size_t frames);
+ private:
+  AudioLevelObserverInterface* observer_;
+  const int chunks_per_interval_;
+  const int sample_rate_;
+  const int channel_number_;
+  webrtc::RmsLevel rms_level_;
+  // Null if WebRTC VAD does not support |sample_rate_|, in which case voice
+  // activity is estimated from peak level.
+  std::unique_ptr<webrtc::Vad> vad_;
+  std::vector<int16_t> mono_buffer_;
+  int16_t peak_;
+  int chunks_;
+  int voice_chunks_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOLEVELMETER_H_
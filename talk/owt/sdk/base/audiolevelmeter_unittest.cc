@@ -0,0 +1,102 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <vector>
+#include "talk/owt/sdk/base/audiolevelmeter.h"
+#include "testing/gtest/include/gtest/gtest.h"
+namespace owt {
+namespace base {
+class LevelRecorder : public AudioLevelObserverInterface {
+ public:
+  void OnAudioLevel(const AudioLevel& level) override {
+    levels.push_back(level);
+  }
+  std::vector<AudioLevel> levels;
+};
+// Interleaved 10ms chunk of a square wave with |amplitude|.
+static std::vector<int16_t> SquareChunk(int sample_rate,
+                                        int channel_number,
+                                        int16_t amplitude) {
+  std::vector<int16_t> chunk(sample_rate / 100 * channel_number);
+  for (size_t i = 0; i < chunk.size(); i++) {
+    chunk[i] = (i / channel_number) % 2 ? amplitude : -amplitude;
+  }
+  return chunk;
+}
+TEST(AudioLevelMeterTest, ReportsOncePerInterval) {
+  LevelRecorder recorder;
+  AudioLevelMeter meter(&recorder, 100, 16000, 1);
+  std::vector<int16_t> silence(160, 0);
+  for (int i = 0; i < 25; i++) {
+    meter.Process(silence.data(), 160);
+  }
+  EXPECT_EQ(2u, recorder.levels.size());
+}
+TEST(AudioLevelMeterTest, SilenceIsMinimumLevelWithoutVoice) {
+  LevelRecorder recorder;
+  AudioLevelMeter meter(&recorder, 50, 48000, 2);
+  std::vector<int16_t> silence(960, 0);
+  for (int i = 0; i < 5; i++) {
+    meter.Process(silence.data(), 480);
+  }
+  ASSERT_EQ(1u, recorder.levels.size());
+  EXPECT_EQ(-127, recorder.levels[0].rms_dbfs);
+  EXPECT_EQ(-127, recorder.levels[0].peak_dbfs);
+  EXPECT_FALSE(recorder.levels[0].voice_active);
+}
+TEST(AudioLevelMeterTest, MeasuresRmsAndPeakLevel) {
+  LevelRecorder recorder;
+  AudioLevelMeter meter(&recorder, 10, 16000, 1);
+  // Half of full scale is -6dBFS for both RMS and peak of a square wave.
+  std::vector<int16_t> chunk = SquareChunk(16000, 1, 16384);
+  meter.Process(chunk.data(), 160);
+  chunk = SquareChunk(16000, 1, 1638);
+  meter.Process(chunk.data(), 160);
+  ASSERT_EQ(2u, recorder.levels.size());
+  EXPECT_EQ(-6, recorder.levels[0].rms_dbfs);
+  EXPECT_EQ(-6, recorder.levels[0].peak_dbfs);
+  EXPECT_EQ(-26, recorder.levels[1].rms_dbfs);
+  EXPECT_EQ(-26, recorder.levels[1].peak_dbfs);
+}
+TEST(AudioLevelMeterTest, PeakIsLoudestChunkOfInterval) {
+  LevelRecorder recorder;
+  AudioLevelMeter meter(&recorder, 30, 16000, 1);
+  std::vector<int16_t> quiet = SquareChunk(16000, 1, 1638);
+  std::vector<int16_t> loud = SquareChunk(16000, 1, 16384);
+  meter.Process(quiet.data(), 160);
+  meter.Process(loud.data(), 160);
+  meter.Process(quiet.data(), 160);
+  ASSERT_EQ(1u, recorder.levels.size());
+  EXPECT_EQ(-6, recorder.levels[0].peak_dbfs);
+  EXPECT_GT(-6, recorder.levels[0].rms_dbfs);
+  EXPECT_LT(-26, recorder.levels[0].rms_dbfs);
+}
+TEST(AudioLevelMeterTest, VoiceActiveIfThirdOfChunksHaveVoice) {
+  // WebRTC VAD does not support 44.1kHz, so voice is detected from peak level.
+  LevelRecorder recorder;
+  AudioLevelMeter meter(&recorder, 90, 44100, 1);
+  std::vector<int16_t> voice = SquareChunk(44100, 1, 3277);
+  std::vector<int16_t> silence(441, 0);
+  for (int i = 0; i < 9; i++) {
+    meter.Process(i < 3 ? voice.data() : silence.data(), 441);
+  }
+  for (int i = 0; i < 9; i++) {
+    meter.Process(i < 2 ? voice.data() : silence.data(), 441);
+  }
+  ASSERT_EQ(2u, recorder.levels.size());
+  EXPECT_TRUE(recorder.levels[0].voice_active);
+  EXPECT_FALSE(recorder.levels[1].voice_active);
+}
+TEST(AudioLevelMeterTest, QuietChunksAreNotVoice) {
+  LevelRecorder recorder;
+  AudioLevelMeter meter(&recorder, 30, 44100, 1);
+  // Below -40dBFS.
+  std::vector<int16_t> quiet = SquareChunk(44100, 1, 300);
+  for (int i = 0; i < 3; i++) {
+    meter.Process(quiet.data(), 441);
+  }
+  ASSERT_EQ(1u, recorder.levels.size());
+  EXPECT_FALSE(recorder.levels[0].voice_active);
+}
+}  // namespace base
+}  // namespace owt
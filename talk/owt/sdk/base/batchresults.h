@@ -0,0 +1,46 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_BATCHRESULTS_H_
+#define OWT_BASE_BATCHRESULTS_H_
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+namespace owt {
+namespace base {
+// Collects results of a batch request. |on_complete| is invoked with all
+// results, in the order of items, when the last item completes.
+template <typename Result>
+class BatchResults {
+ public:
+  BatchResults(size_t size,
+               std::function<void(std::vector<Result>)> on_complete)
+      : results_(size),
+        completed_(size, false),
+        remaining_(size),
+        on_complete_(on_complete) {}
+  // Only the first result of an item is kept.
+  void Complete(size_t index, Result result) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (completed_[index])
+        return;
+      completed_[index] = true;
+      results_[index] = std::move(result);
+      if (--remaining_ > 0)
+        return;
+    }
+    if (on_complete_)
+      on_complete_(std::move(results_));
+  }
+ private:
+  std::mutex mutex_;
+  std::vector<Result> results_;
+  std::vector<bool> completed_;
+  size_t remaining_;
+  std::function<void(std::vector<Result>)> on_complete_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_BATCHRESULTS_H_
@@ -0,0 +1,36 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <string>
+#include <vector>
+#include "talk/owt/sdk/base/batchresults.h"
+#include "testing/gtest/include/gtest/gtest.h"
+namespace owt {
+namespace base {
+TEST(BatchResultsTest, CompletesInOrderOfItems) {
+  std::vector<std::string> results;
+  int completions = 0;
+  BatchResults<std::string> batch(3, [&](std::vector<std::string> r) {
+    completions++;
+    results = r;
+  });
+  batch.Complete(2, "failed");
+  batch.Complete(0, "succeeded");
+  EXPECT_EQ(0, completions);
+  batch.Complete(1, "failed");
+  EXPECT_EQ(1, completions);
+  EXPECT_EQ(std::vector<std::string>({"succeeded", "failed", "failed"}),
+            results);
+}
+TEST(BatchResultsTest, KeepsFirstResultOfItem) {
+  std::vector<std::string> results;
+  BatchResults<std::string> batch(
+      2, [&](std::vector<std::string> r) { results = r; });
+  batch.Complete(0, "succeeded");
+  batch.Complete(0, "failed");
+  EXPECT_TRUE(results.empty());
+  batch.Complete(1, "succeeded");
+  EXPECT_EQ(std::vector<std::string>({"succeeded", "succeeded"}), results);
+}
+}  // namespace base
+}  // namespace owt
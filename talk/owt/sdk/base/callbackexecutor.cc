@@ -0,0 +1,235 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include "talk/owt/sdk/base/callbackexecutor.h"
+#include "talk/owt/sdk/base/timerservice.h"
+namespace owt {
+namespace base {
+namespace {
+// Callbacks may block, so more threads than cores are not useful, but at least
+// two keep one blocking callback from stalling all clients.
+const size_t kMinDefaultThreads = 2;
+const size_t kMaxDefaultThreads = 4;
+// A sequence yields its thread to others after running this many tasks.
+const int kMaxTasksPerTurn = 32;
+// Index of the worker running on current thread, or -1 for other threads.
+thread_local int current_worker = -1;
+thread_local CallbackExecutor* current_executor = nullptr;
+}  // namespace
+CallbackExecutor* CallbackExecutor::Get() {
+  static CallbackExecutor* executor = new CallbackExecutor(
+      std::min(std::max<size_t>(std::thread::hardware_concurrency(),
+                                kMinDefaultThreads),
+               kMaxDefaultThreads));
+  return executor;
+}
+CallbackExecutor::CallbackExecutor(size_t threads)
+    : next_worker_(0),
+      pending_(0),
+      stopped_(false),
+      tasks_run_(0),
+      tasks_stolen_(0),
+      total_queue_latency_us_(0),
+      max_queue_latency_us_(0) {
+  threads = std::max<size_t>(threads, 1);
+  for (size_t i = 0; i < threads; i++)
+    workers_.emplace_back(new Worker());
+  for (size_t i = 0; i < threads; i++)
+    threads_.emplace_back(&CallbackExecutor::Run, this, i);
+}
+CallbackExecutor::~CallbackExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    stopped_ = true;
+  }
+  idle_.notify_all();
+  for (auto& thread : threads_)
+    thread.join();
+}
+void CallbackExecutor::PostTask(std::function<void()> task) {
+  Task queued;
+  queued.run = std::move(task);
+  queued.posted = Clock::now();
+  Post(std::move(queued));
+}
+void CallbackExecutor::Post(Task task) {
+  // Tasks posted by a task stay on its thread, while it is hot.
+  size_t index;
+  if (current_executor == this) {
+    index = static_cast<size_t>(current_worker);
+  } else {
+    index = next_worker_++ % workers_.size();
+  }
+  // Counted before queued, so |pending_| never goes below zero.
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    pending_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    workers_[index]->tasks.push_back(std::move(task));
+  }
+  idle_.notify_one();
+}
+bool CallbackExecutor::Pop(size_t index, Task* task) {
+  {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      *task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      pending_--;
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers_.size(); i++) {
+    Worker& victim = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      pending_--;
+      tasks_stolen_++;
+      return true;
+    }
+  }
+  return false;
+}
+void CallbackExecutor::Run(size_t index) {
+  current_worker = static_cast<int>(index);
+  current_executor = this;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(idle_mutex_);
+      idle_.wait(lock, [this] { return stopped_ || pending_ > 0; });
+      if (stopped_)
+        return;
+    }
+    Task task;
+    // Another thread may take the task first.
+    if (!Pop(index, &task))
+      continue;
+    if (task.posted != Clock::time_point())
+      RecordTask(Clock::now() - task.posted);
+    task.run();
+  }
+}
+void CallbackExecutor::RecordTask(Clock::duration latency) {
+  tasks_run_++;
+  const int64_t latency_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  total_queue_latency_us_ += latency_us;
+  int64_t max = max_queue_latency_us_;
+  while (latency_us > max &&
+         !max_queue_latency_us_.compare_exchange_weak(max, latency_us)) {
+  }
+}
+CallbackExecutorStats CallbackExecutor::GetStats() const {
+  CallbackExecutorStats stats;
+  stats.threads = threads_.size();
+  stats.tasks_stolen = tasks_stolen_;
+  stats.max_queue_latency_us = max_queue_latency_us_;
+  stats.tasks_run = tasks_run_;
+  stats.average_queue_latency_us =
+      stats.tasks_run == 0
+          ? 0
+          : total_queue_latency_us_ / static_cast<int64_t>(stats.tasks_run);
+  return stats;
+}
+struct TaskSequence::Core : public std::enable_shared_from_this<Core> {
+  typedef CallbackExecutor::Clock Clock;
+  Core(const std::string& name, CallbackExecutor* executor)
+      : name(name), executor(executor), scheduled(false), stopped(false) {}
+  void Post(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (stopped)
+        return;
+      tasks.emplace_back(std::move(task), Clock::now());
+      if (scheduled)
+        return;
+      scheduled = true;
+    }
+    Schedule();
+  }
+  void Schedule() {
+    CallbackExecutor::Task turn;
+    auto self = shared_from_this();
+    turn.run = [self] { self->RunTurn(); };
+    executor->Post(std::move(turn));
+  }
+  // Runs queued tasks on current thread, and yields it after a while.
+  void RunTurn() {
+    for (int i = 0; i < kMaxTasksPerTurn; i++) {
+      std::pair<std::function<void()>, Clock::time_point> task;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopped || tasks.empty()) {
+          scheduled = false;
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        running_thread = std::this_thread::get_id();
+      }
+      executor->RecordTask(Clock::now() - task.second);
+      task.first();
+      task.first = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        running_thread = std::thread::id();
+      }
+      task_done.notify_all();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (stopped || tasks.empty()) {
+        scheduled = false;
+        return;
+      }
+    }
+    Schedule();
+  }
+  const std::string name;
+  CallbackExecutor* const executor;
+  mutable std::mutex mutex;
+  std::condition_variable task_done;
+  std::deque<std::pair<std::function<void()>, Clock::time_point>> tasks;
+  // True if a turn is posted to or running on |executor|.
+  bool scheduled;
+  bool stopped;
+  std::thread::id running_thread;
+};
+TaskSequence::TaskSequence(const std::string& name, CallbackExecutor* executor)
+    : core_(std::make_shared<Core>(name, executor)) {}
+TaskSequence::~TaskSequence() {
+  std::deque<std::pair<std::function<void()>, Core::Clock::time_point>> dropped;
+  std::unique_lock<std::mutex> lock(core_->mutex);
+  core_->stopped = true;
+  dropped.swap(core_->tasks);
+  if (core_->running_thread != std::this_thread::get_id()) {
+    core_->task_done.wait(
+        lock, [this] { return core_->running_thread == std::thread::id(); });
+  }
+  lock.unlock();
+}
+void TaskSequence::Post(std::function<void()> task) {
+  core_->Post(std::move(task));
+}
+void TaskSequence::PostDelayed(std::function<void()> task,
+                               uint32_t milliseconds) {
+  std::weak_ptr<Core> weak_core = core_;
+  TimerService::Get()->Schedule(
+      [weak_core, task]() {
+        if (auto core = weak_core.lock())
+          core->Post(task);
+      },
+      milliseconds);
+}
+bool TaskSequence::IsCurrent() const {
+  std::lock_guard<std::mutex> lock(core_->mutex);
+  return core_->running_thread == std::this_thread::get_id();
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,100 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_CALLBACKEXECUTOR_H_
+#define OWT_BASE_CALLBACKEXECUTOR_H_
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "talk/owt/sdk/include/cpp/owt/base/commontypes.h"
+namespace owt {
+namespace base {
+// A fixed number of threads running callbacks and events of all clients and
+// channels. Each thread has its own queue, and an idle thread steals tasks
+// from others. Tasks which must run in order are posted to a TaskSequence.
+class CallbackExecutor {
+ public:
+  // Process-wide executor shared by all clients. It is never destroyed, as the
+  // last reference to a client may be released by a callback.
+  static CallbackExecutor* Get();
+  // At least one thread is started.
+  explicit CallbackExecutor(size_t threads);
+  // Stops all threads. Tasks not run yet are dropped.
+  ~CallbackExecutor();
+  // Runs |task| on one of the threads. Tasks posted are not ordered.
+  void PostTask(std::function<void()> task);
+  // Tasks of TaskSequences are counted as well.
+  CallbackExecutorStats GetStats() const;
+ private:
+  friend class TaskSequence;
+  typedef std::chrono::steady_clock Clock;
+  struct Task {
+    std::function<void()> run;
+    // Zero for turns of a TaskSequence, which records its own tasks.
+    Clock::time_point posted;
+  };
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+  void Post(Task task);
+  // Pops the front of |index|'s queue, or steals the back of another queue.
+  bool Pop(size_t index, Task* task);
+  void Run(size_t index);
+  // Counts a task started after waiting for |latency|.
+  void RecordTask(Clock::duration latency);
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_worker_;
+  // Number of tasks queued. Idle threads wait until it is not zero.
+  std::atomic<size_t> pending_;
+  std::mutex idle_mutex_;
+  std::condition_variable idle_;
+  bool stopped_;
+  std::atomic<uint64_t> tasks_run_;
+  std::atomic<uint64_t> tasks_stolen_;
+  std::atomic<int64_t> total_queue_latency_us_;
+  std::atomic<int64_t> max_queue_latency_us_;
+  // Started after other members are initialized.
+  std::vector<std::thread> threads_;
+};
+// Runs tasks one by one in the order they are posted, on threads of a
+// CallbackExecutor. It replaces a TaskQueue with its own thread for callbacks
+// of a client or a channel.
+class TaskSequence {
+ public:
+  explicit TaskSequence(const std::string& name,
+                        CallbackExecutor* executor = CallbackExecutor::Get());
+  // Tasks not run yet are dropped. If a task is running, waits until it
+  // returns unless called by the task itself.
+  ~TaskSequence();
+  template <class Closure>
+  void PostTask(Closure&& closure) {
+    Post(std::function<void()>(std::forward<Closure>(closure)));
+  }
+  template <class Closure>
+  void PostDelayedTask(Closure&& closure, uint32_t milliseconds) {
+    PostDelayed(std::function<void()>(std::forward<Closure>(closure)),
+                milliseconds);
+  }
+  // Returns true if called by a task of this sequence.
+  bool IsCurrent() const;
+ private:
+  struct Core;
+  void Post(std::function<void()> task);
+  void PostDelayed(std::function<void()> task, uint32_t milliseconds);
+  // Shared with tasks posted to the executor, which may run after this
+  // sequence is destroyed.
+  std::shared_ptr<Core> core_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_CALLBACKEXECUTOR_H_
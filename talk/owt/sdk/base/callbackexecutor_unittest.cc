@@ -0,0 +1,143 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "talk/owt/sdk/base/callbackexecutor.h"
+#include "talk/owt/sdk/test/latch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+using owt::test::Latch;
+TEST(CallbackExecutorTest, SequencesRunTasksInOrder) {
+  CallbackExecutor executor(4);
+  const int kSequences = 100;
+  const int kTasks = 100;
+  std::vector<std::unique_ptr<TaskSequence>> sequences;
+  std::vector<std::vector<int>> results(kSequences);
+  Latch latch(kSequences * kTasks);
+  for (int i = 0; i < kSequences; i++)
+    sequences.emplace_back(new TaskSequence("Sequence", &executor));
+  for (int task = 0; task < kTasks; task++) {
+    for (int i = 0; i < kSequences; i++) {
+      std::vector<int>* result = &results[i];
+      sequences[i]->PostTask([result, task, &latch] {
+        result->push_back(task);
+        latch.Signal();
+      });
+    }
+  }
+  ASSERT_TRUE(latch.Wait());
+  for (auto& result : results) {
+    ASSERT_EQ(static_cast<size_t>(kTasks), result.size());
+    for (int task = 0; task < kTasks; task++)
+      EXPECT_EQ(task, result[task]);
+  }
+  CallbackExecutorStats stats = executor.GetStats();
+  EXPECT_EQ(4u, stats.threads);
+  EXPECT_EQ(static_cast<uint64_t>(kSequences * kTasks), stats.tasks_run);
+  EXPECT_LE(stats.average_queue_latency_us, stats.max_queue_latency_us);
+}
+TEST(CallbackExecutorTest, SequenceRunsOneTaskAtATime) {
+  CallbackExecutor executor(4);
+  TaskSequence sequence("Sequence", &executor);
+  std::atomic<int> running(0);
+  std::atomic<bool> overlapped(false);
+  Latch latch(200);
+  for (int i = 0; i < 200; i++) {
+    sequence.PostTask([&] {
+      if (++running > 1)
+        overlapped = true;
+      EXPECT_TRUE(sequence.IsCurrent());
+      running--;
+      latch.Signal();
+    });
+  }
+  ASSERT_TRUE(latch.Wait());
+  EXPECT_FALSE(overlapped);
+  EXPECT_FALSE(sequence.IsCurrent());
+}
+TEST(CallbackExecutorTest, ThreadCountIsBounded) {
+  CallbackExecutor executor(2);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::vector<std::unique_ptr<TaskSequence>> sequences;
+  Latch latch(100);
+  for (int i = 0; i < 100; i++) {
+    sequences.emplace_back(new TaskSequence("Sequence", &executor));
+    sequences.back()->PostTask([&] {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+      }
+      latch.Signal();
+    });
+  }
+  ASSERT_TRUE(latch.Wait());
+  EXPECT_GE(2u, threads.size());
+}
+TEST(CallbackExecutorTest, BlockedTaskDoesNotStallOtherSequences) {
+  CallbackExecutor executor(2);
+  TaskSequence blocked("Blocked", &executor);
+  TaskSequence other("Other", &executor);
+  Latch release(1);
+  Latch done(1);
+  blocked.PostTask([&] { release.Wait(); });
+  // Queued to the blocked thread or not, it is run by the idle one.
+  for (int i = 0; i < 10; i++)
+    executor.PostTask([] {});
+  other.PostTask([&] { done.Signal(); });
+  EXPECT_TRUE(done.Wait());
+  release.Signal();
+}
+TEST(CallbackExecutorTest, DelayedTaskRunsAfterDelay) {
+  CallbackExecutor executor(1);
+  TaskSequence sequence("Sequence", &executor);
+  Latch latch(1);
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point run_time;
+  sequence.PostDelayedTask(
+      [&] {
+        run_time = std::chrono::steady_clock::now();
+        latch.Signal();
+      },
+      50);
+  ASSERT_TRUE(latch.Wait());
+  EXPECT_LE(50, std::chrono::duration_cast<std::chrono::milliseconds>(
+                    run_time - start)
+                    .count());
+}
+TEST(CallbackExecutorTest, DestroyingSequenceDropsPendingTasks) {
+  CallbackExecutor executor(1);
+  std::atomic<int> run(0);
+  Latch started(1);
+  Latch release(1);
+  std::unique_ptr<TaskSequence> sequence(
+      new TaskSequence("Sequence", &executor));
+  sequence->PostTask([&] {
+    started.Signal();
+    release.Wait();
+    run++;
+  });
+  sequence->PostTask([&] { run++; });
+  sequence->PostDelayedTask([&] { run++; }, 10);
+  ASSERT_TRUE(started.Wait());
+  std::thread releaser([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    release.Signal();
+  });
+  // Waits for the running task.
+  sequence.reset();
+  EXPECT_EQ(1, run);
+  releaser.join();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(1, run);
+}
+}  // namespace base
+}  // namespace owt
@@ -2,9 +2,11 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 #include "talk/owt/sdk/base/customizedaudiocapturer.h"
+#include <algorithm>
+#include <cstdlib>
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
-#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/rtc_base/timeutils.h"
 using namespace rtc;
 namespace owt {
 namespace base {
@@ -17,12 +19,47 @@ CustomizedAudioCapturer::CustomizedAudioCapturer(
       recording_sample_rate_(0),
       recording_channel_number_(0),
       recording_(false),
-      last_call_record_millis_(0),
-      last_thread_rec_end_time_(0),
-      clock_(Clock::GetRealTimeClock()),
-      need_sleep_ms_(0),
-      real_sleep_ms_(0) {}
+      level_observer_(nullptr),
+      level_interval_ms_(0),
+      playout_buffer_(nullptr),
+      playout_frames_in_10ms_(0),
+      playout_sample_rate_(0),
+      playout_channel_number_(0),
+      playout_buffer_size_(0),
+      playing_(false) {}
+CustomizedAudioCapturer::CustomizedAudioCapturer(
+    std::shared_ptr<CustomizedAudioFrameWriter> frame_writer)
+    : frame_generator_(nullptr),
+      frame_writer_(frame_writer),
+      audio_buffer_(nullptr),
+      recording_buffer_(nullptr),
+      recording_frames_in_10ms_(0),
+      recording_sample_rate_(0),
+      recording_channel_number_(0),
+      recording_(false),
+      level_observer_(nullptr),
+      level_interval_ms_(0),
+      playout_buffer_(nullptr),
+      playout_frames_in_10ms_(0),
+      playout_sample_rate_(0),
+      playout_channel_number_(0),
+      playout_buffer_size_(0),
+      playing_(false) {}
 CustomizedAudioCapturer::~CustomizedAudioCapturer() {}
+void CustomizedAudioCapturer::SetAudioFrameSink(
+    std::unique_ptr<AudioFrameSinkInterface> frame_sink) {
+  rtc::CritScope lock(&crit_sect_);
+  RTC_DCHECK(!playing_);
+  frame_sink_ = std::move(frame_sink);
+}
+void CustomizedAudioCapturer::SetAudioLevelObserver(
+    AudioLevelObserverInterface* observer,
+    int interval_ms) {
+  rtc::CritScope lock(&crit_sect_);
+  RTC_DCHECK(!recording_);
+  level_observer_ = observer;
+  level_interval_ms_ = interval_ms;
+}
 int32_t CustomizedAudioCapturer::ActiveAudioLayer(
     AudioDeviceModule::AudioLayer& audioLayer) const {
   return -1;
@@ -46,6 +83,15 @@ int32_t CustomizedAudioCapturer::PlayoutDeviceName(
     uint16_t index,
     char name[kAdmMaxDeviceNameSize],
     char guid[kAdmMaxGuidSize]) {
+  const char* kName = "customized_audio_sink";
+  const char* kGuid = "customized_audio_sink_unique_id";
+  if (frame_sink_ && index < 1) {
+    memset(name, 0, kAdmMaxDeviceNameSize);
+    memset(guid, 0, kAdmMaxGuidSize);
+    memcpy(name, kName, strlen(kName));
+    memcpy(guid, kGuid, strlen(kGuid));
+    return 0;
+  }
   return -1;
 }
 int32_t CustomizedAudioCapturer::RecordingDeviceName(
@@ -64,11 +110,11 @@ int32_t CustomizedAudioCapturer::RecordingDeviceName(
   return -1;
 }
 int32_t CustomizedAudioCapturer::SetPlayoutDevice(uint16_t index) {
-  return -1;
+  return (frame_sink_ && index < 1) ? 0 : -1;
 }
 int32_t CustomizedAudioCapturer::SetPlayoutDevice(
     AudioDeviceModule::WindowsDeviceType device) {
-  return -1;
+  return frame_sink_ ? 0 : -1;
 }
 int32_t CustomizedAudioCapturer::SetRecordingDevice(uint16_t index) {
   return -1;
@@ -78,17 +124,31 @@ int32_t CustomizedAudioCapturer::SetRecordingDevice(
   return -1;
 }
 int32_t CustomizedAudioCapturer::PlayoutIsAvailable(bool& available) {
-  available = false;
-  return -1;
+  available = frame_sink_ != nullptr;
+  return available ? 0 : -1;
 }
 int32_t CustomizedAudioCapturer::InitPlayout() {
-  return -1;
+  rtc::CritScope lock(&crit_sect_);
+  if (!frame_sink_ || playing_) {
+    return -1;
+  }
+  playout_sample_rate_ = frame_sink_->GetSampleRate();
+  playout_channel_number_ = frame_sink_->GetChannelNumber();
+  playout_frames_in_10ms_ = static_cast<size_t>(playout_sample_rate_ / 100);
+  playout_buffer_size_ = playout_frames_in_10ms_ * playout_channel_number_ * 2;
+  playout_buffer_.reset(static_cast<uint8_t*>(webrtc::AlignedMalloc<uint8_t>(
+      playout_buffer_size_ * sizeof(uint8_t), 16)));
+  if (audio_buffer_) {
+    audio_buffer_->SetPlayoutChannels(playout_channel_number_);
+    audio_buffer_->SetPlayoutSampleRate(playout_sample_rate_);
+  }
+  return 0;
 }
 bool CustomizedAudioCapturer::PlayoutIsInitialized() const {
-  return false;
+  return playout_frames_in_10ms_ != 0;
 }
 int32_t CustomizedAudioCapturer::RecordingIsAvailable(bool& available) {
-  if (frame_generator_ != nullptr) {
+  if (frame_generator_ != nullptr || frame_writer_ != nullptr) {
     available = true;
     return 0;
   }
@@ -97,19 +157,50 @@ int32_t CustomizedAudioCapturer::RecordingIsAvailable(bool& available) {
 }
 int32_t CustomizedAudioCapturer::InitRecording() {
   rtc::CritScope lock(&crit_sect_);
-  if (recording_) {
+  if (recording_ || (!frame_writer_ && !frame_generator_)) {
     return -1;
   }
-  recording_sample_rate_ = frame_generator_->GetSampleRate();
-  recording_channel_number_ = frame_generator_->GetChannelNumber();
+  if (frame_writer_) {
+    recording_sample_rate_ = frame_writer_->GetSampleRate();
+    recording_channel_number_ = frame_writer_->GetChannelNumber();
+  } else {
+    AudioSampleFormat format = frame_generator_->GetSampleFormat();
+    int sample_rate = frame_generator_->GetSampleRate();
+    int channel_number = frame_generator_->GetChannelNumber();
+    if (!AudioFrameConverter::IsSupported(format, sample_rate,
+                                          channel_number)) {
+      RTC_LOG(LS_ERROR) << "Unsupported audio format, sample rate "
+                        << sample_rate << ", channel number "
+                        << channel_number << ".";
+      return -1;
+    }
+    frame_converter_.reset(
+        new AudioFrameConverter(format, sample_rate, channel_number));
+    if (frame_converter_->NeedsConversion()) {
+      generator_buffer_.reset(static_cast<uint8_t*>(
+          webrtc::AlignedMalloc<uint8_t>(frame_converter_->InputSizeIn10Ms(),
+                                         16)));
+    } else {
+      generator_buffer_.reset();
+    }
+    recording_sample_rate_ = frame_converter_->OutputSampleRate();
+    recording_channel_number_ = frame_converter_->OutputChannelNumber();
+  }
   recording_frames_in_10ms_ = static_cast<size_t>(recording_sample_rate_ / 100);
   recording_buffer_size_ =
       recording_frames_in_10ms_ * recording_channel_number_ * 2;
   recording_buffer_.reset(static_cast<uint8_t*>(webrtc::AlignedMalloc<uint8_t>(
       recording_buffer_size_ * sizeof(uint8_t), 16)));
+  if (level_observer_) {
+    level_meter_.reset(new AudioLevelMeter(level_observer_, level_interval_ms_,
+                                           recording_sample_rate_,
+                                           recording_channel_number_));
+  } else {
+    level_meter_.reset();
+  }
   if (audio_buffer_) {
-    audio_buffer_->SetRecordingChannels(frame_generator_->GetChannelNumber());
-    audio_buffer_->SetRecordingSampleRate(frame_generator_->GetSampleRate());
+    audio_buffer_->SetRecordingChannels(recording_channel_number_);
+    audio_buffer_->SetRecordingSampleRate(recording_sample_rate_);
   }
   return 0;
 }
@@ -120,16 +211,45 @@ bool CustomizedAudioCapturer::RecordingIsInitialized() const {
     return false;
 }
 int32_t CustomizedAudioCapturer::StartPlayout() {
-  return -1;
+  if (!PlayoutIsInitialized()) {
+    return -1;
+  }
+  if (playing_) {
+    return 0;
+  }
+  playing_ = true;
+  play_scheduler_.Reset();
+  const char* thread_name = "webrtc_audio_module_play_thread";
+  thread_play_.reset(
+      new rtc::PlatformThread(PlayThreadFunc, this, thread_name));
+  thread_play_->Start();
+  thread_play_->SetPriority(rtc::kRealtimePriority);
+  return 0;
 }
 int32_t CustomizedAudioCapturer::StopPlayout() {
-  return -1;
+  {
+    rtc::CritScope lock(&crit_sect_);
+    playing_ = false;
+  }
+  if (thread_play_) {
+    thread_play_->Stop();
+    thread_play_.reset();
+  }
+  // Playout must be initialized again before next StartPlayout.
+  rtc::CritScope lock(&crit_sect_);
+  playout_frames_in_10ms_ = 0;
+  return 0;
 }
 bool CustomizedAudioCapturer::Playing() const {
-  return false;
+  return playing_;
 }
 int32_t CustomizedAudioCapturer::StartRecording() {
   recording_ = true;
+  rec_scheduler_.Reset();
+  {
+    rtc::CritScope lock(&stats_crit_);
+    timing_stats_ = AudioCaptureTimingStats();
+  }
   const char* thread_name = "webrtc_audio_module_capture_thread";
   thread_rec_.reset(new rtc::PlatformThread(RecThreadFunc, this, thread_name));
   thread_rec_->Start();
@@ -151,10 +271,10 @@ bool CustomizedAudioCapturer::Recording() const {
   return recording_;
 }
 int32_t CustomizedAudioCapturer::InitSpeaker() {
-  return -1;
+  return frame_sink_ ? 0 : -1;
 }
 bool CustomizedAudioCapturer::SpeakerIsInitialized() const {
-  return false;
+  return frame_sink_ != nullptr;
 }
 int32_t CustomizedAudioCapturer::InitMicrophone() {
   return 0;
@@ -215,13 +335,25 @@ int32_t CustomizedAudioCapturer::MicrophoneMute(bool& enabled) const {
 }
 
 int32_t CustomizedAudioCapturer::StereoPlayoutIsAvailable(bool& available) {
-  return -1;
+  if (!frame_sink_) {
+    return -1;
+  }
+  available = frame_sink_->GetChannelNumber() == 2;
+  return 0;
 }
 int32_t CustomizedAudioCapturer::SetStereoPlayout(bool enable) {
-  return -1;
+  // Channel number is decided by the sink.
+  if (!frame_sink_ || enable != (frame_sink_->GetChannelNumber() == 2)) {
+    return -1;
+  }
+  return 0;
 }
 int32_t CustomizedAudioCapturer::StereoPlayout(bool& enabled) const {
-  return -1;
+  if (!frame_sink_) {
+    return -1;
+  }
+  enabled = frame_sink_->GetChannelNumber() == 2;
+  return 0;
 }
 int32_t CustomizedAudioCapturer::StereoRecordingIsAvailable(bool& available) {
   return -1;
@@ -234,7 +366,12 @@ int32_t CustomizedAudioCapturer::StereoRecording(bool& enabled) const {
 }
 
 int32_t CustomizedAudioCapturer::PlayoutDelay(uint16_t& delayMS) const {
-  return -1;
+  if (!frame_sink_) {
+    return -1;
+  }
+  // Audio is handed to the sink as soon as it is mixed.
+  delayMS = 0;
+  return 0;
 }
 void CustomizedAudioCapturer::AttachAudioBuffer(
     AudioDeviceBuffer* audioBuffer) {
@@ -249,7 +386,7 @@ void CustomizedAudioCapturer::AttachAudioBuffer(
   audio_buffer_->SetPlayoutChannels(0);
 }
 bool CustomizedAudioCapturer::PlayThreadFunc(void* pThis) {
-  return false;
+  return (static_cast<CustomizedAudioCapturer*>(pThis)->PlayThreadProcess());
 }
 bool CustomizedAudioCapturer::RecThreadFunc(void* pThis) {
   return (static_cast<CustomizedAudioCapturer*>(pThis)->RecThreadProcess());
@@ -258,47 +395,103 @@ bool CustomizedAudioCapturer::RecThreadProcess() {
   if (!recording_) {
     return false;
   }
-  uint64_t current_time = clock_->CurrentNtpInMilliseconds();
-  uint64_t loop_cost_ms = 0;
-  crit_sect_.Enter();
-  if (last_thread_rec_end_time_ > 0) {
-      loop_cost_ms = current_time - last_thread_rec_end_time_;
+  int64_t now_ns = AudioChunkScheduler::MonotonicNanos();
+  bool resynced = false;
+  int64_t deadline_ns = rec_scheduler_.NextChunk(now_ns, &resynced);
+  {
+    rtc::CritScope lock(&stats_crit_);
+    if (resynced)
+      timing_stats_.resyncs++;
+    timing_stats_.RecordWakeUp(now_ns, deadline_ns);
   }
-  if (last_call_record_millis_ == 0 ||
-      (int64_t)(current_time - last_call_record_millis_) >= need_sleep_ms_) {
-    if (frame_generator_->GenerateFramesForNext10Ms(
-            recording_buffer_.get(),
-            static_cast<uint32_t>(recording_buffer_size_)) !=
-        static_cast<uint32_t>(recording_buffer_size_)) {
-      crit_sect_.Leave();
-      //RTC_DCHECK(false);
-      SleepMs(1);
-      RTC_LOG(LS_ERROR) << "Get audio frames failed.";
-      last_thread_rec_end_time_ = clock_->CurrentNtpInMilliseconds();
-      return true;
+  bool chunk_ready = false;
+  const uint8_t* chunk = recording_buffer_.get();
+  crit_sect_.Enter();
+  if (frame_writer_) {
+    // Push mode. Reading from the ring buffer never blocks the writer. On
+    // underrun it yields silence so the stream keeps its pace.
+    frame_writer_->ReadFramesFor10Ms(recording_buffer_.get(),
+                                     recording_buffer_size_);
+    chunk_ready = true;
+  } else if (generator_buffer_) {
+    // Generated audio is converted once, straight into the buffer handed to
+    // AudioDeviceBuffer.
+    const size_t input_size = frame_converter_->InputSizeIn10Ms();
+    const uint8_t* frames = frame_generator_->ReadFramesForNext10Ms(
+        static_cast<uint32_t>(input_size));
+    if (!frames &&
+        frame_generator_->GenerateFramesForNext10Ms(
+            generator_buffer_.get(), static_cast<uint32_t>(input_size)) ==
+            static_cast<uint32_t>(input_size)) {
+      frames = generator_buffer_.get();
     }
+    chunk_ready = frames && frame_converter_->Convert(
+                                frames, input_size,
+                                reinterpret_cast<int16_t*>(
+                                    recording_buffer_.get()));
+  } else {
+    // Generators holding audio in memory, e.g. a mapped file, are read in
+    // place.
+    const uint8_t* frames = frame_generator_->ReadFramesForNext10Ms(
+        static_cast<uint32_t>(recording_buffer_size_));
+    if (frames) {
+      chunk = frames;
+      chunk_ready = true;
+    } else {
+      chunk_ready = frame_generator_->GenerateFramesForNext10Ms(
+                        recording_buffer_.get(),
+                        static_cast<uint32_t>(recording_buffer_size_)) ==
+                    static_cast<uint32_t>(recording_buffer_size_);
+    }
+  }
+  if (!chunk_ready) {
+    crit_sect_.Leave();
+    RTC_LOG(LS_ERROR) << "Get audio frames failed.";
+    rtc::CritScope lock(&stats_crit_);
+    timing_stats_.underruns++;
+  } else {
     // Sample rate and channel number cannot be changed on the fly.
     audio_buffer_->SetRecordedBuffer(
-        recording_buffer_.get(), recording_frames_in_10ms_);  // Buffer copied here
-    last_call_record_millis_ = current_time;
+        chunk, recording_frames_in_10ms_);  // Buffer copied here
     crit_sect_.Leave();
     audio_buffer_->DeliverRecordedData();
-    crit_sect_.Enter();
+    if (level_meter_) {
+      level_meter_->Process(reinterpret_cast<const int16_t*>(chunk),
+                            recording_frames_in_10ms_);
+    }
+    rtc::CritScope lock(&stats_crit_);
+    timing_stats_.delivered_chunks++;
   }
-  crit_sect_.Leave();
-  int64_t cost_ms = clock_->CurrentNtpInMilliseconds() - current_time;
-  need_sleep_ms_ = 10 - cost_ms + need_sleep_ms_ - real_sleep_ms_ - loop_cost_ms;
-  if (need_sleep_ms_ > 0) {
-    current_time = clock_->CurrentNtpInMilliseconds();
-    SleepMs(need_sleep_ms_);
-    real_sleep_ms_ = clock_->CurrentNtpInMilliseconds() - current_time;
-  } else {
-    RTC_LOG(LS_WARNING) << "Cost too much time to get audio frames. This may "
-                       "leads to large latency";
-    real_sleep_ms_ = 0;
+  int64_t next_deadline_ns = rec_scheduler_.NextDeadline();
+  if (AudioChunkScheduler::MonotonicNanos() >= next_deadline_ns) {
+    // Already late for the next chunk. Do not sleep, next iteration catches up.
+    rtc::CritScope lock(&stats_crit_);
+    timing_stats_.overruns++;
+    return true;
+  }
+  AudioChunkScheduler::SleepUntilNanos(next_deadline_ns);
+  return true;
+}
+bool CustomizedAudioCapturer::PlayThreadProcess() {
+  if (!playing_) {
+    return false;
+  }
+  bool resynced = false;
+  play_scheduler_.NextChunk(AudioChunkScheduler::MonotonicNanos(), &resynced);
+  // Pull 10ms of mixed audio. Both calls run on this thread only.
+  audio_buffer_->RequestPlayoutData(playout_frames_in_10ms_);
+  audio_buffer_->GetPlayoutData(playout_buffer_.get());
+  frame_sink_->OnFramesFor10Ms(playout_buffer_.get(),
+                               static_cast<uint32_t>(playout_buffer_size_));
+  int64_t next_deadline_ns = play_scheduler_.NextDeadline();
+  if (AudioChunkScheduler::MonotonicNanos() < next_deadline_ns) {
+    AudioChunkScheduler::SleepUntilNanos(next_deadline_ns);
   }
-  last_thread_rec_end_time_ = clock_->CurrentNtpInMilliseconds();
   return true;
-};
+}
+AudioCaptureTimingStats CustomizedAudioCapturer::GetTimingStats() const {
+  rtc::CritScope lock(&stats_crit_);
+  return timing_stats_;
+}
 }
 }
@@ -8,21 +8,38 @@
 #include "webrtc/rtc_base/memory/aligned_malloc.h"
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/modules/audio_device/audio_device_generic.h"
-#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "talk/owt/sdk/base/audiochunkscheduler.h"
+#include "talk/owt/sdk/base/audioframeconverter.h"
+#include "talk/owt/sdk/base/audiolevelmeter.h"
+#include "talk/owt/sdk/base/customizedaudioframewriter.h"
+#include "talk/owt/sdk/include/cpp/owt/base/audioframesinkinterface.h"
 #include "talk/owt/sdk/include/cpp/owt/base/framegeneratorinterface.h"
 namespace owt {
 namespace base {
 using namespace webrtc;
 // This is a customized audio device which retrieves audio from a
-// AudioFrameGenerator implementation as its microphone.
-// CustomizedAudioCapturer is not able to output audio.
+// AudioFrameGenerator implementation, or audio pushed to a
+// CustomizedAudioFrameWriter, as its microphone. If an AudioFrameSink is set,
+// it is also used as the speaker: mixed playout audio is pulled every 10ms and
+// handed to the sink.
 class CustomizedAudioCapturer : public AudioDeviceGeneric {
  public:
   // Constructs a customized audio device with |frame_generator|. It will read
   // audio from |frame_generator|.
   CustomizedAudioCapturer(
       std::unique_ptr<AudioFrameGeneratorInterface> frame_generator);
+  // Constructs a customized audio device in push mode. It will drain audio
+  // written to |frame_writer| every 10ms without blocking the writer.
+  CustomizedAudioCapturer(
+      std::shared_ptr<CustomizedAudioFrameWriter> frame_writer);
   virtual ~CustomizedAudioCapturer();
+  // Use |frame_sink| as playout device. Must be called before InitPlayout.
+  void SetAudioFrameSink(std::unique_ptr<AudioFrameSinkInterface> frame_sink);
+  // Report level of recorded audio to |observer| every |interval_ms|. Must be
+  // called before InitRecording.
+  void SetAudioLevelObserver(AudioLevelObserverInterface* observer,
+                             int interval_ms);
   // Retrieve the currently utilized audio layer
   int32_t ActiveAudioLayer(
       AudioDeviceModule::AudioLayer& audioLayer) const override;
@@ -96,12 +113,19 @@ class CustomizedAudioCapturer : public AudioDeviceGeneric {
   // Delay information and control
   int32_t PlayoutDelay(uint16_t& delayMS) const override;
   void AttachAudioBuffer(AudioDeviceBuffer* audioBuffer) override;
+  // Returns a snapshot of recording thread timing counters.
+  AudioCaptureTimingStats GetTimingStats() const;
  private:
   static bool RecThreadFunc(void*);
   static bool PlayThreadFunc(void*);
   bool RecThreadProcess();
   bool PlayThreadProcess();
   std::unique_ptr<AudioFrameGeneratorInterface> frame_generator_;
+  // Converts generator's audio when it is not 16 bit PCM at a native rate.
+  std::unique_ptr<AudioFrameConverter> frame_converter_;
+  std::unique_ptr<uint8_t[], webrtc::AlignedFreeDeleter> generator_buffer_;
+  std::shared_ptr<CustomizedAudioFrameWriter> frame_writer_;
+  std::unique_ptr<AudioFrameSinkInterface> frame_sink_;
   AudioDeviceBuffer* audio_buffer_;
   std::unique_ptr<uint8_t[], webrtc::AlignedFreeDeleter>
       recording_buffer_;  // Pointer to a useable memory for audio frames.
@@ -112,11 +136,21 @@ class CustomizedAudioCapturer : public AudioDeviceGeneric {
   size_t recording_buffer_size_;
   std::unique_ptr<rtc::PlatformThread> thread_rec_;
   bool recording_;
-  uint64_t last_call_record_millis_;
-  uint64_t last_thread_rec_end_time_;
-  Clock* clock_;
-  int64_t need_sleep_ms_;
-  int64_t real_sleep_ms_;
+  AudioChunkScheduler rec_scheduler_;
+  AudioLevelObserverInterface* level_observer_;
+  int level_interval_ms_;
+  // Only used on recording thread once recording starts.
+  std::unique_ptr<AudioLevelMeter> level_meter_;
+  std::unique_ptr<uint8_t[], webrtc::AlignedFreeDeleter> playout_buffer_;
+  size_t playout_frames_in_10ms_;
+  int playout_sample_rate_;
+  int playout_channel_number_;
+  size_t playout_buffer_size_;
+  std::unique_ptr<rtc::PlatformThread> thread_play_;
+  bool playing_;
+  AudioChunkScheduler play_scheduler_;
+  mutable rtc::CriticalSection stats_crit_;
+  AudioCaptureTimingStats timing_stats_ RTC_GUARDED_BY(stats_crit_);
 };
 }
 }
@@ -29,7 +29,8 @@ namespace base {
 //  CustomizedAudioDeviceModule::Create()
 // ----------------------------------------------------------------------------
 rtc::scoped_refptr<AudioDeviceModule> CustomizedAudioDeviceModule::Create(
-    std::unique_ptr<AudioFrameGeneratorInterface> frame_generator) {
+    std::unique_ptr<AudioFrameGeneratorInterface> frame_generator,
+    std::unique_ptr<AudioFrameSinkInterface> frame_sink) {
   // Create the generic ref counted implementation.
   rtc::scoped_refptr<CustomizedAudioDeviceModule> audioDevice(
       new rtc::RefCountedObject<CustomizedAudioDeviceModule>());
@@ -38,6 +39,9 @@ rtc::scoped_refptr<AudioDeviceModule> CustomizedAudioDeviceModule::Create(
       -1) {
     return nullptr;
   }
+  if (audioDevice->SetAudioFrameSink(std::move(frame_sink)) == -1) {
+    return nullptr;
+  }
   // Ensure that the generic audio buffer can communicate with the
   // platform-specific parts.
   if (audioDevice->AttachAudioBuffer() == -1) {
@@ -46,6 +50,23 @@ rtc::scoped_refptr<AudioDeviceModule> CustomizedAudioDeviceModule::Create(
   WebRtcSpl_Init();
   return audioDevice;
 }
+rtc::scoped_refptr<AudioDeviceModule> CustomizedAudioDeviceModule::Create(
+    std::shared_ptr<CustomizedAudioFrameWriter> frame_writer,
+    std::unique_ptr<AudioFrameSinkInterface> frame_sink) {
+  rtc::scoped_refptr<CustomizedAudioDeviceModule> audioDevice(
+      new rtc::RefCountedObject<CustomizedAudioDeviceModule>());
+  if (audioDevice->CreateCustomizedAudioDevice(frame_writer) == -1) {
+    return nullptr;
+  }
+  if (audioDevice->SetAudioFrameSink(std::move(frame_sink)) == -1) {
+    return nullptr;
+  }
+  if (audioDevice->AttachAudioBuffer() == -1) {
+    return nullptr;
+  }
+  WebRtcSpl_Init();
+  return audioDevice;
+}
 // ============================================================================
 //                            Construction & Destruction
 // ============================================================================
@@ -56,9 +77,7 @@ CustomizedAudioDeviceModule::CustomizedAudioDeviceModule()
     : _ptrAudioDevice(NULL),
       _lastProcessTime(rtc::TimeMillis()),
       _initialized(false),
-      _lastError(kAdmErrNone) {
-  CreateOutputAdm();
-}
+      _lastError(kAdmErrNone) {}
 // ----------------------------------------------------------------------------
 //  CreateCustomizedAudioDevice
 // ----------------------------------------------------------------------------
@@ -69,6 +88,29 @@ int32_t CustomizedAudioDeviceModule::CreateCustomizedAudioDevice(
   _ptrAudioDevice = ptrAudioDevice;
   return 0;
 }
+int32_t CustomizedAudioDeviceModule::CreateCustomizedAudioDevice(
+    std::shared_ptr<CustomizedAudioFrameWriter> frame_writer) {
+  if (!frame_writer)
+    return -1;
+  _ptrAudioDevice = new CustomizedAudioCapturer(frame_writer);
+  return 0;
+}
+// ----------------------------------------------------------------------------
+//  SetAudioFrameSink
+//
+//  Playout goes to |frame_sink| if it is set. Otherwise the default internal
+//  ADM is created for playout.
+// ----------------------------------------------------------------------------
+int32_t CustomizedAudioDeviceModule::SetAudioFrameSink(
+    std::unique_ptr<AudioFrameSinkInterface> frame_sink) {
+  if (!frame_sink) {
+    CreateOutputAdm();
+    return _outputAdm ? 0 : -1;
+  }
+  static_cast<CustomizedAudioCapturer*>(_ptrAudioDevice)
+      ->SetAudioFrameSink(std::move(frame_sink));
+  return 0;
+}
 // ----------------------------------------------------------------------------
 //  AttachAudioBuffer
 //
@@ -115,7 +157,8 @@ int32_t CustomizedAudioDeviceModule::Init() {
   if (_ptrAudioDevice->Init() != AudioDeviceGeneric::InitStatus::OK) {
     return -1;
   }
-  if (!_outputAdm || _outputAdm->Init() == -1)
+  // No output ADM means playout goes to the customized audio sink.
+  if (_outputAdm && _outputAdm->Init() == -1)
     return -1;
   _initialized = true;
   return 0;
@@ -129,7 +172,7 @@ int32_t CustomizedAudioDeviceModule::Terminate() {
   if (_ptrAudioDevice->Terminate() == -1) {
     return -1;
   }
-  if (!_outputAdm || _outputAdm->Terminate() == -1)
+  if (_outputAdm && _outputAdm->Terminate() == -1)
     return -1;
   _initialized = false;
   return 0;
@@ -138,13 +181,15 @@ int32_t CustomizedAudioDeviceModule::Terminate() {
 //  Initialized
 // ----------------------------------------------------------------------------
 bool CustomizedAudioDeviceModule::Initialized() const {
-  return (_initialized && _outputAdm->Initialized());
+  return (_initialized && (!_outputAdm || _outputAdm->Initialized()));
 }
 // ----------------------------------------------------------------------------
 //  InitSpeaker
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::InitSpeaker() {
-  return (_outputAdm->InitSpeaker());
+  if (!_outputAdm)
+    return _ptrAudioDevice->InitSpeaker();
+  return _outputAdm->InitSpeaker();
 }
 // ----------------------------------------------------------------------------
 //  InitMicrophone
@@ -157,24 +202,32 @@ int32_t CustomizedAudioDeviceModule::InitMicrophone() {
 //  SpeakerVolumeIsAvailable
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SpeakerVolumeIsAvailable(bool* available) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SpeakerVolumeIsAvailable(*available);
   return _outputAdm->SpeakerVolumeIsAvailable(available);
 }
 // ----------------------------------------------------------------------------
 //  SetSpeakerVolume
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SetSpeakerVolume(uint32_t volume) {
-  return (_outputAdm->SetSpeakerVolume(volume));
+  if (!_outputAdm)
+    return _ptrAudioDevice->SetSpeakerVolume(volume);
+  return _outputAdm->SetSpeakerVolume(volume);
 }
 // ----------------------------------------------------------------------------
 //  SpeakerVolume
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SpeakerVolume(uint32_t* volume) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SpeakerVolume(*volume);
   return _outputAdm->SpeakerVolume(volume);
 }
 // ----------------------------------------------------------------------------
 //  SpeakerIsInitialized
 // ----------------------------------------------------------------------------
 bool CustomizedAudioDeviceModule::SpeakerIsInitialized() const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SpeakerIsInitialized();
   return _outputAdm->SpeakerIsInitialized();
 }
 // ----------------------------------------------------------------------------
@@ -190,6 +243,8 @@ bool CustomizedAudioDeviceModule::MicrophoneIsInitialized() const {
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::MaxSpeakerVolume(
     uint32_t* maxVolume) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->MaxSpeakerVolume(*maxVolume);
   return _outputAdm->MaxSpeakerVolume(maxVolume);
 }
 // ----------------------------------------------------------------------------
@@ -197,24 +252,32 @@ int32_t CustomizedAudioDeviceModule::MaxSpeakerVolume(
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::MinSpeakerVolume(
     uint32_t* minVolume) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->MinSpeakerVolume(*minVolume);
   return _outputAdm->MinSpeakerVolume(minVolume);
 }
 // ----------------------------------------------------------------------------
 //  SpeakerMuteIsAvailable
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SpeakerMuteIsAvailable(bool* available) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SpeakerMuteIsAvailable(*available);
   return _outputAdm->SpeakerMuteIsAvailable(available);
 }
 // ----------------------------------------------------------------------------
 //  SetSpeakerMute
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SetSpeakerMute(bool enable) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SetSpeakerMute(enable);
   return _outputAdm->SetSpeakerMute(enable);
 }
 // ----------------------------------------------------------------------------
 //  SpeakerMute
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SpeakerMute(bool* enabled) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SpeakerMute(*enabled);
   return _outputAdm->SpeakerMute(enabled);
 }
 // ----------------------------------------------------------------------------
@@ -329,24 +392,32 @@ int32_t CustomizedAudioDeviceModule::StereoRecording(bool* enabled) const {
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::StereoPlayoutIsAvailable(
     bool* available) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->StereoPlayoutIsAvailable(*available);
   return _outputAdm->StereoPlayoutIsAvailable(available);
 }
 // ----------------------------------------------------------------------------
 //  SetStereoPlayout
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SetStereoPlayout(bool enable) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SetStereoPlayout(enable);
   return _outputAdm->SetStereoPlayout(enable);
 }
 // ----------------------------------------------------------------------------
 //  StereoPlayout
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::StereoPlayout(bool* enabled) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->StereoPlayout(*enabled);
   return _outputAdm->StereoPlayout(enabled);
 }
 // ----------------------------------------------------------------------------
 //  PlayoutIsAvailable
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::PlayoutIsAvailable(bool* available) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->PlayoutIsAvailable(*available);
   return _outputAdm->PlayoutIsAvailable(available);
 }
 // ----------------------------------------------------------------------------
@@ -392,12 +463,16 @@ int32_t CustomizedAudioDeviceModule::MinMicrophoneVolume(
 //  PlayoutDevices
 // ----------------------------------------------------------------------------
 int16_t CustomizedAudioDeviceModule::PlayoutDevices() {
+  if (!_outputAdm)
+    return _ptrAudioDevice->PlayoutDevices();
   return _outputAdm->PlayoutDevices();
 }
 // ----------------------------------------------------------------------------
 //  SetPlayoutDevice I (II)
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SetPlayoutDevice(uint16_t index) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SetPlayoutDevice(index);
   return _outputAdm->SetPlayoutDevice(index);
 }
 // ----------------------------------------------------------------------------
@@ -405,6 +480,8 @@ int32_t CustomizedAudioDeviceModule::SetPlayoutDevice(uint16_t index) {
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::SetPlayoutDevice(
     WindowsDeviceType device) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->SetPlayoutDevice(device);
   return _outputAdm->SetPlayoutDevice(device);
 }
 // ----------------------------------------------------------------------------
@@ -414,6 +491,8 @@ int32_t CustomizedAudioDeviceModule::PlayoutDeviceName(
     uint16_t index,
     char name[kAdmMaxDeviceNameSize],
     char guid[kAdmMaxGuidSize]) {
+  if (!_outputAdm)
+    return _ptrAudioDevice->PlayoutDeviceName(index, name, guid);
   return _outputAdm->PlayoutDeviceName(index, name, guid);
 }
 // ----------------------------------------------------------------------------
@@ -463,6 +542,8 @@ int32_t CustomizedAudioDeviceModule::SetRecordingDevice(
 //  InitPlayout
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::InitPlayout() {
+  if (!_outputAdm)
+    return _ptrAudioDevice->InitPlayout();
   return _outputAdm->InitPlayout();
 }
 // ----------------------------------------------------------------------------
@@ -476,6 +557,8 @@ int32_t CustomizedAudioDeviceModule::InitRecording() {
 //  PlayoutIsInitialized
 // ----------------------------------------------------------------------------
 bool CustomizedAudioDeviceModule::PlayoutIsInitialized() const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->PlayoutIsInitialized();
   return _outputAdm->PlayoutIsInitialized();
 }
 // ----------------------------------------------------------------------------
@@ -489,19 +572,32 @@ bool CustomizedAudioDeviceModule::RecordingIsInitialized() const {
 //  StartPlayout
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::StartPlayout() {
+  if (!_outputAdm) {
+    CHECK_INITIALIZED();
+    _audioDeviceBuffer.StartPlayout();
+    return _ptrAudioDevice->StartPlayout();
+  }
   return (_outputAdm->StartPlayout());
 }
 // ----------------------------------------------------------------------------
 //  StopPlayout
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::StopPlayout() {
+  if (!_outputAdm) {
+    CHECK_INITIALIZED();
+    int32_t result = _ptrAudioDevice->StopPlayout();
+    _audioDeviceBuffer.StopPlayout();
+    return result;
+  }
   return (_outputAdm->StopPlayout());
 }
 // ----------------------------------------------------------------------------
 //  Playing
 // ----------------------------------------------------------------------------
 bool CustomizedAudioDeviceModule::Playing() const {
-  return (_outputAdm->Playing());
+  if (!_outputAdm)
+    return _ptrAudioDevice->Playing();
+  return _outputAdm->Playing();
 }
 // ----------------------------------------------------------------------------
 //  StartRecording
@@ -533,12 +629,16 @@ int32_t CustomizedAudioDeviceModule::RegisterAudioCallback(
     AudioTransport* audioCallback) {
   rtc::CritScope cs(&_critSectAudioCb);
   _audioDeviceBuffer.RegisterAudioCallback(audioCallback);
+  if (!_outputAdm)
+    return 0;
   return _outputAdm->RegisterAudioCallback(audioCallback);
 }
 // ----------------------------------------------------------------------------
 //  PlayoutDelay
 // ----------------------------------------------------------------------------
 int32_t CustomizedAudioDeviceModule::PlayoutDelay(uint16_t* delayMS) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->PlayoutDelay(*delayMS);
   return _outputAdm->PlayoutDelay(delayMS);
 }
 bool CustomizedAudioDeviceModule::BuiltInAECIsAvailable() const {
@@ -568,6 +668,8 @@ int32_t CustomizedAudioDeviceModule::EnableBuiltInNS(bool enable) {
 #if defined(WEBRTC_IOS)
 int CustomizedAudioDeviceModule::GetPlayoutAudioParameters(
     AudioParameters* params) const {
+  if (!_outputAdm)
+    return _ptrAudioDevice->GetPlayoutAudioParameters(params);
   return _outputAdm->GetPlayoutAudioParameters(params);
 }
 int CustomizedAudioDeviceModule::GetRecordAudioParameters(
@@ -575,6 +677,27 @@ int CustomizedAudioDeviceModule::GetRecordAudioParameters(
   return _ptrAudioDevice->GetRecordAudioParameters(params);
 }
 #endif  // WEBRTC_IOS
+// ----------------------------------------------------------------------------
+//  CaptureTimingStats
+// ----------------------------------------------------------------------------
+AudioCaptureTimingStats CustomizedAudioDeviceModule::CaptureTimingStats()
+    const {
+  if (!_ptrAudioDevice)
+    return AudioCaptureTimingStats();
+  return static_cast<CustomizedAudioCapturer*>(_ptrAudioDevice)
+      ->GetTimingStats();
+}
+// ----------------------------------------------------------------------------
+//  SetAudioLevelObserver
+// ----------------------------------------------------------------------------
+void CustomizedAudioDeviceModule::SetAudioLevelObserver(
+    AudioLevelObserverInterface* observer,
+    int interval_ms) {
+  if (!_ptrAudioDevice)
+    return;
+  static_cast<CustomizedAudioCapturer*>(_ptrAudioDevice)
+      ->SetAudioLevelObserver(observer, interval_ms);
+}
 void CustomizedAudioDeviceModule::CreateOutputAdm(){
   if(_outputAdm==nullptr){
     _outputAdm = webrtc::AudioDeviceModuleImpl::Create(
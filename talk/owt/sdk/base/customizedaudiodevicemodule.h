@@ -9,6 +9,8 @@
 #include "webrtc/modules/audio_device/include/audio_device.h"
 #include "webrtc/modules/audio_device/audio_device_generic.h"
 #include "webrtc/rtc_base/scoped_ref_ptr.h"
+#include "talk/owt/sdk/base/customizedaudiocapturer.h"
+#include "talk/owt/sdk/include/cpp/owt/base/audioframesinkinterface.h"
 #include "talk/owt/sdk/include/cpp/owt/base/framegeneratorinterface.h"
 namespace owt {
 namespace base {
@@ -16,15 +18,24 @@ using namespace webrtc;
 /**
  @brief CustomizedADM is able to create customized audio device use customized
  audio input.
- @details CustomizedADM does not support audio output yet.
+ @details Audio output goes to the default internal ADM, or to a customized
+ audio sink if one is set.
  */
 class CustomizedAudioDeviceModule : public webrtc::AudioDeviceModule {
  public:
   CustomizedAudioDeviceModule();
   virtual ~CustomizedAudioDeviceModule();
   // Factory methods (resource allocation/deallocation)
+  // If |frame_sink| is null, playout goes to the default internal ADM.
+  // Otherwise mixed playout audio is handed to |frame_sink| and no audio
+  // output device is opened.
   static rtc::scoped_refptr<AudioDeviceModule> Create(
-      std::unique_ptr<AudioFrameGeneratorInterface> frame_generator);
+      std::unique_ptr<AudioFrameGeneratorInterface> frame_generator,
+      std::unique_ptr<AudioFrameSinkInterface> frame_sink = nullptr);
+  // Creates an ADM whose input is audio pushed to |frame_writer|.
+  static rtc::scoped_refptr<AudioDeviceModule> Create(
+      std::shared_ptr<CustomizedAudioFrameWriter> frame_writer,
+      std::unique_ptr<AudioFrameSinkInterface> frame_sink = nullptr);
   // Retrieve the currently utilized audio layer
   int32_t ActiveAudioLayer(AudioLayer* audioLayer) const override;
   // Full-duplex transportation of PCM audio
@@ -108,9 +119,18 @@ class CustomizedAudioDeviceModule : public webrtc::AudioDeviceModule {
   int GetPlayoutAudioParameters(AudioParameters* params) const override;
   int GetRecordAudioParameters(AudioParameters* params) const override;
 #endif  // WEBRTC_IOS
+  // Timing counters of the customized recording thread.
+  AudioCaptureTimingStats CaptureTimingStats() const;
+  // Report level of customized recording to |observer| every |interval_ms|.
+  void SetAudioLevelObserver(AudioLevelObserverInterface* observer,
+                             int interval_ms);
  private:
   int32_t CreateCustomizedAudioDevice(
       std::unique_ptr<AudioFrameGeneratorInterface> frame_generator);
+  int32_t CreateCustomizedAudioDevice(
+      std::shared_ptr<CustomizedAudioFrameWriter> frame_writer);
+  int32_t SetAudioFrameSink(
+      std::unique_ptr<AudioFrameSinkInterface> frame_sink);
   int32_t AttachAudioBuffer();
   void CreateOutputAdm();
   rtc::CriticalSection _critSect;
@@ -121,7 +141,8 @@ class CustomizedAudioDeviceModule : public webrtc::AudioDeviceModule {
   int64_t _lastProcessTime;
   bool _initialized;
   mutable ErrorCode _lastError;
-  // Default internal adm for playout.
+  // Default internal adm for playout. Null if playout goes to a customized
+  // audio sink.
   rtc::scoped_refptr<webrtc::AudioDeviceModule> _outputAdm;
 };
 }
@@ -0,0 +1,84 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/customizedaudioframewriter.h"
+#include <algorithm>
+#include <cstring>
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+namespace owt {
+namespace base {
+CustomizedAudioFrameWriter::CustomizedAudioFrameWriter(int sample_rate,
+                                                       int channel_number,
+                                                       int target_latency_ms,
+                                                       int max_latency_ms)
+    : sample_rate_(sample_rate),
+      channel_number_(channel_number),
+      target_latency_ms_(std::max(target_latency_ms, 0)),
+      max_latency_ms_(std::max(max_latency_ms, target_latency_ms_ + 10)),
+      bytes_per_sample_frame_(static_cast<size_t>(channel_number) * 2),
+      bytes_per_10ms_(static_cast<size_t>(sample_rate / 100) *
+                      bytes_per_sample_frame_),
+      // Leave room for one more packet on top of maximum latency so a write
+      // does not fail right before the reader trims the buffer.
+      ring_(bytes_per_10ms_ * (max_latency_ms_ / 10 + 1) * 2),
+      prebuffering_(true),
+      underruns_(0),
+      overruns_(0),
+      dropped_ms_(0) {
+  RTC_CHECK(sample_rate_ % 100 == 0);
+  RTC_CHECK(channel_number_ > 0);
+}
+CustomizedAudioFrameWriter::~CustomizedAudioFrameWriter() {}
+bool CustomizedAudioFrameWriter::WriteFrames(const uint8_t* buffer,
+                                             const uint32_t size) {
+  if (!buffer || size % bytes_per_sample_frame_ != 0) {
+    RTC_LOG(LS_ERROR) << "Invalid audio frame size " << size << ".";
+    return false;
+  }
+  if (!ring_.Write(buffer, size)) {
+    overruns_++;
+    return false;
+  }
+  return true;
+}
+bool CustomizedAudioFrameWriter::ReadFramesFor10Ms(uint8_t* buffer,
+                                                   size_t size) {
+  RTC_DCHECK_EQ(size, bytes_per_10ms_);
+  const size_t target_bytes = bytes_per_10ms_ * (target_latency_ms_ / 10);
+  const size_t max_bytes = bytes_per_10ms_ * (max_latency_ms_ / 10);
+  size_t buffered = ring_.Size();
+  if (buffered > max_bytes) {
+    // Producer is faster than real time. Drop the oldest audio to get back
+    // to target latency.
+    size_t excess = buffered - std::max(target_bytes, bytes_per_10ms_);
+    excess -= excess % bytes_per_sample_frame_;
+    size_t dropped = ring_.Skip(excess);
+    dropped_ms_ += dropped * 10 / bytes_per_10ms_;
+    buffered -= dropped;
+  }
+  if (prebuffering_) {
+    if (buffered < std::max(target_bytes, bytes_per_10ms_)) {
+      memset(buffer, 0, size);
+      return false;
+    }
+    prebuffering_ = false;
+  }
+  if (!ring_.Read(buffer, size)) {
+    memset(buffer, 0, size);
+    underruns_++;
+    prebuffering_ = true;
+    return false;
+  }
+  return true;
+}
+AudioFrameWriterStats CustomizedAudioFrameWriter::GetStats() {
+  AudioFrameWriterStats stats;
+  stats.underruns = underruns_.load();
+  stats.overruns = overruns_.load();
+  stats.dropped_ms = dropped_ms_.load();
+  stats.buffered_ms = static_cast<int>(ring_.Size() * 10 / bytes_per_10ms_);
+  return stats;
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,50 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_CUSTOMIZEDAUDIOFRAMEWRITER_H_
+#define OWT_BASE_CUSTOMIZEDAUDIOFRAMEWRITER_H_
+#include <atomic>
+#include "talk/owt/sdk/base/spscringbuffer.h"
+#include "talk/owt/sdk/include/cpp/owt/base/framegeneratorinterface.h"
+namespace owt {
+namespace base {
+// Push mode audio input. Application threads write PCM of any packet size,
+// CustomizedAudioCapturer's recording thread reads it back 10ms at a time.
+class CustomizedAudioFrameWriter : public AudioFrameWriterInterface {
+ public:
+  CustomizedAudioFrameWriter(int sample_rate,
+                             int channel_number,
+                             int target_latency_ms,
+                             int max_latency_ms);
+  ~CustomizedAudioFrameWriter() override;
+  // AudioFrameWriterInterface. Producer thread.
+  bool WriteFrames(const uint8_t* buffer, const uint32_t size) override;
+  int GetSampleRate() override { return sample_rate_; }
+  int GetChannelNumber() override { return channel_number_; }
+  int GetTargetLatencyMs() override { return target_latency_ms_; }
+  int GetMaxLatencyMs() override { return max_latency_ms_; }
+  AudioFrameWriterStats GetStats() override;
+  // Consumer thread. Fills |buffer| with the next 10ms of audio. If not
+  // enough audio is buffered, |buffer| is filled with silence and false is
+  // returned. |size| must be the size of 10ms audio.
+  bool ReadFramesFor10Ms(uint8_t* buffer, size_t size);
+  // Size of 10ms audio in bytes.
+  size_t BytesPer10Ms() const { return bytes_per_10ms_; }
+ private:
+  const int sample_rate_;
+  const int channel_number_;
+  const int target_latency_ms_;
+  const int max_latency_ms_;
+  const size_t bytes_per_sample_frame_;
+  const size_t bytes_per_10ms_;
+  SpscRingBuffer<uint8_t> ring_;
+  // Consumer only. True until |target_latency_ms_| audio is buffered, at start
+  // and after each underrun.
+  bool prebuffering_;
+  std::atomic<uint64_t> underruns_;
+  std::atomic<uint64_t> overruns_;
+  std::atomic<uint64_t> dropped_ms_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_CUSTOMIZEDAUDIOFRAMEWRITER_H_
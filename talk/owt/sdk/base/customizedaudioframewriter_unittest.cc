@@ -0,0 +1,92 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <vector>
+#include "talk/owt/sdk/base/customizedaudioframewriter.h"
+#include "testing/gtest/include/gtest/gtest.h"
+namespace owt {
+namespace base {
+// 16kHz mono, 10ms is 320 bytes. Target latency is 20ms, maximum 40ms.
+class CustomizedAudioFrameWriterTest : public testing::Test {
+ protected:
+  CustomizedAudioFrameWriterTest()
+      : writer_(16000, 1, 20, 40), chunk_(writer_.BytesPer10Ms()) {}
+  bool WriteChunk(uint8_t value) {
+    std::vector<uint8_t> chunk(writer_.BytesPer10Ms(), value);
+    return writer_.WriteFrames(chunk.data(), chunk.size());
+  }
+  bool ReadChunk() {
+    return writer_.ReadFramesFor10Ms(chunk_.data(), chunk_.size());
+  }
+  CustomizedAudioFrameWriter writer_;
+  std::vector<uint8_t> chunk_;
+};
+TEST_F(CustomizedAudioFrameWriterTest, PrebuffersToTargetLatency) {
+  ASSERT_EQ(320u, writer_.BytesPer10Ms());
+  EXPECT_TRUE(WriteChunk(1));
+  EXPECT_FALSE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 0), chunk_);
+  EXPECT_TRUE(WriteChunk(2));
+  EXPECT_TRUE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 1), chunk_);
+  EXPECT_TRUE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 2), chunk_);
+  AudioFrameWriterStats stats = writer_.GetStats();
+  EXPECT_EQ(0u, stats.underruns);
+  EXPECT_EQ(0, stats.buffered_ms);
+}
+TEST_F(CustomizedAudioFrameWriterTest, UnderrunRestartsPrebuffering) {
+  WriteChunk(1);
+  WriteChunk(2);
+  ReadChunk();
+  ReadChunk();
+  EXPECT_FALSE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 0), chunk_);
+  EXPECT_EQ(1u, writer_.GetStats().underruns);
+  // A single chunk is below target latency, so it is held back.
+  WriteChunk(3);
+  EXPECT_FALSE(ReadChunk());
+  EXPECT_EQ(1u, writer_.GetStats().underruns);
+  WriteChunk(4);
+  EXPECT_TRUE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 3), chunk_);
+}
+TEST_F(CustomizedAudioFrameWriterTest, AcceptsPacketsOfAnySampleFrameSize) {
+  std::vector<uint8_t> packet(200, 5);
+  EXPECT_TRUE(writer_.WriteFrames(packet.data(), packet.size()));
+  EXPECT_TRUE(writer_.WriteFrames(packet.data(), packet.size()));
+  EXPECT_TRUE(writer_.WriteFrames(packet.data(), packet.size()));
+  EXPECT_FALSE(ReadChunk());
+  EXPECT_TRUE(writer_.WriteFrames(packet.data(), packet.size()));
+  EXPECT_TRUE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 5), chunk_);
+  EXPECT_EQ(15, writer_.GetStats().buffered_ms);
+}
+TEST_F(CustomizedAudioFrameWriterTest, RejectsPartialSampleFrames) {
+  std::vector<uint8_t> packet(3, 1);
+  EXPECT_FALSE(writer_.WriteFrames(packet.data(), packet.size()));
+  EXPECT_FALSE(writer_.WriteFrames(nullptr, 320));
+  AudioFrameWriterStats stats = writer_.GetStats();
+  EXPECT_EQ(0u, stats.overruns);
+  EXPECT_EQ(0, stats.buffered_ms);
+}
+TEST_F(CustomizedAudioFrameWriterTest, OverflowDropsWritesAndOldestAudio) {
+  // Ring holds 4096 bytes, which is 12 full chunks.
+  for (uint8_t i = 0; i < 12; i++) {
+    EXPECT_TRUE(WriteChunk(i));
+  }
+  EXPECT_FALSE(WriteChunk(12));
+  AudioFrameWriterStats stats = writer_.GetStats();
+  EXPECT_EQ(1u, stats.overruns);
+  EXPECT_EQ(120, stats.buffered_ms);
+  // Reader trims the buffer back to target latency before reading.
+  EXPECT_TRUE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 10), chunk_);
+  stats = writer_.GetStats();
+  EXPECT_EQ(100u, stats.dropped_ms);
+  EXPECT_EQ(10, stats.buffered_ms);
+  EXPECT_TRUE(ReadChunk());
+  EXPECT_EQ(std::vector<uint8_t>(320, 11), chunk_);
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,197 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/customizedaudiosource.h"
+#include <algorithm>
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+namespace owt {
+namespace base {
+CustomizedAudioSourcePacer* CustomizedAudioSourcePacer::Get() {
+  static CustomizedAudioSourcePacer* pacer = new CustomizedAudioSourcePacer();
+  return pacer;
+}
+CustomizedAudioSourcePacer::CustomizedAudioSourcePacer() {}
+void CustomizedAudioSourcePacer::AddSource(CustomizedAudioSource* source) {
+  std::lock_guard<std::mutex> thread_lock(thread_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    if (std::find(sources_.begin(), sources_.end(), source) != sources_.end())
+      return;
+    sources_.push_back(source);
+  }
+  if (!thread_) {
+    scheduler_.Reset();
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      timing_stats_ = AudioCaptureTimingStats();
+    }
+    thread_.reset(new rtc::PlatformThread(
+        ThreadFunc, this, "customized_audio_source_pacer"));
+    thread_->Start();
+    thread_->SetPriority(rtc::kRealtimePriority);
+  }
+}
+void CustomizedAudioSourcePacer::RemoveSource(CustomizedAudioSource* source) {
+  std::lock_guard<std::mutex> thread_lock(thread_mutex_);
+  bool empty = false;
+  {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    auto it = std::find(sources_.begin(), sources_.end(), source);
+    if (it == sources_.end())
+      return;
+    sources_.erase(it);
+    empty = sources_.empty();
+  }
+  if (empty && thread_) {
+    // ThreadProcess returns false once it sees no source.
+    thread_->Stop();
+    thread_.reset();
+  }
+}
+bool CustomizedAudioSourcePacer::ThreadFunc(void* pacer) {
+  return static_cast<CustomizedAudioSourcePacer*>(pacer)->ThreadProcess();
+}
+bool CustomizedAudioSourcePacer::ThreadProcess() {
+  int64_t now_ns = AudioChunkScheduler::MonotonicNanos();
+  bool resynced = false;
+  int64_t deadline_ns = scheduler_.NextChunk(now_ns, &resynced);
+  size_t source_count = 0;
+  uint64_t underruns = 0;
+  {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    if (sources_.empty())
+      return false;
+    for (auto* source : sources_) {
+      if (!source->DeliverNext10Ms())
+        underruns++;
+    }
+    source_count = sources_.size();
+  }
+  int64_t next_deadline_ns = scheduler_.NextDeadline();
+  bool overrun = AudioChunkScheduler::MonotonicNanos() >= next_deadline_ns;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (resynced)
+      timing_stats_.resyncs++;
+    timing_stats_.RecordWakeUp(now_ns, deadline_ns);
+    timing_stats_.delivered_chunks++;
+    timing_stats_.underruns += underruns;
+    if (overrun)
+      timing_stats_.overruns++;
+  }
+  if (!overrun) {
+    AudioChunkScheduler::SleepUntilNanos(next_deadline_ns);
+  } else {
+    RTC_LOG(LS_WARNING) << "Delivering audio of " << source_count
+                        << " customized sources takes more than 10ms.";
+  }
+  return true;
+}
+AudioCaptureTimingStats CustomizedAudioSourcePacer::GetTimingStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return timing_stats_;
+}
+rtc::scoped_refptr<CustomizedAudioSource> CustomizedAudioSource::Create(
+    std::unique_ptr<AudioFrameGeneratorInterface> frame_generator,
+    AudioLevelObserverInterface* level_observer,
+    int level_interval_ms) {
+  if (!frame_generator ||
+      !AudioFrameConverter::IsSupported(frame_generator->GetSampleFormat(),
+                                        frame_generator->GetSampleRate(),
+                                        frame_generator->GetChannelNumber())) {
+    return nullptr;
+  }
+  return new rtc::RefCountedObject<CustomizedAudioSource>(
+      std::move(frame_generator), level_observer, level_interval_ms);
+}
+CustomizedAudioSource::CustomizedAudioSource(
+    std::unique_ptr<AudioFrameGeneratorInterface> frame_generator,
+    AudioLevelObserverInterface* level_observer,
+    int level_interval_ms)
+    : frame_generator_(std::move(frame_generator)),
+      frame_converter_(frame_generator_->GetSampleFormat(),
+                       frame_generator_->GetSampleRate(),
+                       frame_generator_->GetChannelNumber()),
+      buffer_(static_cast<uint8_t*>(webrtc::AlignedMalloc<uint8_t>(
+          frame_converter_.InputSizeIn10Ms(), 16))) {
+  if (frame_converter_.NeedsConversion()) {
+    converted_buffer_.reset(
+        static_cast<int16_t*>(webrtc::AlignedMalloc<int16_t>(
+            frame_converter_.OutputFramesIn10Ms() *
+                frame_converter_.OutputChannelNumber() * sizeof(int16_t),
+            16)));
+  }
+  if (level_observer) {
+    level_meter_.reset(new AudioLevelMeter(
+        level_observer, level_interval_ms, frame_converter_.OutputSampleRate(),
+        frame_converter_.OutputChannelNumber()));
+  }
+}
+CustomizedAudioSource::~CustomizedAudioSource() {
+  CustomizedAudioSourcePacer::Get()->RemoveSource(this);
+}
+void CustomizedAudioSource::AddSink(webrtc::AudioTrackSinkInterface* sink) {
+  bool first_sink = false;
+  {
+    rtc::CritScope lock(&sink_crit_);
+    if (std::find(sinks_.begin(), sinks_.end(), sink) != sinks_.end())
+      return;
+    first_sink = sinks_.empty();
+    sinks_.push_back(sink);
+  }
+  // Pacer locks are never taken with |sink_crit_| held, as pacing thread
+  // takes them in the opposite order.
+  if (first_sink)
+    CustomizedAudioSourcePacer::Get()->AddSource(this);
+}
+void CustomizedAudioSource::RemoveSink(webrtc::AudioTrackSinkInterface* sink) {
+  bool last_sink = false;
+  {
+    rtc::CritScope lock(&sink_crit_);
+    auto it = std::find(sinks_.begin(), sinks_.end(), sink);
+    if (it == sinks_.end())
+      return;
+    sinks_.erase(it);
+    last_sink = sinks_.empty();
+  }
+  if (last_sink)
+    CustomizedAudioSourcePacer::Get()->RemoveSource(this);
+}
+bool CustomizedAudioSource::DeliverNext10Ms() {
+  const size_t input_size = frame_converter_.InputSizeIn10Ms();
+  const uint8_t* frames = frame_generator_->ReadFramesForNext10Ms(
+      static_cast<uint32_t>(input_size));
+  if (!frames) {
+    if (frame_generator_->GenerateFramesForNext10Ms(
+            buffer_.get(), static_cast<uint32_t>(input_size)) !=
+        static_cast<uint32_t>(input_size)) {
+      RTC_LOG(LS_ERROR) << "Get audio frames failed.";
+      return false;
+    }
+    frames = buffer_.get();
+  }
+  const void* audio = frames;
+  if (converted_buffer_) {
+    if (!frame_converter_.Convert(frames, input_size,
+                                  converted_buffer_.get())) {
+      RTC_LOG(LS_ERROR) << "Convert audio frames failed.";
+      return false;
+    }
+    audio = converted_buffer_.get();
+  }
+  if (level_meter_) {
+    level_meter_->Process(static_cast<const int16_t*>(audio),
+                          frame_converter_.OutputFramesIn10Ms());
+  }
+  rtc::CritScope lock(&sink_crit_);
+  for (auto* sink : sinks_) {
+    sink->OnData(audio, 16, frame_converter_.OutputSampleRate(),
+                 frame_converter_.OutputChannelNumber(),
+                 frame_converter_.OutputFramesIn10Ms());
+  }
+  return true;
+}
+}  // namespace base
+}  // namespace owt
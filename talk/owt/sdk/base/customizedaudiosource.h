@@ -0,0 +1,91 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_CUSTOMIZEDAUDIOSOURCE_H_
+#define OWT_BASE_CUSTOMIZEDAUDIOSOURCE_H_
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "webrtc/api/mediastreaminterface.h"
+#include "webrtc/api/notifier.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/memory/aligned_malloc.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "talk/owt/sdk/base/audiochunkscheduler.h"
+#include "talk/owt/sdk/base/audioframeconverter.h"
+#include "talk/owt/sdk/base/audiolevelmeter.h"
+#include "talk/owt/sdk/include/cpp/owt/base/framegeneratorinterface.h"
+namespace owt {
+namespace base {
+class CustomizedAudioSource;
+// Drives all CustomizedAudioSource instances of the process from a single
+// realtime thread, so the number of threads does not grow with the number of
+// streams. The thread only runs while at least one source has sinks.
+class CustomizedAudioSourcePacer {
+ public:
+  static CustomizedAudioSourcePacer* Get();
+  void AddSource(CustomizedAudioSource* source);
+  // After it returns, |source| is not accessed by pacing thread any more.
+  void RemoveSource(CustomizedAudioSource* source);
+  // Returns a snapshot of pacing thread timing counters since it last started.
+  // A chunk counts as delivered once all sources are given 10ms of audio.
+  AudioCaptureTimingStats GetTimingStats() const;
+ private:
+  CustomizedAudioSourcePacer();
+  static bool ThreadFunc(void* pacer);
+  bool ThreadProcess();
+  // Protects |sources_|. Held while sources deliver audio.
+  std::mutex sources_mutex_;
+  std::vector<CustomizedAudioSource*> sources_;
+  // Serializes starting and stopping |thread_|.
+  std::mutex thread_mutex_;
+  std::unique_ptr<rtc::PlatformThread> thread_;
+  AudioChunkScheduler scheduler_;
+  mutable std::mutex stats_mutex_;
+  AudioCaptureTimingStats timing_stats_;
+};
+// An audio source whose audio is pulled from its own
+// AudioFrameGeneratorInterface every 10ms and pushed to the sinks of the
+// tracks using it, e.g. the send stream of a PeerConnection. Unlike the
+// generator set by GlobalConfiguration, it does not go through the audio
+// device module, so each LocalStream can have a different one.
+class CustomizedAudioSource
+    : public webrtc::Notifier<webrtc::AudioSourceInterface> {
+ public:
+  // If |level_observer| is not null, level of audio from |frame_generator| is
+  // reported to it every |level_interval_ms| on pacing thread.
+  static rtc::scoped_refptr<CustomizedAudioSource> Create(
+      std::unique_ptr<AudioFrameGeneratorInterface> frame_generator,
+      AudioLevelObserverInterface* level_observer = nullptr,
+      int level_interval_ms = 100);
+  // MediaSourceInterface.
+  SourceState state() const override { return kLive; }
+  bool remote() const override { return false; }
+  // AudioSourceInterface.
+  void AddSink(webrtc::AudioTrackSinkInterface* sink) override;
+  void RemoveSink(webrtc::AudioTrackSinkInterface* sink) override;
+  // Pulls 10ms audio from generator and delivers it to all sinks. Called on
+  // pacing thread. Returns false if generator fails to provide audio.
+  bool DeliverNext10Ms();
+ protected:
+  CustomizedAudioSource(
+      std::unique_ptr<AudioFrameGeneratorInterface> frame_generator,
+      AudioLevelObserverInterface* level_observer,
+      int level_interval_ms);
+  ~CustomizedAudioSource() override;
+ private:
+  std::unique_ptr<AudioFrameGeneratorInterface> frame_generator_;
+  AudioFrameConverter frame_converter_;
+  // Audio from generator, and converted audio if conversion is needed.
+  std::unique_ptr<uint8_t[], webrtc::AlignedFreeDeleter> buffer_;
+  std::unique_ptr<int16_t[], webrtc::AlignedFreeDeleter> converted_buffer_;
+  // Only used on pacing thread.
+  std::unique_ptr<AudioLevelMeter> level_meter_;
+  rtc::CriticalSection sink_crit_;
+  std::vector<webrtc::AudioTrackSinkInterface*> sinks_
+      RTC_GUARDED_BY(sink_crit_);
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_CUSTOMIZEDAUDIOSOURCE_H_
@@ -4,7 +4,7 @@
 #include <future>
 #include <thread>
 #include <vector>
-#include "webrtc/rtc_base/task_queue.h"
+#include "talk/owt/sdk/base/callbackexecutor.h"
 #ifndef OWT_BASE_EVENTTRIGGER_H_
 #define OWT_BASE_EVENTTRIGGER_H_
 namespace owt {
@@ -17,7 +17,7 @@ class EventTrigger final {
  public:
   template <typename O, typename A, typename F>
   static void OnEvent0(std::vector<O, A> const& observers,
-                       std::shared_ptr<rtc::TaskQueue> queue,
+                       std::shared_ptr<TaskSequence> queue,
                        F func) {
     for (auto it = observers.begin(); it != observers.end(); ++it) {
       auto f = std::bind(func, *it);
@@ -26,7 +26,7 @@ class EventTrigger final {
   }
   template <typename O, typename A, typename F, typename T1>
   static void OnEvent1(std::vector<O, A> const& observers,
-                       std::shared_ptr<rtc::TaskQueue> queue,
+                       std::shared_ptr<TaskSequence> queue,
                        F func,
                        T1 arg1) {
     for (auto it = observers.begin(); it != observers.end(); ++it) {
@@ -36,7 +36,7 @@ class EventTrigger final {
   }
   template <typename O, typename A, typename F, typename T1, typename T2>
   static void OnEvent2(std::vector<O, A> const& observers,
-                       std::shared_ptr<rtc::TaskQueue> queue,
+                       std::shared_ptr<TaskSequence> queue,
                        F func,
                        T1 arg1,
                        T2 arg2) {
@@ -0,0 +1,35 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/exponentialbackoff.h"
+#include <algorithm>
+namespace owt {
+namespace base {
+ExponentialBackoff::ExponentialBackoff(unsigned initial_delay_ms,
+                                       unsigned max_delay_ms,
+                                       double jitter)
+    : ExponentialBackoff(initial_delay_ms,
+                         max_delay_ms,
+                         jitter,
+                         std::random_device()()) {}
+ExponentialBackoff::ExponentialBackoff(unsigned initial_delay_ms,
+                                       unsigned max_delay_ms,
+                                       double jitter,
+                                       uint32_t seed)
+    : initial_delay_ms_(initial_delay_ms),
+      max_delay_ms_(std::max(initial_delay_ms, max_delay_ms)),
+      jitter_(std::min(std::max(jitter, 0.0), 1.0)),
+      random_(seed) {}
+unsigned ExponentialBackoff::Delay(unsigned attempt) {
+  // Doubling more than 32 times overflows, and exceeds any sensible cap.
+  double delay = static_cast<double>(initial_delay_ms_) *
+                 static_cast<double>(uint64_t(1) << std::min(attempt, 32u));
+  delay = std::min(delay, static_cast<double>(max_delay_ms_));
+  if (jitter_ > 0) {
+    std::uniform_real_distribution<double> fraction(0, jitter_);
+    delay *= 1 - fraction(random_);
+  }
+  return static_cast<unsigned>(delay);
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,37 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_EXPONENTIALBACKOFF_H_
+#define OWT_BASE_EXPONENTIALBACKOFF_H_
+#include <stdint.h>
+#include <random>
+namespace owt {
+namespace base {
+// Delays between retries which grow exponentially up to a cap, with random
+// jitter. Without jitter, clients which lost a server at the same time, e.g.
+// when it restarts, retry in lockstep and overload it again.
+class ExponentialBackoff {
+ public:
+  // Delay of attempt n is min(|max_delay_ms|, |initial_delay_ms| * 2^n),
+  // reduced by a random fraction up to |jitter|. |jitter| of 0 disables
+  // jitter, and 1 means "full jitter", i.e. delays spread evenly between 0
+  // and the exponential delay.
+  ExponentialBackoff(unsigned initial_delay_ms,
+                     unsigned max_delay_ms,
+                     double jitter);
+  // Same as above, but with a fixed seed for reproducible delays.
+  ExponentialBackoff(unsigned initial_delay_ms,
+                     unsigned max_delay_ms,
+                     double jitter,
+                     uint32_t seed);
+  // Delay before retry |attempt|, counted from 0.
+  unsigned Delay(unsigned attempt);
+ private:
+  const unsigned initial_delay_ms_;
+  const unsigned max_delay_ms_;
+  const double jitter_;
+  std::mt19937 random_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_EXPONENTIALBACKOFF_H_
@@ -0,0 +1,36 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <set>
+#include "talk/owt/sdk/base/exponentialbackoff.h"
+#include "testing/gtest/include/gtest/gtest.h"
+namespace owt {
+namespace base {
+TEST(ExponentialBackoffTest, DoublesUpToCapWithoutJitter) {
+  ExponentialBackoff backoff(500, 5000, 0);
+  EXPECT_EQ(500u, backoff.Delay(0));
+  EXPECT_EQ(1000u, backoff.Delay(1));
+  EXPECT_EQ(4000u, backoff.Delay(3));
+  EXPECT_EQ(5000u, backoff.Delay(4));
+  EXPECT_EQ(5000u, backoff.Delay(100));
+}
+TEST(ExponentialBackoffTest, JitterStaysWithinRange) {
+  ExponentialBackoff backoff(1000, 30000, 0.5, 1);
+  for (int i = 0; i < 1000; i++) {
+    unsigned delay = backoff.Delay(2);
+    EXPECT_LE(2000u, delay);
+    EXPECT_GE(4000u, delay);
+  }
+}
+TEST(ExponentialBackoffTest, JitterSpreadsClients) {
+  // Clients disconnected at the same time should not retry together.
+  std::set<unsigned> delays;
+  for (uint32_t client = 0; client < 100; client++) {
+    ExponentialBackoff backoff(1000, 30000, 1, client);
+    delays.insert(backoff.Delay(3));
+  }
+  EXPECT_LT(90u, delays.size());
+  EXPECT_GE(8000u, *delays.rbegin());
+}
+}  // namespace base
+}  // namespace owt
@@ -52,11 +52,18 @@ void FunctionalSetSessionDescriptionObserver::OnFailure(
   }
 }
 FunctionalStatsObserver::FunctionalStatsObserver(
-    std::function<void(std::shared_ptr<ConnectionStats>)> on_complete)
-    : on_complete_(on_complete) {}
+    std::function<void(std::shared_ptr<ConnectionStats>)> on_complete,
+    std::unordered_set<std::string> track_ids)
+    : on_complete_(on_complete), track_ids_(std::move(track_ids)) {}
 rtc::scoped_refptr<FunctionalStatsObserver> FunctionalStatsObserver::Create(
     std::function<void(std::shared_ptr<ConnectionStats>)> on_complete) {
-  return new rtc::RefCountedObject<FunctionalStatsObserver>(on_complete);
+  return Create(on_complete, std::unordered_set<std::string>());
+}
+rtc::scoped_refptr<FunctionalStatsObserver> FunctionalStatsObserver::Create(
+    std::function<void(std::shared_ptr<ConnectionStats>)> on_complete,
+    std::unordered_set<std::string> track_ids) {
+  return new rtc::RefCountedObject<FunctionalStatsObserver>(
+      on_complete, std::move(track_ids));
 }
 void FunctionalStatsObserver::OnComplete(const webrtc::StatsReports& reports) {
   if (on_complete_ != nullptr) {
@@ -64,6 +71,14 @@ void FunctionalStatsObserver::OnComplete(const webrtc::StatsReports& reports) {
     int32_t adapt_reason = static_cast<int32_t>(VideoSenderReport::AdaptReason::kUnknown);
     for (const auto* report : reports) {
       ReportType report_type = GetReportType(report);
+      if (!track_ids_.empty() &&
+          report->type() == webrtc::StatsReport::kStatsReportTypeSsrc) {
+        const auto* track_id =
+            report->FindValue(webrtc::StatsReport::kStatsValueNameTrackId);
+        if (!track_id ||
+            track_ids_.find(track_id->ToString()) == track_ids_.end())
+          continue;
+      }
       switch (report_type) {
       case REPORT_AUDIO_RECEIVER:
       {
@@ -314,14 +329,36 @@ FunctionalStatsObserver::ReportType FunctionalStatsObserver::GetReportType(
 rtc::scoped_refptr<FunctionalNativeStatsObserver>
 FunctionalNativeStatsObserver::Create(
     std::function<void(const webrtc::StatsReports& reports)> on_complete) {
-  return new rtc::RefCountedObject<FunctionalNativeStatsObserver>(on_complete);
+  return Create(on_complete, std::unordered_set<std::string>());
+}
+rtc::scoped_refptr<FunctionalNativeStatsObserver>
+FunctionalNativeStatsObserver::Create(
+    std::function<void(const webrtc::StatsReports& reports)> on_complete,
+    std::unordered_set<std::string> track_ids) {
+  return new rtc::RefCountedObject<FunctionalNativeStatsObserver>(
+      on_complete, std::move(track_ids));
 }
 void FunctionalNativeStatsObserver::OnComplete(
     const webrtc::StatsReports& reports) {
   if (!on_complete_) {
     return;
   }
-  on_complete_(reports);
+  if (track_ids_.empty()) {
+    on_complete_(reports);
+    return;
+  }
+  webrtc::StatsReports track_reports;
+  for (const auto* report : reports) {
+    if (report->type() == webrtc::StatsReport::kStatsReportTypeSsrc) {
+      const auto* track_id =
+          report->FindValue(webrtc::StatsReport::kStatsValueNameTrackId);
+      if (!track_id ||
+          track_ids_.find(track_id->ToString()) == track_ids_.end())
+        continue;
+    }
+    track_reports.push_back(report);
+  }
+  on_complete_(track_reports);
 }
 }
 }
@@ -5,6 +5,7 @@
 #define OWT_BASE_FUNCTIONALOBSERVER_H_
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
 #include "webrtc/api/jsep.h"
 #include "webrtc/api/peerconnectioninterface.h"
 #include "webrtc/rtc_base/scoped_ref_ptr.h"
@@ -53,10 +54,16 @@ class FunctionalStatsObserver : public webrtc::StatsObserver {
  public:
   static rtc::scoped_refptr<FunctionalStatsObserver> Create(
       std::function<void(std::shared_ptr<ConnectionStats>)> on_complete);
+  // Sender and receiver reports are only collected for tracks in |track_ids|,
+  // e.g. for one of the streams sharing a PeerConnection.
+  static rtc::scoped_refptr<FunctionalStatsObserver> Create(
+      std::function<void(std::shared_ptr<ConnectionStats>)> on_complete,
+      std::unordered_set<std::string> track_ids);
   virtual void OnComplete(const webrtc::StatsReports& reports);
  protected:
   FunctionalStatsObserver(
-      std::function<void(std::shared_ptr<ConnectionStats>)> on_complete);
+      std::function<void(std::shared_ptr<ConnectionStats>)> on_complete,
+      std::unordered_set<std::string> track_ids);
  private:
   enum ReportType {
     REPORT_AUDIO_SENDER = 1,
@@ -70,6 +77,8 @@ class FunctionalStatsObserver : public webrtc::StatsObserver {
     REPORT_TYPE_UKNOWN = 99,
   };
   std::function<void(std::shared_ptr<ConnectionStats>)> on_complete_;
+  // Empty if reports of all tracks are collected.
+  const std::unordered_set<std::string> track_ids_;
   ReportType GetReportType(const webrtc::StatsReport* report);
   template <class T>
   T GetValue(std::function<T(const webrtc::StatsReport::Value&)> get_value,
@@ -93,13 +102,20 @@ class FunctionalNativeStatsObserver : public webrtc::StatsObserver {
  public:
   static rtc::scoped_refptr<FunctionalNativeStatsObserver> Create(
       std::function<void(const webrtc::StatsReports& reports)> on_complete);
+  // SSRC reports are only passed for tracks in |track_ids|.
+  static rtc::scoped_refptr<FunctionalNativeStatsObserver> Create(
+      std::function<void(const webrtc::StatsReports& reports)> on_complete,
+      std::unordered_set<std::string> track_ids);
   virtual void OnComplete(const webrtc::StatsReports& reports) override;
  protected:
   FunctionalNativeStatsObserver(
-      std::function<void(const webrtc::StatsReports& reports)> on_complete)
-      : on_complete_(on_complete){};
+      std::function<void(const webrtc::StatsReports& reports)> on_complete,
+      std::unordered_set<std::string> track_ids)
+      : on_complete_(on_complete), track_ids_(std::move(track_ids)){};
  private:
   std::function<void(const webrtc::StatsReports& reports)> on_complete_;
+  // Empty if reports of all tracks are passed.
+  const std::unordered_set<std::string> track_ids_;
 };
 }
 }
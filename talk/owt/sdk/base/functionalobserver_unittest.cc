@@ -0,0 +1,61 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <memory>
+#include <string>
+#include "talk/owt/sdk/base/functionalobserver.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/api/statstypes.h"
+namespace owt {
+namespace base {
+// An audio receiver report of track |track_id|.
+static std::unique_ptr<webrtc::StatsReport> ReceiverReport(
+    const std::string& ssrc,
+    const std::string& track_id,
+    int64_t bytes_received) {
+  std::unique_ptr<webrtc::StatsReport> report(
+      new webrtc::StatsReport(webrtc::StatsReport::NewIdWithDirection(
+          webrtc::StatsReport::kStatsReportTypeSsrc, ssrc,
+          webrtc::StatsReport::kReceive)));
+  report->AddString(webrtc::StatsReport::kStatsValueNameTrackId, track_id);
+  report->AddInt64(webrtc::StatsReport::kStatsValueNameBytesReceived,
+                   bytes_received);
+  return report;
+}
+TEST(FunctionalStatsObserverTest, CollectsReportsOfAllTracksByDefault) {
+  auto first = ReceiverReport("1", "audio-1", 100);
+  auto second = ReceiverReport("2", "audio-2", 200);
+  std::shared_ptr<ConnectionStats> stats;
+  auto observer = FunctionalStatsObserver::Create(
+      [&stats](std::shared_ptr<ConnectionStats> result) { stats = result; });
+  observer->OnComplete({first.get(), second.get()});
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(2u, stats->audio_receiver_reports.size());
+}
+TEST(FunctionalStatsObserverTest, CollectsReportsOfGivenTracksOnly) {
+  auto first = ReceiverReport("1", "audio-1", 100);
+  auto second = ReceiverReport("2", "audio-2", 200);
+  std::shared_ptr<ConnectionStats> stats;
+  auto observer = FunctionalStatsObserver::Create(
+      [&stats](std::shared_ptr<ConnectionStats> result) { stats = result; },
+      {"audio-2"});
+  observer->OnComplete({first.get(), second.get()});
+  ASSERT_TRUE(stats);
+  ASSERT_EQ(1u, stats->audio_receiver_reports.size());
+  EXPECT_EQ(200, stats->audio_receiver_reports[0]->bytes_rcvd);
+}
+TEST(FunctionalNativeStatsObserverTest, PassesReportsOfGivenTracksOnly) {
+  auto first = ReceiverReport("1", "audio-1", 100);
+  auto second = ReceiverReport("2", "audio-2", 200);
+  // Reports not bound to a track are shared by all tracks.
+  webrtc::StatsReport transport(webrtc::StatsReport::NewTypedId(
+      webrtc::StatsReport::kStatsReportTypeTransport, "transport"));
+  webrtc::StatsReports passed;
+  auto observer = FunctionalNativeStatsObserver::Create(
+      [&passed](const webrtc::StatsReports& reports) { passed = reports; },
+      {"audio-2"});
+  observer->OnComplete({first.get(), second.get(), &transport});
+  EXPECT_EQ(webrtc::StatsReports({second.get(), &transport}), passed);
+}
+}  // namespace base
+}  // namespace owt
@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 #include "owt/base/globalconfiguration.h"
+#include "talk/owt/sdk/base/customizedaudioframewriter.h"
 namespace owt {
 namespace base {
 #if defined(WEBRTC_WIN)
@@ -9,8 +10,16 @@ namespace base {
 bool GlobalConfiguration::hardware_acceleration_enabled_ = true;
 #endif
 bool GlobalConfiguration::encoded_frame_ = false;
+bool GlobalConfiguration::customized_audio_input_enabled_ = false;
 std::unique_ptr<AudioFrameGeneratorInterface>
     GlobalConfiguration::audio_frame_generator_ = nullptr;
+std::shared_ptr<AudioFrameWriterInterface>
+    GlobalConfiguration::audio_frame_writer_ = nullptr;
+std::unique_ptr<AudioFrameSinkInterface>
+    GlobalConfiguration::audio_frame_sink_ = nullptr;
+AudioLevelObserverInterface* GlobalConfiguration::audio_level_observer_ =
+    nullptr;
+int GlobalConfiguration::audio_level_interval_ms_ = 100;
 #if defined(WEBRTC_WIN) || defined(WEBRTC_LINUX)
 std::unique_ptr<VideoDecoderInterface>
     GlobalConfiguration::video_decoder_ = nullptr;
@@ -22,5 +31,17 @@ AudioProcessingSettings GlobalConfiguration::audio_processing_settings_ = {
 AudioProcessingSettings GlobalConfiguration::audio_processing_settings_ = {
     true, true, true, true};
 #endif
+PeerConnectionThreadingSettings GlobalConfiguration::threading_settings_;
+std::shared_ptr<AudioFrameWriterInterface>
+GlobalConfiguration::EnableCustomizedAudioPushInput(int sample_rate,
+                                                    int channel_number,
+                                                    int target_latency_ms,
+                                                    int max_latency_ms) {
+  audio_frame_generator_.reset(nullptr);
+  customized_audio_input_enabled_ = true;
+  audio_frame_writer_ = std::make_shared<CustomizedAudioFrameWriter>(
+      sample_rate, channel_number, target_latency_ms, max_latency_ms);
+  return audio_frame_writer_;
+}
 }
 }
@@ -0,0 +1,175 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <errno.h>
+#include <linux/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "talk/owt/sdk/base/linux/networkmonitorlinux.h"
+#include "webrtc/rtc_base/logging.h"
+namespace owt {
+namespace base {
+namespace {
+// Large enough for a burst of messages, e.g. all addresses of an interface
+// removed together.
+const size_t kReceiveBufferSize = 16384;
+}  // namespace
+NetworkMonitorLinux::NetworkMonitorLinux()
+    : netlink_fd_(-1), wakeup_fd_(-1) {}
+NetworkMonitorLinux::~NetworkMonitorLinux() {
+  Stop();
+}
+void NetworkMonitorLinux::Start() {
+  if (thread_)
+    return;
+  netlink_fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (netlink_fd_ < 0) {
+    RTC_LOG(LS_ERROR) << "Failed to create netlink socket, errno: " << errno;
+    return;
+  }
+  struct sockaddr_nl address;
+  memset(&address, 0, sizeof(address));
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR |
+                      RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+  if (bind(netlink_fd_, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) != 0) {
+    RTC_LOG(LS_ERROR) << "Failed to bind netlink socket, errno: " << errno;
+    close(netlink_fd_);
+    netlink_fd_ = -1;
+    return;
+  }
+  wakeup_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wakeup_fd_ < 0) {
+    RTC_LOG(LS_ERROR) << "Failed to create eventfd, errno: " << errno;
+    close(netlink_fd_);
+    netlink_fd_ = -1;
+    return;
+  }
+  thread_.reset(new std::thread(&NetworkMonitorLinux::Run, this));
+  RTC_LOG(LS_INFO) << "Started netlink network monitor.";
+}
+void NetworkMonitorLinux::Stop() {
+  if (!thread_)
+    return;
+  uint64_t value = 1;
+  if (write(wakeup_fd_, &value, sizeof(value)) < 0) {
+    RTC_LOG(LS_ERROR) << "Failed to stop netlink network monitor, errno: "
+                      << errno;
+  }
+  thread_->join();
+  thread_.reset();
+  close(wakeup_fd_);
+  wakeup_fd_ = -1;
+  close(netlink_fd_);
+  netlink_fd_ = -1;
+}
+rtc::AdapterType NetworkMonitorLinux::GetAdapterType(
+    const std::string& interface_name) {
+  return rtc::AdapterType::ADAPTER_TYPE_UNKNOWN;
+}
+// static
+bool NetworkMonitorLinux::IsNetworkChange(const char* buffer, size_t length) {
+  int remaining = static_cast<int>(length);
+  for (const struct nlmsghdr* header =
+           reinterpret_cast<const struct nlmsghdr*>(buffer);
+       NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+    switch (header->nlmsg_type) {
+      case RTM_NEWADDR:
+      case RTM_DELADDR: {
+        if (header->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifaddrmsg)))
+          break;
+        const struct ifaddrmsg* message =
+            static_cast<const struct ifaddrmsg*>(NLMSG_DATA(header));
+        if (message->ifa_scope == RT_SCOPE_HOST)
+          break;
+        // Another RTM_NEWADDR is sent when duplicate address detection
+        // completes.
+        if (header->nlmsg_type == RTM_NEWADDR &&
+            (message->ifa_flags & (IFA_F_TENTATIVE | IFA_F_DADFAILED)))
+          break;
+        return true;
+      }
+      case RTM_NEWROUTE:
+      case RTM_DELROUTE: {
+        if (header->nlmsg_len < NLMSG_LENGTH(sizeof(struct rtmsg)))
+          break;
+        const struct rtmsg* message =
+            static_cast<const struct rtmsg*>(NLMSG_DATA(header));
+        // Default routes decide the interface used to reach servers.
+        if (message->rtm_table != RT_TABLE_MAIN || message->rtm_dst_len != 0)
+          break;
+        return true;
+      }
+      case RTM_NEWLINK:
+      case RTM_DELLINK: {
+        if (header->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifinfomsg)))
+          break;
+        const struct ifinfomsg* message =
+            static_cast<const struct ifinfomsg*>(NLMSG_DATA(header));
+        if (message->ifi_flags & IFF_LOOPBACK)
+          break;
+        // RTM_NEWLINK is also sent for changes other than link state.
+        if (header->nlmsg_type == RTM_NEWLINK &&
+            !(message->ifi_change & (IFF_UP | IFF_RUNNING | IFF_LOWER_UP)))
+          break;
+        return true;
+      }
+      default:
+        break;
+    }
+  }
+  return false;
+}
+void NetworkMonitorLinux::Run() {
+  std::unique_ptr<char[]> buffer(new char[kReceiveBufferSize]);
+  struct pollfd fds[2];
+  fds[0].fd = netlink_fd_;
+  fds[0].events = POLLIN;
+  fds[1].fd = wakeup_fd_;
+  fds[1].events = POLLIN;
+  while (true) {
+    fds[0].revents = 0;
+    fds[1].revents = 0;
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      RTC_LOG(LS_ERROR) << "Failed to poll netlink socket, errno: " << errno;
+      return;
+    }
+    if (fds[1].revents)
+      return;
+    // Read all queued messages, so a burst of changes is signaled once.
+    bool changed = false;
+    while (true) {
+      ssize_t received =
+          recv(netlink_fd_, buffer.get(), kReceiveBufferSize, MSG_DONTWAIT);
+      if (received > 0) {
+        changed = changed || IsNetworkChange(buffer.get(), received);
+      } else if (received < 0 && errno == EINTR) {
+        continue;
+      } else if (received < 0 && errno == ENOBUFS) {
+        // Messages are dropped by kernel. Some of them may be changes.
+        changed = true;
+      } else {
+        break;
+      }
+    }
+    if (changed) {
+      RTC_LOG(LS_INFO) << "Networks changed.";
+      OnNetworksChanged();
+    }
+  }
+}
+rtc::NetworkMonitorInterface*
+NetworkMonitorFactoryLinux::CreateNetworkMonitor() {
+  return new NetworkMonitorLinux();
+}
+}  // namespace base
+}  // namespace owt
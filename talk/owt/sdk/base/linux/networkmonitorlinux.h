@@ -0,0 +1,49 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_LINUX_NETWORKMONITORLINUX_H_
+#define OWT_BASE_LINUX_NETWORKMONITORLINUX_H_
+#include <stddef.h>
+#include <memory>
+#include <thread>
+#include "webrtc/rtc_base/network.h"
+namespace owt {
+namespace base {
+/**
+ * Watches rtnetlink for address, route and link changes, so networks changed
+ * are known in milliseconds instead of after ICE times out.
+ *
+ * Only changes in the network namespace of the thread calling Start are
+ * observed. It can be tested on one machine with veth pairs in network
+ * namespaces, by changing their addresses, routes and link states.
+ */
+class NetworkMonitorLinux : public rtc::NetworkMonitorBase {
+ public:
+  NetworkMonitorLinux();
+  ~NetworkMonitorLinux() override;
+  void Start() override;
+  void Stop() override;
+  // Always return unknown because it is not used anywhere.
+  rtc::AdapterType GetAdapterType(const std::string& interface_name) override;
+  // Returns true if rtnetlink messages in |buffer| change networks usable by
+  // ICE. Changes of loopback interfaces, tentative IPv6 addresses and
+  // non-default routes are ignored.
+  static bool IsNetworkChange(const char* buffer, size_t length);
+ private:
+  // Reads netlink messages on |thread_| until |wakeup_fd_| is signaled.
+  void Run();
+  int netlink_fd_;
+  int wakeup_fd_;
+  std::unique_ptr<std::thread> thread_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkMonitorLinux);
+};
+class NetworkMonitorFactoryLinux : public rtc::NetworkMonitorFactory {
+ public:
+  NetworkMonitorFactoryLinux() {}
+  rtc::NetworkMonitorInterface* CreateNetworkMonitor() override;
+ private:
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkMonitorFactoryLinux);
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_LINUX_NETWORKMONITORLINUX_H_
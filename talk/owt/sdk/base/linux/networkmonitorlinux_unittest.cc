@@ -0,0 +1,103 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <linux/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <string.h>
+#include <vector>
+#include "talk/owt/sdk/base/linux/networkmonitorlinux.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+namespace {
+// Appends a netlink message of |type| with |payload| to |buffer|.
+template <typename Payload>
+void AppendMessage(uint16_t type,
+                   const Payload& payload,
+                   std::vector<char>* buffer) {
+  const size_t offset = buffer->size();
+  buffer->resize(offset + NLMSG_SPACE(sizeof(Payload)));
+  struct nlmsghdr* header =
+      reinterpret_cast<struct nlmsghdr*>(buffer->data() + offset);
+  header->nlmsg_len = NLMSG_LENGTH(sizeof(Payload));
+  header->nlmsg_type = type;
+  memcpy(NLMSG_DATA(header), &payload, sizeof(Payload));
+}
+struct ifaddrmsg AddressMessage(unsigned char scope, unsigned char flags) {
+  struct ifaddrmsg message;
+  memset(&message, 0, sizeof(message));
+  message.ifa_family = AF_INET6;
+  message.ifa_scope = scope;
+  message.ifa_flags = flags;
+  return message;
+}
+struct rtmsg RouteMessage(unsigned char table, unsigned char dst_len) {
+  struct rtmsg message;
+  memset(&message, 0, sizeof(message));
+  message.rtm_family = AF_INET;
+  message.rtm_table = table;
+  message.rtm_dst_len = dst_len;
+  return message;
+}
+struct ifinfomsg LinkMessage(unsigned flags, unsigned change) {
+  struct ifinfomsg message;
+  memset(&message, 0, sizeof(message));
+  message.ifi_flags = flags;
+  message.ifi_change = change;
+  return message;
+}
+bool IsNetworkChange(const std::vector<char>& buffer) {
+  return NetworkMonitorLinux::IsNetworkChange(buffer.data(), buffer.size());
+}
+}  // namespace
+TEST(NetworkMonitorLinuxTest, AddressChanges) {
+  std::vector<char> added;
+  AppendMessage(RTM_NEWADDR, AddressMessage(RT_SCOPE_UNIVERSE, 0), &added);
+  EXPECT_TRUE(IsNetworkChange(added));
+  std::vector<char> removed;
+  AppendMessage(RTM_DELADDR, AddressMessage(RT_SCOPE_LINK, 0), &removed);
+  EXPECT_TRUE(IsNetworkChange(removed));
+}
+TEST(NetworkMonitorLinuxTest, IgnoresLoopbackAndTentativeAddresses) {
+  std::vector<char> buffer;
+  AppendMessage(RTM_NEWADDR, AddressMessage(RT_SCOPE_HOST, 0), &buffer);
+  AppendMessage(RTM_NEWADDR,
+                AddressMessage(RT_SCOPE_UNIVERSE, IFA_F_TENTATIVE), &buffer);
+  AppendMessage(RTM_DELADDR, AddressMessage(RT_SCOPE_HOST, 0), &buffer);
+  EXPECT_FALSE(IsNetworkChange(buffer));
+  // Address is usable once duplicate address detection completes.
+  AppendMessage(RTM_NEWADDR, AddressMessage(RT_SCOPE_UNIVERSE, 0), &buffer);
+  EXPECT_TRUE(IsNetworkChange(buffer));
+}
+TEST(NetworkMonitorLinuxTest, OnlyDefaultRoutesOfMainTable) {
+  std::vector<char> buffer;
+  AppendMessage(RTM_NEWROUTE, RouteMessage(RT_TABLE_MAIN, 24), &buffer);
+  AppendMessage(RTM_NEWROUTE, RouteMessage(RT_TABLE_LOCAL, 0), &buffer);
+  EXPECT_FALSE(IsNetworkChange(buffer));
+  std::vector<char> default_route;
+  AppendMessage(RTM_DELROUTE, RouteMessage(RT_TABLE_MAIN, 0), &default_route);
+  EXPECT_TRUE(IsNetworkChange(default_route));
+}
+TEST(NetworkMonitorLinuxTest, LinkStateChanges) {
+  std::vector<char> buffer;
+  AppendMessage(RTM_NEWLINK, LinkMessage(IFF_UP, 0), &buffer);
+  AppendMessage(RTM_DELLINK, LinkMessage(IFF_LOOPBACK, ~0u), &buffer);
+  EXPECT_FALSE(IsNetworkChange(buffer));
+  std::vector<char> down;
+  AppendMessage(RTM_NEWLINK, LinkMessage(IFF_UP, IFF_LOWER_UP), &down);
+  EXPECT_TRUE(IsNetworkChange(down));
+  std::vector<char> removed;
+  AppendMessage(RTM_DELLINK, LinkMessage(0, 0), &removed);
+  EXPECT_TRUE(IsNetworkChange(removed));
+}
+TEST(NetworkMonitorLinuxTest, IgnoresTruncatedMessages) {
+  std::vector<char> buffer;
+  AppendMessage(RTM_NEWADDR, AddressMessage(RT_SCOPE_UNIVERSE, 0), &buffer);
+  EXPECT_FALSE(NetworkMonitorLinux::IsNetworkChange(buffer.data(),
+                                                    sizeof(struct nlmsghdr)));
+  EXPECT_FALSE(NetworkMonitorLinux::IsNetworkChange(buffer.data(), 0));
+}
+}  // namespace base
+}  // namespace owt
@@ -13,9 +13,18 @@ PeerConnectionChannel::PeerConnectionChannel(
     : pc_thread_(nullptr),
       configuration_(configuration),
       factory_(nullptr),
-      peer_connection_(nullptr) {
+      peer_connection_(nullptr),
+      restart_ice_in_next_offer_(false) {
+  for (auto& audio_enc_param : configuration_.audio) {
+    preferred_audio_codecs_.push_back(audio_enc_param.codec.name);
+  }
+  for (auto& video_enc_param : configuration_.video) {
+    preferred_video_codecs_.push_back(video_enc_param.codec.name);
+  }
 }
 PeerConnectionChannel::~PeerConnectionChannel() {
+  if (pooled_observer_)
+    pooled_observer_->SetObserver(nullptr);
   if (peer_connection_ != nullptr) {
     peer_connection_->Close();
   }
@@ -24,16 +33,28 @@ PeerConnectionChannel::~PeerConnectionChannel() {
 }
 bool PeerConnectionChannel::InitializePeerConnection() {
   RTC_LOG(LS_INFO) << "Initialize PeerConnection.";
-  if (factory_.get() == nullptr)
-    factory_ = PeerConnectionDependencyFactory::Get();
   offer_answer_options_ =
       webrtc::PeerConnectionInterface::RTCOfferAnswerOptions();
   offer_answer_options_.offer_to_receive_audio = true;
   offer_answer_options_.offer_to_receive_video = true;
   configuration_.enable_dtls_srtp = true;
   configuration_.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
-  peer_connection_ = (factory_->CreatePeerConnection(configuration_, this))
-                         .get();
+  PooledPeerConnection pooled;
+  if (configuration_.receive_only && configuration_.peer_connection_pool &&
+      configuration_.peer_connection_pool->Take(this, &pooled)) {
+    RTC_LOG(LS_INFO) << "Use a PeerConnection from pool.";
+    factory_ = pooled.factory;
+    pooled_observer_ = std::move(pooled.observer);
+    peer_connection_ = pooled.peer_connection;
+  } else {
+    if (factory_.get() == nullptr) {
+      factory_ = configuration_.receive_only
+                     ? PeerConnectionDependencyFactory::GetNextShard()
+                     : PeerConnectionDependencyFactory::Get();
+    }
+    peer_connection_ =
+        (factory_->CreatePeerConnection(configuration_, this)).get();
+  }
   if (!peer_connection_.get()) {
     RTC_LOG(LS_ERROR) << "Failed to initialize PeerConnection.";
     RTC_DCHECK(false);
@@ -94,6 +115,13 @@ PeerConnectionChannel::LocalDescription() {
   RTC_CHECK(peer_connection_);
   return peer_connection_->local_description();
 }
+rtc::scoped_refptr<webrtc::PeerConnectionInterface>
+PeerConnectionChannel::GetPeerConnection() const {
+  return peer_connection_;
+}
+bool PeerConnectionChannel::IsPeerConnectionPooled() const {
+  return pooled_observer_ != nullptr;
+}
 PeerConnectionInterface::SignalingState PeerConnectionChannel::SignalingState()
     const {
   RTC_CHECK(peer_connection_);
@@ -117,9 +145,11 @@ void PeerConnectionChannel::OnMessage(rtc::Message* msg) {
           static_cast<rtc::TypedMessageData<
               scoped_refptr<FunctionalCreateSessionDescriptionObserver>>*>(
               msg->pdata);
-      peer_connection_->CreateOffer(
-          param->data(),
-          offer_answer_options_);
+      webrtc::PeerConnectionInterface::RTCOfferAnswerOptions options =
+          offer_answer_options_;
+      // ICE is restarted by one offer only.
+      options.ice_restart = restart_ice_in_next_offer_.exchange(false);
+      peer_connection_->CreateOffer(param->data(), options);
       delete param;
       break;
     }
@@ -149,44 +179,40 @@ void PeerConnectionChannel::OnMessage(rtc::Message* msg) {
     case kMessageTypeSetLocalDescription: {
       SetSessionDescriptionMessage* param =
           static_cast<SetSessionDescriptionMessage*>(msg->pdata);
-      // Set codec preference.
+      // PeerConnection takes the ownership of description.
       webrtc::SessionDescriptionInterface* desc = param->description;
-      std::string sdp_string;
-      if (!desc->ToString(&sdp_string)) {
-        RTC_LOG(LS_ERROR) << "Error parsing local description.";
-        RTC_DCHECK(false);
-      }
-      std::vector<AudioCodec> audio_codecs;
-      for (auto& audio_enc_param : configuration_.audio) {
-        audio_codecs.push_back(audio_enc_param.codec.name);
-      }
-      sdp_string = SdpUtils::SetPreferAudioCodecs(
-          sdp_string, audio_codecs);
-      std::vector<VideoCodec> video_codecs;
-      for (auto& video_enc_param : configuration_.video) {
-        video_codecs.push_back(video_enc_param.codec.name);
+      param->description = nullptr;
+      // Set codec preference. Description is parsed again only if it is
+      // changed, which is not the case for most renegotiations and ICE
+      // restarts.
+      if (!preferred_audio_codecs_.empty() ||
+          !preferred_video_codecs_.empty()) {
+        std::string sdp_string;
+        if (!desc->ToString(&sdp_string)) {
+          RTC_LOG(LS_ERROR) << "Error parsing local description.";
+          RTC_DCHECK(false);
+        }
+        std::string preferred_sdp = SdpUtils::SetPreferCodecs(
+            sdp_string, preferred_audio_codecs_, preferred_video_codecs_);
+        if (preferred_sdp != sdp_string) {
+          webrtc::SessionDescriptionInterface* new_desc(
+              webrtc::CreateSessionDescription(desc->type(), preferred_sdp,
+                                               nullptr));
+          delete desc;
+          desc = new_desc;
+        }
       }
-      sdp_string = SdpUtils::SetPreferVideoCodecs(
-          sdp_string, video_codecs);
-      webrtc::SessionDescriptionInterface* new_desc(
-          webrtc::CreateSessionDescription(desc->type(), sdp_string, nullptr));
-      peer_connection_->SetLocalDescription(param->observer, new_desc);
+      peer_connection_->SetLocalDescription(param->observer, desc);
       delete param;
       break;
     }
     case kMessageTypeSetRemoteDescription: {
       SetSessionDescriptionMessage* param =
           static_cast<SetSessionDescriptionMessage*>(msg->pdata);
-      // Set codec preference.
+      // PeerConnection takes the ownership of description.
       webrtc::SessionDescriptionInterface* desc = param->description;
-      std::string sdp_string;
-      if (!desc->ToString(&sdp_string)) {
-        RTC_LOG(LS_ERROR) << "Error parsing local description.";
-        RTC_DCHECK(false);
-      }
-      webrtc::SessionDescriptionInterface* new_desc(
-          webrtc::CreateSessionDescription(desc->type(), sdp_string, nullptr));
-      peer_connection_->SetRemoteDescription(param->observer, new_desc);
+      param->description = nullptr;
+      peer_connection_->SetRemoteDescription(param->observer, desc);
       delete param;
       break;
     }
@@ -304,10 +330,15 @@ void PeerConnectionChannel::OnIceConnectionChange(
     PeerConnectionInterface::IceConnectionState new_state) {}
 void PeerConnectionChannel::OnIceGatheringChange(
     PeerConnectionInterface::IceGatheringState new_state) {}
+void PeerConnectionChannel::RestartIceInNextOffer() {
+  restart_ice_in_next_offer_ = true;
+}
 void PeerConnectionChannel::OnNetworksChanged(){
   RTC_LOG(LS_INFO) << "PeerConnectionChannel::OnNetworksChanged.";
 }
 PeerConnectionChannelConfiguration::PeerConnectionChannelConfiguration()
-    : RTCConfiguration() {}
+    : RTCConfiguration(),
+      receive_only(false),
+      ice_restart_on_network_change(false) {}
 }
 }
@@ -3,10 +3,12 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef WOOGEEN_BASE_PEERCONNECTIONCHANNEL_H_
 #define WOOGEEN_BASE_PEERCONNECTIONCHANNEL_H_
+#include <atomic>
 #include <vector>
 #include "webrtc/rtc_base/messagehandler.h"
 #include "webrtc/rtc_base/third_party/sigslot/sigslot.h"
 #include "talk/owt/sdk/base/peerconnectiondependencyfactory.h"
+#include "talk/owt/sdk/base/peerconnectionpool.h"
 #include "talk/owt/sdk/base/mediaconstraintsimpl.h"
 #include "talk/owt/sdk/base/functionalobserver.h"
 #include "talk/owt/sdk/include/cpp/owt/base/commontypes.h"
@@ -55,6 +57,14 @@ struct PeerConnectionChannelConfiguration
   std::vector<AudioEncodingParameters> audio;
   /// Indicate whether this PeerConnection is used for sending encoded frame.
   bool encoded_video_frame_;
+  /// Indicate whether this PeerConnection only receives media. Such
+  /// PeerConnections are spread across factory shards.
+  bool receive_only;
+  /// Pool to take a receive only PeerConnection from. A PeerConnection is
+  /// created if it is nullptr or empty.
+  std::shared_ptr<PeerConnectionPool> peer_connection_pool;
+  /// Restart ICE when local addresses or routes change.
+  bool ice_restart_on_network_change;
 };
 class PeerConnectionChannel : public rtc::MessageHandler,
                               public webrtc::PeerConnectionObserver,
@@ -66,7 +76,12 @@ class PeerConnectionChannel : public rtc::MessageHandler,
   virtual ~PeerConnectionChannel();
   bool InitializePeerConnection();
   const webrtc::SessionDescriptionInterface* LocalDescription();
+  // Subclasses managing transceivers use it on |pc_thread_| or in
+  // PeerConnectionObserver callbacks.
+  rtc::scoped_refptr<webrtc::PeerConnectionInterface> GetPeerConnection() const;
   PeerConnectionInterface::SignalingState SignalingState() const;
+  // Returns true if the PeerConnection is taken from a PeerConnectionPool.
+  bool IsPeerConnectionPooled() const;
   // Apply the bitrate settings on all tracks available. Failing to set any of them
   // will result in a false return, with remaining settings applicable still applied.
   // Subclasses can override this to implementation specific bitrate allocation policies.
@@ -109,7 +124,9 @@ class PeerConnectionChannel : public rtc::MessageHandler,
   virtual void OnSetLocalSessionDescriptionFailure(const std::string& error);
   virtual void OnSetRemoteSessionDescriptionSuccess();
   virtual void OnSetRemoteSessionDescriptionFailure(const std::string& error);
-  // Fired when networks changed. (Only works on iOS)
+  // The next offer created restarts ICE.
+  void RestartIceInNextOffer();
+  // Fired when networks changed. (Only works on iOS and Linux)
   virtual void OnNetworksChanged();
   enum MessageType : int {
     kMessageTypeCreateOffer = 101,
@@ -141,7 +158,15 @@ class PeerConnectionChannel : public rtc::MessageHandler,
   // |factory_| is got from PeerConnectionDependencyFactory::Get() which is
   // shared among all PeerConnectionChannels.
   rtc::scoped_refptr<PeerConnectionDependencyFactory> factory_;
+  // Observer of a pooled |peer_connection_|, which forwards events to this
+  // channel. Declared before |peer_connection_| to outlive it.
+  std::unique_ptr<ForwardingPeerConnectionObserver> pooled_observer_;
   rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection_;
+  // Codecs in the order of preference, got from |configuration_| once. Local
+  // descriptions are not rewritten if both are empty.
+  std::vector<AudioCodec> preferred_audio_codecs_;
+  std::vector<VideoCodec> preferred_video_codecs_;
+  std::atomic<bool> restart_ice_in_next_offer_;
 };
 }
 }
@@ -2,7 +2,18 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 #include <iostream>
+#include <thread>
+#if defined(WEBRTC_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(WEBRTC_IOS)
+#include <pthread.h>
+#endif
 #include "talk/owt/sdk/base/customizedaudiodevicemodule.h"
+#include "talk/owt/sdk/base/customizedaudioframewriter.h"
 #include "talk/owt/sdk/base/encodedvideoencoderfactory.h"
 #include "talk/owt/sdk/base/peerconnectiondependencyfactory.h"
 #include "webrtc/api/audio_codecs/builtin_audio_decoder_factory.h"
@@ -25,6 +36,9 @@
 #if defined(WEBRTC_LINUX) || defined(WEBRTC_WIN)
 #include "talk/owt/sdk/base/customizedvideodecoderfactory.h"
 #endif
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+#include "talk/owt/sdk/base/linux/networkmonitorlinux.h"
+#endif
 #include "owt/base/clientconfiguration.h"
 #include "owt/base/globalconfiguration.h"
 using namespace rtc;
@@ -38,12 +52,81 @@ PeerConnectionThread::~PeerConnectionThread() {
   RTC_LOG(LS_INFO) << "Quit a PeerConnectionThread.";
   Stop();
 }
-rtc::scoped_refptr<PeerConnectionDependencyFactory>
-    PeerConnectionDependencyFactory::dependency_factory_;
+// Binds current thread to |cpu| if it is not negative, and applies
+// |priority|. Failures are logged as they are not fatal.
+static void ApplyThreadSettings(const std::string& name,
+                                int cpu,
+                                ThreadPriority priority) {
+#if defined(WEBRTC_LINUX)
+  if (cpu >= 0) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)) {
+      RTC_LOG(LS_WARNING) << "Failed to bind " << name << " to CPU " << cpu;
+    }
+  }
+  if (priority == ThreadPriority::kRealtime) {
+    sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+      RTC_LOG(LS_WARNING) << "Failed to set realtime priority for " << name;
+    }
+  } else if (priority != ThreadPriority::kNormal) {
+    // Nice value applies to a single thread on Linux.
+    int nice_value = priority == ThreadPriority::kHigh ? -10 : 10;
+    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice_value)) {
+      RTC_LOG(LS_WARNING) << "Failed to set priority for " << name;
+    }
+  }
+#elif defined(WEBRTC_WIN)
+  if (cpu >= 0 && cpu < 64) {
+    if (!SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu)) {
+      RTC_LOG(LS_WARNING) << "Failed to bind " << name << " to CPU " << cpu;
+    }
+  }
+  int win_priority = THREAD_PRIORITY_NORMAL;
+  if (priority == ThreadPriority::kLow)
+    win_priority = THREAD_PRIORITY_BELOW_NORMAL;
+  else if (priority == ThreadPriority::kHigh)
+    win_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+  else if (priority == ThreadPriority::kRealtime)
+    win_priority = THREAD_PRIORITY_TIME_CRITICAL;
+  if (!SetThreadPriority(GetCurrentThread(), win_priority)) {
+    RTC_LOG(LS_WARNING) << "Failed to set priority for " << name;
+  }
+#elif defined(WEBRTC_IOS)
+  // Thread affinity is not available on iOS.
+  qos_class_t qos_class = QOS_CLASS_DEFAULT;
+  if (priority == ThreadPriority::kLow)
+    qos_class = QOS_CLASS_UTILITY;
+  else if (priority == ThreadPriority::kHigh)
+    qos_class = QOS_CLASS_USER_INITIATED;
+  else if (priority == ThreadPriority::kRealtime)
+    qos_class = QOS_CLASS_USER_INTERACTIVE;
+  if (pthread_set_qos_class_self_np(qos_class, 0)) {
+    RTC_LOG(LS_WARNING) << "Failed to set priority for " << name;
+  }
+#endif
+}
+// Returns the CPU for thread of |shard_index|, or -1 for any CPU.
+static int ShardCpu(const std::vector<int>& cpus, int shard_index) {
+  if (cpus.empty())
+    return -1;
+  return cpus[shard_index % cpus.size()];
+}
+PeerConnectionDependencyFactory*
+    PeerConnectionDependencyFactory::dependency_factory_ = nullptr;
+std::vector<PeerConnectionDependencyFactory*>
+    PeerConnectionDependencyFactory::shards_;
+size_t PeerConnectionDependencyFactory::next_shard_ = 0;
+int PeerConnectionDependencyFactory::shard_users_ = 0;
 std::mutex PeerConnectionDependencyFactory::get_pc_dependency_factory_mutex_;
-PeerConnectionDependencyFactory::PeerConnectionDependencyFactory()
+PeerConnectionDependencyFactory::PeerConnectionDependencyFactory(
+    int shard_index)
     : pc_thread_(new PeerConnectionThread),
       callback_thread_(new PeerConnectionThread),
+      shard_index_(shard_index),
       field_trial_("WebRTC-H264HighProfile/Enabled/") {
 #if defined(WEBRTC_WIN)
   if (GlobalConfiguration::GetVideoHardwareAccelerationEnabled()) {
@@ -58,7 +141,33 @@ PeerConnectionDependencyFactory::PeerConnectionDependencyFactory()
   encoded_frame_ = GlobalConfiguration::GetEncodedVideoFrameEnabled();
   pc_thread_->Start();
 }
-PeerConnectionDependencyFactory::~PeerConnectionDependencyFactory() {}
+// Factory and threads of a destroyed shard. Factory is released first, as
+// members are destroyed in reverse order.
+struct ShardResources {
+  std::unique_ptr<rtc::Thread> pc_thread;
+  std::unique_ptr<rtc::Thread> callback_thread;
+  std::unique_ptr<rtc::Thread> signaling_thread;
+  std::unique_ptr<rtc::Thread> worker_thread;
+  std::unique_ptr<rtc::Thread> network_thread;
+  scoped_refptr<PeerConnectionFactoryInterface> pc_factory;
+};
+// The first shard is never destroyed. Other shards are destroyed after the
+// last ReleaseShards() once PeerConnections created by them are closed. The
+// last reference may be released on one of the shard's threads, so they are
+// stopped on a new thread.
+PeerConnectionDependencyFactory::~PeerConnectionDependencyFactory() {
+  RTC_DCHECK_GT(shard_index_, 0);
+  RTC_LOG(LS_INFO) << "Destroy factory shard " << shard_index_;
+  ShardResources* resources = new ShardResources;
+  resources->pc_thread.reset(pc_thread_);
+  resources->callback_thread.reset(callback_thread_);
+  resources->signaling_thread = std::move(signaling_thread_);
+  resources->worker_thread = std::move(worker_thread_);
+  resources->network_thread = std::move(network_thread_);
+  resources->pc_factory = pc_factory_;
+  pc_factory_ = nullptr;
+  std::thread([resources]() { delete resources; }).detach();
+}
 rtc::scoped_refptr<webrtc::PeerConnectionInterface>
 PeerConnectionDependencyFactory::CreatePeerConnection(
     const webrtc::PeerConnectionInterface::RTCConfiguration& config,
@@ -72,12 +181,62 @@ PeerConnectionDependencyFactory::CreatePeerConnection(
 }
 PeerConnectionDependencyFactory* PeerConnectionDependencyFactory::Get() {
   std::lock_guard<std::mutex> lock(get_pc_dependency_factory_mutex_);
-  if (!dependency_factory_.get()) {
-    dependency_factory_ =
-        new rtc::RefCountedObject<PeerConnectionDependencyFactory>();
-    dependency_factory_->CreatePeerConnectionFactory();
+  if (!dependency_factory_) {
+    dependency_factory_ = CreateShard(0).release();
+  }
+  return dependency_factory_;
+}
+PeerConnectionDependencyFactory*
+PeerConnectionDependencyFactory::GetNextShard() {
+  const int shard_count =
+      GlobalConfiguration::GetThreadingSettings().factory_shards;
+  if (shard_count <= 1 ||
+      GlobalConfiguration::GetCustomizedAudioInputEnabled() ||
+      GlobalConfiguration::GetCustomizedAudioOutputEnabled() ||
+      GlobalConfiguration::GetCustomizedVideoDecoderEnabled()) {
+    return Get();
+  }
+  size_t shard_index;
+  {
+    std::lock_guard<std::mutex> lock(get_pc_dependency_factory_mutex_);
+    shard_index = next_shard_;
+    next_shard_ = (next_shard_ + 1) % shard_count;
+    if (shard_index > 0) {
+      if (shards_.size() < shard_index)
+        shards_.resize(shard_index, nullptr);
+      if (!shards_[shard_index - 1])
+        shards_[shard_index - 1] = CreateShard(shard_index).release();
+      return shards_[shard_index - 1];
+    }
+  }
+  return Get();
+}
+void PeerConnectionDependencyFactory::RetainShards() {
+  std::lock_guard<std::mutex> lock(get_pc_dependency_factory_mutex_);
+  shard_users_++;
+}
+void PeerConnectionDependencyFactory::ReleaseShards() {
+  std::vector<PeerConnectionDependencyFactory*> shards;
+  {
+    std::lock_guard<std::mutex> lock(get_pc_dependency_factory_mutex_);
+    RTC_DCHECK_GT(shard_users_, 0);
+    if (--shard_users_ > 0)
+      return;
+    shards.swap(shards_);
+    next_shard_ = 0;
+  }
+  // Shards not used by any PeerConnection are destroyed here, out of lock.
+  for (auto* shard : shards) {
+    if (shard)
+      shard->Release();
   }
-  return dependency_factory_.get();
+}
+rtc::scoped_refptr<PeerConnectionDependencyFactory>
+PeerConnectionDependencyFactory::CreateShard(int shard_index) {
+  rtc::scoped_refptr<PeerConnectionDependencyFactory> factory =
+      new rtc::RefCountedObject<PeerConnectionDependencyFactory>(shard_index);
+  factory->CreatePeerConnectionFactory();
+  return factory;
 }
 const scoped_refptr<PeerConnectionFactoryInterface>&
 PeerConnectionDependencyFactory::GetPeerConnectionFactory() {
@@ -89,25 +248,45 @@ PeerConnectionDependencyFactory::GetPeerConnectionFactory() {
 void PeerConnectionDependencyFactory::
     CreatePeerConnectionFactoryOnCurrentThread() {
   RTC_LOG(LS_INFO) << "CreatePeerConnectionOnCurrentThread";
-  if (GlobalConfiguration::GetAECEnabled()
-      && GlobalConfiguration::GetAEC3Enabled()) {
-    field_trial_ += "OWT-EchoCanceller3/Enabled/";
-  }
-  webrtc::field_trial::InitFieldTrialsFromString(field_trial_.c_str());
-  if (!rtc::InitializeSSL()) {
-    RTC_LOG(LS_ERROR) << "Failed to initialize SSL.";
-    RTC_NOTREACHED();
-    return;
+  // Field trials and SSL are process wide.
+  if (shard_index_ == 0) {
+    if (GlobalConfiguration::GetAECEnabled() &&
+        GlobalConfiguration::GetAEC3Enabled()) {
+      field_trial_ += "OWT-EchoCanceller3/Enabled/";
+    }
+    webrtc::field_trial::InitFieldTrialsFromString(field_trial_.c_str());
+    if (!rtc::InitializeSSL()) {
+      RTC_LOG(LS_ERROR) << "Failed to initialize SSL.";
+      RTC_NOTREACHED();
+      return;
+    }
   }
-  rtc::Thread* worker_thread = new rtc::Thread();
-  worker_thread->SetName("worker_thread", nullptr);
-  rtc::Thread* signaling_thread = new rtc::Thread();
-  signaling_thread->SetName("signaling_thread", nullptr);
-  rtc::Thread* network_thread = new rtc::Thread();
-  network_thread->SetName("network_thread", nullptr);
+  const std::string name_suffix =
+      shard_index_ == 0 ? "" : "_" + std::to_string(shard_index_);
+  worker_thread_.reset(new rtc::Thread());
+  rtc::Thread* worker_thread = worker_thread_.get();
+  worker_thread->SetName("worker_thread" + name_suffix, nullptr);
+  signaling_thread_.reset(new rtc::Thread());
+  rtc::Thread* signaling_thread = signaling_thread_.get();
+  signaling_thread->SetName("signaling_thread" + name_suffix, nullptr);
+  network_thread_.reset(new rtc::Thread());
+  rtc::Thread* network_thread = network_thread_.get();
+  network_thread->SetName("network_thread" + name_suffix, nullptr);
   RTC_CHECK(worker_thread->Start() && signaling_thread->Start() &&
             network_thread->Start())
       << "Failed to start threads";
+  const PeerConnectionThreadingSettings& threading =
+      GlobalConfiguration::GetThreadingSettings();
+  const int worker_cpu = ShardCpu(threading.worker_thread_cpus, shard_index_);
+  const ThreadPriority worker_priority = threading.worker_thread_priority;
+  worker_thread->Invoke<void>(RTC_FROM_HERE, [&] {
+    ApplyThreadSettings(worker_thread->name(), worker_cpu, worker_priority);
+  });
+  const int network_cpu = ShardCpu(threading.network_thread_cpus, shard_index_);
+  const ThreadPriority network_priority = threading.network_thread_priority;
+  network_thread->Invoke<void>(RTC_FROM_HERE, [&] {
+    ApplyThreadSettings(network_thread->name(), network_cpu, network_priority);
+  });
 #if defined(WEBRTC_IOS)
   // Use webrtc::VideoEn(De)coderFactory on iOS.
   std::unique_ptr<VideoEncoderFactory> encoder_factory;
@@ -140,9 +319,11 @@ void PeerConnectionDependencyFactory::
 #endif
   // Raw audio frame
   // if adm is nullptr, voe_base will initilize it with the default internal
-  // adm.
+  // adm. Other shards are not used when customized audio is enabled.
   rtc::scoped_refptr<AudioDeviceModule> adm;
-  if (GlobalConfiguration::GetCustomizedAudioInputEnabled()) {
+  if (shard_index_ == 0 &&
+      (GlobalConfiguration::GetCustomizedAudioInputEnabled() ||
+       GlobalConfiguration::GetCustomizedAudioOutputEnabled())) {
     // Create ADM on worker thred as RegisterAudioCallback is invoked there.
     adm = worker_thread->Invoke<rtc::scoped_refptr<AudioDeviceModule>>(
                RTC_FROM_HERE,
@@ -279,7 +460,7 @@ PeerConnectionDependencyFactory::PeerConnectionFactory() const {
   return pc_factory_;
 }
 rtc::NetworkMonitorInterface* PeerConnectionDependencyFactory::NetworkMonitor(){
-#if defined(WEBRTC_IOS)
+#if defined(WEBRTC_IOS) || (defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID))
   pc_thread_->Invoke<void>(
       RTC_FROM_HERE,
       Bind(
@@ -296,12 +477,33 @@ void PeerConnectionDependencyFactory::CreateNetworkMonitorOnCurrentThread() {
      network_monitor_ = new NetworkMonitorIos();
      network_monitor_->Start();
   }
+#elif defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (!network_monitor_) {
+    network_monitor_ = new NetworkMonitorLinux();
+    network_monitor_->Start();
+  }
 #endif
 }
 scoped_refptr<webrtc::AudioDeviceModule>
 PeerConnectionDependencyFactory::CreateCustomizedAudioDeviceModuleOnCurrentThread() {
-  return CustomizedAudioDeviceModule::Create(
-     GlobalConfiguration::GetAudioFrameGenerator());
+  scoped_refptr<webrtc::AudioDeviceModule> adm;
+  if (GlobalConfiguration::GetAudioFrameWriter()) {
+    // Only created by EnableCustomizedAudioPushInput.
+    adm = CustomizedAudioDeviceModule::Create(
+        std::static_pointer_cast<CustomizedAudioFrameWriter>(
+            GlobalConfiguration::GetAudioFrameWriter()),
+        GlobalConfiguration::GetAudioFrameSink());
+  } else {
+    adm = CustomizedAudioDeviceModule::Create(
+        GlobalConfiguration::GetAudioFrameGenerator(),
+        GlobalConfiguration::GetAudioFrameSink());
+  }
+  if (adm && GlobalConfiguration::GetAudioLevelObserver()) {
+    static_cast<CustomizedAudioDeviceModule*>(adm.get())
+        ->SetAudioLevelObserver(GlobalConfiguration::GetAudioLevelObserver(),
+                                GlobalConfiguration::GetAudioLevelIntervalMs());
+  }
+  return adm;
 }
 }
 }
@@ -3,7 +3,9 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef OWT_BASE_PEERCONNECTIONDEPENDENCYFACTORY_H_
 #define OWT_BASE_PEERCONNECTIONDEPENDENCYFACTORY_H_
+#include <memory>
 #include <mutex>
+#include <vector>
 #include "webrtc/api/peerconnectioninterface.h"
 #include "webrtc/api/mediastreaminterface.h"
 #include "webrtc/rtc_base/bind.h"
@@ -31,8 +33,19 @@ class PeerConnectionThread : public rtc::Thread {
 class PeerConnectionDependencyFactory : public rtc::RefCountInterface {
  public:
   // Get a PeerConnectionDependencyFactory instance. It doesn't create a new
-  // instance. It always return the same instance.
+  // instance. It always return the same instance, which is the first shard.
   static PeerConnectionDependencyFactory* Get();
+  // Get factory shards in turn. Only PeerConnections which don't send local
+  // streams can be created by shards other than the first one, because local
+  // tracks are created by the first shard. It always returns the first shard
+  // if customized audio or customized video decoder is enabled, as they only
+  // apply to the first shard.
+  static PeerConnectionDependencyFactory* GetNextShard();
+  // Shards other than the first one are kept while they are retained, e.g. by
+  // a ConferenceClient during its lifetime. After the last release, a shard
+  // is destroyed once PeerConnections created by it are closed.
+  static void RetainShards();
+  static void ReleaseShards();
   rtc::scoped_refptr<webrtc::PeerConnectionInterface> CreatePeerConnection(
       const webrtc::PeerConnectionInterface::RTCConfiguration& config,
       webrtc::PeerConnectionObserver* observer);
@@ -58,12 +71,15 @@ class PeerConnectionDependencyFactory : public rtc::RefCountInterface {
       const;
   ~PeerConnectionDependencyFactory();
  protected:
-  explicit PeerConnectionDependencyFactory();
+  explicit PeerConnectionDependencyFactory(int shard_index = 0);
   virtual const rtc::scoped_refptr<PeerConnectionFactoryInterface>&
   GetPeerConnectionFactory();
  private:
   // Create a PeerConnectionDependencyFactory instance.
   // static rtc::scoped_refptr<PeerConnectionDependencyFactory> Create();
+  // Create and initialize shard |shard_index|.
+  static rtc::scoped_refptr<PeerConnectionDependencyFactory> CreateShard(
+      int shard_index);
   void CreatePeerConnectionFactory();
   void CreatePeerConnectionFactoryOnCurrentThread();
   rtc::scoped_refptr<webrtc::PeerConnectionInterface>
@@ -73,8 +89,19 @@ class PeerConnectionDependencyFactory : public rtc::RefCountInterface {
   void CreateNetworkMonitorOnCurrentThread();
   rtc::scoped_refptr<webrtc::AudioDeviceModule> CreateCustomizedAudioDeviceModuleOnCurrentThread();
   scoped_refptr<PeerConnectionFactoryInterface> pc_factory_;
-  static scoped_refptr<PeerConnectionDependencyFactory>
-      dependency_factory_;  // Get() always return this instance.
+  // Get() always return this instance. It is never released.
+  static PeerConnectionDependencyFactory* dependency_factory_;
+  // Shards other than |dependency_factory_|, created on demand. Each holds a
+  // reference released by the last ReleaseShards(). Raw pointers are used so
+  // static destruction at exit does not release them.
+  static std::vector<PeerConnectionDependencyFactory*> shards_;
+  static size_t next_shard_;
+  static int shard_users_;
+  int shard_index_;
+  // Threads of |pc_factory_|. Created on |pc_thread_|.
+  std::unique_ptr<rtc::Thread> worker_thread_;
+  std::unique_ptr<rtc::Thread> signaling_thread_;
+  std::unique_ptr<rtc::Thread> network_thread_;
   Thread*
       pc_thread_;  // This thread performs all operations on pcfactory and pc.
   Thread* callback_thread_;  // This thread performs all callbacks.
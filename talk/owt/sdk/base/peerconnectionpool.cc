@@ -0,0 +1,171 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/peerconnectionpool.h"
+#include "webrtc/rtc_base/logging.h"
+namespace owt {
+namespace base {
+ForwardingPeerConnectionObserver::ForwardingPeerConnectionObserver()
+    : observer_(nullptr) {}
+void ForwardingPeerConnectionObserver::SetObserver(
+    webrtc::PeerConnectionObserver* observer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  observer_ = observer;
+}
+webrtc::PeerConnectionObserver* ForwardingPeerConnectionObserver::Observer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return observer_;
+}
+void ForwardingPeerConnectionObserver::OnSignalingChange(
+    webrtc::PeerConnectionInterface::SignalingState new_state) {
+  if (auto observer = Observer())
+    observer->OnSignalingChange(new_state);
+}
+void ForwardingPeerConnectionObserver::OnAddStream(
+    rtc::scoped_refptr<webrtc::MediaStreamInterface> stream) {
+  if (auto observer = Observer())
+    observer->OnAddStream(stream);
+}
+void ForwardingPeerConnectionObserver::OnRemoveStream(
+    rtc::scoped_refptr<webrtc::MediaStreamInterface> stream) {
+  if (auto observer = Observer())
+    observer->OnRemoveStream(stream);
+}
+void ForwardingPeerConnectionObserver::OnDataChannel(
+    rtc::scoped_refptr<webrtc::DataChannelInterface> data_channel) {
+  if (auto observer = Observer())
+    observer->OnDataChannel(data_channel);
+}
+void ForwardingPeerConnectionObserver::OnRenegotiationNeeded() {
+  if (auto observer = Observer())
+    observer->OnRenegotiationNeeded();
+}
+void ForwardingPeerConnectionObserver::OnIceConnectionChange(
+    webrtc::PeerConnectionInterface::IceConnectionState new_state) {
+  if (auto observer = Observer())
+    observer->OnIceConnectionChange(new_state);
+}
+void ForwardingPeerConnectionObserver::OnIceGatheringChange(
+    webrtc::PeerConnectionInterface::IceGatheringState new_state) {
+  if (auto observer = Observer())
+    observer->OnIceGatheringChange(new_state);
+}
+void ForwardingPeerConnectionObserver::OnIceCandidate(
+    const webrtc::IceCandidateInterface* candidate) {
+  if (auto observer = Observer())
+    observer->OnIceCandidate(candidate);
+}
+void ForwardingPeerConnectionObserver::OnIceCandidatesRemoved(
+    const std::vector<cricket::Candidate>& candidates) {
+  if (auto observer = Observer())
+    observer->OnIceCandidatesRemoved(candidates);
+}
+PeerConnectionPool::PeerConnectionPool(
+    const webrtc::PeerConnectionInterface::RTCConfiguration& configuration,
+    size_t low_watermark,
+    size_t high_watermark)
+    : configuration_(configuration),
+      low_watermark_(low_watermark),
+      high_watermark_(high_watermark),
+      filling_(false),
+      stopped_(false),
+      queue_(new rtc::TaskQueue("PeerConnectionPoolQueue")) {
+  configuration_.enable_dtls_srtp = true;
+  configuration_.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
+  // Gather candidates before the PeerConnection is taken.
+  if (configuration_.ice_candidate_pool_size == 0)
+    configuration_.ice_candidate_pool_size = 1;
+}
+PeerConnectionPool::~PeerConnectionPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  queue_.reset();
+  for (auto& pooled : peer_connections_) {
+    pooled.peer_connection->Close();
+  }
+}
+void PeerConnectionPool::Start() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = false;
+    if (filling_ || peer_connections_.size() >= high_watermark_)
+      return;
+    filling_ = true;
+  }
+  queue_->PostTask([this] { Fill(); });
+}
+void PeerConnectionPool::Drain() {
+  std::deque<PooledPeerConnection> peer_connections;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    std::swap(peer_connections, peer_connections_);
+  }
+  for (auto& pooled : peer_connections) {
+    pooled.peer_connection->Close();
+  }
+}
+bool PeerConnectionPool::Take(webrtc::PeerConnectionObserver* observer,
+                              PooledPeerConnection* pooled) {
+  RTC_CHECK(pooled);
+  bool refill = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (peer_connections_.empty()) {
+      refill = !filling_;
+      filling_ = true;
+    } else {
+      *pooled = std::move(peer_connections_.front());
+      peer_connections_.pop_front();
+      if (peer_connections_.size() < low_watermark_ && !filling_) {
+        refill = true;
+        filling_ = true;
+      }
+    }
+  }
+  if (refill)
+    queue_->PostTask([this] { Fill(); });
+  if (!pooled->peer_connection)
+    return false;
+  pooled->observer->SetObserver(observer);
+  return true;
+}
+size_t PeerConnectionPool::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return peer_connections_.size();
+}
+void PeerConnectionPool::Fill() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_ || peer_connections_.size() >= high_watermark_) {
+        filling_ = false;
+        return;
+      }
+    }
+    PooledPeerConnection pooled;
+    pooled.factory = PeerConnectionDependencyFactory::GetNextShard();
+    pooled.observer.reset(new ForwardingPeerConnectionObserver());
+    pooled.peer_connection = pooled.factory->CreatePeerConnection(
+        configuration_, pooled.observer.get());
+    if (!pooled.peer_connection) {
+      RTC_LOG(LS_ERROR) << "Failed to create PeerConnection for pool.";
+      std::lock_guard<std::mutex> lock(mutex_);
+      filling_ = false;
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopped_) {
+      // Drained while it was being created.
+      filling_ = false;
+      lock.unlock();
+      pooled.peer_connection->Close();
+      return;
+    }
+    peer_connections_.push_back(std::move(pooled));
+  }
+}
+}  // namespace base
+}  // namespace owt
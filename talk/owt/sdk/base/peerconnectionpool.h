@@ -0,0 +1,88 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_PEERCONNECTIONPOOL_H_
+#define OWT_BASE_PEERCONNECTIONPOOL_H_
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "talk/owt/sdk/base/peerconnectiondependencyfactory.h"
+#include "webrtc/rtc_base/task_queue.h"
+namespace owt {
+namespace base {
+// Forwards PeerConnection events to an observer set after the PeerConnection
+// is created. Events before the observer is set are dropped.
+class ForwardingPeerConnectionObserver : public webrtc::PeerConnectionObserver {
+ public:
+  ForwardingPeerConnectionObserver();
+  void SetObserver(webrtc::PeerConnectionObserver* observer);
+  // PeerConnectionObserver
+  void OnSignalingChange(
+      webrtc::PeerConnectionInterface::SignalingState new_state) override;
+  void OnAddStream(
+      rtc::scoped_refptr<webrtc::MediaStreamInterface> stream) override;
+  void OnRemoveStream(
+      rtc::scoped_refptr<webrtc::MediaStreamInterface> stream) override;
+  void OnDataChannel(
+      rtc::scoped_refptr<webrtc::DataChannelInterface> data_channel) override;
+  void OnRenegotiationNeeded() override;
+  void OnIceConnectionChange(
+      webrtc::PeerConnectionInterface::IceConnectionState new_state) override;
+  void OnIceGatheringChange(
+      webrtc::PeerConnectionInterface::IceGatheringState new_state) override;
+  void OnIceCandidate(const webrtc::IceCandidateInterface* candidate) override;
+  void OnIceCandidatesRemoved(
+      const std::vector<cricket::Candidate>& candidates) override;
+ private:
+  webrtc::PeerConnectionObserver* Observer();
+  std::mutex mutex_;
+  webrtc::PeerConnectionObserver* observer_;
+};
+// A PeerConnection taken from PeerConnectionPool. |observer| must outlive
+// |peer_connection|.
+struct PooledPeerConnection {
+  rtc::scoped_refptr<PeerConnectionDependencyFactory> factory;
+  rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection;
+  std::unique_ptr<ForwardingPeerConnectionObserver> observer;
+};
+// Creates PeerConnections ahead of demand, so a new PeerConnectionChannel
+// doesn't wait for PeerConnection creation and ICE gathering. PeerConnections
+// are created with ICE candidate pool, so candidates are gathered before they
+// are taken. The pool is refilled to |high_watermark| in background when it
+// drops below |low_watermark|.
+//
+// PeerConnections are receive only, see
+// PeerConnectionChannelConfiguration::receive_only.
+class PeerConnectionPool {
+ public:
+  PeerConnectionPool(
+      const webrtc::PeerConnectionInterface::RTCConfiguration& configuration,
+      size_t low_watermark,
+      size_t high_watermark);
+  ~PeerConnectionPool();
+  // Starts filling the pool.
+  void Start();
+  // Stops filling the pool and closes idle PeerConnections. Start fills it
+  // again.
+  void Drain();
+  // Takes a PeerConnection and sets |observer| as its observer. Returns false
+  // if the pool is empty.
+  bool Take(webrtc::PeerConnectionObserver* observer,
+            PooledPeerConnection* pooled);
+  size_t Size() const;
+ private:
+  // Runs on |queue_|.
+  void Fill();
+  webrtc::PeerConnectionInterface::RTCConfiguration configuration_;
+  const size_t low_watermark_;
+  const size_t high_watermark_;
+  mutable std::mutex mutex_;
+  std::deque<PooledPeerConnection> peer_connections_;
+  bool filling_;
+  bool stopped_;
+  // Declared last, so tasks are stopped before other members are destroyed.
+  std::unique_ptr<rtc::TaskQueue> queue_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_PEERCONNECTIONPOOL_H_
@@ -1,10 +1,12 @@
 // Copyright (C) <2018> Intel Corporation
 //
 // SPDX-License-Identifier: Apache-2.0
-#include <regex>
-#include <sstream>
-#include <vector>
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "talk/owt/sdk/base/sdputils.h"
 #include "webrtc/rtc_base/logging.h"
 using namespace rtc;
@@ -22,189 +24,249 @@ static const std::unordered_map<VideoCodec, const std::string, EnumClassHash>
                          {VideoCodec::kH264, "H264"},
                          {VideoCodec::kVp9, "VP9"},
                          {VideoCodec::kH265, "H265"}};
-std::string SdpUtils::SetPreferAudioCodecs(const std::string& original_sdp,
-                                          std::vector<AudioCodec>& codec) {
-  std::string cur_sdp(original_sdp);
-  if (codec.size() == 0)
-    return cur_sdp;
-  std::vector<AudioCodec> rcodecs(codec.rbegin(), codec.rend());
-  std::vector<std::string> codec_names;
-  for (auto codec_current : rcodecs) {
-    auto codec_it = audio_codec_names.find(codec_current);
-    if (codec_it == audio_codec_names.end()) {
-      RTC_LOG(LS_WARNING) << "Preferred audio codec is not available.";
-      continue;
-    }
-    codec_names.push_back(codec_it->second);
+namespace {
+// A line of SDP. Its content is [begin, end), followed by line break
+// [end, next).
+struct SdpLine {
+  size_t begin;
+  size_t end;
+  size_t next;
+};
+std::vector<SdpLine> SplitLines(const std::string& sdp) {
+  std::vector<SdpLine> lines;
+  size_t begin = 0;
+  while (begin < sdp.size()) {
+    size_t next = sdp.find('\n', begin);
+    next = (next == std::string::npos) ? sdp.size() : next + 1;
+    size_t end = next;
+    if (end > begin && sdp[end - 1] == '\n')
+      end--;
+    if (end > begin && sdp[end - 1] == '\r')
+      end--;
+    lines.push_back({begin, end, next});
+    begin = next;
   }
-  cur_sdp = SdpUtils::SetPreferCodecs(cur_sdp, codec_names, true);
-  return cur_sdp;
+  return lines;
 }
-std::string SdpUtils::SetPreferVideoCodecs(const std::string& original_sdp,
-                                          std::vector<VideoCodec>& codec) {
-  std::string cur_sdp(original_sdp);
-  if (codec.size() == 0)
-    return cur_sdp;
-  std::vector<VideoCodec> rcodecs(codec.rbegin(), codec.rend());
-  std::vector<std::string> codec_names;
-  for (auto codec_current : rcodecs) {
-    auto codec_it = video_codec_names.find(codec_current);
-    if (codec_it == video_codec_names.end()) {
-      RTC_LOG(LS_WARNING) << "Preferred video codec is not available.";
+bool StartsWith(const std::string& sdp,
+                const SdpLine& line,
+                const char* prefix,
+                size_t prefix_length) {
+  return line.end - line.begin >= prefix_length &&
+         sdp.compare(line.begin, prefix_length, prefix) == 0;
+}
+// Attributes with a payload type, in the same order as kPayloadAttributes.
+enum PayloadAttribute { kRtpmap = 0, kFmtp, kRtcpFb };
+const char* const kPayloadAttributes[] = {"a=rtpmap:", "a=fmtp:",
+                                          "a=rtcp-fb:"};
+// Returns the payload type of an "a=rtpmap:", "a=fmtp:" or "a=rtcp-fb:" line,
+// and sets |*attribute| and |*value| to the attribute and the offset of the
+// rest of the line. Returns an empty string for other lines.
+std::string PayloadType(const std::string& sdp,
+                        const SdpLine& line,
+                        PayloadAttribute* attribute,
+                        size_t* value) {
+  for (int i = kRtpmap; i <= kRtcpFb; i++) {
+    const size_t length = strlen(kPayloadAttributes[i]);
+    if (!StartsWith(sdp, line, kPayloadAttributes[i], length))
       continue;
-    }
-    codec_names.push_back(codec_it->second);
+    size_t space = sdp.find(' ', line.begin + length);
+    if (space == std::string::npos || space >= line.end)
+      return std::string();
+    *attribute = static_cast<PayloadAttribute>(i);
+    *value = space + 1;
+    return sdp.substr(line.begin + length, space - line.begin - length);
   }
-  cur_sdp = SdpUtils::SetPreferCodecs(cur_sdp, codec_names, false);
-  return cur_sdp;
+  return std::string();
 }
-std::vector<std::string> SdpUtils::GetCodecValues(const std::string& sdp,
-    std::string& codec_name,
-    bool is_audio) {
-  std::vector<std::string> codec_values;
-  std::string sdp_current(sdp);
-  std::regex reg_rtp_map(
-      "a=rtpmap:(\\d+) " + codec_name + "\\/\\d+(?=[\r]?[\n]?)",
-      std::regex_constants::icase);
-  std::smatch rtp_map_match;
-  while (std::regex_search(sdp_current, rtp_map_match, reg_rtp_map)) {
-    codec_values.push_back(rtp_map_match[1]);
-    sdp_current = rtp_map_match.suffix();
-  }
-  return codec_values;
+bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return ::tolower(static_cast<unsigned char>(x)) ==
+                  ::tolower(static_cast<unsigned char>(y));
+         });
 }
-// Remove non-prefer codecs out of the list. Keeping red and ulpfec,
-// assuming the binding to original codec is out-of-bound.
-// Keeping corresponding rtx payloads. Reorder m-line according to
-// the reverse order of input codec names.
-// TODO: unify to std::regex impl for Linux builds.
-std::string SdpUtils::SetPreferCodecs(const std::string& sdp,
-    std::vector<std::string>& codec_names,
-    bool is_audio) {
-  // Search all rtx maps in the sdp.
-  std::regex reg_fmtp_apt(
-      "a=fmtp:(\\d+) apt=(\\d+)(?=[\r]?[\n]?)",
-      std::regex_constants::icase);
-  std::smatch rtx_map_match;
-  // Key is the rtx payload type, value is the original payload type.
-  std::unordered_map<std::string, std::string> rtx_maps;
-  std::string current_sdp = sdp;
-  while (std::regex_search(current_sdp, rtx_map_match, reg_fmtp_apt)) {
-    rtx_maps.insert({ rtx_map_match.str(1), rtx_map_match.str(2) });
-    current_sdp = rtx_map_match.suffix();
+// Appends media section |lines| to |result| with preferred codecs first,
+// and drops payload types which are neither preferred codecs, their RTX,
+// nor red and ulpfec for video. Attributes of dropped payload types are
+// removed. A section without preferred codecs is not changed.
+void RewriteMediaSection(const std::string& sdp,
+                         const SdpLine* lines,
+                         size_t count,
+                         const std::vector<std::string>& codec_names,
+                         bool is_audio,
+                         std::string* result) {
+  const SdpLine& m_line = lines[0];
+  // m=<media> <port> <proto> <fmt> ...
+  std::vector<std::string> tokens;
+  size_t begin = m_line.begin;
+  while (begin <= m_line.end) {
+    size_t space = sdp.find(' ', begin);
+    if (space == std::string::npos || space > m_line.end)
+      space = m_line.end;
+    if (space > begin)
+      tokens.push_back(sdp.substr(begin, space - begin));
+    begin = space + 1;
   }
-  std::vector<std::string> kept_codec_values;
-  if (!is_audio) {
-    // Get red and ulpfec payload type if any.
-    bool has_red = false, has_ulpfec = false;
-    std::regex reg_red_map(
-        "a=rtpmap:(\\d+) red\\/\\d+(?=[\r]?[\n]?)",
-        std::regex_constants::icase);
-    std::smatch red_map_match;
-    std::string red_codec_value;
-    auto search_result = std::regex_search(sdp, red_map_match, reg_red_map);
-    if (search_result && red_map_match.size() != 0) {
-      red_codec_value = red_map_match[1];
-      has_red = true;
-    }
-    std::regex reg_ulpfec_map(
-        "a=rtpmap:(\\d+) ulpfec\\/\\d+(?=[\r]?[\n]?)",
-        std::regex_constants::icase);
-    std::smatch ulpfec_map_match;
-    std::string ulpfec_codec_value;
-    search_result = std::regex_search(sdp, ulpfec_map_match, reg_ulpfec_map);
-    if (search_result && ulpfec_map_match.size() != 0) {
-      ulpfec_codec_value = ulpfec_map_match[1];
-      has_ulpfec = true;
-    }
-    if (has_red) {
-      kept_codec_values.push_back(red_codec_value);
-      for (auto& rtx_value : rtx_maps) {
-        if (rtx_value.second == red_codec_value) {
-            kept_codec_values.push_back(rtx_value.first);
-        }
-      }
+  if (tokens.size() < 3) {
+    RTC_LOG(LS_WARNING) << "Wrong SDP format description: "
+                        << sdp.substr(m_line.begin, m_line.end - m_line.begin);
+    for (size_t i = 0; i < count; i++)
+      result->append(sdp, lines[i].begin, lines[i].next - lines[i].begin);
+    return;
+  }
+  // Key is payload type, value is encoding name.
+  std::unordered_map<std::string, std::string> encodings;
+  // Key is RTX payload type, value is the original payload type.
+  std::unordered_map<std::string, std::string> rtx_maps;
+  for (size_t i = 1; i < count; i++) {
+    PayloadAttribute attribute;
+    size_t value = 0;
+    std::string payload_type = PayloadType(sdp, lines[i], &attribute, &value);
+    if (payload_type.empty())
+      continue;
+    if (attribute == kRtpmap) {
+      size_t slash = sdp.find('/', value);
+      if (slash == std::string::npos || slash > lines[i].end)
+        slash = lines[i].end;
+      encodings[payload_type] = sdp.substr(value, slash - value);
+    } else if (attribute == kFmtp && lines[i].end - value > 4 &&
+               sdp.compare(value, 4, "apt=") == 0) {
+      size_t apt_end = value + 4;
+      while (apt_end < lines[i].end && ::isdigit(sdp[apt_end]))
+        apt_end++;
+      rtx_maps[payload_type] = sdp.substr(value + 4, apt_end - value - 4);
     }
-    if (has_ulpfec) {
-      kept_codec_values.push_back(ulpfec_codec_value);
-      for (auto& rtx_value : rtx_maps) {
-        if (rtx_value.second == ulpfec_codec_value) {
-            kept_codec_values.push_back(rtx_value.first);
-        }
+  }
+  std::vector<std::string> kept;
+  for (auto& codec_name : codec_names) {
+    for (size_t i = 3; i < tokens.size(); i++) {
+      auto encoding = encodings.find(tokens[i]);
+      if (encoding != encodings.end() &&
+          EqualsIgnoreCase(encoding->second, codec_name)) {
+        kept.push_back(tokens[i]);
       }
     }
   }
-  for (auto& codec_name : codec_names) {
-    std::vector<std::string> codec_values = GetCodecValues(sdp, codec_name, is_audio);
-    for (auto& value : codec_values) {
-      // Input codec names are in reverse order, so the highest priortiy will be
-      // placed at the beginning.
-      kept_codec_values.insert(kept_codec_values.begin(), value);
-      for (auto& rtx_value : rtx_maps) {
-        if (rtx_value.second == value) {
-          kept_codec_values.push_back(rtx_value.first);
-        }
+  if (kept.empty()) {
+    RTC_LOG(LS_WARNING) << "No preferred codec in "
+                        << (is_audio ? "audio" : "video") << " m-line.";
+    for (size_t i = 0; i < count; i++)
+      result->append(sdp, lines[i].begin, lines[i].next - lines[i].begin);
+    return;
+  }
+  // Keep red and ulpfec, assuming the binding to original codec is
+  // out-of-bound.
+  if (!is_audio) {
+    for (size_t i = 3; i < tokens.size(); i++) {
+      auto encoding = encodings.find(tokens[i]);
+      if (encoding != encodings.end() &&
+          (EqualsIgnoreCase(encoding->second, "red") ||
+           EqualsIgnoreCase(encoding->second, "ulpfec"))) {
+        kept.push_back(tokens[i]);
       }
     }
   }
-  std::string media_type;
-  media_type = is_audio ? "audio" : "video";
-  std::regex reg_m_line("m=" + media_type + ".*(?=[\r]?[\n]?)");
-  std::smatch m_line_match;
-  auto search_result = std::regex_search(sdp, m_line_match, reg_m_line);
-  if (!search_result || m_line_match.size() == 0) {
-    RTC_LOG(LS_WARNING) << "M-line is not found. SDP: " << sdp;
-    return sdp;
+  std::unordered_set<std::string> kept_set(kept.begin(), kept.end());
+  for (size_t i = 3; i < tokens.size(); i++) {
+    auto rtx = rtx_maps.find(tokens[i]);
+    if (rtx != rtx_maps.end() && kept_set.count(rtx->second) != 0 &&
+        kept_set.insert(tokens[i]).second) {
+      kept.push_back(tokens[i]);
+    }
   }
-  std::string m_line(m_line_match[0]);
-  // Split m_line into vector and put preferred codec in the first place.
-  std::vector<std::string> m_line_vector;
-  std::stringstream original_m_line_stream(m_line);
-  std::string item;
-  while (std::getline(original_m_line_stream, item, ' ')) {
-    m_line_vector.push_back(item);
+  std::unordered_set<std::string> dropped;
+  for (size_t i = 3; i < tokens.size(); i++) {
+    if (kept_set.count(tokens[i]) == 0)
+      dropped.insert(tokens[i]);
   }
-  if (m_line_vector.size() < 3) {
-    RTC_LOG(LS_WARNING) << "Wrong SDP format description: " << m_line;
-    return sdp;
+  const size_t m_line_start = result->size();
+  result->append(tokens[0]).append(" ").append(tokens[1]).append(" ");
+  result->append(tokens[2]);
+  for (auto& payload_type : kept)
+    result->append(" ").append(payload_type);
+  RTC_LOG(LS_INFO) << "New m-line: " << result->substr(m_line_start);
+  result->append(sdp, m_line.end, m_line.next - m_line.end);
+  for (size_t i = 1; i < count; i++) {
+    PayloadAttribute attribute;
+    size_t value = 0;
+    if (!dropped.empty() &&
+        dropped.count(PayloadType(sdp, lines[i], &attribute, &value)) != 0) {
+      continue;
+    }
+    result->append(sdp, lines[i].begin, lines[i].next - lines[i].begin);
   }
-  std::stringstream m_line_stream;
-  for (int i = 0; i < 3; i++) {
-    if (i < 2)
-      m_line_stream << m_line_vector[i] << " ";
-    else
-      m_line_stream << m_line_vector[i];
+}
+}  // namespace
+std::string SdpUtils::SetPreferAudioCodecs(const std::string& original_sdp,
+                                          std::vector<AudioCodec>& codec) {
+  return SetPreferCodecs(original_sdp, codec, std::vector<VideoCodec>());
+}
+std::string SdpUtils::SetPreferVideoCodecs(const std::string& original_sdp,
+                                          std::vector<VideoCodec>& codec) {
+  return SetPreferCodecs(original_sdp, std::vector<AudioCodec>(), codec);
+}
+std::string SdpUtils::SetPreferCodecs(const std::string& sdp,
+                                      const std::vector<AudioCodec>& audio,
+                                      const std::vector<VideoCodec>& video) {
+  std::vector<std::string> audio_names;
+  for (auto codec : audio) {
+    auto codec_it = audio_codec_names.find(codec);
+    if (codec_it == audio_codec_names.end()) {
+      RTC_LOG(LS_WARNING) << "Preferred audio codec is not available.";
+      continue;
+    }
+    audio_names.push_back(codec_it->second);
   }
-  for (auto& codec_value : kept_codec_values) {
-    m_line_stream << " " << codec_value;
+  std::vector<std::string> video_names;
+  for (auto codec : video) {
+    auto codec_it = video_codec_names.find(codec);
+    if (codec_it == video_codec_names.end()) {
+      RTC_LOG(LS_WARNING) << "Preferred video codec is not available.";
+      continue;
+    }
+    video_names.push_back(codec_it->second);
   }
-  RTC_LOG(LS_INFO) << "New m-line: " << m_line_stream.str();
-  std::string before_strip = std::regex_replace(sdp, reg_m_line, m_line_stream.str());
-  std::string after_strip = before_strip;
-  // Remove all a=fmtp:xx, a=rtpmap:xx and a=rtcp-fb:xx where xx is not in m-line,
-  // this includes the a=fmtp:xx apt:yy lines for rtx.
-  for (size_t i = 3, m_line_vector_size = m_line_vector.size(); i < m_line_vector_size; i++) {
-    if (std::find(kept_codec_values.begin(), kept_codec_values.end(),
-      m_line_vector[i]) == kept_codec_values.end()) {
-      std::string codec_value = m_line_vector[i];
-      std::regex reg_rtp_xx_map(
-          "a=rtpmap:" + codec_value + " .*\\r\\n",
-          std::regex_constants::icase);
-      after_strip = std::regex_replace(before_strip, reg_rtp_xx_map, "");
-      before_strip = after_strip;
-      std::regex reg_fmtp_xx_map(
-          "a=fmtp:" + codec_value + " .*\\r\\n",
-          std::regex_constants::icase);
-      after_strip = std::regex_replace(before_strip, reg_fmtp_xx_map, "");
-      before_strip = after_strip;
-      std::regex reg_rtcp_map(
-          "a=rtcp-fb:" + codec_value + " .*\\r\\n",
-          std::regex_constants::icase);
-      after_strip = std::regex_replace(before_strip, reg_rtcp_map, "");
-      before_strip = after_strip;
+  if (audio_names.empty() && video_names.empty())
+    return sdp;
+  return RewriteCodecs(sdp, audio_names, video_names);
+}
+// Parses |sdp| into lines once, rewrites m-sections of media types with
+// preferred codecs, and serializes the result once.
+std::string SdpUtils::RewriteCodecs(
+    const std::string& sdp,
+    const std::vector<std::string>& audio_codec_names,
+    const std::vector<std::string>& video_codec_names) {
+  std::vector<SdpLine> lines = SplitLines(sdp);
+  if (lines.empty())
+    return sdp;
+  std::string result;
+  result.reserve(sdp.size());
+  size_t section_begin = 0;
+  for (size_t i = 0; i <= lines.size(); i++) {
+    if (i < lines.size() && (i == 0 || !StartsWith(sdp, lines[i], "m=", 2)))
+      continue;
+    // Lines [section_begin, i) are the session description or a media
+    // section.
+    const SdpLine& first = lines[section_begin];
+    const std::vector<std::string>* codec_names = nullptr;
+    bool is_audio = false;
+    if (StartsWith(sdp, first, "m=audio ", 8) && !audio_codec_names.empty()) {
+      codec_names = &audio_codec_names;
+      is_audio = true;
+    } else if (StartsWith(sdp, first, "m=video ", 8) &&
+               !video_codec_names.empty()) {
+      codec_names = &video_codec_names;
+    }
+    if (codec_names) {
+      RewriteMediaSection(sdp, &lines[section_begin], i - section_begin,
+                          *codec_names, is_audio, &result);
+    } else if (i > section_begin) {
+      result.append(sdp, first.begin, lines[i - 1].next - first.begin);
     }
+    section_begin = i;
   }
-  return after_strip;
+  return result;
 }
 }
 }
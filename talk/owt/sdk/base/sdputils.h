@@ -15,19 +15,27 @@ class SdpUtils {
                                          std::vector<AudioCodec>& codec);
   static std::string SetPreferVideoCodecs(const std::string& sdp,
                                          std::vector<VideoCodec>& codec);
+  /**
+   @brief Reorder and filter audio and video codecs in a single pass.
+   @details Every m-line of a media type is rewritten. Media types without
+   preferred codecs are not changed.
+   */
+  static std::string SetPreferCodecs(const std::string& sdp,
+                                     const std::vector<AudioCodec>& audio,
+                                     const std::vector<VideoCodec>& video);
  private:
   /**
    @brief Replace SDP for preferred codec.
    @param sdp Original SDP.
-   @param codec_names Codec names in SDP.
-   @param is_audio True if prefer audio codec, false if prefer video codec.
+   @param audio_codec_names Audio codec names in SDP, the most preferred
+   first.
+   @param video_codec_names Video codec names in SDP, the most preferred
+   first.
    */
-  static std::string SetPreferCodecs(const std::string& sdp,
-                                     std::vector<std::string>& codec_name,
-                                     bool is_audio);
-  static std::vector<std::string> GetCodecValues(const std::string& sdp,
-                                                 std::string& codec_name,
-                                                 bool is_audio);
+  static std::string RewriteCodecs(
+      const std::string& sdp,
+      const std::vector<std::string>& audio_codec_names,
+      const std::vector<std::string>& video_codec_names);
 };
 }
 }
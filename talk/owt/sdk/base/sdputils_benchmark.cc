@@ -0,0 +1,303 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+// Cost of reordering codecs in offers created by PeerConnection, before they
+// are set as local descriptions. The regex based implementation SdpUtils had
+// before is compared with the single-pass rewriter. A publication has one
+// audio and one video m-line, and a PeerConnection shared by 16
+// subscriptions has 16 of each.
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "talk/owt/sdk/base/sdputils.h"
+#include "talk/owt/sdk/test/benchmark.h"
+namespace owt {
+namespace base {
+namespace {
+// Media sections as in offers created by Chrome.
+std::string AudioSection(int mid) {
+  std::string mid_string = std::to_string(mid);
+  return "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 104 9 0 8 106 105 13 110 112 "
+         "113 126\r\n"
+         "c=IN IP4 0.0.0.0\r\n"
+         "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+         "a=ice-ufrag:Kn2v\r\n"
+         "a=ice-pwd:m7I4R1sCSxF7vmtNBAZf2tXk\r\n"
+         "a=ice-options:trickle\r\n"
+         "a=fingerprint:sha-256 6B:8B:F0:65:5F:78:E2:51:3B:AC:6F:F3:3F:46:1B:"
+         "35:DC:B8:5F:64:1A:24:C2:43:F0:A1:58:D0:A1:2C:19:08\r\n"
+         "a=setup:actpass\r\n"
+         "a=mid:" + mid_string + "\r\n"
+         "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+         "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/"
+         "abs-send-time\r\n"
+         "a=extmap:3 http://www.ietf.org/id/"
+         "draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+         "a=sendrecv\r\n"
+         "a=msid:stream track-audio-" + mid_string + "\r\n"
+         "a=rtcp-mux\r\n"
+         "a=rtpmap:111 opus/48000/2\r\n"
+         "a=rtcp-fb:111 transport-cc\r\n"
+         "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+         "a=rtpmap:103 ISAC/16000\r\n"
+         "a=rtpmap:104 ISAC/32000\r\n"
+         "a=rtpmap:9 G722/8000\r\n"
+         "a=rtpmap:0 PCMU/8000\r\n"
+         "a=rtpmap:8 PCMA/8000\r\n"
+         "a=rtpmap:106 CN/32000\r\n"
+         "a=rtpmap:105 CN/16000\r\n"
+         "a=rtpmap:13 CN/8000\r\n"
+         "a=rtpmap:110 telephone-event/48000\r\n"
+         "a=rtpmap:112 telephone-event/32000\r\n"
+         "a=rtpmap:113 telephone-event/16000\r\n"
+         "a=rtpmap:126 telephone-event/8000\r\n"
+         "a=ssrc:1001" + mid_string + " cname:Yk4hDI5NNoN2dVeD\r\n";
+}
+std::string VideoSection(int mid) {
+  std::string mid_string = std::to_string(mid);
+  std::string section =
+      "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 102 122 127 121 125 "
+      "107 108 109 124 120 123 119 114 115 116\r\n"
+      "c=IN IP4 0.0.0.0\r\n"
+      "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+      "a=ice-ufrag:Kn2v\r\n"
+      "a=ice-pwd:m7I4R1sCSxF7vmtNBAZf2tXk\r\n"
+      "a=ice-options:trickle\r\n"
+      "a=fingerprint:sha-256 6B:8B:F0:65:5F:78:E2:51:3B:AC:6F:F3:3F:46:1B:"
+      "35:DC:B8:5F:64:1A:24:C2:43:F0:A1:58:D0:A1:2C:19:08\r\n"
+      "a=setup:actpass\r\n"
+      "a=mid:" + mid_string + "\r\n"
+      "a=extmap:14 urn:ietf:params:rtp-hdrext:toffset\r\n"
+      "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/"
+      "abs-send-time\r\n"
+      "a=extmap:13 urn:3gpp:video-orientation\r\n"
+      "a=sendrecv\r\n"
+      "a=msid:stream track-video-" + mid_string + "\r\n"
+      "a=rtcp-mux\r\n"
+      "a=rtcp-rsize\r\n";
+  const char* const kPrimaries[][3] = {
+      {"96", "97", "VP8/90000"},
+      {"98", "99", "VP9/90000"},
+      {"100", "101", "VP9/90000"},
+      {"102", "122", "H264/90000"},
+      {"127", "121", "H264/90000"},
+      {"125", "107", "H264/90000"},
+      {"108", "109", "H264/90000"},
+      {"124", "120", "red/90000"}};
+  for (auto& primary : kPrimaries) {
+    const std::string payload_type(primary[0]);
+    const std::string rtx(primary[1]);
+    section += "a=rtpmap:" + payload_type + " " + primary[2] + "\r\n";
+    if (std::string(primary[2]) != "red/90000") {
+      for (const char* feedback :
+           {"goog-remb", "transport-cc", "ccm fir", "nack", "nack pli"}) {
+        section += "a=rtcp-fb:" + payload_type + " " + feedback + "\r\n";
+      }
+    }
+    if (std::string(primary[2]) == "H264/90000") {
+      section += "a=fmtp:" + payload_type +
+                 " level-asymmetry-allowed=1;packetization-mode=1;"
+                 "profile-level-id=42001f\r\n";
+    }
+    section += "a=rtpmap:" + rtx + " rtx/90000\r\n";
+    section += "a=fmtp:" + rtx + " apt=" + payload_type + "\r\n";
+  }
+  section += "a=rtpmap:123 ulpfec/90000\r\n";
+  for (const char* payload_type : {"119", "114", "115", "116"}) {
+    section += "a=rtpmap:" + std::string(payload_type) + " flexfec-03/90000\r\n";
+  }
+  section += "a=ssrc-group:FID 2001" + mid_string + " 3001" + mid_string +
+             "\r\n"
+             "a=ssrc:2001" + mid_string + " cname:Yk4hDI5NNoN2dVeD\r\n"
+             "a=ssrc:3001" + mid_string + " cname:Yk4hDI5NNoN2dVeD\r\n";
+  return section;
+}
+std::string Offer(int sections_per_type) {
+  std::string offer =
+      "v=0\r\n"
+      "o=- 4611731400430051336 2 IN IP4 127.0.0.1\r\n"
+      "s=-\r\n"
+      "t=0 0\r\n"
+      "a=group:BUNDLE";
+  for (int i = 0; i < sections_per_type * 2; i++)
+    offer += " " + std::to_string(i);
+  offer += "\r\na=msid-semantic: WMS stream\r\n";
+  for (int i = 0; i < sections_per_type; i++) {
+    offer += AudioSection(i * 2);
+    offer += VideoSection(i * 2 + 1);
+  }
+  return offer;
+}
+std::vector<std::string> LegacyGetCodecValues(const std::string& sdp,
+                                              std::string& codec_name) {
+  std::vector<std::string> codec_values;
+  std::string sdp_current(sdp);
+  std::regex reg_rtp_map(
+      "a=rtpmap:(\\d+) " + codec_name + "\\/\\d+(?=[\r]?[\n]?)",
+      std::regex_constants::icase);
+  std::smatch rtp_map_match;
+  while (std::regex_search(sdp_current, rtp_map_match, reg_rtp_map)) {
+    codec_values.push_back(rtp_map_match[1]);
+    sdp_current = rtp_map_match.suffix();
+  }
+  return codec_values;
+}
+// The previous SdpUtils::SetPreferCodecs, without its logging.
+std::string LegacySetPreferCodecs(const std::string& sdp,
+                                  std::vector<std::string>& codec_names,
+                                  bool is_audio) {
+  // Search all rtx maps in the sdp.
+  std::regex reg_fmtp_apt(
+      "a=fmtp:(\\d+) apt=(\\d+)(?=[\r]?[\n]?)",
+      std::regex_constants::icase);
+  std::smatch rtx_map_match;
+  // Key is the rtx payload type, value is the original payload type.
+  std::unordered_map<std::string, std::string> rtx_maps;
+  std::string current_sdp = sdp;
+  while (std::regex_search(current_sdp, rtx_map_match, reg_fmtp_apt)) {
+    rtx_maps.insert({ rtx_map_match.str(1), rtx_map_match.str(2) });
+    current_sdp = rtx_map_match.suffix();
+  }
+  std::vector<std::string> kept_codec_values;
+  if (!is_audio) {
+    // Get red and ulpfec payload type if any.
+    bool has_red = false, has_ulpfec = false;
+    std::regex reg_red_map(
+        "a=rtpmap:(\\d+) red\\/\\d+(?=[\r]?[\n]?)",
+        std::regex_constants::icase);
+    std::smatch red_map_match;
+    std::string red_codec_value;
+    auto search_result = std::regex_search(sdp, red_map_match, reg_red_map);
+    if (search_result && red_map_match.size() != 0) {
+      red_codec_value = red_map_match[1];
+      has_red = true;
+    }
+    std::regex reg_ulpfec_map(
+        "a=rtpmap:(\\d+) ulpfec\\/\\d+(?=[\r]?[\n]?)",
+        std::regex_constants::icase);
+    std::smatch ulpfec_map_match;
+    std::string ulpfec_codec_value;
+    search_result = std::regex_search(sdp, ulpfec_map_match, reg_ulpfec_map);
+    if (search_result && ulpfec_map_match.size() != 0) {
+      ulpfec_codec_value = ulpfec_map_match[1];
+      has_ulpfec = true;
+    }
+    if (has_red) {
+      kept_codec_values.push_back(red_codec_value);
+      for (auto& rtx_value : rtx_maps) {
+        if (rtx_value.second == red_codec_value) {
+            kept_codec_values.push_back(rtx_value.first);
+        }
+      }
+    }
+    if (has_ulpfec) {
+      kept_codec_values.push_back(ulpfec_codec_value);
+      for (auto& rtx_value : rtx_maps) {
+        if (rtx_value.second == ulpfec_codec_value) {
+            kept_codec_values.push_back(rtx_value.first);
+        }
+      }
+    }
+  }
+  for (auto& codec_name : codec_names) {
+    std::vector<std::string> codec_values = LegacyGetCodecValues(sdp, codec_name);
+    for (auto& value : codec_values) {
+      // Input codec names are in reverse order, so the highest priortiy will be
+      // placed at the beginning.
+      kept_codec_values.insert(kept_codec_values.begin(), value);
+      for (auto& rtx_value : rtx_maps) {
+        if (rtx_value.second == value) {
+          kept_codec_values.push_back(rtx_value.first);
+        }
+      }
+    }
+  }
+  std::string media_type;
+  media_type = is_audio ? "audio" : "video";
+  std::regex reg_m_line("m=" + media_type + ".*(?=[\r]?[\n]?)");
+  std::smatch m_line_match;
+  auto search_result = std::regex_search(sdp, m_line_match, reg_m_line);
+  if (!search_result || m_line_match.size() == 0) {
+    return sdp;
+  }
+  std::string m_line(m_line_match[0]);
+  // Split m_line into vector and put preferred codec in the first place.
+  std::vector<std::string> m_line_vector;
+  std::stringstream original_m_line_stream(m_line);
+  std::string item;
+  while (std::getline(original_m_line_stream, item, ' ')) {
+    m_line_vector.push_back(item);
+  }
+  if (m_line_vector.size() < 3) {
+    return sdp;
+  }
+  std::stringstream m_line_stream;
+  for (int i = 0; i < 3; i++) {
+    if (i < 2)
+      m_line_stream << m_line_vector[i] << " ";
+    else
+      m_line_stream << m_line_vector[i];
+  }
+  for (auto& codec_value : kept_codec_values) {
+    m_line_stream << " " << codec_value;
+  }
+  std::string before_strip = std::regex_replace(sdp, reg_m_line, m_line_stream.str());
+  std::string after_strip = before_strip;
+  // Remove all a=fmtp:xx, a=rtpmap:xx and a=rtcp-fb:xx where xx is not in m-line,
+  // this includes the a=fmtp:xx apt:yy lines for rtx.
+  for (size_t i = 3, m_line_vector_size = m_line_vector.size(); i < m_line_vector_size; i++) {
+    if (std::find(kept_codec_values.begin(), kept_codec_values.end(),
+      m_line_vector[i]) == kept_codec_values.end()) {
+      std::string codec_value = m_line_vector[i];
+      std::regex reg_rtp_xx_map(
+          "a=rtpmap:" + codec_value + " .*\\r\\n",
+          std::regex_constants::icase);
+      after_strip = std::regex_replace(before_strip, reg_rtp_xx_map, "");
+      before_strip = after_strip;
+      std::regex reg_fmtp_xx_map(
+          "a=fmtp:" + codec_value + " .*\\r\\n",
+          std::regex_constants::icase);
+      after_strip = std::regex_replace(before_strip, reg_fmtp_xx_map, "");
+      before_strip = after_strip;
+      std::regex reg_rtcp_map(
+          "a=rtcp-fb:" + codec_value + " .*\\r\\n",
+          std::regex_constants::icase);
+      after_strip = std::regex_replace(before_strip, reg_rtcp_map, "");
+      before_strip = after_strip;
+    }
+  }
+  return after_strip;
+}
+// SdpUtils::SetPreferAudioCodecs and SetPreferVideoCodecs as they were
+// called by PeerConnectionChannel, with codec names in reverse order.
+std::string LegacyReorderCodecs(const std::string& sdp,
+                                const std::vector<std::string>& audio,
+                                const std::vector<std::string>& video) {
+  std::vector<std::string> audio_names(audio.rbegin(), audio.rend());
+  std::vector<std::string> video_names(video.rbegin(), video.rend());
+  std::string result = LegacySetPreferCodecs(sdp, audio_names, true);
+  return LegacySetPreferCodecs(result, video_names, false);
+}
+}  // namespace
+OWT_BENCHMARK(SdpCodecPreference) {
+  const std::vector<AudioCodec> audio_codecs = {AudioCodec::kOpus,
+                                                AudioCodec::kPcmu};
+  const std::vector<VideoCodec> video_codecs = {VideoCodec::kH264,
+                                                VideoCodec::kVp8};
+  const std::vector<std::string> audio_names = {"OPUS", "PCMU"};
+  const std::vector<std::string> video_names = {"H264", "VP8"};
+  for (int sections : {1, 16}) {
+    const std::string offer = Offer(sections);
+    const std::string label = std::to_string(sections) + " m-line(s) per type";
+    owt::test::MeasureAndReport("regex, " + label, 20, 0, [&]() {
+      LegacyReorderCodecs(offer, audio_names, video_names);
+    });
+    owt::test::MeasureAndReport("single-pass, " + label, 20, 0, [&]() {
+      SdpUtils::SetPreferCodecs(offer, audio_codecs, video_codecs);
+    });
+  }
+}
+}  // namespace base
+}  // namespace owt
@@ -0,0 +1,108 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/base/sdputils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+namespace {
+const char kSessionSection[] =
+    "v=0\r\n"
+    "o=- 1 2 IN IP4 127.0.0.1\r\n"
+    "s=-\r\n"
+    "t=0 0\r\n";
+const char kAudioSection[] =
+    "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 0 8\r\n"
+    "a=mid:0\r\n"
+    "a=rtpmap:111 opus/48000/2\r\n"
+    "a=rtcp-fb:111 transport-cc\r\n"
+    "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+    "a=rtpmap:103 ISAC/16000\r\n"
+    "a=rtpmap:0 PCMU/8000\r\n"
+    "a=rtpmap:8 PCMA/8000\r\n";
+const char kVideoSection[] =
+    "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 102 103\r\n"
+    "a=mid:1\r\n"
+    "a=rtpmap:96 VP8/90000\r\n"
+    "a=rtcp-fb:96 nack\r\n"
+    "a=rtpmap:97 rtx/90000\r\n"
+    "a=fmtp:97 apt=96\r\n"
+    "a=rtpmap:98 H264/90000\r\n"
+    "a=rtcp-fb:98 nack\r\n"
+    "a=fmtp:98 packetization-mode=1;profile-level-id=42001f\r\n"
+    "a=rtpmap:99 rtx/90000\r\n"
+    "a=fmtp:99 apt=98\r\n"
+    "a=rtpmap:100 red/90000\r\n"
+    "a=rtpmap:101 rtx/90000\r\n"
+    "a=fmtp:101 apt=100\r\n"
+    "a=rtpmap:102 ulpfec/90000\r\n"
+    "a=rtpmap:103 VP9/90000\r\n"
+    "a=rtcp-fb:103 nack\r\n";
+}  // namespace
+TEST(SdpUtilsTest, ReordersAndFiltersVideoCodecs) {
+  const std::string sdp =
+      std::string(kSessionSection) + kAudioSection + kVideoSection;
+  std::vector<VideoCodec> codecs = {VideoCodec::kH264, VideoCodec::kVp8};
+  const std::string expected_video =
+      "m=video 9 UDP/TLS/RTP/SAVPF 98 96 100 102 97 99 101\r\n"
+      "a=mid:1\r\n"
+      "a=rtpmap:96 VP8/90000\r\n"
+      "a=rtcp-fb:96 nack\r\n"
+      "a=rtpmap:97 rtx/90000\r\n"
+      "a=fmtp:97 apt=96\r\n"
+      "a=rtpmap:98 H264/90000\r\n"
+      "a=rtcp-fb:98 nack\r\n"
+      "a=fmtp:98 packetization-mode=1;profile-level-id=42001f\r\n"
+      "a=rtpmap:99 rtx/90000\r\n"
+      "a=fmtp:99 apt=98\r\n"
+      "a=rtpmap:100 red/90000\r\n"
+      "a=rtpmap:101 rtx/90000\r\n"
+      "a=fmtp:101 apt=100\r\n"
+      "a=rtpmap:102 ulpfec/90000\r\n";
+  EXPECT_EQ(std::string(kSessionSection) + kAudioSection + expected_video,
+            SdpUtils::SetPreferVideoCodecs(sdp, codecs));
+}
+TEST(SdpUtilsTest, RewritesEveryMLineOfMediaType) {
+  const std::string sdp = std::string(kSessionSection) + kAudioSection +
+                          kVideoSection + kAudioSection;
+  const std::string expected_audio =
+      "m=audio 9 UDP/TLS/RTP/SAVPF 0 111\r\n"
+      "a=mid:0\r\n"
+      "a=rtpmap:111 opus/48000/2\r\n"
+      "a=rtcp-fb:111 transport-cc\r\n"
+      "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+      "a=rtpmap:0 PCMU/8000\r\n";
+  EXPECT_EQ(std::string(kSessionSection) + expected_audio + kVideoSection +
+                expected_audio,
+            SdpUtils::SetPreferCodecs(sdp, {AudioCodec::kPcmu,
+                                            AudioCodec::kOpus},
+                                      std::vector<VideoCodec>()));
+}
+TEST(SdpUtilsTest, KeepsMLineWithoutPreferredCodec) {
+  const std::string sdp =
+      std::string(kSessionSection) + kAudioSection + kVideoSection;
+  std::vector<VideoCodec> codecs = {VideoCodec::kH265};
+  EXPECT_EQ(sdp, SdpUtils::SetPreferVideoCodecs(sdp, codecs));
+}
+TEST(SdpUtilsTest, KeepsSdpWithoutPreferences) {
+  const std::string sdp =
+      std::string(kSessionSection) + kAudioSection + kVideoSection;
+  EXPECT_EQ(sdp, SdpUtils::SetPreferCodecs(sdp, std::vector<AudioCodec>(),
+                                           std::vector<VideoCodec>()));
+}
+TEST(SdpUtilsTest, AcceptsLineFeedLineBreaks) {
+  const std::string sdp =
+      "v=0\n"
+      "m=audio 9 RTP/SAVPF 111 0\n"
+      "a=rtpmap:111 opus/48000/2\n"
+      "a=rtpmap:0 PCMU/8000";
+  std::vector<AudioCodec> codecs = {AudioCodec::kPcmu};
+  EXPECT_EQ(
+      "v=0\n"
+      "m=audio 9 RTP/SAVPF 0\n"
+      "a=rtpmap:0 PCMU/8000",
+      SdpUtils::SetPreferAudioCodecs(sdp, codecs));
+}
+}
+}
@@ -0,0 +1,88 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_SPSCRINGBUFFER_H_
+#define OWT_BASE_SPSCRINGBUFFER_H_
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+namespace owt {
+namespace base {
+// Lock-free ring buffer for exactly one producer thread and one consumer
+// thread. Writes and reads are all-or-nothing so a packet is never split
+// between two reads by a concurrent write. Capacity is rounded up to a power
+// of two.
+template <typename T>
+class SpscRingBuffer {
+ public:
+  explicit SpscRingBuffer(size_t capacity)
+      : capacity_(RoundUpToPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        buffer_(new T[capacity_]),
+        read_index_(0),
+        write_index_(0) {}
+  size_t Capacity() const { return capacity_; }
+  // Number of elements available for reading. Exact when called from either
+  // the producer or the consumer thread.
+  size_t Size() const {
+    return write_index_.load(std::memory_order_acquire) -
+           read_index_.load(std::memory_order_acquire);
+  }
+  // Producer only. Returns false without writing anything if there is not
+  // enough room for |count| elements.
+  bool Write(const T* data, size_t count) {
+    const size_t write_index = write_index_.load(std::memory_order_relaxed);
+    const size_t read_index = read_index_.load(std::memory_order_acquire);
+    if (capacity_ - (write_index - read_index) < count)
+      return false;
+    const size_t offset = write_index & mask_;
+    const size_t first = std::min(count, capacity_ - offset);
+    memcpy(buffer_.get() + offset, data, first * sizeof(T));
+    memcpy(buffer_.get(), data + first, (count - first) * sizeof(T));
+    write_index_.store(write_index + count, std::memory_order_release);
+    return true;
+  }
+  // Consumer only. Returns false without reading anything if fewer than
+  // |count| elements are available.
+  bool Read(T* data, size_t count) {
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    const size_t write_index = write_index_.load(std::memory_order_acquire);
+    if (write_index - read_index < count)
+      return false;
+    const size_t offset = read_index & mask_;
+    const size_t first = std::min(count, capacity_ - offset);
+    memcpy(data, buffer_.get() + offset, first * sizeof(T));
+    memcpy(data + first, buffer_.get(), (count - first) * sizeof(T));
+    read_index_.store(read_index + count, std::memory_order_release);
+    return true;
+  }
+  // Consumer only. Drops up to |count| of the oldest elements and returns the
+  // number actually dropped.
+  size_t Skip(size_t count) {
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    const size_t write_index = write_index_.load(std::memory_order_acquire);
+    count = std::min(count, write_index - read_index);
+    read_index_.store(read_index + count, std::memory_order_release);
+    return count;
+  }
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value)
+      result <<= 1;
+    return result;
+  }
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<T[]> buffer_;
+  // Indexes grow monotonically and wrap at SIZE_MAX; only their difference
+  // and the bits under |mask_| are meaningful. Kept on separate cache lines so
+  // producer and consumer do not false-share.
+  alignas(64) std::atomic<size_t> read_index_;
+  alignas(64) std::atomic<size_t> write_index_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_SPSCRINGBUFFER_H_
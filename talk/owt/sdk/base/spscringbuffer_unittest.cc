@@ -0,0 +1,71 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <thread>
+#include <vector>
+#include "talk/owt/sdk/base/spscringbuffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+TEST(SpscRingBufferTest, CapacityIsRoundedUpToPowerOfTwo) {
+  SpscRingBuffer<int16_t> ring(100);
+  EXPECT_EQ(ring.Capacity(), 128u);
+}
+TEST(SpscRingBufferTest, WriteAndReadAreAllOrNothing) {
+  SpscRingBuffer<int16_t> ring(8);
+  std::vector<int16_t> data = {1, 2, 3, 4, 5, 6};
+  EXPECT_TRUE(ring.Write(data.data(), data.size()));
+  EXPECT_FALSE(ring.Write(data.data(), data.size()));
+  EXPECT_EQ(ring.Size(), 6u);
+  std::vector<int16_t> out(8, 0);
+  EXPECT_FALSE(ring.Read(out.data(), 8));
+  EXPECT_TRUE(ring.Read(out.data(), 4));
+  EXPECT_EQ(out[3], 4);
+  EXPECT_EQ(ring.Size(), 2u);
+}
+TEST(SpscRingBufferTest, WrapsAround) {
+  SpscRingBuffer<int16_t> ring(8);
+  std::vector<int16_t> data = {1, 2, 3, 4, 5, 6};
+  std::vector<int16_t> out(6, 0);
+  EXPECT_TRUE(ring.Write(data.data(), 6));
+  EXPECT_TRUE(ring.Read(out.data(), 6));
+  EXPECT_TRUE(ring.Write(data.data(), 6));
+  EXPECT_TRUE(ring.Read(out.data(), 6));
+  EXPECT_EQ(out, data);
+}
+TEST(SpscRingBufferTest, SkipDropsOldestElements) {
+  SpscRingBuffer<int16_t> ring(8);
+  std::vector<int16_t> data = {1, 2, 3, 4};
+  EXPECT_TRUE(ring.Write(data.data(), 4));
+  EXPECT_EQ(ring.Skip(3), 3u);
+  int16_t value = 0;
+  EXPECT_TRUE(ring.Read(&value, 1));
+  EXPECT_EQ(value, 4);
+  EXPECT_EQ(ring.Skip(3), 0u);
+}
+TEST(SpscRingBufferTest, ConcurrentProducerAndConsumerKeepOrder) {
+  const int kPackets = 10000;
+  const size_t kPacketSize = 7;
+  SpscRingBuffer<int> ring(64);
+  std::thread producer([&ring, kPackets, kPacketSize]() {
+    std::vector<int> packet(kPacketSize);
+    for (int i = 0; i < kPackets; i++) {
+      for (size_t j = 0; j < kPacketSize; j++)
+        packet[j] = i;
+      while (!ring.Write(packet.data(), kPacketSize))
+        std::this_thread::yield();
+    }
+  });
+  std::vector<int> packet(kPacketSize);
+  for (int i = 0; i < kPackets; i++) {
+    while (!ring.Read(packet.data(), kPacketSize))
+      std::this_thread::yield();
+    for (size_t j = 0; j < kPacketSize; j++)
+      ASSERT_EQ(packet[j], i);
+  }
+  producer.join();
+  EXPECT_EQ(ring.Size(), 0u);
+}
+}
+}
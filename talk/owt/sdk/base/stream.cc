@@ -6,6 +6,7 @@
 #include "webrtc/media/engine/webrtcvideocapturerfactory.h"
 #include "webrtc/modules/video_capture/video_capture_factory.h"
 #include "webrtc/modules/desktop_capture/desktop_capture_options.h"
+#include "talk/owt/sdk/base/customizedaudiosource.h"
 #include "talk/owt/sdk/base/customizedframescapturer.h"
 #if defined(WEBRTC_WIN)
 #include "talk/owt/sdk/base/desktopcapturer.h"
@@ -295,6 +296,20 @@ std::shared_ptr<LocalStream> LocalStream::Create(
         new LocalStream(parameters, std::move(framer)));
     return stream;
 }
+std::shared_ptr<LocalStream> LocalStream::Create(
+    std::shared_ptr<LocalCustomizedStreamParameters> parameters,
+    std::unique_ptr<AudioFrameGeneratorInterface> audio_generator,
+    std::unique_ptr<VideoFrameGeneratorInterface> video_generator,
+    AudioLevelObserverInterface* audio_level_observer,
+    int audio_level_interval_ms) {
+    int error_code = 0;
+    std::shared_ptr<LocalStream> stream(new LocalStream(
+        parameters, std::move(audio_generator), std::move(video_generator),
+        audio_level_observer, audio_level_interval_ms, error_code));
+    if (error_code != 0)
+      return nullptr;
+    return stream;
+}
 std::shared_ptr<LocalStream> LocalStream::Create(
     std::shared_ptr<LocalCustomizedStreamParameters> parameters,
     VideoEncoderInterface* encoder) {
@@ -465,37 +480,88 @@ LocalStream::LocalStream(
   media_stream_->AddRef();
 }
 #endif
-LocalStream::LocalStream(
-    std::shared_ptr<LocalCustomizedStreamParameters> parameters,
-    std::unique_ptr<VideoFrameGeneratorInterface> framer)
-    : media_constraints_(new MediaConstraintsImpl) {
-  if (!parameters->VideoEnabled() && !parameters->AudioEnabled()) {
-    RTC_LOG(LS_WARNING) << "Create Local Camera Stream without video and audio.";
-  }
+namespace {
+// Creates a media stream with a video track of frames from |video_generator|
+// if it is not null, and an audio track if |audio_enabled|. The audio track
+// gets audio from |audio_source|, or from the audio device module if it is
+// null.
+scoped_refptr<MediaStreamInterface> CreateCustomizedMediaStream(
+    const std::string& media_stream_id,
+    std::unique_ptr<VideoFrameGeneratorInterface> video_generator,
+    bool audio_enabled,
+    scoped_refptr<webrtc::AudioSourceInterface> audio_source) {
   scoped_refptr<PeerConnectionDependencyFactory> pcd_factory =
       PeerConnectionDependencyFactory::Get();
-  std::string media_stream_id("MediaStream-" + rtc::CreateRandomUuid());
-  Id(media_stream_id);
   scoped_refptr<MediaStreamInterface> stream =
       pcd_factory->CreateLocalMediaStream(media_stream_id);
-  std::unique_ptr<CustomizedFramesCapturer> capturer(nullptr);
-  if (parameters->VideoEnabled()) {
-    capturer = std::unique_ptr<CustomizedFramesCapturer>(
-        new CustomizedFramesCapturer(std::move(framer)));
+  if (video_generator) {
+    std::unique_ptr<CustomizedFramesCapturer> capturer(
+        new CustomizedFramesCapturer(std::move(video_generator)));
     capturer->Init();
     scoped_refptr<VideoTrackSourceInterface> source =
-    pcd_factory->CreateVideoSource(std::move(capturer), nullptr);
+        pcd_factory->CreateVideoSource(std::move(capturer), nullptr);
     std::string video_track_id("VideoTrack-" + rtc::CreateRandomUuid());
     scoped_refptr<VideoTrackInterface> video_track =
         pcd_factory->CreateLocalVideoTrack(video_track_id, source);
     stream->AddTrack(video_track);
   }
-  if (parameters->AudioEnabled()) {
+  if (audio_enabled) {
     std::string audio_track_id("AudioTrack-" + rtc::CreateRandomUuid());
     scoped_refptr<AudioTrackInterface> audio_track =
-        pcd_factory->CreateLocalAudioTrack(audio_track_id);
+        audio_source ? pcd_factory->CreateLocalAudioTrack(audio_track_id,
+                                                          audio_source)
+                     : pcd_factory->CreateLocalAudioTrack(audio_track_id);
     stream->AddTrack(audio_track);
   }
+  return stream;
+}
+}  // namespace
+LocalStream::LocalStream(
+    std::shared_ptr<LocalCustomizedStreamParameters> parameters,
+    std::unique_ptr<VideoFrameGeneratorInterface> framer)
+    : media_constraints_(new MediaConstraintsImpl) {
+  if (!parameters->VideoEnabled() && !parameters->AudioEnabled()) {
+    RTC_LOG(LS_WARNING) << "Create Local Camera Stream without video and audio.";
+  }
+  std::string media_stream_id("MediaStream-" + rtc::CreateRandomUuid());
+  Id(media_stream_id);
+  if (!parameters->VideoEnabled())
+    framer.reset();
+  scoped_refptr<MediaStreamInterface> stream = CreateCustomizedMediaStream(
+      media_stream_id, std::move(framer), parameters->AudioEnabled(), nullptr);
+  media_stream_ = stream;
+  media_stream_->AddRef();
+}
+LocalStream::LocalStream(
+    std::shared_ptr<LocalCustomizedStreamParameters> parameters,
+    std::unique_ptr<AudioFrameGeneratorInterface> audio_generator,
+    std::unique_ptr<VideoFrameGeneratorInterface> video_generator,
+    AudioLevelObserverInterface* audio_level_observer,
+    int audio_level_interval_ms,
+    int& error_code)
+    : media_constraints_(new MediaConstraintsImpl) {
+  if (!parameters->VideoEnabled() && !parameters->AudioEnabled()) {
+    RTC_LOG(LS_WARNING) << "Create LocalStream without video and audio.";
+  }
+  scoped_refptr<CustomizedAudioSource> audio_source;
+  if (parameters->AudioEnabled()) {
+    audio_source = CustomizedAudioSource::Create(
+        std::move(audio_generator), audio_level_observer,
+        audio_level_interval_ms);
+    if (!audio_source) {
+      RTC_LOG(LS_ERROR) << "Audio frame generator is null or its format is "
+                           "not supported.";
+      error_code = static_cast<int>(ExceptionType::kLocalInvalidOption);
+      return;
+    }
+  }
+  std::string media_stream_id("MediaStream-" + rtc::CreateRandomUuid());
+  Id(media_stream_id);
+  if (!parameters->VideoEnabled())
+    video_generator.reset();
+  scoped_refptr<MediaStreamInterface> stream = CreateCustomizedMediaStream(
+      media_stream_id, std::move(video_generator), audio_source != nullptr,
+      audio_source);
   media_stream_ = stream;
   media_stream_->AddRef();
 }
@@ -0,0 +1,99 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include "talk/owt/sdk/base/timerservice.h"
+namespace owt {
+namespace base {
+const TimerService::TimerId TimerService::kInvalidTimerId;
+TimerService* TimerService::Get() {
+  static TimerService* service = new TimerService();
+  return service;
+}
+TimerService::TimerService()
+    : next_id_(kInvalidTimerId + 1),
+      running_id_(kInvalidTimerId),
+      stopped_(false),
+      thread_(&TimerService::Run, this) {}
+TimerService::~TimerService() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  wakeup_.notify_one();
+  thread_.join();
+}
+TimerService::TimerId TimerService::Schedule(std::function<void()> task,
+                                             int64_t delay_ms) {
+  const Clock::time_point deadline =
+      Clock::now() + std::chrono::milliseconds(std::max<int64_t>(delay_ms, 0));
+  bool earliest = false;
+  TimerId id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+      return kInvalidTimerId;
+    id = next_id_++;
+    auto timer =
+        timers_.emplace(std::make_pair(deadline, id), std::move(task)).first;
+    deadlines_[id] = deadline;
+    earliest = timer == timers_.begin();
+  }
+  // Timer thread only needs to wake up earlier than it planned.
+  if (earliest)
+    wakeup_.notify_one();
+  return id;
+}
+bool TimerService::Cancel(TimerId id) {
+  if (id == kInvalidTimerId)
+    return false;
+  std::function<void()> task;
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto deadline = deadlines_.find(id);
+  if (deadline != deadlines_.end()) {
+    auto timer = timers_.find(std::make_pair(deadline->second, id));
+    // Destroyed after unlocking, in case it holds the last reference to an
+    // object which cancels timers.
+    task = std::move(timer->second);
+    timers_.erase(timer);
+    deadlines_.erase(deadline);
+    lock.unlock();
+    return true;
+  }
+  if (std::this_thread::get_id() != thread_.get_id()) {
+    task_done_.wait(lock, [this, id] { return running_id_ != id; });
+  }
+  return false;
+}
+size_t TimerService::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return timers_.size();
+}
+void TimerService::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopped_) {
+    if (timers_.empty()) {
+      wakeup_.wait(lock);
+      continue;
+    }
+    auto timer = timers_.begin();
+    // Copied, as the timer may be cancelled while waiting.
+    const Clock::time_point deadline = timer->first.first;
+    if (deadline > Clock::now()) {
+      wakeup_.wait_until(lock, deadline);
+      continue;
+    }
+    running_id_ = timer->first.second;
+    std::function<void()> task = std::move(timer->second);
+    deadlines_.erase(running_id_);
+    timers_.erase(timer);
+    lock.unlock();
+    task();
+    task = nullptr;
+    lock.lock();
+    running_id_ = kInvalidTimerId;
+    task_done_.notify_all();
+  }
+}
+}  // namespace base
+}  // namespace owt
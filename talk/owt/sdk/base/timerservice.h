@@ -0,0 +1,58 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_TIMERSERVICE_H_
+#define OWT_BASE_TIMERSERVICE_H_
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+namespace owt {
+namespace base {
+// Runs delayed tasks, e.g. reconnection and ack timeouts of all channels, on a
+// single thread. A burst of timers costs no more threads, and a timer can be
+// cancelled before the object it refers to is destroyed.
+class TimerService {
+ public:
+  typedef uint64_t TimerId;
+  // Never used for a timer. Cancelling it has no effect.
+  static const TimerId kInvalidTimerId = 0;
+  // Process-wide service shared by all channels. It is never destroyed, as the
+  // last reference to a channel may be released by a timer.
+  static TimerService* Get();
+  TimerService();
+  // Stops timer thread. Tasks not run yet are dropped.
+  ~TimerService();
+  // Runs |task| on timer thread after |delay_ms|. Tasks should return quickly,
+  // as they delay other timers.
+  TimerId Schedule(std::function<void()> task, int64_t delay_ms);
+  // Returns true if timer |id| is cancelled before it runs. If its task is
+  // running, waits until it returns unless called by the task itself. So
+  // objects referred by the task can be destroyed after Cancel.
+  bool Cancel(TimerId id);
+  // Number of timers not run yet.
+  size_t Size() const;
+ private:
+  typedef std::chrono::steady_clock Clock;
+  void Run();
+  mutable std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::condition_variable task_done_;
+  // Ordered by deadline, and by id for timers with the same deadline.
+  std::map<std::pair<Clock::time_point, TimerId>, std::function<void()>>
+      timers_;
+  std::unordered_map<TimerId, Clock::time_point> deadlines_;
+  TimerId next_id_;
+  TimerId running_id_;
+  bool stopped_;
+  // Started after other members are initialized.
+  std::thread thread_;
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_TIMERSERVICE_H_
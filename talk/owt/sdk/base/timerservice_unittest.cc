@@ -0,0 +1,116 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "talk/owt/sdk/base/timerservice.h"
+#include "talk/owt/sdk/test/latch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gmock/include/gmock/gmock.h"
+namespace owt {
+namespace base {
+using owt::test::Latch;
+TEST(TimerServiceTest, RunsTimersInDeadlineOrder) {
+  TimerService service;
+  std::mutex mutex;
+  std::vector<int> order;
+  Latch latch(3);
+  auto record = [&](int value) {
+    return [&, value] {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(value);
+      }
+      latch.Signal();
+    };
+  };
+  service.Schedule(record(3), 60);
+  service.Schedule(record(1), 0);
+  service.Schedule(record(2), 30);
+  ASSERT_TRUE(latch.Wait());
+  EXPECT_EQ(order, std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(0u, service.Size());
+}
+TEST(TimerServiceTest, TimersShareOneThread) {
+  TimerService service;
+  const int kTimers = 1000;
+  std::mutex mutex;
+  std::vector<std::thread::id> threads;
+  Latch latch(kTimers);
+  for (int i = 0; i < kTimers; i++) {
+    service.Schedule(
+        [&] {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.push_back(std::this_thread::get_id());
+          }
+          latch.Signal();
+        },
+        i % 10);
+  }
+  ASSERT_TRUE(latch.Wait());
+  ASSERT_EQ(static_cast<size_t>(kTimers), threads.size());
+  for (auto& thread : threads)
+    EXPECT_EQ(threads[0], thread);
+  EXPECT_NE(std::this_thread::get_id(), threads[0]);
+}
+TEST(TimerServiceTest, CancelledTimerDoesNotRun) {
+  TimerService service;
+  std::atomic<bool> cancelled_run(false);
+  Latch latch(1);
+  TimerService::TimerId id =
+      service.Schedule([&] { cancelled_run = true; }, 20);
+  service.Schedule([&] { latch.Signal(); }, 40);
+  EXPECT_TRUE(service.Cancel(id));
+  EXPECT_FALSE(service.Cancel(id));
+  EXPECT_FALSE(service.Cancel(TimerService::kInvalidTimerId));
+  ASSERT_TRUE(latch.Wait());
+  EXPECT_FALSE(cancelled_run);
+}
+TEST(TimerServiceTest, CancelWaitsForRunningTask) {
+  TimerService service;
+  Latch started(1);
+  std::atomic<bool> finished(false);
+  TimerService::TimerId id = service.Schedule(
+      [&] {
+        started.Signal();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+      },
+      0);
+  ASSERT_TRUE(started.Wait());
+  EXPECT_FALSE(service.Cancel(id));
+  EXPECT_TRUE(finished);
+}
+TEST(TimerServiceTest, TaskCanCancelAndScheduleTimers) {
+  TimerService service;
+  Latch latch(1);
+  std::atomic<TimerService::TimerId> id(TimerService::kInvalidTimerId);
+  std::atomic<bool> other_run(false);
+  TimerService::TimerId other =
+      service.Schedule([&] { other_run = true; }, 1000);
+  id = service.Schedule(
+      [&] {
+        // Cancelling itself must not wait for itself.
+        EXPECT_FALSE(service.Cancel(id));
+        EXPECT_TRUE(service.Cancel(other));
+        service.Schedule([&] { latch.Signal(); }, 0);
+      },
+      20);
+  ASSERT_TRUE(latch.Wait());
+  EXPECT_FALSE(other_run);
+}
+TEST(TimerServiceTest, DropsPendingTimersWhenDestroyed) {
+  std::atomic<bool> run(false);
+  {
+    TimerService service;
+    service.Schedule([&] { run = true; }, 10000);
+    EXPECT_EQ(1u, service.Size());
+  }
+  EXPECT_FALSE(run);
+}
+}  // namespace base
+}  // namespace owt
@@ -3,9 +3,16 @@
 // SPDX-License-Identifier: Apache-2.0
 #include <algorithm>
 #include <string>
+#include <unordered_set>
+#include "talk/owt/sdk/base/batchresults.h"
+#include "talk/owt/sdk/base/callbackexecutor.h"
 #include "talk/owt/sdk/base/mediautils.h"
+#include "talk/owt/sdk/base/peerconnectiondependencyfactory.h"
+#include "talk/owt/sdk/base/peerconnectionpool.h"
 #include "talk/owt/sdk/base/stringutils.h"
 #include "talk/owt/sdk/conference/conferencepeerconnectionchannel.h"
+#include "talk/owt/sdk/conference/conferencesharedpeerconnectionchannel.h"
+#include "talk/owt/sdk/conference/signalingmessagedecoder.h"
 #include "talk/owt/sdk/include/cpp/owt/base/stream.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/conferenceclient.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/remotemixedstream.h"
@@ -13,7 +20,6 @@
 #include "webrtc/rtc_base/third_party/base64/base64.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/logging.h"
-#include "webrtc/rtc_base/task_queue.h"
 using namespace rtc;
 namespace owt {
 namespace conference {
@@ -55,103 +61,114 @@ void Participant::TriggerOnParticipantLeft() {
     (*its).get().OnLeft();
   }
 }
-void ConferenceInfo::AddParticipant(std::shared_ptr<Participant> participant) {
-  if (!ParticipantPresent(participant->Id())) {
-    const std::lock_guard<std::mutex> lock(participants_mutex_);
-    participants_.push_back(participant);
+std::shared_ptr<const std::vector<std::shared_ptr<RemoteStream>>>
+ConferenceInfo::RemoteStreamsSnapshot() const {
+  const std::lock_guard<std::mutex> lock(remote_streams_mutex_);
+  if (!remote_streams_snapshot_) {
+    remote_streams_snapshot_ =
+        std::make_shared<const std::vector<std::shared_ptr<RemoteStream>>>(
+            remote_streams_.begin(), remote_streams_.end());
+  }
+  return remote_streams_snapshot_;
+}
+std::shared_ptr<const std::vector<std::shared_ptr<Participant>>>
+ConferenceInfo::ParticipantsSnapshot() const {
+  const std::lock_guard<std::mutex> lock(participants_mutex_);
+  if (!participants_snapshot_) {
+    participants_snapshot_ =
+        std::make_shared<const std::vector<std::shared_ptr<Participant>>>(
+            participants_.begin(), participants_.end());
   }
-  return;
+  return participants_snapshot_;
+}
+void ConferenceInfo::AddParticipant(std::shared_ptr<Participant> participant) {
+  const std::lock_guard<std::mutex> lock(participants_mutex_);
+  auto index = participant_index_.emplace(participant->Id(),
+                                          participants_.end());
+  if (!index.second)
+    return;
+  index.first->second = participants_.insert(participants_.end(), participant);
+  participants_snapshot_.reset();
 }
 void ConferenceInfo::AddOrUpdateStream(
     std::shared_ptr<RemoteStream> remote_stream,
     bool& update) {
   update = false;
-  std::string stream_id = remote_stream->Id();
-  const std::lock_guard<std::mutex> lock(remote_streams_mutex_);
-  auto it = std::find_if(remote_streams_.begin(), remote_streams_.end(),
-                         [&](std::shared_ptr<RemoteStream> o) -> bool {
-                           bool match = (o->Id() == stream_id);
-                           if (match)
-                             update = true;
-                           return match;
-                         });
-  if (update && it != remote_streams_.end()) {
-    (*it)->Capabilities(remote_stream->Capabilities());
-    (*it)->Settings(remote_stream->Settings());
-    // Attributes is not supported to be updated so we will not update it.
-    TriggerOnStreamUpdated(stream_id);
-  } else {
-    remote_streams_.push_back(remote_stream);
+  std::shared_ptr<RemoteStream> existing_stream;
+  {
+    const std::lock_guard<std::mutex> lock(remote_streams_mutex_);
+    auto index = remote_stream_index_.emplace(remote_stream->Id(),
+                                              remote_streams_.end());
+    if (index.second) {
+      index.first->second =
+          remote_streams_.insert(remote_streams_.end(), remote_stream);
+      remote_streams_snapshot_.reset();
+      return;
+    }
+    existing_stream = *index.first->second;
   }
+  update = true;
+  existing_stream->Capabilities(remote_stream->Capabilities());
+  existing_stream->Settings(remote_stream->Settings());
+  // Attributes is not supported to be updated so we will not update it.
+  existing_stream->TriggerOnStreamUpdated();
 }
 void ConferenceInfo::RemoveParticipantById(const std::string& id) {
   const std::lock_guard<std::mutex> lock(participants_mutex_);
-  participants_.erase(std::find_if(
-      participants_.begin(), participants_.end(),
-      [&](std::shared_ptr<Participant> o) -> bool { return o->Id() == id; }));
+  auto index = participant_index_.find(id);
+  if (index == participant_index_.end())
+    return;
+  participants_.erase(index->second);
+  participant_index_.erase(index);
+  participants_snapshot_.reset();
 }
 void ConferenceInfo::RemoveStreamById(const std::string& stream_id) {
   const std::lock_guard<std::mutex> lock(remote_streams_mutex_);
-  remote_streams_.erase(
-      std::find_if(remote_streams_.begin(), remote_streams_.end(),
-                   [&](std::shared_ptr<RemoteStream> o) -> bool {
-                     return o->Id() == stream_id;
-                   }));
+  auto index = remote_stream_index_.find(stream_id);
+  if (index == remote_stream_index_.end())
+    return;
+  remote_streams_.erase(index->second);
+  remote_stream_index_.erase(index);
+  remote_streams_snapshot_.reset();
 }
-bool ConferenceInfo::ParticipantPresent(const std::string& participant_id) {
+std::shared_ptr<Participant> ConferenceInfo::FindParticipant(
+    const std::string& id) const {
   const std::lock_guard<std::mutex> lock(participants_mutex_);
-  for (auto& it : participants_) {
-    if (it->Id() == participant_id)
-      return true;
-  }
-  return false;
+  auto index = participant_index_.find(id);
+  return index == participant_index_.end() ? nullptr : *index->second;
 }
-bool ConferenceInfo::RemoteStreamPresent(const std::string& stream_id) {
+std::shared_ptr<RemoteStream> ConferenceInfo::FindRemoteStream(
+    const std::string& id) const {
   const std::lock_guard<std::mutex> lock(remote_streams_mutex_);
-  for (auto& it : remote_streams_) {
-    if (it->Id() == stream_id)
-      return true;
-  }
-  return false;
+  auto index = remote_stream_index_.find(id);
+  return index == remote_stream_index_.end() ? nullptr : *index->second;
 }
 void ConferenceInfo::TriggerOnParticipantLeft(
     const std::string& participant_id) {
-  const std::lock_guard<std::mutex> lock(participants_mutex_);
-  for (auto& it : participants_) {
-    if (it->Id() == participant_id) {
-      it->TriggerOnParticipantLeft();
-      break;
-    }
-  }
+  auto participant = FindParticipant(participant_id);
+  if (participant)
+    participant->TriggerOnParticipantLeft();
 }
 void ConferenceInfo::TriggerOnStreamEnded(const std::string& stream_id) {
-  for (auto& it : remote_streams_) {
-    if (it->Id() == stream_id) {
-      it->TriggerOnStreamEnded();
-      break;
-    }
-  }
+  auto stream = FindRemoteStream(stream_id);
+  if (stream)
+    stream->TriggerOnStreamEnded();
 }
 void ConferenceInfo::TriggerOnStreamUpdated(const std::string& stream_id) {
-  for (auto& it : remote_streams_) {
-    if (it->Id() == stream_id) {
-      it->TriggerOnStreamUpdated();
-      break;
-    }
-  }
+  auto stream = FindRemoteStream(stream_id);
+  if (stream)
+    stream->TriggerOnStreamUpdated();
 }
 void ConferenceInfo::TriggerOnStreamMuteOrUnmute(const std::string& stream_id, 
           owt::base::TrackKind track_kind, bool muted) {
-  for (auto& it : remote_streams_) {
-    if (it->Id() == stream_id) {
-      if (muted) {
-        it->TriggerOnStreamMute(track_kind);
-      }
-      else {
-        it->TriggerOnStreamUnmute(track_kind);
-      }      
-      break;
-    }
+  auto stream = FindRemoteStream(stream_id);
+  if (!stream)
+    return;
+  if (muted) {
+    stream->TriggerOnStreamMute(track_kind);
+  }
+  else {
+    stream->TriggerOnStreamUnmute(track_kind);
   }
 }
 enum ConferenceClient::StreamType : int {
@@ -168,11 +185,22 @@ std::shared_ptr<ConferenceClient> ConferenceClient::Create(
 ConferenceClient::ConferenceClient(
     const ConferenceClientConfiguration& configuration)
     : configuration_(configuration),
-      event_queue_(new rtc::TaskQueue("ConferenceClientEventQueue")),
+      event_queue_(new TaskSequence("ConferenceClientEventQueue")),
       signaling_channel_(new ConferenceSocketSignalingChannel()),
-      signaling_channel_connected_(false) {}
+      signaling_channel_connected_(false),
+      notification_flush_scheduled_(false) {
+  signaling_channel_->SetAckTimeout(configuration.signaling_timeout_ms);
+  signaling_channel_->SetSessionGracePeriod(
+      configuration.session_grace_period_ms);
+  signaling_channel_->SetMaxInFlightMessages(
+      configuration.max_pending_signaling_requests);
+  signaling_channel_->SetIceCandidateBatchWindow(
+      configuration.ice_candidate_batch_window_ms);
+  PeerConnectionDependencyFactory::RetainShards();
+}
 ConferenceClient::~ConferenceClient() {
   signaling_channel_->RemoveObserver(*this);
+  PeerConnectionDependencyFactory::ReleaseShards();
 }
 void ConferenceClient::AddObserver(ConferenceClientObserver& observer) {
   const std::lock_guard<std::mutex> lock(observer_mutex_);
@@ -242,6 +270,24 @@ void ConferenceClient::Join(
                            "please pass it without modification.";
     token_base64 = rtc::Base64::Encode(token);
   }
+  if (!signaling_channel_->IsSessionKept()) {
+    // State of last session is stale.
+    const std::lock_guard<std::mutex> lock(conference_info_mutex_);
+    current_conference_info_.reset();
+    added_streams_.clear();
+    added_stream_type_.clear();
+  }
+  if (configuration_.peer_connection_pool_high_watermark > 0) {
+    std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
+    if (!peer_connection_pool_) {
+      peer_connection_pool_.reset(new PeerConnectionPool(
+          GetPeerConnectionChannelConfiguration(),
+          configuration_.peer_connection_pool_low_watermark,
+          configuration_.peer_connection_pool_high_watermark));
+    }
+    // Warm up PeerConnections while joining.
+    peer_connection_pool_->Start();
+  }
   signaling_channel_->AddObserver(*this);
   signaling_channel_->Connect(
       token_base64,
@@ -269,11 +315,12 @@ void ConferenceClient::Join(
           user_id = info->get_map()["user"]->get_string();
           role = info->get_map()["role"]->get_string();
           const std::lock_guard<std::mutex> lock(conference_info_mutex_);
+          // Conference info of a kept session is reused, and updated below.
           if (!current_conference_info_.get()) {
             current_conference_info_.reset(new ConferenceInfo);
-            current_conference_info_->self_.reset(
-                new Participant(participant_id, role, user_id));
           }
+          current_conference_info_->self_.reset(
+              new Participant(participant_id, role, user_id));
         }
         auto room_info = info->get_map()["room"];
         if (room_info == nullptr ||
@@ -289,38 +336,25 @@ void ConferenceClient::Join(
           current_conference_info_->id_ =
               room_info->get_map()["id"]->get_string();
         }
-        // Trigger OnUserJoin for existed users, and also fill in the
-        // ConferenceInfo.
-        if (room_info->get_map()["participants"]->get_flag() !=
-            sio::message::flag_array) {
-          RTC_LOG(LS_WARNING) << "Room info doesn't contain valid users.";
-        } else {
-          auto users = room_info->get_map()["participants"]->get_vector();
-          // Make sure |on_success| is triggered before any other events because
-          // OnUserJoined and OnStreamAdded should be triggered after join a
-          // conference.
-          for (auto it = users.begin(); it != users.end(); ++it) {
-            TriggerOnUserJoined(*it, true);
-          }
-        }
-        // Trigger OnStreamAdded for existed remote streams, and also fill in
-        // the ConferenceInfo.
-        if (room_info->get_map()["streams"]->get_flag() !=
-            sio::message::flag_array) {
-          RTC_LOG(LS_WARNING) << "Room info doesn't contain valid streams.";
-        } else {
-          auto streams = room_info->get_map()["streams"]->get_vector();
-          for (auto it = streams.begin(); it != streams.end(); ++it) {
-            RTC_LOG(LS_INFO) << "Find streams in the conference.";
-            TriggerOnStreamAdded(*it, true);
-          }
-        }
+        // Fill in the ConferenceInfo with existed users and remote streams.
+        // Make sure |on_success| is triggered before any other events because
+        // OnUserJoined and OnStreamAdded should be triggered after join a
+        // conference. When a session kept after last Leave is reused, only
+        // users left and streams removed since then are notified, after
+        // |on_success|.
+        auto removals = ApplyRoomInfo(room_info, true);
         // Invoke the success callback before trigger any participant join or
         // stream added message.
         if (on_success) {
           event_queue_->PostTask(
               [on_success, this]() { on_success(current_conference_info_); });
         }
+        if (!removals.empty()) {
+          event_queue_->PostTask([removals]() {
+            for (const auto& notify : removals)
+              notify();
+          });
+        }
       },
       on_failure);
 }
@@ -467,15 +501,35 @@ void ConferenceClient::Subscribe(
   // Reorder SDP according to perference list.
   PeerConnectionChannelConfiguration config =
       GetPeerConnectionChannelConfiguration();
+  config.receive_only = true;
+  {
+    std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
+    config.peer_connection_pool = peer_connection_pool_;
+  }
   for (auto codec : options.video.codecs) {
     config.video.push_back(VideoEncodingParameters(codec, 0, false));
   }
   for (auto codec : options.audio.codecs) {
     config.audio.push_back(AudioEncodingParameters(codec, 0));
   }
+  // Subscriptions with codec preferences need their own SDP.
+  std::shared_ptr<ConferenceSharedPeerConnectionChannel> shared_channel;
+  if (configuration_.multiplex_subscriptions && options.video.codecs.empty() &&
+      options.audio.codecs.empty()) {
+    std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
+    if (!shared_subscription_channel_ ||
+        (!shared_subscription_channel_->AcceptsSubscriptions() &&
+         !shared_subscription_channel_->IsMultiplexingUnsupported())) {
+      shared_subscription_channel_.reset(
+          new ConferenceSharedPeerConnectionChannel(config,
+                                                    signaling_channel_));
+    }
+    if (shared_subscription_channel_->AcceptsSubscriptions())
+      shared_channel = shared_subscription_channel_;
+  }
   std::shared_ptr<ConferencePeerConnectionChannel> pcc(
       new ConferencePeerConnectionChannel(config, signaling_channel_,
-                                          event_queue_));
+                                          event_queue_, shared_channel));
   pcc->AddObserver(*this);
   {
     std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
@@ -498,6 +552,60 @@ void ConferenceClient::Subscribe(
       },
       on_failure);
 }
+void ConferenceClient::PublishBatch(
+    const std::vector<PublishRequest>& requests,
+    std::function<void(std::vector<PublishResult>)> on_complete) {
+  if (requests.empty()) {
+    if (on_complete) {
+      event_queue_->PostTask(
+          [on_complete]() { on_complete(std::vector<PublishResult>()); });
+    }
+    return;
+  }
+  auto results = std::make_shared<BatchResults<PublishResult>>(
+      requests.size(), on_complete);
+  // Callbacks run on |event_queue_|, and so does |on_complete|.
+  for (size_t i = 0; i < requests.size(); i++) {
+    Publish(requests[i].stream, requests[i].options,
+            [results, i](std::shared_ptr<ConferencePublication> publication) {
+              PublishResult result;
+              result.publication = publication;
+              results->Complete(i, result);
+            },
+            [results, i](std::unique_ptr<Exception> e) {
+              PublishResult result;
+              result.exception = std::move(e);
+              results->Complete(i, result);
+            });
+  }
+}
+void ConferenceClient::SubscribeBatch(
+    const std::vector<SubscribeRequest>& requests,
+    std::function<void(std::vector<SubscribeResult>)> on_complete) {
+  if (requests.empty()) {
+    if (on_complete) {
+      event_queue_->PostTask(
+          [on_complete]() { on_complete(std::vector<SubscribeResult>()); });
+    }
+    return;
+  }
+  auto results = std::make_shared<BatchResults<SubscribeResult>>(
+      requests.size(), on_complete);
+  for (size_t i = 0; i < requests.size(); i++) {
+    Subscribe(
+        requests[i].stream, requests[i].options,
+        [results, i](std::shared_ptr<ConferenceSubscription> subscription) {
+          SubscribeResult result;
+          result.subscription = subscription;
+          results->Complete(i, result);
+        },
+        [results, i](std::unique_ptr<Exception> e) {
+          SubscribeResult result;
+          result.exception = std::move(e);
+          results->Complete(i, result);
+        });
+  }
+}
 void ConferenceClient::UnPublish(
     const std::string& session_id,
     std::function<void()> on_success,
@@ -733,6 +841,10 @@ void ConferenceClient::Leave(
   {
     std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
     subscribe_pcs_.clear();
+    shared_subscription_channel_.reset();
+    // Idle PeerConnections hold ports and threads until next Join.
+    if (peer_connection_pool_)
+      peer_connection_pool_->Drain();
   }
   signaling_channel_->Disconnect(RunInEventQueue(on_success), on_failure);
 }
@@ -777,6 +889,18 @@ void ConferenceClient::GetStats(
   }
   pcc->GetStats(on_success, on_failure);
 }
+ConferenceClientStats ConferenceClient::GetClientStats() const {
+  ConferenceClientStats stats;
+  {
+    std::lock_guard<std::mutex> lock(client_stats_mutex_);
+    stats = client_stats_;
+  }
+  stats.callback_executor = CallbackExecutor::Get()->GetStats();
+  std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
+  if (peer_connection_pool_)
+    stats.pooled_peer_connections = peer_connection_pool_->Size();
+  return stats;
+}
 void ConferenceClient::OnStreamAdded(sio::message::ptr stream) {
   TriggerOnStreamAdded(stream);
 }
@@ -804,6 +928,33 @@ void ConferenceClient::OnSignalingMessage(sio::message::ptr message) {
     RTC_LOG(LS_WARNING) << "Ignore signaling status except soac/ready/error.";
     return;
   }
+  // SOAC messages of a shared transport carry transport ID.
+  std::shared_ptr<ConferenceSharedPeerConnectionChannel> shared_channel;
+  {
+    std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
+    shared_channel = shared_subscription_channel_;
+  }
+  if (shared_channel && stream_id == shared_channel->TransportId()) {
+    if (soac_status->get_string() == "soac") {
+      auto soac_data = message->get_map()["data"];
+      if (soac_data == nullptr ||
+          soac_data->get_flag() != sio::message::flag_object) {
+        RTC_LOG(LS_WARNING) << "Received signaling message without answer.";
+        return;
+      }
+      shared_channel->OnSignalingMessage(soac_data);
+      return;
+    }
+    // Without transport sharing, transport ID is the first subscription's ID,
+    // which handles its progress.
+    if (!shared_channel->IsMultiplexingUnsupported()) {
+      if (soac_status->get_string() == "error") {
+        shared_channel->OnTransportError(
+            "MCU reported an error was occurred for shared transport.");
+      }
+      return;
+    }
+  }
   auto pcc = GetConferencePeerConnectionChannel(stream_id);
   if (pcc == nullptr) {
     RTC_LOG(LS_WARNING) << "Received signaling message from unknown sender.";
@@ -864,6 +1015,10 @@ void ConferenceClient::OnServerDisconnected() {
     std::lock_guard<std::mutex> lock(subscribe_pcs_mutex_);
     subscribe_pcs_.clear();
     subscribe_id_label_map_.clear();
+    shared_subscription_channel_.reset();
+    // Idle PeerConnections hold ports and threads until next Join.
+    if (peer_connection_pool_)
+      peer_connection_pool_->Drain();
   }
   for (auto its = observers_.begin(); its != observers_.end(); ++its) {
     (*its).get().OnServerDisconnected();
@@ -874,6 +1029,26 @@ void ConferenceClient::OnStreamError(
     std::shared_ptr<const Exception> exception) {
   TriggerOnStreamError(stream, exception);
 }
+// Adds |sample| to |stats|.
+static void AddSample(SampleStats* stats, int64_t sample) {
+  if (stats->count == 0 || sample < stats->min)
+    stats->min = sample;
+  if (stats->count == 0 || sample > stats->max)
+    stats->max = sample;
+  stats->count++;
+  stats->sum += sample;
+}
+void ConferenceClient::OnFirstFrame(int elapsed_ms, bool pooled) {
+  std::lock_guard<std::mutex> lock(client_stats_mutex_);
+  AddSample(pooled ? &client_stats_.time_to_first_frame_pooled_ms
+                   : &client_stats_.time_to_first_frame_unpooled_ms,
+            elapsed_ms);
+}
+void ConferenceClient::OnConnected(int elapsed_ms, int candidate_messages) {
+  std::lock_guard<std::mutex> lock(client_stats_mutex_);
+  AddSample(&client_stats_.time_to_connect_ms, elapsed_ms);
+  AddSample(&client_stats_.ice_candidate_messages, candidate_messages);
+}
 void ConferenceClient::OnStreamId(const std::string& id,
                                   const std::string& publish_stream_label) {
   {
@@ -929,275 +1104,26 @@ bool ConferenceClient::CheckSignalingChannelOnline(
 }
 void ConferenceClient::ParseStreamInfo(sio::message::ptr stream_info,
                                        bool joining) {
-  std::string id = stream_info->get_map()["id"]->get_string();
-  std::string view("");
-  // owner_id here stands for participantID
-  std::string owner_id("");
-  std::string video_source("");
-  std::string audio_source("");
-  bool has_audio = false, has_video = false;
-  std::unordered_map<std::string, std::string> attributes;
-  auto media_info = stream_info->get_map()["media"];
-  if (media_info == nullptr ||
-      media_info->get_flag() != sio::message::flag_object) {
-    RTC_DCHECK(false);
-    RTC_LOG(LS_ERROR) << "Invalid media info from stream " << id
-                      << ", this stream will be ignored.";
+  StreamInfoMessage stream_info_message;
+  if (!DecodeStreamInfo(stream_info, &stream_info_message)) {
+    RTC_LOG(LS_ERROR) << "Invalid stream info, this stream will be ignored.";
     return;
   }
-  auto type = stream_info->get_map()["type"]->get_string();
-  if (type != "mixed" && type != "forward") {
-    RTC_LOG(LS_ERROR) << "Invalid stream type.";
-    return;
-  } else if (type == "mixed") {
-    // Get the view info for mixed stream.
-    auto view_info_obj = stream_info->get_map()["info"];
-    if (view_info_obj != nullptr &&
-        view_info_obj->get_flag() == sio::message::flag_object) {
-      auto label_obj = view_info_obj->get_map()["label"];
-      if (label_obj != nullptr &&
-          label_obj->get_flag() == sio::message::flag_string) {
-        view = label_obj->get_string();
-      }
-    }
-  } else if (type == "forward") {
-    // Get the stream attributes and owner id;
-    auto pub_info = stream_info->get_map()["info"];
-    if (pub_info == nullptr ||
-        pub_info->get_flag() != sio::message::flag_object) {
-      RTC_LOG(LS_ERROR) << "Invalid publication info from stream " << id
-                        << ", this stream will be ignored";
-      return;
-    }
-    owner_id = pub_info->get_map()["owner"]->get_string();
-    attributes = AttributesFromStreamInfo(pub_info);
-  }
-  SubscriptionCapabilities subscription_capabilities;
-  PublicationSettings publication_settings;
-  auto audio_info = media_info->get_map()["audio"];
-  if (audio_info == nullptr ||
-      audio_info->get_flag() != sio::message::flag_object) {
-    RTC_LOG(LS_INFO) << "No audio in stream " << id;
-  } else {
-    // Parse the VideoInfo structure.
-    auto audio_source_obj = audio_info->get_map()["source"];
-    if (audio_source_obj != nullptr &&
-        audio_source_obj->get_flag() == sio::message::flag_string) {
-      audio_source = audio_source_obj->get_string();
-    }
-    auto audio_format_obj = audio_info->get_map()["format"];
-    if (audio_format_obj == nullptr ||
-        audio_format_obj->get_flag() != sio::message::flag_object) {
-      RTC_LOG(LS_ERROR) << "Invalid audio format info in media info";
-      return;
-    }
-    // Main audio capability
-    std::string codec;
-    unsigned long sample_rate = 0, channel_num = 0;
-    auto sample_rate_obj = audio_format_obj->get_map()["sampleRate"];
-    auto codec_obj = audio_format_obj->get_map()["codec"];
-    auto channel_num_obj = audio_format_obj->get_map()["channelNum"];
-    if (codec_obj == nullptr ||
-        codec_obj->get_flag() != sio::message::flag_string) {
-      RTC_LOG(LS_ERROR) << "codec name in optional audio info invalid.";
-      return;
-    }
-    has_audio = true;
-    codec = codec_obj->get_string();
-    if (sample_rate_obj != nullptr)
-      sample_rate = sample_rate_obj->get_int();
-    if (channel_num_obj != nullptr)
-      channel_num = audio_format_obj->get_int();
-    AudioCodecParameters audio_codec_param(
-        MediaUtils::GetAudioCodecFromString(codec), channel_num, sample_rate);
-    publication_settings.audio.codec = audio_codec_param;
-    subscription_capabilities.audio.codecs.push_back(audio_codec_param);
-    // Optional audio capabilities
-    auto audio_format_obj_optional = audio_info->get_map()["optional"];
-    if (audio_format_obj_optional == nullptr ||
-        audio_format_obj_optional->get_flag() != sio::message::flag_object) {
-      RTC_LOG(LS_INFO) << "No optional audio info available";
-    } else {
-      auto audio_format_optional =
-          audio_format_obj_optional->get_map()["format"];
-      if (audio_format_optional == nullptr ||
-          audio_format_optional->get_flag() != sio::message::flag_array) {
-        RTC_LOG(LS_INFO) << "Invalid optional audio info";
-      } else {
-        auto formats = audio_format_optional->get_vector();
-        for (auto it = formats.begin(); it != formats.end(); ++it) {
-          unsigned long optional_sample_rate = 0, optional_channel_num = 0;
-          auto optional_sample_rate_obj = (*it)->get_map()["sampleRate"];
-          auto optional_codec_obj = (*it)->get_map()["codec"];
-          auto optional_channel_num_obj = (*it)->get_map()["channelNum"];
-          if (optional_codec_obj == nullptr ||
-              optional_codec_obj->get_flag() != sio::message::flag_string) {
-            RTC_LOG(LS_ERROR) << "codec name in optional audio info invalid.";
-            return;
-          }
-          codec = optional_codec_obj->get_string();
-          if (codec == "nellymoser") {
-            codec = "asao";
-          }
-          if (optional_sample_rate_obj != nullptr)
-            optional_sample_rate = optional_sample_rate_obj->get_int();
-          if (optional_channel_num_obj != nullptr)
-            optional_channel_num = optional_channel_num_obj->get_int();
-          subscription_capabilities.audio.codecs.push_back(
-              AudioCodecParameters(MediaUtils::GetAudioCodecFromString(codec),
-                                   optional_channel_num, optional_sample_rate));
-        }
-      }
-    }
-  }
-  auto video_info = media_info->get_map()["video"];
-  if (video_info == nullptr ||
-      video_info->get_flag() != sio::message::flag_object) {
-    RTC_LOG(LS_INFO) << "No audio info in the media info";
-  } else {
-    // Parse the VideoInfo structure.
-    auto video_source_obj = video_info->get_map()["source"];
-    if (video_source_obj != nullptr &&
-        video_source_obj->get_flag() == sio::message::flag_string) {
-      video_source = video_source_obj->get_string();
-    }
-    auto video_format_obj = video_info->get_map()["format"];
-    if (video_format_obj == nullptr ||
-        video_format_obj->get_flag() != sio::message::flag_object) {
-      RTC_LOG(LS_ERROR) << "Invalid video format info.";
-      return;
-    } else {
-      has_video = true;
-      VideoSubscriptionCapabilities video_subscription_capabilities;
-      // Parse the video publication settings.
-      std::string codec_name =
-          video_format_obj->get_map()["codec"]->get_string();
-      std::string profile_name("");
-      auto profile_name_obj = video_format_obj->get_map()["profile"];
-      if (profile_name_obj != nullptr &&
-          profile_name_obj->get_flag() == sio::message::flag_string) {
-        profile_name = profile_name_obj->get_string();
-      }
-      VideoPublicationSettings video_publication_settings;
-      VideoCodecParameters video_codec_parameters(
-          MediaUtils::GetVideoCodecFromString(codec_name), profile_name);
-      video_publication_settings.codec = video_codec_parameters;
-      video_subscription_capabilities.codecs.push_back(video_codec_parameters);
-      auto video_params_obj = video_info->get_map()["parameters"];
-      if (video_params_obj != nullptr &&
-          video_params_obj->get_flag() == sio::message::flag_object) {
-        auto main_resolution = video_params_obj->get_map()["resolution"];
-        if (main_resolution != nullptr &&
-            main_resolution->get_flag() == sio::message::flag_object) {
-          Resolution resolution =
-              Resolution(main_resolution->get_map()["width"]->get_int(),
-                         main_resolution->get_map()["height"]->get_int());
-          video_publication_settings.resolution = resolution;
-          video_subscription_capabilities.resolutions.push_back(resolution);
-        }
-        double frame_rate_num = 0, bitrate_num = 0, keyframe_interval_num = 0;
-        auto main_frame_rate = video_params_obj->get_map()["framerate"];
-        if (main_frame_rate != nullptr) {
-          frame_rate_num = main_frame_rate->get_int();
-          video_publication_settings.frame_rate = frame_rate_num;
-          video_subscription_capabilities.frame_rates.push_back(frame_rate_num);
-        }
-        auto main_bitrate = video_params_obj->get_map()["bitrate"];
-        if (main_bitrate != nullptr) {
-          bitrate_num = main_bitrate->get_int();
-          video_publication_settings.bitrate = bitrate_num;
-        }
-        auto main_keyframe_interval =
-            video_params_obj->get_map()["keyFrameInterval"];
-        if (main_keyframe_interval != nullptr) {
-          keyframe_interval_num = main_keyframe_interval->get_int();
-          video_publication_settings.keyframe_interval = keyframe_interval_num;
-          video_subscription_capabilities.keyframe_intervals.push_back(
-              keyframe_interval_num);
-        }
-      }
-      publication_settings.video = video_publication_settings;
-      // Parse the video subscription capabilities.
-      auto optional_video_obj = video_info->get_map()["optional"];
-      if (optional_video_obj != nullptr &&
-          optional_video_obj->get_flag() == sio::message::flag_object) {
-        auto optional_video_format_obj =
-            optional_video_obj->get_map()["format"];
-        if (optional_video_format_obj != nullptr &&
-            optional_video_format_obj->get_flag() == sio::message::flag_array) {
-          auto formats = optional_video_format_obj->get_vector();
-          for (auto it = formats.begin(); it != formats.end(); ++it) {
-            std::string optional_codec_name =
-                (*it)->get_map()["codec"]->get_string();
-            std::string optional_profile_name("");
-            auto optional_profile_name_obj = (*it)->get_map()["profile"];
-            if (optional_profile_name_obj != nullptr &&
-                optional_profile_name_obj->get_flag() ==
-                    sio::message::flag_string) {
-              optional_profile_name = optional_profile_name_obj->get_string();
-            }
-            video_subscription_capabilities.codecs.push_back(
-                VideoCodecParameters(
-                    MediaUtils::GetVideoCodecFromString(optional_codec_name),
-                    optional_profile_name));
-          }
-        }
-        auto optional_video_params_obj =
-            optional_video_obj->get_map()["parameters"];
-        if (optional_video_params_obj != nullptr &&
-            optional_video_params_obj->get_flag() ==
-                sio::message::flag_object) {
-          auto resolution_obj =
-              optional_video_params_obj->get_map()["resolution"];
-          if (resolution_obj != nullptr &&
-              resolution_obj->get_flag() == sio::message::flag_array) {
-            auto resolutions = resolution_obj->get_vector();
-            for (auto it = resolutions.begin(); it != resolutions.end(); ++it) {
-              Resolution resolution =
-                  Resolution((*it)->get_map()["width"]->get_int(),
-                             (*it)->get_map()["height"]->get_int());
-              video_subscription_capabilities.resolutions.push_back(resolution);
-            }
-          }
-          auto framerate_obj =
-              optional_video_params_obj->get_map()["framerate"];
-          if (framerate_obj != nullptr &&
-              framerate_obj->get_flag() == sio::message::flag_array) {
-            auto framerates = framerate_obj->get_vector();
-            for (auto it = framerates.begin(); it != framerates.end(); ++it) {
-              double frame_rate = (*it)->get_int();
-              video_subscription_capabilities.frame_rates.push_back(frame_rate);
-            }
-          }
-          auto bitrate_obj = optional_video_params_obj->get_map()["bitrate"];
-          if (bitrate_obj != nullptr &&
-              bitrate_obj->get_flag() == sio::message::flag_array) {
-            auto bitrates = bitrate_obj->get_vector();
-            for (auto it = bitrates.begin(); it != bitrates.end(); ++it) {
-              std::string bitrate_mul = (*it)->get_string();
-              // The bitrate multiplier is in the form of "x1.0" and we need to
-              // strip the "x" here.
-              video_subscription_capabilities.bitrate_multipliers.push_back(
-                  std::stod(bitrate_mul.substr(1)));
-            }
-          }
-          auto keyframe_interval_obj =
-              optional_video_params_obj->get_map()["keyFrameInterval"];
-          if (keyframe_interval_obj != nullptr &&
-              keyframe_interval_obj->get_flag() == sio::message::flag_array) {
-            auto keyframe_intervals = keyframe_interval_obj->get_vector();
-            for (auto it = keyframe_intervals.begin();
-                 it != keyframe_intervals.end(); ++it) {
-              double keyframe_interval = (*it)->get_int();
-              video_subscription_capabilities.keyframe_intervals.push_back(
-                  keyframe_interval);
-            }
-          }
-        }
-        subscription_capabilities.video = video_subscription_capabilities;
-      }
-    }
-  }
+  const std::string& id = stream_info_message.id;
+  const std::string& type = stream_info_message.type;
+  const std::string& view = stream_info_message.view;
+  // owner_id here stands for participantID
+  std::string owner_id(stream_info_message.owner_id);
+  const std::string& video_source = stream_info_message.video_source;
+  const std::string& audio_source = stream_info_message.audio_source;
+  const bool has_audio = stream_info_message.has_audio;
+  const bool has_video = stream_info_message.has_video;
+  const std::unordered_map<std::string, std::string>& attributes =
+      stream_info_message.attributes;
+  const SubscriptionCapabilities& subscription_capabilities =
+      stream_info_message.subscription_capabilities;
+  const PublicationSettings& publication_settings =
+      stream_info_message.publication_settings;
   // Now that all information needed for PublicationSettings and
   // SubscriptionCapabilities have been gathered, we construct remote streams.
   bool updated = false;
@@ -1225,13 +1151,8 @@ void ConferenceClient::ParseStreamInfo(sio::message::ptr stream_info,
       {
         const std::lock_guard<std::mutex> lock(stream_update_observer_mutex_);
         current_conference_info_->AddOrUpdateStream(remote_stream, updated);
-        if (!joining && !updated) {
-          for (auto its = observers_.begin(); its != observers_.end(); ++its) {
-            auto& o = (*its).get();
-            event_queue_->PostTask(
-                [&o, remote_stream] { o.OnStreamAdded(remote_stream); });
-          }
-        }
+        if (!joining && !updated)
+          NotifyStreamAdded(remote_stream, false);
       }
     } else {
       auto remote_stream = std::make_shared<RemoteStream>(
@@ -1247,13 +1168,8 @@ void ConferenceClient::ParseStreamInfo(sio::message::ptr stream_info,
       {
         const std::lock_guard<std::mutex> lock(stream_update_observer_mutex_);
         current_conference_info_->AddOrUpdateStream(remote_stream, updated);
-        if (!joining && !updated) {
-          for (auto its = observers_.begin(); its != observers_.end(); ++its) {
-            auto& o = (*its).get();
-            event_queue_->PostTask(
-                [&o, remote_stream] { o.OnStreamAdded(remote_stream); });
-          }
-        }
+        if (!joining && !updated)
+          NotifyStreamAdded(remote_stream, false);
       }
     }
   } else if (type == "mixed") {
@@ -1271,13 +1187,8 @@ void ConferenceClient::ParseStreamInfo(sio::message::ptr stream_info,
     {
       const std::lock_guard<std::mutex> lock(stream_update_observer_mutex_);
       current_conference_info_->AddOrUpdateStream(remote_stream, updated);
-      if (!joining) {
-        for (auto its = observers_.begin(); its != observers_.end(); ++its) {
-          auto& o = (*its).get();
-          event_queue_->PostTask(
-              [&o, remote_stream] { o.OnStreamAdded(remote_stream); });
-        }
-      }
+      if (!joining)
+        NotifyStreamAdded(remote_stream, true);
     }
   }
 }
@@ -1291,13 +1202,8 @@ void ConferenceClient::TriggerOnUserJoined(sio::message::ptr user_info,
   if (ParseUser(user_info, &user_raw)) {
     std::shared_ptr<Participant> user(user_raw);
     current_conference_info_->AddParticipant(user);
-    if (!joining) {
-      const std::lock_guard<std::mutex> lock(observer_mutex_);
-      for (auto its = observers_.begin(); its != observers_.end(); ++its) {
-        auto& o = (*its).get();
-        event_queue_->PostTask([&o, user] { o.OnParticipantJoined(user); });
-      }
-    }
+    if (!joining)
+      NotifyParticipantJoined(user);
   }
 }
 void ConferenceClient::TriggerOnUserLeft(sio::message::ptr user_info) {
@@ -1306,29 +1212,27 @@ void ConferenceClient::TriggerOnUserLeft(sio::message::ptr user_info) {
     RTC_DCHECK(false);
     return;
   }
-  auto user_id = user_info->get_string();
-  current_conference_info_->TriggerOnParticipantLeft(user_id);
-  current_conference_info_->RemoveParticipantById(user_id);
+  RemoveParticipant(user_info->get_string())();
+}
+std::function<void()> ConferenceClient::RemoveParticipant(
+    const std::string& participant_id) {
+  CancelParticipantJoined(participant_id);
+  auto participant = current_conference_info_->FindParticipant(participant_id);
+  current_conference_info_->RemoveParticipantById(participant_id);
+  return [participant]() {
+    if (participant)
+      participant->TriggerOnParticipantLeft();
+  };
 }
 bool ConferenceClient::ParseUser(sio::message::ptr user_message,
                                  Participant** participant) const {
-  if (user_message == nullptr ||
-      user_message->get_flag() != sio::message::flag_object ||
-      user_message->get_map()["id"] == nullptr ||
-      user_message->get_map()["id"]->get_flag() != sio::message::flag_string ||
-      user_message->get_map()["user"] == nullptr ||
-      user_message->get_map()["user"]->get_flag() !=
-          sio::message::flag_string ||
-      user_message->get_map()["role"] == nullptr ||
-      user_message->get_map()["role"]->get_flag() !=
-          sio::message::flag_string) {
+  ParticipantInfoMessage participant_info;
+  if (!DecodeParticipantInfo(user_message, &participant_info)) {
     RTC_DCHECK(false);
     return false;
   }
-  std::string id = user_message->get_map()["id"]->get_string();
-  std::string user_name = user_message->get_map()["user"]->get_string();
-  std::string role = user_message->get_map()["role"]->get_string();
-  *participant = new Participant(id, role, user_name);
+  *participant = new Participant(participant_info.id, participant_info.role,
+                                 participant_info.user);
   return true;
 }
 std::shared_ptr<ConferencePeerConnectionChannel>
@@ -1383,8 +1287,68 @@ ConferenceClient::GetPeerConnectionChannelConfiguration() const {
                 kCandidateNetworkPolicyAll;
   config.continual_gathering_policy =
       PeerConnectionInterface::ContinualGatheringPolicy::GATHER_CONTINUALLY;
+  config.ice_restart_on_network_change =
+      configuration_.ice_restart_on_network_change;
   return config;
 }
+void ConferenceClient::OnRoomResync(std::shared_ptr<sio::message> room_info) {
+  for (const auto& notify : ApplyRoomInfo(room_info, false))
+    notify();
+}
+std::vector<std::function<void()>> ConferenceClient::ApplyRoomInfo(
+    std::shared_ptr<sio::message> room_info,
+    bool joining) {
+  std::vector<std::function<void()>> removals;
+  // Participants first, so owners are known when streams are added.
+  auto participants = room_info->get_map()["participants"];
+  if (participants && participants->get_flag() == sio::message::flag_array) {
+    std::unordered_set<std::string> current_ids;
+    for (const auto& participant : participants->get_vector()) {
+      if (!participant || participant->get_flag() != sio::message::flag_object)
+        continue;
+      auto id = participant->get_map()["id"];
+      if (!id || id->get_flag() != sio::message::flag_string)
+        continue;
+      current_ids.insert(id->get_string());
+      if (!current_conference_info_->FindParticipant(id->get_string()))
+        TriggerOnUserJoined(participant, joining);
+    }
+    for (const auto& participant :
+         *current_conference_info_->ParticipantsSnapshot()) {
+      if (current_ids.find(participant->Id()) == current_ids.end())
+        removals.push_back(RemoveParticipant(participant->Id()));
+    }
+  } else {
+    RTC_LOG(LS_WARNING) << "Room info doesn't contain valid users.";
+  }
+  auto streams = room_info->get_map()["streams"];
+  if (streams && streams->get_flag() == sio::message::flag_array) {
+    std::unordered_set<std::string> current_ids;
+    for (const auto& stream : streams->get_vector()) {
+      if (!stream || stream->get_flag() != sio::message::flag_object)
+        continue;
+      auto id = stream->get_map()["id"];
+      if (!id || id->get_flag() != sio::message::flag_string)
+        continue;
+      current_ids.insert(id->get_string());
+      if (added_streams_.find(id->get_string()) == added_streams_.end())
+        TriggerOnStreamAdded(stream, joining);
+    }
+    std::vector<std::string> removed_ids;
+    for (const auto& stream : added_streams_) {
+      if (current_ids.find(stream.first) == current_ids.end())
+        removed_ids.push_back(stream.first);
+    }
+    for (const auto& id : removed_ids) {
+      auto notify = RemoveStream(id);
+      if (notify)
+        removals.push_back(notify);
+    }
+  } else {
+    RTC_LOG(LS_WARNING) << "Room info doesn't contain valid streams.";
+  }
+  return removals;
+}
 void ConferenceClient::OnUserJoined(std::shared_ptr<sio::message> user) {
   TriggerOnUserJoined(user);
 }
@@ -1392,23 +1356,32 @@ void ConferenceClient::OnUserLeft(std::shared_ptr<sio::message> user) {
   TriggerOnUserLeft(user);
 }
 void ConferenceClient::TriggerOnStreamRemoved(sio::message::ptr stream_info) {
-  std::string id = stream_info->get_map()["id"]->get_string();
+  auto notify = RemoveStream(stream_info->get_map()["id"]->get_string());
+  if (notify)
+    notify();
+}
+std::function<void()> ConferenceClient::RemoveStream(const std::string& id) {
   auto stream_it = added_streams_.find(id);
   auto stream_type = added_stream_type_.find(id);
   if (stream_it == added_streams_.end() ||
       stream_type == added_stream_type_.end()) {
     RTC_LOG(LS_WARNING) << "Invalid stream or type.";
-    return;
+    return nullptr;
   }
   added_streams_.erase(stream_it);
   added_stream_type_.erase(stream_type);
-  current_conference_info_->TriggerOnStreamEnded(id);
+  CancelStreamAdded(id);
+  auto stream = current_conference_info_->FindRemoteStream(id);
   current_conference_info_->RemoveStreamById(id);
-  const std::lock_guard<std::mutex> lock(stream_update_observer_mutex_);
-  for (auto its = stream_update_observers_.begin();
-       its != stream_update_observers_.end(); ++its) {
-    (*its).get().OnStreamRemoved(id);
-  }
+  return [this, stream, id]() {
+    if (stream)
+      stream->TriggerOnStreamEnded();
+    const std::lock_guard<std::mutex> lock(stream_update_observer_mutex_);
+    for (auto its = stream_update_observers_.begin();
+         its != stream_update_observers_.end(); ++its) {
+      (*its).get().OnStreamRemoved(id);
+    }
+  };
 }
 void ConferenceClient::TriggerOnStreamError(
     std::shared_ptr<Stream> stream,
@@ -1490,33 +1463,123 @@ void ConferenceClient::TriggerOnStreamUpdated(sio::message::ptr stream_info) {
     }
   }
 }
-std::unordered_map<std::string, std::string>
-ConferenceClient::AttributesFromStreamInfo(
-    std::shared_ptr<sio::message> stream_info) {
-  std::unordered_map<std::string, std::string> attributes;
-  if (stream_info->get_map().find("attributes") ==
-      stream_info->get_map().end()) {
-    // TODO: CHECK here. However, to compatible with old version, no CHECK at
-    // this time.
-    RTC_LOG(LS_WARNING) << "Cannot find attributes info.";
-    return attributes;
-  }
-  auto attributes_info = stream_info->get_map()["attributes"];
-  if (attributes_info->get_flag() != sio::message::flag_object) {
-    // TODO: CHECK here. However, to compatible with old version, no CHECK at
-    // this time.
-    RTC_LOG(LS_WARNING) << "Incorrect attribute format.";
-    return attributes;
-  }
-  auto attribute_map = attributes_info->get_map();
-  for (auto const& attribute_pair : attribute_map) {
-    if (attribute_pair.second->get_flag() != sio::message::flag_string) {
-      RTC_DCHECK(false);
-      continue;
+void ConferenceClient::NotifyParticipantJoined(
+    std::shared_ptr<Participant> participant) {
+  if (configuration_.batch_notifications) {
+    const std::lock_guard<std::mutex> lock(pending_notifications_mutex_);
+    pending_joined_participants_.push_back(participant);
+    ScheduleNotificationFlush(pending_joined_participants_.size() ==
+                                      configuration_.max_notification_batch_size
+                                  ? 0
+                                  : configuration_.notification_batch_window_ms);
+    return;
+  }
+  const std::lock_guard<std::mutex> lock(observer_mutex_);
+  for (auto its = observers_.begin(); its != observers_.end(); ++its) {
+    auto& o = (*its).get();
+    event_queue_->PostTask(
+        [&o, participant] { o.OnParticipantJoined(participant); });
+  }
+}
+void ConferenceClient::NotifyStreamAdded(std::shared_ptr<RemoteStream> stream,
+                                         bool mixed) {
+  if (configuration_.batch_notifications) {
+    const std::lock_guard<std::mutex> lock(pending_notifications_mutex_);
+    pending_added_streams_.push_back(stream);
+    ScheduleNotificationFlush(pending_added_streams_.size() ==
+                                      configuration_.max_notification_batch_size
+                                  ? 0
+                                  : configuration_.notification_batch_window_ms);
+    return;
+  }
+  const std::lock_guard<std::mutex> lock(observer_mutex_);
+  for (auto its = observers_.begin(); its != observers_.end(); ++its) {
+    auto& o = (*its).get();
+    if (mixed) {
+      auto mixed_stream = std::static_pointer_cast<RemoteMixedStream>(stream);
+      event_queue_->PostTask(
+          [&o, mixed_stream] { o.OnStreamAdded(mixed_stream); });
+    } else {
+      event_queue_->PostTask([&o, stream] { o.OnStreamAdded(stream); });
     }
-    attributes[attribute_pair.first] = attribute_pair.second->get_string();
   }
-  return attributes;
+}
+void ConferenceClient::CancelParticipantJoined(
+    const std::string& participant_id) {
+  if (!configuration_.batch_notifications)
+    return;
+  const std::lock_guard<std::mutex> lock(pending_notifications_mutex_);
+  pending_joined_participants_.erase(
+      std::remove_if(pending_joined_participants_.begin(),
+                     pending_joined_participants_.end(),
+                     [&participant_id](std::shared_ptr<Participant> o) {
+                       return o->Id() == participant_id;
+                     }),
+      pending_joined_participants_.end());
+}
+void ConferenceClient::CancelStreamAdded(const std::string& stream_id) {
+  if (!configuration_.batch_notifications)
+    return;
+  const std::lock_guard<std::mutex> lock(pending_notifications_mutex_);
+  pending_added_streams_.erase(
+      std::remove_if(pending_added_streams_.begin(),
+                     pending_added_streams_.end(),
+                     [&stream_id](std::shared_ptr<RemoteStream> o) {
+                       return o->Id() == stream_id;
+                     }),
+      pending_added_streams_.end());
+}
+void ConferenceClient::ScheduleNotificationFlush(int delay_ms) {
+  // A full batch is flushed immediately even if a delayed flush is scheduled.
+  // The delayed one delivers whatever is pending when it runs.
+  if (notification_flush_scheduled_ && delay_ms > 0)
+    return;
+  notification_flush_scheduled_ = true;
+  std::weak_ptr<ConferenceClient> weak_this = shared_from_this();
+  auto flush = [weak_this] {
+    auto that = weak_this.lock();
+    if (that)
+      that->FlushNotifications();
+  };
+  if (delay_ms > 0)
+    event_queue_->PostDelayedTask(flush, delay_ms);
+  else
+    event_queue_->PostTask(flush);
+}
+void ConferenceClient::FlushNotifications() {
+  std::vector<std::shared_ptr<Participant>> participants;
+  std::vector<std::shared_ptr<RemoteStream>> streams;
+  {
+    const std::lock_guard<std::mutex> lock(pending_notifications_mutex_);
+    notification_flush_scheduled_ = false;
+    participants.swap(pending_joined_participants_);
+    streams.swap(pending_added_streams_);
+  }
+  if (participants.empty() && streams.empty())
+    return;
+  std::vector<std::reference_wrapper<ConferenceClientObserver>> observers;
+  {
+    const std::lock_guard<std::mutex> lock(observer_mutex_);
+    observers = observers_;
+  }
+  // Participants are delivered before streams they may have published.
+  const size_t batch_size =
+      std::max<size_t>(configuration_.max_notification_batch_size, 1);
+  for (size_t begin = 0; begin < participants.size(); begin += batch_size) {
+    std::vector<std::shared_ptr<Participant>> batch(
+        participants.begin() + begin,
+        participants.begin() +
+            std::min(participants.size(), begin + batch_size));
+    for (auto& o : observers)
+      o.get().OnParticipantsJoined(batch);
+  }
+  for (size_t begin = 0; begin < streams.size(); begin += batch_size) {
+    std::vector<std::shared_ptr<RemoteStream>> batch(
+        streams.begin() + begin,
+        streams.begin() + std::min(streams.size(), begin + batch_size));
+    for (auto& o : observers)
+      o.get().OnStreamsAdded(batch);
+  }
 }
 std::function<void()> ConferenceClient::RunInEventQueue(
     std::function<void()> func) {
@@ -0,0 +1,657 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "talk/owt/sdk/conference/conferencepeerconnectionchannel.h"
+#include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/localconferenceserver.h"
+#include "talk/owt/sdk/include/cpp/owt/conference/conferenceclient.h"
+#include "talk/owt/sdk/test/latch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/rtc_base/third_party/base64/base64.h"
+#include "webrtc/rtc_base/timeutils.h"
+namespace owt {
+namespace conference {
+namespace {
+using owt::test::Latch;
+const char kOfferSdp[] =
+    "v=0\r\no=- 0 2 IN IP4 127.0.0.1\r\ns=-\r\nt=0 0\r\n"
+    "a=group:BUNDLE 0\r\nm=video 9 UDP/TLS/RTP/SAVPF 96\r\n"
+    "c=IN IP4 0.0.0.0\r\na=mid:0\r\na=setup:actpass\r\n"
+    "a=ice-ufrag:abcd\r\na=ice-pwd:abcdefghijklmnopqrstuvwx\r\n"
+    "a=sendonly\r\na=rtpmap:96 VP8/90000\r\n";
+std::string Token() {
+  return rtc::Base64::Encode("{\"host\":\"localhost\"}");
+}
+// Records participant joined and stream added events. |latch| is signaled
+// once for each participant or stream.
+class RecordingObserver : public ConferenceClientObserver {
+ public:
+  explicit RecordingObserver(Latch* latch) : latch_(latch) {}
+  void OnParticipantJoined(std::shared_ptr<Participant> participant) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    single_events++;
+    participants.push_back(participant);
+    latch_->Signal();
+  }
+  void OnStreamAdded(std::shared_ptr<RemoteStream> stream) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    single_events++;
+    streams.push_back(stream);
+    latch_->Signal();
+  }
+  void OnParticipantsJoined(
+      std::vector<std::shared_ptr<Participant>> participants) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    batch_sizes.push_back(participants.size());
+    for (auto& participant : participants) {
+      ids.push_back(participant->Id());
+      latch_->Signal();
+    }
+  }
+  void OnStreamsAdded(
+      std::vector<std::shared_ptr<RemoteStream>> streams) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    batch_sizes.push_back(streams.size());
+    for (auto& stream : streams) {
+      ids.push_back(stream->Id());
+      latch_->Signal();
+    }
+  }
+  std::mutex mutex;
+  int single_events = 0;
+  std::vector<size_t> batch_sizes;
+  std::vector<std::string> ids;
+  // Participants and streams notified one by one.
+  std::vector<std::shared_ptr<Participant>> participants;
+  std::vector<std::shared_ptr<RemoteStream>> streams;
+ private:
+  Latch* latch_;
+};
+// Appends "left" to |events| when the participant leaves.
+class LeftObserver : public ParticipantObserver {
+ public:
+  LeftObserver(std::mutex* mutex,
+               std::vector<std::string>* events,
+               Latch* latch)
+      : mutex_(mutex), events_(events), latch_(latch) {}
+  void OnLeft() override {
+    {
+      std::lock_guard<std::mutex> lock(*mutex_);
+      events_->push_back("left");
+    }
+    latch_->Signal();
+  }
+ private:
+  std::mutex* mutex_;
+  std::vector<std::string>* events_;
+  Latch* latch_;
+};
+// Signals |latch| when the stream ends.
+class EndedObserver : public owt::base::StreamObserver {
+ public:
+  explicit EndedObserver(Latch* latch) : latch_(latch) {}
+  void OnEnded() override { latch_->Signal(); }
+ private:
+  Latch* latch_;
+};
+}  // namespace
+class ConferenceClientTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    LocalConferenceServer::Options options;
+    options.issue_reconnection_tickets = false;
+    StartServer(options);
+  }
+  // Replaces the server clients connect to.
+  void StartServer(const LocalConferenceServer::Options& options) {
+    server_ = LocalConferenceServer::Create(options);
+    std::weak_ptr<LocalConferenceServer> server = server_;
+    ConferenceSocketSignalingChannel::SetTransportFactory([server]() {
+      return server.lock()->CreateTransport();
+    });
+  }
+  void TearDown() override {
+    ConferenceSocketSignalingChannel::SetTransportFactory(nullptr);
+    channels_.clear();
+  }
+  std::shared_ptr<ConferenceClient> JoinClient(
+      const ConferenceClientConfiguration& configuration) {
+    auto client = ConferenceClient::Create(configuration);
+    Latch joined(1);
+    client->Join(Token(),
+                 [&joined](std::shared_ptr<ConferenceInfo>) { joined.Signal(); },
+                 nullptr);
+    EXPECT_TRUE(joined.Wait());
+    return client;
+  }
+  void LeaveClient(std::shared_ptr<ConferenceClient> client) {
+    Latch left(1);
+    client->Leave([&left]() { left.Signal(); }, nullptr);
+    EXPECT_TRUE(left.Wait());
+  }
+  // Joins a participant through a bare signaling channel.
+  std::shared_ptr<ConferenceSocketSignalingChannel> JoinChannel() {
+    auto channel = std::make_shared<ConferenceSocketSignalingChannel>(
+        server_->CreateTransport());
+    Latch joined(1);
+    channel->Connect(
+        Token(), [&joined](sio::message::ptr room_info) { joined.Signal(); },
+        nullptr);
+    EXPECT_TRUE(joined.Wait());
+    channels_.push_back(channel);
+    return channel;
+  }
+  // Publishes a video stream through |channel| and returns its ID once the
+  // server has added it.
+  std::string Publish(
+      std::shared_ptr<ConferenceSocketSignalingChannel> channel) {
+    sio::message::ptr options = sio::object_message::create();
+    sio::message::ptr media = sio::object_message::create();
+    sio::message::ptr video = sio::object_message::create();
+    video->get_map()["source"] = sio::string_message::create("camera");
+    media->get_map()["video"] = video;
+    media->get_map()["audio"] = sio::bool_message::create(false);
+    options->get_map()["media"] = media;
+    std::mutex mutex;
+    std::string stream_id;
+    Latch added(1);
+    channel->SendInitializationMessage(
+        options, "label", "",
+        [&](std::string id) {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            stream_id = id;
+          }
+          sio::message::ptr offer = sio::object_message::create();
+          offer->get_map()["type"] = sio::string_message::create("offer");
+          offer->get_map()["sdp"] = sio::string_message::create(kOfferSdp);
+          sio::message::ptr soac = sio::object_message::create();
+          soac->get_map()["id"] = sio::string_message::create(id);
+          soac->get_map()["signaling"] = offer;
+          channel->SendSdp(soac, [&added]() { added.Signal(); }, nullptr);
+        },
+        nullptr);
+    EXPECT_TRUE(added.Wait());
+    std::lock_guard<std::mutex> lock(mutex);
+    return stream_id;
+  }
+  // Subscribes video of |stream_id| on |transport_id|, or on a new transport
+  // if it is empty. Returns subscription ID and transport ID in server's ack.
+  std::pair<std::string, std::string> Subscribe(
+      std::shared_ptr<ConferenceSocketSignalingChannel> channel,
+      const std::string& stream_id,
+      const std::string& transport_id) {
+    sio::message::ptr options = sio::object_message::create();
+    sio::message::ptr media = sio::object_message::create();
+    sio::message::ptr video = sio::object_message::create();
+    video->get_map()["from"] = sio::string_message::create(stream_id);
+    media->get_map()["video"] = video;
+    media->get_map()["audio"] = sio::bool_message::create(false);
+    options->get_map()["media"] = media;
+    sio::message::ptr transport = sio::object_message::create();
+    transport->get_map()["type"] = sio::string_message::create("webrtc");
+    if (!transport_id.empty())
+      transport->get_map()["id"] = sio::string_message::create(transport_id);
+    options->get_map()["transport"] = transport;
+    std::mutex mutex;
+    std::pair<std::string, std::string> result;
+    Latch acked(1);
+    channel->SendSubscribeMessage(
+        options,
+        [&](std::string acked_session_id, std::string acked_transport_id) {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            result = std::make_pair(acked_session_id, acked_transport_id);
+          }
+          acked.Signal();
+        },
+        nullptr);
+    EXPECT_TRUE(acked.Wait());
+    std::lock_guard<std::mutex> lock(mutex);
+    return result;
+  }
+  // Joins like JoinClient, and returns conference info in |info|.
+  std::shared_ptr<ConferenceClient> JoinClientWithInfo(
+      std::shared_ptr<ConferenceInfo>* info) {
+    auto client = ConferenceClient::Create(ConferenceClientConfiguration());
+    Latch joined(1);
+    client->Join(Token(),
+                 [&joined, info](std::shared_ptr<ConferenceInfo> joined_info) {
+                   *info = joined_info;
+                   joined.Signal();
+                 },
+                 nullptr);
+    EXPECT_TRUE(joined.Wait());
+    return client;
+  }
+  std::shared_ptr<LocalConferenceServer> server_;
+  std::vector<std::shared_ptr<ConferenceSocketSignalingChannel>> channels_;
+};
+TEST_F(ConferenceClientTest, BatchesParticipantsJoinedInOrder) {
+  ConferenceClientConfiguration configuration;
+  configuration.batch_notifications = true;
+  configuration.max_notification_batch_size = 3;
+  auto client = JoinClient(configuration);
+  Latch notified(5);
+  RecordingObserver observer(&notified);
+  client->AddObserver(observer);
+  std::vector<std::string> expected_ids;
+  // Server names participants after the order they join, and |client| is
+  // the first.
+  for (int i = 0; i < 5; i++) {
+    JoinChannel();
+    expected_ids.push_back("participant-" + std::to_string(i + 2));
+  }
+  EXPECT_TRUE(notified.Wait());
+  LeaveClient(client);
+  client->RemoveObserver(observer);
+  std::lock_guard<std::mutex> lock(observer.mutex);
+  EXPECT_EQ(0, observer.single_events);
+  EXPECT_EQ(expected_ids, observer.ids);
+  for (size_t size : observer.batch_sizes)
+    EXPECT_LE(size, 3u);
+}
+TEST_F(ConferenceClientTest, BatchesStreamsAddedInOrder) {
+  ConferenceClientConfiguration configuration;
+  configuration.batch_notifications = true;
+  configuration.max_notification_batch_size = 3;
+  auto publisher = JoinChannel();
+  auto client = JoinClient(configuration);
+  Latch notified(4);
+  RecordingObserver observer(&notified);
+  client->AddObserver(observer);
+  std::vector<std::string> expected_ids;
+  for (int i = 0; i < 4; i++)
+    expected_ids.push_back(Publish(publisher));
+  EXPECT_TRUE(notified.Wait());
+  LeaveClient(client);
+  client->RemoveObserver(observer);
+  std::lock_guard<std::mutex> lock(observer.mutex);
+  EXPECT_EQ(0, observer.single_events);
+  EXPECT_EQ(expected_ids, observer.ids);
+  for (size_t size : observer.batch_sizes)
+    EXPECT_LE(size, 3u);
+}
+TEST_F(ConferenceClientTest, NotifiesOneByOneWithoutBatching) {
+  auto client = JoinClient(ConferenceClientConfiguration());
+  Latch notified(2);
+  RecordingObserver observer(&notified);
+  client->AddObserver(observer);
+  JoinChannel();
+  JoinChannel();
+  EXPECT_TRUE(notified.Wait());
+  LeaveClient(client);
+  client->RemoveObserver(observer);
+  std::lock_guard<std::mutex> lock(observer.mutex);
+  EXPECT_EQ(2, observer.single_events);
+  EXPECT_TRUE(observer.batch_sizes.empty());
+}
+TEST_F(ConferenceClientTest, SubscribeBatchCompletesInOrderOfRequests) {
+  auto client = JoinClient(ConferenceClientConfiguration());
+  // Publisher joins, then its stream is added.
+  Latch added(2);
+  RecordingObserver observer(&added);
+  client->AddObserver(observer);
+  Publish(JoinChannel());
+  ASSERT_TRUE(added.Wait());
+  client->RemoveObserver(observer);
+  std::shared_ptr<RemoteStream> stream;
+  {
+    std::lock_guard<std::mutex> lock(observer.mutex);
+    ASSERT_EQ(1u, observer.streams.size());
+    stream = observer.streams[0];
+  }
+  // Each request fails for a different reason.
+  std::vector<SubscribeRequest> requests(3);
+  requests[0].stream = stream;
+  requests[0].options.audio.disabled = true;
+  requests[0].options.video.disabled = true;
+  requests[2].stream = std::make_shared<RemoteStream>(
+      "unknown", "participant-1", SubscriptionCapabilities(),
+      PublicationSettings());
+  std::vector<SubscribeResult> results;
+  Latch completed(1);
+  client->SubscribeBatch(requests,
+                         [&](std::vector<SubscribeResult> batch_results) {
+                           results = batch_results;
+                           completed.Signal();
+                         });
+  ASSERT_TRUE(completed.Wait());
+  ASSERT_EQ(3u, results.size());
+  for (auto& result : results) {
+    EXPECT_FALSE(result.subscription);
+    ASSERT_TRUE(result.exception);
+  }
+  EXPECT_NE(std::string::npos,
+            results[0].exception->Message().find("disabled"));
+  EXPECT_NE(std::string::npos,
+            results[1].exception->Message().find("Null pointer"));
+  EXPECT_NE(std::string::npos,
+            results[2].exception->Message().find("invalid stream"));
+  LeaveClient(client);
+}
+TEST_F(ConferenceClientTest, BatchWithoutRequestsCompletesEmpty) {
+  auto client = JoinClient(ConferenceClientConfiguration());
+  Latch completed(2);
+  client->PublishBatch({}, [&completed](std::vector<PublishResult> results) {
+    EXPECT_TRUE(results.empty());
+    completed.Signal();
+  });
+  client->SubscribeBatch(
+      {}, [&completed](std::vector<SubscribeResult> results) {
+        EXPECT_TRUE(results.empty());
+        completed.Signal();
+      });
+  EXPECT_TRUE(completed.Wait());
+  LeaveClient(client);
+}
+// Subscriptions sharing a PeerConnection are told apart by the transport ID
+// in subscribe acks, which stats of each subscription rely on.
+TEST_F(ConferenceClientTest, SubscriptionsShareTransportTheyAskFor) {
+  LocalConferenceServer::Options options;
+  options.issue_reconnection_tickets = false;
+  options.share_subscription_transports = true;
+  StartServer(options);
+  const std::string stream_id = Publish(JoinChannel());
+  auto subscriber = JoinChannel();
+  auto first = Subscribe(subscriber, stream_id, "");
+  EXPECT_EQ(first.first, first.second);
+  auto second = Subscribe(subscriber, stream_id, first.second);
+  EXPECT_NE(first.first, second.first);
+  EXPECT_EQ(first.second, second.second);
+  // An unknown transport is not shared.
+  auto third = Subscribe(subscriber, stream_id, "unknown");
+  EXPECT_EQ(third.first, third.second);
+  // Transports of other participants are not shared either.
+  auto fourth = Subscribe(JoinChannel(), stream_id, first.second);
+  EXPECT_EQ(fourth.first, fourth.second);
+}
+TEST_F(ConferenceClientTest, NotifiesChangesOfKeptSessionAfterJoined) {
+  ConferenceClientConfiguration configuration;
+  configuration.session_grace_period_ms = 5000;
+  auto client = JoinClient(configuration);
+  Latch notified(1);
+  RecordingObserver observer(&notified);
+  client->AddObserver(observer);
+  auto channel = JoinChannel();
+  EXPECT_TRUE(notified.Wait());
+  client->RemoveObserver(observer);
+  std::shared_ptr<Participant> participant;
+  {
+    std::lock_guard<std::mutex> lock(observer.mutex);
+    ASSERT_EQ(1u, observer.participants.size());
+    participant = observer.participants.front();
+  }
+  std::mutex mutex;
+  std::vector<std::string> events;
+  Latch done(2);
+  LeftObserver left_observer(&mutex, &events, &done);
+  participant->AddObserver(left_observer);
+  LeaveClient(client);
+  // |channel| leaves while session of |client| is kept.
+  channels_.clear();
+  channel.reset();
+  for (int i = 0; i < 500 && server_->ParticipantCount() > 0; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(0u, server_->ParticipantCount());
+  client->Join(Token(),
+               [&](std::shared_ptr<ConferenceInfo> info) {
+                 {
+                   std::lock_guard<std::mutex> lock(mutex);
+                   events.push_back("joined");
+                 }
+                 done.Signal();
+               },
+               nullptr);
+  EXPECT_TRUE(done.Wait());
+  LeaveClient(client);
+  participant->RemoveObserver(left_observer);
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(std::vector<std::string>({"joined", "left"}), events);
+}
+TEST_F(ConferenceClientTest, ResyncsRoomMissedWhileDisconnected) {
+  LocalConferenceServer::Options options;
+  options.room_info_on_relogin = true;
+  StartServer(options);
+  std::shared_ptr<ConferenceInfo> info;
+  auto client = JoinClientWithInfo(&info);
+  ASSERT_TRUE(info);
+  Latch notified(2);
+  RecordingObserver observer(&notified);
+  client->AddObserver(observer);
+  auto leaving = JoinChannel();
+  Publish(leaving);
+  ASSERT_TRUE(notified.Wait());
+  client->RemoveObserver(observer);
+  std::shared_ptr<Participant> left_participant;
+  std::shared_ptr<RemoteStream> removed_stream;
+  {
+    std::lock_guard<std::mutex> lock(observer.mutex);
+    ASSERT_EQ(1u, observer.participants.size());
+    ASSERT_EQ(1u, observer.streams.size());
+    left_participant = observer.participants.front();
+    removed_stream = observer.streams.front();
+  }
+  std::mutex mutex;
+  std::vector<std::string> events;
+  Latch removed(2);
+  LeftObserver left_observer(&mutex, &events, &removed);
+  EndedObserver ended_observer(&removed);
+  left_participant->AddObserver(left_observer);
+  removed_stream->AddObserver(ended_observer);
+  server_->DropConnection(info->Self()->Id());
+  // Room changes while |client| is disconnected, so it misses the events.
+  channels_.clear();
+  leaving.reset();
+  auto joining = JoinChannel();
+  const std::string added_stream_id = Publish(joining);
+  Latch resynced(2);
+  RecordingObserver resync_observer(&resynced);
+  client->AddObserver(resync_observer);
+  server_->RestoreConnection(info->Self()->Id());
+  EXPECT_TRUE(resynced.Wait());
+  EXPECT_TRUE(removed.Wait());
+  client->RemoveObserver(resync_observer);
+  left_participant->RemoveObserver(left_observer);
+  removed_stream->RemoveObserver(ended_observer);
+  {
+    std::lock_guard<std::mutex> lock(resync_observer.mutex);
+    ASSERT_EQ(1u, resync_observer.participants.size());
+    ASSERT_EQ(1u, resync_observer.streams.size());
+    EXPECT_NE(left_participant->Id(), resync_observer.participants[0]->Id());
+    EXPECT_EQ(added_stream_id, resync_observer.streams[0]->Id());
+  }
+  auto streams = info->RemoteStreams();
+  ASSERT_EQ(1u, streams.size());
+  EXPECT_EQ(added_stream_id, streams[0]->Id());
+  for (const auto& participant : info->Participants())
+    EXPECT_NE(left_participant->Id(), participant->Id());
+  LeaveClient(client);
+}
+TEST_F(ConferenceClientTest, SkipsRoomResyncNotAdvertised) {
+  LocalConferenceServer::Options options;
+  options.room_info_on_relogin = true;
+  options.advertise_room_resync = false;
+  StartServer(options);
+  std::shared_ptr<ConferenceInfo> info;
+  auto client = JoinClientWithInfo(&info);
+  ASSERT_TRUE(info);
+  auto publisher = JoinChannel();
+  server_->DropConnection(info->Self()->Id());
+  Publish(publisher);
+  Latch notified(1);
+  RecordingObserver observer(&notified);
+  client->AddObserver(observer);
+  server_->RestoreConnection(info->Self()->Id());
+  // Relogin is acked before this stream is added, so room info in the ack
+  // would have been applied by the time it is notified.
+  const std::string stream_id = Publish(publisher);
+  EXPECT_TRUE(notified.Wait());
+  client->RemoveObserver(observer);
+  {
+    std::lock_guard<std::mutex> lock(observer.mutex);
+    ASSERT_EQ(1u, observer.streams.size());
+    EXPECT_EQ(stream_id, observer.streams[0]->Id());
+  }
+  auto streams = info->RemoteStreams();
+  ASSERT_EQ(1u, streams.size());
+  EXPECT_EQ(stream_id, streams[0]->Id());
+  LeaveClient(client);
+}
+TEST(FirstFrameObserverTest, ReportsFirstFrameOnce) {
+  std::vector<int> reports;
+  FirstFrameObserver observer(
+      rtc::TimeMillis() - 100,
+      [&reports](int elapsed_ms) { reports.push_back(elapsed_ms); });
+  webrtc::VideoFrame frame(webrtc::I420Buffer::Create(2, 2),
+                           webrtc::kVideoRotation_0, 0);
+  observer.OnFrame(frame);
+  observer.OnFrame(frame);
+  ASSERT_EQ(1u, reports.size());
+  EXPECT_GE(reports[0], 100);
+}
+TEST_F(ConferenceClientTest, ReportsCallbackExecutorStats) {
+  auto client = JoinClient(ConferenceClientConfiguration());
+  const CallbackExecutorStats stats =
+      client->GetClientStats().callback_executor;
+  EXPECT_GE(stats.threads, 2u);
+  EXPECT_LE(stats.threads, 4u);
+  // Join's callback at least.
+  EXPECT_GE(stats.tasks_run, 1u);
+  EXPECT_LE(stats.average_queue_latency_us, stats.max_queue_latency_us);
+  LeaveClient(client);
+}
+TEST_F(ConferenceClientTest, DrainsPeerConnectionPoolOnLeave) {
+  ConferenceClientConfiguration configuration;
+  configuration.peer_connection_pool_low_watermark = 1;
+  configuration.peer_connection_pool_high_watermark = 2;
+  auto client = ConferenceClient::Create(configuration);
+  ConferenceClientStats stats = client->GetClientStats();
+  EXPECT_EQ(0u, stats.pooled_peer_connections);
+  EXPECT_EQ(0u, stats.time_to_first_frame_pooled_ms.count);
+  EXPECT_EQ(0u, stats.time_to_first_frame_unpooled_ms.count);
+  Latch joined(1);
+  client->Join(Token(),
+               [&joined](std::shared_ptr<ConferenceInfo>) { joined.Signal(); },
+               nullptr);
+  ASSERT_TRUE(joined.Wait());
+  for (int i = 0;
+       i < 50 && client->GetClientStats().pooled_peer_connections < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(2u, client->GetClientStats().pooled_peer_connections);
+  LeaveClient(client);
+  EXPECT_EQ(0u, client->GetClientStats().pooled_peer_connections);
+}
+namespace {
+// Exposes mutations ConferenceClient makes on signaling events.
+class MutableConferenceInfo : public ConferenceInfo {
+ public:
+  using ConferenceInfo::AddOrUpdateStream;
+  using ConferenceInfo::AddParticipant;
+  using ConferenceInfo::RemoveParticipantById;
+  using ConferenceInfo::RemoveStreamById;
+  using ConferenceInfo::TriggerOnParticipantLeft;
+  using ConferenceInfo::TriggerOnStreamEnded;
+};
+class CountingParticipantObserver : public ParticipantObserver {
+ public:
+  void OnLeft() override { left++; }
+  int left = 0;
+};
+class CountingStreamObserver : public owt::base::StreamObserver {
+ public:
+  void OnEnded() override { ended++; }
+  void OnUpdated() override { updated++; }
+  int ended = 0;
+  int updated = 0;
+};
+std::shared_ptr<RemoteStream> CreateRemoteStream(const std::string& id) {
+  return std::make_shared<RemoteStream>(id, "participant-1",
+                                        SubscriptionCapabilities(),
+                                        PublicationSettings());
+}
+}  // namespace
+TEST(ConferenceInfoTest, FindsParticipantsAfterAddAndRemove) {
+  MutableConferenceInfo info;
+  auto first = std::make_shared<Participant>("participant-1", "presenter", "");
+  auto second = std::make_shared<Participant>("participant-2", "viewer", "");
+  info.AddParticipant(first);
+  info.AddParticipant(second);
+  // Participant with a known ID is ignored.
+  info.AddParticipant(
+      std::make_shared<Participant>("participant-1", "viewer", ""));
+  CountingParticipantObserver observer;
+  first->AddObserver(observer);
+  info.TriggerOnParticipantLeft("participant-1");
+  EXPECT_EQ(1, observer.left);
+  info.RemoveParticipantById("participant-1");
+  info.RemoveParticipantById("participant-3");
+  info.TriggerOnParticipantLeft("participant-1");
+  EXPECT_EQ(1, observer.left);
+  first->RemoveObserver(observer);
+  std::vector<std::shared_ptr<Participant>> participants = info.Participants();
+  ASSERT_EQ(1u, participants.size());
+  EXPECT_EQ(second, participants[0]);
+}
+TEST(ConferenceInfoTest, FindsStreamsAfterAddAndRemove) {
+  MutableConferenceInfo info;
+  auto stream = CreateRemoteStream("stream-1");
+  CountingStreamObserver observer;
+  stream->AddObserver(observer);
+  bool updated = true;
+  info.AddOrUpdateStream(stream, updated);
+  EXPECT_FALSE(updated);
+  // Stream with a known ID updates the existing one.
+  info.AddOrUpdateStream(CreateRemoteStream("stream-1"), updated);
+  EXPECT_TRUE(updated);
+  EXPECT_EQ(1, observer.updated);
+  info.AddOrUpdateStream(CreateRemoteStream("stream-2"), updated);
+  EXPECT_FALSE(updated);
+  info.TriggerOnStreamEnded("stream-1");
+  EXPECT_EQ(1, observer.ended);
+  info.RemoveStreamById("stream-1");
+  info.TriggerOnStreamEnded("stream-1");
+  EXPECT_EQ(1, observer.ended);
+  stream->RemoveObserver(observer);
+  std::vector<std::shared_ptr<RemoteStream>> streams = info.RemoteStreams();
+  ASSERT_EQ(1u, streams.size());
+  EXPECT_EQ("stream-2", streams[0]->Id());
+}
+TEST(ConferenceInfoTest, SnapshotsAreNotChangedByMutations) {
+  MutableConferenceInfo info;
+  auto first = std::make_shared<Participant>("participant-1", "presenter", "");
+  auto second = std::make_shared<Participant>("participant-2", "viewer", "");
+  info.AddParticipant(first);
+  auto participants = info.ParticipantsSnapshot();
+  // Snapshot is shared until next mutation.
+  EXPECT_EQ(participants, info.ParticipantsSnapshot());
+  info.AddParticipant(second);
+  auto added_participants = info.ParticipantsSnapshot();
+  info.RemoveParticipantById("participant-1");
+  auto removed_participants = info.ParticipantsSnapshot();
+  EXPECT_EQ(std::vector<std::shared_ptr<Participant>>({first}),
+            *participants);
+  EXPECT_EQ(std::vector<std::shared_ptr<Participant>>({first, second}),
+            *added_participants);
+  EXPECT_EQ(std::vector<std::shared_ptr<Participant>>({second}),
+            *removed_participants);
+  bool updated = false;
+  auto stream = CreateRemoteStream("stream-1");
+  info.AddOrUpdateStream(stream, updated);
+  auto streams = info.RemoteStreamsSnapshot();
+  EXPECT_EQ(streams, info.RemoteStreamsSnapshot());
+  info.RemoveStreamById("stream-1");
+  EXPECT_EQ(std::vector<std::shared_ptr<RemoteStream>>({stream}), *streams);
+  EXPECT_TRUE(info.RemoteStreamsSnapshot()->empty());
+}
+}  // namespace conference
+}  // namespace owt
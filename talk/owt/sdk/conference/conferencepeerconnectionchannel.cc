@@ -5,12 +5,14 @@
 #include <future>
 #include <thread>
 #include <vector>
+#include "talk/owt/sdk/base/callbackexecutor.h"
 #include "talk/owt/sdk/base/functionalobserver.h"
 #include "talk/owt/sdk/base/mediautils.h"
 #include "talk/owt/sdk/base/peerconnectiondependencyfactory.h"
+#include "talk/owt/sdk/conference/conferencesharedpeerconnectionchannel.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/remotemixedstream.h"
 #include "webrtc/rtc_base/logging.h"
-#include "webrtc/rtc_base/task_queue.h"
+#include "webrtc/rtc_base/timeutils.h"
 using namespace rtc;
 namespace owt {
 namespace conference {
@@ -56,23 +58,47 @@ const string kSessionDescriptionTiebreakerKey = "tiebreaker";
 const string kIceCandidateSdpMidKey = "sdpMid";
 const string kIceCandidateSdpMLineIndexKey = "sdpMLineIndex";
 const string kIceCandidateSdpNameKey = "candidate";
+FirstFrameObserver::FirstFrameObserver(
+    int64_t start_time_ms,
+    std::function<void(int elapsed_ms)> on_first_frame)
+    : start_time_ms_(start_time_ms),
+      on_first_frame_(on_first_frame),
+      recorded_(false) {}
+void FirstFrameObserver::OnFrame(const webrtc::VideoFrame& frame) {
+  if (recorded_.exchange(true))
+    return;
+  const int elapsed_ms = static_cast<int>(rtc::TimeMillis() - start_time_ms_);
+  RTC_LOG(LS_INFO) << "First frame is received " << elapsed_ms
+                   << "ms after subscribing.";
+  on_first_frame_(elapsed_ms);
+}
 ConferencePeerConnectionChannel::ConferencePeerConnectionChannel(
     PeerConnectionChannelConfiguration& configuration,
     std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel,
-    std::shared_ptr<rtc::TaskQueue> event_queue)
+    std::shared_ptr<TaskSequence> event_queue,
+    std::shared_ptr<ConferenceSharedPeerConnectionChannel> shared_channel)
     : PeerConnectionChannel(configuration),
       signaling_channel_(signaling_channel),
       session_id_(""),
+      ice_candidate_batcher_(
+          std::make_shared<IceCandidateBatcher>(signaling_channel)),
+      negotiation_start_ms_(0),
+      connect_time_recorded_(false),
       ice_restart_needed_(false),
       connected_(false),
       sub_stream_added_(false),
       sub_server_ready_(false),
-      event_queue_(event_queue) {
-  InitializePeerConnection();
+      event_queue_(event_queue),
+      shared_channel_(shared_channel),
+      subscribe_time_ms_(0) {
+  if (!shared_channel_)
+    InitializePeerConnection();
   RTC_CHECK(signaling_channel_);
 }
 ConferencePeerConnectionChannel::~ConferencePeerConnectionChannel() {
   RTC_LOG(LS_INFO) << "Deconstruct conference peer connection channel";
+  if (first_frame_track_)
+    first_frame_track_->RemoveSink(first_frame_observer_.get());
   if (published_stream_)
     Unpublish(GetSessionId(), nullptr, nullptr);
   if (subscribed_stream_)
@@ -102,6 +128,8 @@ void ConferencePeerConnectionChannel::RemoveObserver(
 }
 void ConferencePeerConnectionChannel::CreateOffer() {
   RTC_LOG(LS_INFO) << "Create offer.";
+  if (negotiation_start_ms_ == 0)
+    negotiation_start_ms_ = rtc::TimeMillis();
   scoped_refptr<FunctionalCreateSessionDescriptionObserver> observer =
       FunctionalCreateSessionDescriptionObserver::Create(
           std::bind(&ConferencePeerConnectionChannel::
@@ -118,6 +146,10 @@ void ConferencePeerConnectionChannel::CreateOffer() {
   pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeCreateOffer, data);
 }
 void ConferencePeerConnectionChannel::IceRestart() {
+  if (shared_channel_) {
+    RTC_LOG(LS_WARNING) << "ICE restart is not supported on shared transport.";
+    return;
+  }
   if (SignalingState() == PeerConnectionInterface::SignalingState::kStable) {
     DoIceRestart();
   } else {
@@ -128,8 +160,7 @@ void ConferencePeerConnectionChannel::DoIceRestart() {
   RTC_LOG(LS_INFO) << "ICE restart";
   RTC_DCHECK(SignalingState() ==
              PeerConnectionInterface::SignalingState::kStable);
-  media_constraints_.SetMandatory(
-      webrtc::MediaConstraintsInterface::kIceRestart, true);
+  RestartIceInNextOffer();
   this->CreateOffer();
 }
 void ConferencePeerConnectionChannel::CreateAnswer() {
@@ -157,14 +188,13 @@ void ConferencePeerConnectionChannel::OnSignalingChange(
   if (new_state == webrtc::PeerConnectionInterface::SignalingState::kStable) {
     if (ice_restart_needed_) {
       ice_restart_needed_ = false;
-      {
-        std::lock_guard<std::mutex> lock(candidates_mutex_);
-        ice_candidates_.clear();
-      }
+      ice_candidate_batcher_->Clear();
       DoIceRestart();
     } else {
-      DrainIceCandidates();
+      ice_candidate_batcher_->SetNegotiating(false);
     }
+  } else {
+    ice_candidate_batcher_->SetNegotiating(true);
   }
 }
 void ConferencePeerConnectionChannel::OnAddStream(
@@ -173,6 +203,22 @@ void ConferencePeerConnectionChannel::OnAddStream(
   if (subscribed_stream_ != nullptr)
     subscribed_stream_->MediaStream(stream);
   std::weak_ptr<ConferencePeerConnectionChannel> weak_this = shared_from_this();
+  if (!first_frame_track_ && !shared_channel_ &&
+      !stream->GetVideoTracks().empty()) {
+    const bool pooled = IsPeerConnectionPooled();
+    first_frame_observer_.reset(new FirstFrameObserver(
+        subscribe_time_ms_, [weak_this, pooled](int elapsed_ms) {
+          auto that = weak_this.lock();
+          if (!that)
+            return;
+          const std::lock_guard<std::mutex> lock(that->observers_mutex_);
+          for (auto& observer : that->observers_)
+            observer.get().OnFirstFrame(elapsed_ms, pooled);
+        }));
+    first_frame_track_ = stream->GetVideoTracks()[0];
+    first_frame_track_->AddOrUpdateSink(first_frame_observer_.get(),
+                                        rtc::VideoSinkWants());
+  }
   if (subscribe_success_callback_) {
     bool server_ready = false;
     {
@@ -204,6 +250,12 @@ void ConferencePeerConnectionChannel::OnIceConnectionChange(
   RTC_LOG(LS_INFO) << "Ice connection state changed: " << new_state;
   if (new_state == PeerConnectionInterface::kIceConnectionConnected ||
       new_state == PeerConnectionInterface::kIceConnectionCompleted) {
+    if (!connect_time_recorded_ && negotiation_start_ms_ != 0) {
+      connect_time_recorded_ = true;
+      const int elapsed_ms =
+          static_cast<int>(rtc::TimeMillis() - negotiation_start_ms_);
+      NotifyConnected(elapsed_ms, ice_candidate_batcher_->MessagesSent());
+    }
     connected_ = true;
   } else if (new_state == PeerConnectionInterface::kIceConnectionFailed) {
     // TODO(jianlin): Change trigger condition back to kIceConnectionClosed
@@ -222,35 +274,13 @@ void ConferencePeerConnectionChannel::OnIceConnectionChange(
 void ConferencePeerConnectionChannel::OnIceGatheringChange(
     PeerConnectionInterface::IceGatheringState new_state) {
   RTC_LOG(LS_INFO) << "Ice gathering state changed: " << new_state;
+  if (new_state == PeerConnectionInterface::kIceGatheringComplete)
+    ice_candidate_batcher_->EndOfCandidates();
 }
-// TODO(jianlin): New signaling protocol defines candidate as
-// a string instead of object. Need to double check with server
-// side implementation before we switch to it.
 void ConferencePeerConnectionChannel::OnIceCandidate(
     const webrtc::IceCandidateInterface* candidate) {
   RTC_LOG(LS_INFO) << "On ice candidate";
-  string candidate_string;
-  candidate->ToString(&candidate_string);
-  candidate_string.insert(0, "a=");
-  sio::message::ptr message = sio::object_message::create();
-  message->get_map()["id"] = sio::string_message::create(session_id_);
-  sio::message::ptr sdp_message = sio::object_message::create();
-  sdp_message->get_map()["type"] = sio::string_message::create("candidate");
-  sio::message::ptr candidate_message = sio::object_message::create();
-  candidate_message->get_map()["sdpMLineIndex"] =
-      sio::int_message::create(candidate->sdp_mline_index());
-  candidate_message->get_map()["sdpMid"] =
-      sio::string_message::create(candidate->sdp_mid());
-  candidate_message->get_map()["candidate"] =
-      sio::string_message::create(candidate_string);
-  sdp_message->get_map()["candidate"] = candidate_message;
-  message->get_map()["signaling"] = sdp_message;
-  if (signaling_state_ ==
-      webrtc::PeerConnectionInterface::SignalingState::kStable) {
-    signaling_channel_->SendSdp(message, nullptr, nullptr);
-  } else {
-    ice_candidates_.push_back(message);
-  }
+  ice_candidate_batcher_->AddCandidate(candidate);
 }
 void ConferencePeerConnectionChannel::OnIceCandidatesRemoved(
     const std::vector<cricket::Candidate>& candidates) {
@@ -516,6 +546,7 @@ void ConferencePeerConnectionChannel::Subscribe(
     return;
   }
   subscribed_stream_ = stream;
+  subscribe_time_ms_ = rtc::TimeMillis();
   if (!CheckNullPointer((uintptr_t)stream.get(), on_failure)) {
     RTC_LOG(LS_ERROR) << "Remote stream cannot be nullptr.";
     return;
@@ -581,12 +612,53 @@ void ConferencePeerConnectionChannel::Subscribe(
     media_options->get_map()["video"] = sio::bool_message::create(false);
   }
   sio_options->get_map()["media"] = media_options;
-  offer_answer_options_.offer_to_receive_audio =
+  const bool receive_audio =
       stream->has_audio_ && !subscribe_options.audio.disabled;
-  offer_answer_options_.offer_to_receive_video =
+  const bool receive_video =
       stream->has_video_ && !subscribe_options.video.disabled;
+  if (!shared_channel_) {
+    SendSubscribeMessage(sio_options, receive_audio, receive_video,
+                         on_failure);
+    return;
+  }
+  std::weak_ptr<ConferencePeerConnectionChannel> weak_this = shared_from_this();
+  shared_channel_->Subscribe(
+      shared_from_this(), sio_options, receive_audio, receive_video,
+      [weak_this, sio_options, receive_audio, receive_video] {
+        // MCU does not share the transport. Subscribe with a PeerConnection
+        // of this channel.
+        auto that = weak_this.lock();
+        if (!that)
+          return;
+        RTC_LOG(LS_INFO) << "Fall back to a dedicated PeerConnection.";
+        that->shared_channel_.reset();
+        that->InitializePeerConnection();
+        that->SendSubscribeMessage(sio_options, receive_audio, receive_video,
+                                   that->failure_callback_);
+      },
+      [weak_this](std::unique_ptr<Exception> e) {
+        auto that = weak_this.lock();
+        if (!that)
+          return;
+        std::function<void(std::unique_ptr<Exception>)> failure_callback;
+        {
+          std::lock_guard<std::mutex> lock(that->callback_mutex_);
+          failure_callback = that->failure_callback_;
+          that->ResetCallbacks();
+        }
+        if (failure_callback)
+          failure_callback(std::move(e));
+      });
+}
+void ConferencePeerConnectionChannel::SendSubscribeMessage(
+    sio::message::ptr options,
+    bool receive_audio,
+    bool receive_video,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  offer_answer_options_.offer_to_receive_audio = receive_audio;
+  offer_answer_options_.offer_to_receive_video = receive_video;
   signaling_channel_->SendInitializationMessage(
-      sio_options, "", stream->Id(),
+      options, "", subscribed_stream_->Id(),
       [this](std::string session_id) {
         // Pre-set the session's ID.
         SetSessionId(session_id);
@@ -645,6 +717,10 @@ void ConferencePeerConnectionChannel::Unsubscribe(
   connected_ = false;
   signaling_channel_->SendStreamEvent("unsubscribe", session_id,
                                       RunInEventQueue(on_success), on_failure);
+  if (shared_channel_) {
+    shared_channel_->Unsubscribe(session_id);
+    return;
+  }
   this->ClosePeerConnection();
 }
 void ConferencePeerConnectionChannel::SendStreamControlMessage(
@@ -703,7 +779,11 @@ void ConferencePeerConnectionChannel::Stop(
 void ConferencePeerConnectionChannel::GetConnectionStats(
     std::function<void(std::shared_ptr<ConnectionStats>)> on_success,
     std::function<void(std::unique_ptr<Exception>)> on_failure) {
-  if (!published_stream_ && !subscribed_stream_) {
+  // Stats of a subscription sharing a PeerConnection are filtered by its
+  // tracks, so they are not available before its media stream is created.
+  if ((!published_stream_ && !subscribed_stream_) ||
+      (subscribed_stream_ && shared_channel_ &&
+       !subscribed_stream_->MediaStream())) {
     if (on_failure != nullptr) {
       event_queue_->PostTask([on_failure]() {
         std::unique_ptr<Exception> e(
@@ -714,7 +794,10 @@ void ConferencePeerConnectionChannel::GetConnectionStats(
     }
     return;
   }
-  if (subscribed_stream_) {
+  if (subscribed_stream_ && shared_channel_) {
+    shared_channel_->GetConnectionStats(subscribed_stream_->MediaStream(),
+                                        on_success, on_failure);
+  } else if (subscribed_stream_) {
     scoped_refptr<FunctionalStatsObserver> observer =
         FunctionalStatsObserver::Create(on_success);
     GetStatsMessage* stats_message = new GetStatsMessage(
@@ -736,6 +819,23 @@ void ConferencePeerConnectionChannel::GetStats(
   if (!on_success) {
     return;
   }
+  if (subscribed_stream_ && shared_channel_) {
+    // Filtered by tracks like connection stats.
+    if (!subscribed_stream_->MediaStream()) {
+      if (on_failure != nullptr) {
+        event_queue_->PostTask([on_failure]() {
+          std::unique_ptr<Exception> e(
+              new Exception(ExceptionType::kConferenceUnknown,
+                            "No stream associated with the session"));
+          on_failure(std::move(e));
+        });
+      }
+      return;
+    }
+    shared_channel_->GetStats(subscribed_stream_->MediaStream(), on_success,
+                              on_failure);
+    return;
+  }
   scoped_refptr<FunctionalNativeStatsObserver> observer =
       FunctionalNativeStatsObserver::Create(on_success);
   GetNativeStatsMessage* stats_message = new GetNativeStatsMessage(
@@ -805,6 +905,10 @@ void ConferencePeerConnectionChannel::OnSignalingMessage(
     RTC_LOG(LS_WARNING) << "Ignore invalid signaling message from MCU.";
     return;
   }
+  if (shared_channel_) {
+    shared_channel_->OnSignalingMessage(message);
+    return;
+  }
   // Since trickle ICE from MCU is not supported, we parse the message as
   // SOAC message, not Canddiate message.
   if (message->get_map().find("type") == message->get_map().end()) {
@@ -827,12 +931,14 @@ void ConferencePeerConnectionChannel::OnSignalingMessage(
         << "Ignoring signaling message from server other than answer.";
   }
 }
-void ConferencePeerConnectionChannel::DrainIceCandidates() {
-  std::lock_guard<std::mutex> lock(candidates_mutex_);
-  for (auto it = ice_candidates_.begin(); it != ice_candidates_.end(); ++it) {
-    signaling_channel_->SendSdp(*it, nullptr, nullptr);
-  }
-  ice_candidates_.clear();
+void ConferencePeerConnectionChannel::NotifyConnected(int elapsed_ms,
+                                                      int candidate_messages) {
+  RTC_LOG(LS_INFO) << "ICE is connected " << elapsed_ms
+                   << "ms after creating offer, with " << candidate_messages
+                   << " candidate messages sent.";
+  const std::lock_guard<std::mutex> lock(observers_mutex_);
+  for (auto& observer : observers_)
+    observer.get().OnConnected(elapsed_ms, candidate_messages);
 }
 std::string ConferencePeerConnectionChannel::GetSubStreamId() {
   if (subscribed_stream_) {
@@ -844,6 +950,7 @@ std::string ConferencePeerConnectionChannel::GetSubStreamId() {
 void ConferencePeerConnectionChannel::SetSessionId(const std::string& id) {
   RTC_LOG(LS_INFO) << "Setting session ID for current channel";
   session_id_ = id;
+  ice_candidate_batcher_->SetId(id);
 }
 std::string ConferencePeerConnectionChannel::GetSessionId() const {
   return session_id_;
@@ -866,6 +973,12 @@ void ConferencePeerConnectionChannel::SendPublishMessage(
 }
 void ConferencePeerConnectionChannel::OnNetworksChanged() {
   RTC_LOG(LS_INFO) << "ConferencePeerConnectionChannel::OnNetworksChanged";
+  // Nothing to restart before MCU accepts the session.
+  if (!configuration_.ice_restart_on_network_change || shared_channel_ ||
+      GetSessionId().empty()) {
+    return;
+  }
+  IceRestart();
 }
 void ConferencePeerConnectionChannel::OnStreamError(
     const std::string& error_message) {
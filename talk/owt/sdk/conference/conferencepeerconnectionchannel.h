@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef OWT_CONFERENCE_CONFERENCEPEERCONNECTIONCHANNEL_H_
 #define OWT_CONFERENCE_CONFERENCEPEERCONNECTIONCHANNEL_H_
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -10,22 +12,43 @@
 #include <random>
 #include "talk/owt/sdk/base/peerconnectionchannel.h"
 #include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/icecandidatebatcher.h"
+#include "webrtc/api/video/video_frame.h"
+#include "webrtc/api/video/video_sink_interface.h"
 #include "talk/owt/sdk/include/cpp/owt/base/stream.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/subscribeoptions.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/conferencepublication.h"
 namespace owt {
 namespace conference {
 using namespace owt::base;
+class ConferenceSharedPeerConnectionChannel;
+// Measures time from subscribing to the first decoded frame, and reports it to
+// |on_first_frame| once.
+class FirstFrameObserver : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  FirstFrameObserver(int64_t start_time_ms,
+                     std::function<void(int elapsed_ms)> on_first_frame);
+  void OnFrame(const webrtc::VideoFrame& frame) override;
+ private:
+  const int64_t start_time_ms_;
+  std::function<void(int elapsed_ms)> on_first_frame_;
+  std::atomic<bool> recorded_;
+};
 // An instance of ConferencePeerConnectionChannel manages a PeerConnection with
 // MCU as well as it's signaling through Socket.IO.
 class ConferencePeerConnectionChannel
     : public PeerConnectionChannel,
       public std::enable_shared_from_this<ConferencePeerConnectionChannel> {
+  friend class ConferenceSharedPeerConnectionChannel;
  public:
+  // If |shared_channel| is not nullptr, this channel subscribes through it
+  // instead of creating a PeerConnection.
   explicit ConferencePeerConnectionChannel(
       PeerConnectionChannelConfiguration& configuration,
       std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel,
-      std::shared_ptr<rtc::TaskQueue> event_queue);
+      std::shared_ptr<TaskSequence> event_queue,
+      std::shared_ptr<ConferenceSharedPeerConnectionChannel> shared_channel =
+          nullptr);
   ~ConferencePeerConnectionChannel();
   // Add a ConferencePeerConnectionChannel observer so it will be notified when
   // this object have some events.
@@ -157,12 +180,19 @@ class ConferencePeerConnectionChannel
       std::function<void()> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure)
       const;
-  void DrainIceCandidates();
+  // Tells observers ICE is connected |elapsed_ms| after the first offer, with
+  // |candidate_messages| sent.
+  void NotifyConnected(int elapsed_ms, int candidate_messages);
   void DoIceRestart();
   void SendPublishMessage(
     sio::message::ptr options,
     std::shared_ptr<LocalStream> stream,
     std::function<void(std::unique_ptr<Exception>)> on_failure);
+  void SendSubscribeMessage(
+      sio::message::ptr options,
+      bool receive_audio,
+      bool receive_video,
+      std::function<void(std::unique_ptr<Exception>)> on_failure);
   std::function<void()> RunInEventQueue(std::function<void()> func);
   // Set publish_success_callback_, subscribe_success_callback_ and
   // failure_callback_ to nullptr.
@@ -181,11 +211,10 @@ class ConferencePeerConnectionChannel
   std::function<void(std::string)> subscribe_success_callback_;
   std::function<void(std::unique_ptr<Exception>)> failure_callback_;
   std::mutex callback_mutex_;
-  // Stored candidates, will be send out after setting remote description.
-  // Use sio::message::ptr instead of IceCandidateInterface* to avoid one more
-  // deep copy.
-  std::vector<sio::message::ptr> ice_candidates_;
-  std::mutex candidates_mutex_;
+  std::shared_ptr<IceCandidateBatcher> ice_candidate_batcher_;
+  // Time of the first offer, for ConferenceClientStats.
+  std::atomic<int64_t> negotiation_start_ms_;
+  bool connect_time_recorded_;
   bool ice_restart_needed_;
   std::mutex observers_mutex_;
   std::vector<std::reference_wrapper<ConferencePeerConnectionChannelObserver>>
@@ -196,7 +225,12 @@ class ConferencePeerConnectionChannel
   bool sub_stream_added_;
   bool sub_server_ready_;
   // Queue for callbacks and events.
-  std::shared_ptr<rtc::TaskQueue> event_queue_;
+  std::shared_ptr<TaskSequence> event_queue_;
+  // PeerConnection carrying this subscription if it is shared with others.
+  std::shared_ptr<ConferenceSharedPeerConnectionChannel> shared_channel_;
+  int64_t subscribe_time_ms_;
+  std::unique_ptr<FirstFrameObserver> first_frame_observer_;
+  rtc::scoped_refptr<webrtc::VideoTrackInterface> first_frame_track_;
 };
 }
 }
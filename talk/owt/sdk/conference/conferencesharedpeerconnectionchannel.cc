@@ -0,0 +1,595 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/conference/conferencesharedpeerconnectionchannel.h"
+#include <algorithm>
+#include <unordered_set>
+#include "talk/owt/sdk/base/functionalobserver.h"
+#include "talk/owt/sdk/conference/conferencepeerconnectionchannel.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/timeutils.h"
+using namespace rtc;
+namespace owt {
+namespace conference {
+using std::string;
+enum ConferenceSharedPeerConnectionChannel::MultiplexingState : int {
+  kMultiplexingStateUnknown = 1,  // No subscription is acked yet.
+  kMultiplexingStateSupported,    // MCU shares the transport.
+  kMultiplexingStateUnsupported,  // MCU creates a transport per subscription.
+};
+enum ConferenceSharedPeerConnectionChannel::SharedMessageType : int {
+  kMessageTypeAddTransceivers = 301,
+  kMessageTypeStopTransceivers,
+};
+struct AddTransceiversMessage : public rtc::MessageData {
+  AddTransceiversMessage(const std::string& session_id,
+                         bool receive_audio,
+                         bool receive_video)
+      : session_id(session_id),
+        receive_audio(receive_audio),
+        receive_video(receive_video) {}
+  std::string session_id;
+  bool receive_audio;
+  bool receive_video;
+};
+// Other subscriptions share the PeerConnection, so only reports of |stream|'s
+// tracks are collected.
+static std::unordered_set<std::string> TrackIds(MediaStreamInterface* stream) {
+  std::unordered_set<std::string> track_ids;
+  for (const auto& track : stream->GetAudioTracks())
+    track_ids.insert(track->id());
+  for (const auto& track : stream->GetVideoTracks())
+    track_ids.insert(track->id());
+  return track_ids;
+}
+ConferenceSharedPeerConnectionChannel::ConferenceSharedPeerConnectionChannel(
+    PeerConnectionChannelConfiguration& configuration,
+    std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel)
+    : PeerConnectionChannel(configuration),
+      signaling_channel_(signaling_channel),
+      multiplexing_state_(kMultiplexingStateUnknown),
+      closed_(false),
+      negotiating_(false),
+      ice_candidate_batcher_(
+          std::make_shared<IceCandidateBatcher>(signaling_channel)),
+      negotiation_start_ms_(0),
+      connect_time_recorded_(false),
+      connected_(false) {
+  InitializePeerConnection();
+  RTC_CHECK(signaling_channel_);
+  // Media sections are created by transceivers.
+  offer_answer_options_.offer_to_receive_audio =
+      webrtc::PeerConnectionInterface::RTCOfferAnswerOptions::kUndefined;
+  offer_answer_options_.offer_to_receive_video =
+      webrtc::PeerConnectionInterface::RTCOfferAnswerOptions::kUndefined;
+}
+ConferenceSharedPeerConnectionChannel::
+    ~ConferenceSharedPeerConnectionChannel() {
+  RTC_LOG(LS_INFO) << "Deconstruct conference shared peer connection channel";
+}
+void ConferenceSharedPeerConnectionChannel::Subscribe(
+    std::shared_ptr<ConferencePeerConnectionChannel> subscription,
+    sio::message::ptr options,
+    bool receive_audio,
+    bool receive_video,
+    std::function<void()> fallback,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  Operation operation;
+  operation.subscribe = true;
+  operation.subscription = subscription;
+  // Transport is added when the request is sent, so it is not shared with
+  // caller.
+  operation.options = sio::object_message::create();
+  for (auto& option : options->get_map()) {
+    operation.options->get_map()[option.first] = option.second;
+  }
+  operation.receive_audio = receive_audio;
+  operation.receive_video = receive_video;
+  operation.fallback = fallback;
+  operation.on_failure = on_failure;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    operations_.push_back(operation);
+  }
+  StartNextOperation();
+}
+void ConferenceSharedPeerConnectionChannel::Unsubscribe(
+    const std::string& session_id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (subscriptions_.find(session_id) == subscriptions_.end())
+      return;
+    if (closed_) {
+      subscriptions_.erase(session_id);
+      return;
+    }
+    Operation operation;
+    operation.session_id = session_id;
+    operations_.push_back(operation);
+  }
+  StartNextOperation();
+}
+bool ConferenceSharedPeerConnectionChannel::AcceptsSubscriptions() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !closed_ && multiplexing_state_ != kMultiplexingStateUnsupported;
+}
+bool ConferenceSharedPeerConnectionChannel::IsMultiplexingUnsupported() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return multiplexing_state_ == kMultiplexingStateUnsupported;
+}
+std::string ConferenceSharedPeerConnectionChannel::TransportId() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return transport_id_;
+}
+void ConferenceSharedPeerConnectionChannel::StartNextOperation() {
+  while (true) {
+    Operation operation;
+    bool runnable = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (negotiating_ || operations_.empty())
+        return;
+      operation = operations_.front();
+      operations_.pop_front();
+      if (operation.subscribe) {
+        runnable = !closed_ &&
+                   multiplexing_state_ != kMultiplexingStateUnsupported;
+      } else {
+        auto it = subscriptions_.find(operation.session_id);
+        if (closed_ && it != subscriptions_.end()) {
+          subscriptions_.erase(it);
+        } else {
+          runnable = !closed_ && it != subscriptions_.end();
+        }
+      }
+      if (runnable) {
+        negotiating_ = true;
+        current_operation_ = operation;
+      }
+    }
+    if (!runnable) {
+      // Subscriptions not accepted any more are handed back.
+      if (operation.subscribe && operation.fallback)
+        operation.fallback();
+      continue;
+    }
+    if (!operation.subscribe) {
+      pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeStopTransceivers,
+                       new rtc::TypedMessageData<std::string>(
+                           operation.session_id));
+      return;
+    }
+    sio::message::ptr transport = sio::object_message::create();
+    transport->get_map()["type"] = sio::string_message::create("webrtc");
+    const std::string transport_id = TransportId();
+    if (!transport_id.empty()) {
+      transport->get_map()["id"] = sio::string_message::create(transport_id);
+    }
+    operation.options->get_map()["transport"] = transport;
+    std::weak_ptr<ConferenceSharedPeerConnectionChannel> weak_this =
+        shared_from_this();
+    std::function<void(std::unique_ptr<Exception>)> on_failure =
+        operation.on_failure;
+    signaling_channel_->SendSubscribeMessage(
+        operation.options,
+        [weak_this, operation](std::string session_id,
+                               std::string transport_id) {
+          auto that = weak_this.lock();
+          if (!that)
+            return;
+          that->OnSubscribeAck(operation, session_id, transport_id);
+        },
+        [weak_this, on_failure](std::unique_ptr<Exception> e) {
+          if (on_failure)
+            on_failure(std::move(e));
+          auto that = weak_this.lock();
+          if (!that)
+            return;
+          that->FinishOperation();
+        });
+    return;
+  }
+}
+void ConferenceSharedPeerConnectionChannel::FinishOperation() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    negotiating_ = false;
+    current_operation_ = Operation();
+  }
+  StartNextOperation();
+}
+void ConferenceSharedPeerConnectionChannel::OnSubscribeAck(
+    const Operation& operation,
+    const std::string& session_id,
+    const std::string& transport_id) {
+  auto subscription = operation.subscription.lock();
+  bool accepted = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (multiplexing_state_ == kMultiplexingStateUnknown) {
+      // The first subscription tells whether MCU shares the transport. If it
+      // does not, this PeerConnection belongs to the first subscription.
+      if (transport_id.empty()) {
+        multiplexing_state_ = kMultiplexingStateUnsupported;
+        transport_id_ = session_id;
+      } else {
+        multiplexing_state_ = kMultiplexingStateSupported;
+        transport_id_ = transport_id;
+      }
+      accepted = true;
+    } else {
+      accepted = (transport_id == transport_id_);
+    }
+    accepted = accepted && !closed_ && subscription;
+    if (accepted) {
+      Subscription& entry = subscriptions_[session_id];
+      entry.channel = subscription;
+      current_operation_.session_id = session_id;
+    }
+  }
+  if (!accepted) {
+    RTC_LOG(LS_WARNING) << "Subscription " << session_id
+                        << " is not carried by shared transport.";
+    signaling_channel_->SendStreamEvent("unsubscribe", session_id, nullptr,
+                                        nullptr);
+    if (subscription && operation.fallback) {
+      operation.fallback();
+    }
+    FinishOperation();
+    return;
+  }
+  ice_candidate_batcher_->SetId(TransportId());
+  subscription->SetSessionId(session_id);
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeAddTransceivers,
+                   new AddTransceiversMessage(session_id,
+                                              operation.receive_audio,
+                                              operation.receive_video));
+}
+void ConferenceSharedPeerConnectionChannel::OnMessage(rtc::Message* msg) {
+  switch (msg->message_id) {
+    case kMessageTypeAddTransceivers: {
+      AddTransceiversMessage* param =
+          static_cast<AddTransceiversMessage*>(msg->pdata);
+      AddTransceivers(param->session_id, param->receive_audio,
+                      param->receive_video);
+      delete param;
+      break;
+    }
+    case kMessageTypeStopTransceivers: {
+      rtc::TypedMessageData<std::string>* param =
+          static_cast<rtc::TypedMessageData<std::string>*>(msg->pdata);
+      StopTransceivers(param->data());
+      delete param;
+      break;
+    }
+    default:
+      PeerConnectionChannel::OnMessage(msg);
+  }
+}
+void ConferenceSharedPeerConnectionChannel::AddTransceivers(
+    const std::string& session_id,
+    bool receive_audio,
+    bool receive_video) {
+  auto peer_connection = GetPeerConnection();
+  if (peer_connection->signaling_state() ==
+      webrtc::PeerConnectionInterface::SignalingState::kClosed) {
+    FinishOperation();
+    return;
+  }
+  webrtc::RtpTransceiverInit init;
+  init.direction = webrtc::RtpTransceiverDirection::kRecvOnly;
+  std::vector<cricket::MediaType> media_types;
+  if (receive_audio)
+    media_types.push_back(cricket::MEDIA_TYPE_AUDIO);
+  if (receive_video)
+    media_types.push_back(cricket::MEDIA_TYPE_VIDEO);
+  std::vector<rtc::scoped_refptr<webrtc::RtpTransceiverInterface>>
+      transceivers;
+  for (auto media_type : media_types) {
+    auto result = peer_connection->AddTransceiver(media_type, init);
+    if (!result.ok()) {
+      RTC_LOG(LS_ERROR) << "Failed to add transceiver: "
+                        << result.error().message();
+      FailSubscriptions("Failed to add transceiver.");
+      return;
+    }
+    transceivers.push_back(result.MoveValue());
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(session_id);
+    if (it != subscriptions_.end())
+      it->second.transceivers = transceivers;
+  }
+  CreateOffer();
+}
+void ConferenceSharedPeerConnectionChannel::StopTransceivers(
+    const std::string& session_id) {
+  std::vector<rtc::scoped_refptr<webrtc::RtpTransceiverInterface>>
+      transceivers;
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(session_id);
+    if (it != subscriptions_.end()) {
+      transceivers = it->second.transceivers;
+      subscriptions_.erase(it);
+    }
+    last = subscriptions_.empty();
+    if (last)
+      closed_ = true;
+  }
+  if (last) {
+    RTC_LOG(LS_INFO) << "Close shared peer connection.";
+    GetPeerConnection()->Close();
+    FinishOperation();
+    return;
+  }
+  for (auto transceiver : transceivers) {
+    transceiver->Stop();
+  }
+  CreateOffer();
+}
+void ConferenceSharedPeerConnectionChannel::CreateOffer() {
+  RTC_LOG(LS_INFO) << "Create offer.";
+  if (negotiation_start_ms_ == 0)
+    negotiation_start_ms_ = rtc::TimeMillis();
+  scoped_refptr<FunctionalCreateSessionDescriptionObserver> observer =
+      FunctionalCreateSessionDescriptionObserver::Create(
+          std::bind(&ConferenceSharedPeerConnectionChannel::
+                        OnCreateSessionDescriptionSuccess,
+                    this, std::placeholders::_1),
+          std::bind(&ConferenceSharedPeerConnectionChannel::
+                        OnCreateSessionDescriptionFailure,
+                    this, std::placeholders::_1));
+  rtc::TypedMessageData<
+      scoped_refptr<FunctionalCreateSessionDescriptionObserver>>* data =
+      new rtc::TypedMessageData<
+          scoped_refptr<FunctionalCreateSessionDescriptionObserver>>(observer);
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeCreateOffer, data);
+}
+void ConferenceSharedPeerConnectionChannel::CreateAnswer() {
+  RTC_LOG(LS_WARNING) << "MCU is not expected to send offers.";
+}
+void ConferenceSharedPeerConnectionChannel::OnSignalingChange(
+    PeerConnectionInterface::SignalingState new_state) {
+  RTC_LOG(LS_INFO) << "Signaling state changed: " << new_state;
+  const bool stable =
+      new_state == webrtc::PeerConnectionInterface::SignalingState::kStable;
+  bool negotiated = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    negotiated = stable && negotiating_;
+  }
+  ice_candidate_batcher_->SetNegotiating(!stable);
+  if (negotiated) {
+    FinishOperation();
+  }
+}
+void ConferenceSharedPeerConnectionChannel::OnAddStream(
+    rtc::scoped_refptr<MediaStreamInterface> stream) {
+  RTC_LOG(LS_INFO) << "On add stream.";
+  std::vector<std::string> track_ids;
+  for (auto track : stream->GetAudioTracks())
+    track_ids.push_back(track->id());
+  for (auto track : stream->GetVideoTracks())
+    track_ids.push_back(track->id());
+  std::shared_ptr<ConferencePeerConnectionChannel> subscription;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : subscriptions_) {
+      for (auto transceiver : entry.second.transceivers) {
+        auto track = transceiver->receiver()->track();
+        if (track && std::find(track_ids.begin(), track_ids.end(),
+                               track->id()) != track_ids.end()) {
+          subscription = entry.second.channel.lock();
+          break;
+        }
+      }
+      if (subscription)
+        break;
+    }
+  }
+  if (!subscription) {
+    RTC_LOG(LS_WARNING) << "Received a stream not belonging to any "
+                           "subscription.";
+    return;
+  }
+  subscription->OnAddStream(stream);
+}
+void ConferenceSharedPeerConnectionChannel::OnIceConnectionChange(
+    PeerConnectionInterface::IceConnectionState new_state) {
+  RTC_LOG(LS_INFO) << "Ice connection state changed: " << new_state;
+  if (new_state == PeerConnectionInterface::kIceConnectionConnected ||
+      new_state == PeerConnectionInterface::kIceConnectionCompleted) {
+    if (!connect_time_recorded_ && negotiation_start_ms_ != 0) {
+      connect_time_recorded_ = true;
+      // Reported once for the PeerConnection, by any of its subscriptions.
+      std::shared_ptr<ConferencePeerConnectionChannel> subscription;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : subscriptions_) {
+          subscription = entry.second.channel.lock();
+          if (subscription)
+            break;
+        }
+      }
+      if (subscription) {
+        subscription->NotifyConnected(
+            static_cast<int>(rtc::TimeMillis() - negotiation_start_ms_),
+            ice_candidate_batcher_->MessagesSent());
+      }
+    }
+    connected_ = true;
+  } else if (new_state == PeerConnectionInterface::kIceConnectionFailed) {
+    if (connected_) {
+      FailSubscriptions("Stream ICE connection failed.");
+    }
+    connected_ = false;
+  }
+}
+void ConferenceSharedPeerConnectionChannel::OnIceGatheringChange(
+    PeerConnectionInterface::IceGatheringState new_state) {
+  RTC_LOG(LS_INFO) << "Ice gathering state changed: " << new_state;
+  if (new_state == PeerConnectionInterface::kIceGatheringComplete)
+    ice_candidate_batcher_->EndOfCandidates();
+}
+void ConferenceSharedPeerConnectionChannel::OnIceCandidate(
+    const webrtc::IceCandidateInterface* candidate) {
+  RTC_LOG(LS_INFO) << "On ice candidate";
+  ice_candidate_batcher_->AddCandidate(candidate);
+}
+void ConferenceSharedPeerConnectionChannel::OnCreateSessionDescriptionSuccess(
+    webrtc::SessionDescriptionInterface* desc) {
+  RTC_LOG(LS_INFO) << "Create sdp success.";
+  scoped_refptr<FunctionalSetSessionDescriptionObserver> observer =
+      FunctionalSetSessionDescriptionObserver::Create(
+          std::bind(&ConferenceSharedPeerConnectionChannel::
+                        OnSetLocalSessionDescriptionSuccess,
+                    this),
+          std::bind(&ConferenceSharedPeerConnectionChannel::
+                        OnSetLocalSessionDescriptionFailure,
+                    this, std::placeholders::_1));
+  SetSessionDescriptionMessage* msg =
+      new SetSessionDescriptionMessage(observer.get(), desc);
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeSetLocalDescription, msg);
+}
+void ConferenceSharedPeerConnectionChannel::OnCreateSessionDescriptionFailure(
+    const std::string& error) {
+  RTC_LOG(LS_ERROR) << "Create sdp failed: " << error;
+  FailSubscriptions("Failed to create offer.");
+}
+void ConferenceSharedPeerConnectionChannel::
+    OnSetLocalSessionDescriptionSuccess() {
+  RTC_LOG(LS_INFO) << "Set local sdp success.";
+  auto desc = LocalDescription();
+  string sdp;
+  desc->ToString(&sdp);
+  sio::message::ptr message = sio::object_message::create();
+  message->get_map()["id"] = sio::string_message::create(TransportId());
+  sio::message::ptr sdp_message = sio::object_message::create();
+  sdp_message->get_map()["type"] = sio::string_message::create(desc->type());
+  sdp_message->get_map()["sdp"] = sio::string_message::create(sdp);
+  message->get_map()["signaling"] = sdp_message;
+  signaling_channel_->SendSdp(message, nullptr, nullptr);
+}
+void ConferenceSharedPeerConnectionChannel::
+    OnSetLocalSessionDescriptionFailure(const std::string& error) {
+  RTC_LOG(LS_ERROR) << "Set local sdp failed: " << error;
+  FailSubscriptions("Failed to set local description.");
+}
+void ConferenceSharedPeerConnectionChannel::
+    OnSetRemoteSessionDescriptionFailure(const std::string& error) {
+  RTC_LOG(LS_ERROR) << "Set remote sdp failed: " << error;
+  FailSubscriptions("Failed to set remote description.");
+}
+void ConferenceSharedPeerConnectionChannel::SetRemoteDescription(
+    const std::string& type,
+    const std::string& sdp) {
+  webrtc::SessionDescriptionInterface* desc(
+      webrtc::CreateSessionDescription(type, sdp, nullptr));
+  if (!desc) {
+    RTC_LOG(LS_ERROR) << "Failed to create session description.";
+    return;
+  }
+  scoped_refptr<FunctionalSetSessionDescriptionObserver> observer =
+      FunctionalSetSessionDescriptionObserver::Create(
+          std::bind(&ConferenceSharedPeerConnectionChannel::
+                        OnSetRemoteSessionDescriptionSuccess,
+                    this),
+          std::bind(&ConferenceSharedPeerConnectionChannel::
+                        OnSetRemoteSessionDescriptionFailure,
+                    this, std::placeholders::_1));
+  SetSessionDescriptionMessage* msg =
+      new SetSessionDescriptionMessage(observer.get(), desc);
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeSetRemoteDescription, msg);
+}
+void ConferenceSharedPeerConnectionChannel::OnSignalingMessage(
+    sio::message::ptr message) {
+  if (message == nullptr || message->get_flag() != sio::message::flag_object ||
+      message->get_map()["type"] == nullptr ||
+      message->get_map()["type"]->get_flag() != sio::message::flag_string ||
+      message->get_map()["sdp"] == nullptr ||
+      message->get_map()["sdp"]->get_flag() != sio::message::flag_string) {
+    RTC_LOG(LS_ERROR) << "Invalid signaling message";
+    return;
+  }
+  const std::string type = message->get_map()["type"]->get_string();
+  RTC_LOG(LS_INFO) << "On signaling message: " << type;
+  if (type == "answer") {
+    SetRemoteDescription(type, message->get_map()["sdp"]->get_string());
+  } else {
+    RTC_LOG(LS_ERROR)
+        << "Ignoring signaling message from server other than answer.";
+  }
+}
+void ConferenceSharedPeerConnectionChannel::OnTransportError(
+    const std::string& error_message) {
+  FailSubscriptions(error_message);
+}
+void ConferenceSharedPeerConnectionChannel::FailSubscriptions(
+    const std::string& error_message) {
+  Operation operation;
+  std::vector<std::shared_ptr<ConferencePeerConnectionChannel>> channels;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_)
+      return;
+    closed_ = true;
+    operation = current_operation_;
+    // Subscription being negotiated fails with its failure callback.
+    if (operation.subscribe)
+      subscriptions_.erase(operation.session_id);
+    for (auto& entry : subscriptions_) {
+      auto channel = entry.second.channel.lock();
+      if (channel)
+        channels.push_back(channel);
+    }
+  }
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeClosePeerConnection,
+                   nullptr);
+  // Others are unsubscribed by their channels on stream error. Session ID is
+  // empty if subscribe is not acked yet.
+  if (operation.subscribe && !operation.session_id.empty()) {
+    signaling_channel_->SendStreamEvent("unsubscribe", operation.session_id,
+                                        nullptr, nullptr);
+  }
+  if (operation.subscribe && operation.on_failure) {
+    std::unique_ptr<Exception> e(
+        new Exception(ExceptionType::kConferenceUnknown, error_message));
+    operation.on_failure(std::move(e));
+  }
+  for (auto& channel : channels) {
+    channel->OnStreamError(error_message);
+  }
+  FinishOperation();
+}
+void ConferenceSharedPeerConnectionChannel::GetConnectionStats(
+    MediaStreamInterface* stream,
+    std::function<void(std::shared_ptr<ConnectionStats>)> on_success,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  RTC_DCHECK(stream);
+  scoped_refptr<FunctionalStatsObserver> observer =
+      FunctionalStatsObserver::Create(on_success, TrackIds(stream));
+  GetStatsMessage* stats_message = new GetStatsMessage(
+      observer.get(), stream,
+      webrtc::PeerConnectionInterface::kStatsOutputLevelStandard);
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeGetStats, stats_message);
+}
+void ConferenceSharedPeerConnectionChannel::GetStats(
+    MediaStreamInterface* stream,
+    std::function<void(const webrtc::StatsReports& reports)> on_success,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  if (!on_success) {
+    return;
+  }
+  RTC_DCHECK(stream);
+  scoped_refptr<FunctionalNativeStatsObserver> observer =
+      FunctionalNativeStatsObserver::Create(on_success, TrackIds(stream));
+  GetNativeStatsMessage* stats_message = new GetNativeStatsMessage(
+      observer.get(), nullptr,
+      webrtc::PeerConnectionInterface::kStatsOutputLevelStandard);
+  pc_thread_->Post(RTC_FROM_HERE, this, kMessageTypeGetStats, stats_message);
+}
+}  // namespace conference
+}  // namespace owt
@@ -0,0 +1,148 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_CONFERENCE_CONFERENCESHAREDPEERCONNECTIONCHANNEL_H_
+#define OWT_CONFERENCE_CONFERENCESHAREDPEERCONNECTIONCHANNEL_H_
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "talk/owt/sdk/base/peerconnectionchannel.h"
+#include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/icecandidatebatcher.h"
+namespace owt {
+namespace conference {
+using namespace owt::base;
+class ConferencePeerConnectionChannel;
+// Carries several subscriptions over a single PeerConnection with MCU. Each
+// subscription gets its own recvonly transceivers, and the PeerConnection is
+// renegotiated when subscriptions are added or removed. Negotiations are
+// serialized, one subscription at a time.
+//
+// Subscriptions are still represented by ConferencePeerConnectionChannel
+// instances created without a PeerConnection, which forward media operations
+// here. MCU tells the transport ID in subscribe ack if it shares transports
+// among sessions. Otherwise, the first subscription owns this PeerConnection
+// as if it was not shared, and later ones are handed back through their
+// fallback callbacks.
+class ConferenceSharedPeerConnectionChannel
+    : public PeerConnectionChannel,
+      public std::enable_shared_from_this<
+          ConferenceSharedPeerConnectionChannel> {
+ public:
+  explicit ConferenceSharedPeerConnectionChannel(
+      PeerConnectionChannelConfiguration& configuration,
+      std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel);
+  ~ConferenceSharedPeerConnectionChannel();
+  // Subscribes with |options|, which is the subscribe request without
+  // transport. |subscription| is notified with the session ID, and with the
+  // remote media stream once negotiated. |fallback| is invoked instead if MCU
+  // does not share this PeerConnection.
+  void Subscribe(std::shared_ptr<ConferencePeerConnectionChannel> subscription,
+                 sio::message::ptr options,
+                 bool receive_audio,
+                 bool receive_video,
+                 std::function<void()> fallback,
+                 std::function<void(std::unique_ptr<Exception>)> on_failure);
+  // Stops transceivers of |session_id| after it is unsubscribed. The
+  // PeerConnection is closed when no subscription is left.
+  void Unsubscribe(const std::string& session_id);
+  // False if the PeerConnection is closed, or MCU does not share it.
+  bool AcceptsSubscriptions() const;
+  // True if MCU is known not to share transports among sessions.
+  bool IsMultiplexingUnsupported() const;
+  // ID of the PeerConnection in signaling messages. Empty until the first
+  // subscription is acked.
+  std::string TransportId() const;
+  // SOAC message for the PeerConnection.
+  void OnSignalingMessage(sio::message::ptr message);
+  // Called when MCU reports the transport is failed.
+  void OnTransportError(const std::string& error_message);
+  void GetConnectionStats(
+      MediaStreamInterface* stream,
+      std::function<void(std::shared_ptr<ConnectionStats>)> on_success,
+      std::function<void(std::unique_ptr<Exception>)> on_failure);
+  void GetStats(
+      MediaStreamInterface* stream,
+      std::function<void(const webrtc::StatsReports& reports)> on_success,
+      std::function<void(std::unique_ptr<Exception>)> on_failure);
+ protected:
+  void CreateOffer() override;
+  void CreateAnswer() override;
+  void OnMessage(rtc::Message* msg) override;
+  // PeerConnectionObserver
+  void OnSignalingChange(
+      PeerConnectionInterface::SignalingState new_state) override;
+  void OnAddStream(rtc::scoped_refptr<MediaStreamInterface> stream) override;
+  void OnIceConnectionChange(
+      PeerConnectionInterface::IceConnectionState new_state) override;
+  void OnIceGatheringChange(
+      PeerConnectionInterface::IceGatheringState new_state) override;
+  void OnIceCandidate(const webrtc::IceCandidateInterface* candidate) override;
+  // CreateSessionDescriptionObserver
+  void OnCreateSessionDescriptionSuccess(
+      webrtc::SessionDescriptionInterface* desc) override;
+  void OnCreateSessionDescriptionFailure(const std::string& error) override;
+  // SetSessionDescriptionObserver
+  void OnSetLocalSessionDescriptionSuccess() override;
+  void OnSetLocalSessionDescriptionFailure(const std::string& error) override;
+  void OnSetRemoteSessionDescriptionFailure(const std::string& error) override;
+ private:
+  // A subscription added or removed, which needs a negotiation.
+  struct Operation {
+    Operation() : subscribe(false), receive_audio(false), receive_video(false) {}
+    bool subscribe;
+    std::string session_id;
+    std::weak_ptr<ConferencePeerConnectionChannel> subscription;
+    sio::message::ptr options;
+    bool receive_audio;
+    bool receive_video;
+    std::function<void()> fallback;
+    std::function<void(std::unique_ptr<Exception>)> on_failure;
+  };
+  struct Subscription {
+    std::weak_ptr<ConferencePeerConnectionChannel> channel;
+    std::vector<rtc::scoped_refptr<webrtc::RtpTransceiverInterface>>
+        transceivers;
+  };
+  enum MultiplexingState : int;
+  enum SharedMessageType : int;
+  // Starts the first queued operation if no negotiation is in progress.
+  void StartNextOperation();
+  // Called when the current negotiation is done.
+  void FinishOperation();
+  void OnSubscribeAck(const Operation& operation,
+                      const std::string& session_id,
+                      const std::string& transport_id);
+  // Run on |pc_thread_|.
+  void AddTransceivers(const std::string& session_id,
+                       bool receive_audio,
+                       bool receive_video);
+  void StopTransceivers(const std::string& session_id);
+  void SetRemoteDescription(const std::string& type, const std::string& sdp);
+  // Closes the PeerConnection, and notifies subscriptions about an
+  // unrecoverable error.
+  void FailSubscriptions(const std::string& error_message);
+  std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel_;
+  mutable std::mutex mutex_;
+  // Following members are guarded by |mutex_|.
+  std::string transport_id_;
+  MultiplexingState multiplexing_state_;
+  bool closed_;
+  bool negotiating_;
+  Operation current_operation_;
+  std::deque<Operation> operations_;
+  // Key is subscription ID.
+  std::unordered_map<std::string, Subscription> subscriptions_;
+  std::shared_ptr<IceCandidateBatcher> ice_candidate_batcher_;
+  // Time of the first offer, for ConferenceClientStats.
+  std::atomic<int64_t> negotiation_start_ms_;
+  bool connect_time_recorded_;
+  bool connected_;
+};
+}  // namespace conference
+}  // namespace owt
+#endif  // OWT_CONFERENCE_CONFERENCESHAREDPEERCONNECTIONCHANNEL_H_
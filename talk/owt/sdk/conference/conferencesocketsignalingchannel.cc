@@ -8,10 +8,13 @@
 #if defined(WEBRTC_IOS)
 #include <CoreFoundation/CFDate.h>
 #endif
+#include "talk/owt/sdk/base/exponentialbackoff.h"
 #include "talk/owt/sdk/base/mediautils.h"
 #include "talk/owt/sdk/base/stringutils.h"
 #include "talk/owt/sdk/base/sysinfo.h"
+#include "talk/owt/sdk/base/timerservice.h"
 #include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/siosignalingtransport.h"
 #include "webrtc/rtc_base/third_party/base64/base64.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
@@ -64,16 +67,52 @@ const std::string kEventNameConnectionFailed = "connection_failed";
 const uint64_t kMachLinuxTimeDelta = 978307200;
 #endif
 const int kReconnectionAttempts = 10;
-const int kReconnectionDelay = 2000;
+// Reconnection delays grow exponentially from the initial delay up to the max
+// delay. Full jitter spreads clients dropped at the same time.
+const unsigned kReconnectionInitialDelay = 1000;
+const unsigned kReconnectionMaxDelay = 30000;
+const double kReconnectionJitter = 1.0;
+const int kDefaultAckTimeout = 30000;
+const size_t kDefaultMaxInFlightMessages = 64;
+static std::mutex transport_factory_mutex;
+static ConferenceSocketSignalingChannel::TransportFactory transport_factory;
+void ConferenceSocketSignalingChannel::SetTransportFactory(
+    TransportFactory factory) {
+  std::lock_guard<std::mutex> lock(transport_factory_mutex);
+  transport_factory = std::move(factory);
+}
+std::unique_ptr<SignalingTransportInterface>
+ConferenceSocketSignalingChannel::CreateTransport() {
+  {
+    std::lock_guard<std::mutex> lock(transport_factory_mutex);
+    if (transport_factory)
+      return transport_factory();
+  }
+  return std::unique_ptr<SignalingTransportInterface>(
+      new SioSignalingTransport());
+}
 ConferenceSocketSignalingChannel::ConferenceSocketSignalingChannel()
-    : socket_client_(new sio::client()),
+    : ConferenceSocketSignalingChannel(CreateTransport()) {}
+ConferenceSocketSignalingChannel::ConferenceSocketSignalingChannel(
+    std::unique_ptr<SignalingTransportInterface> transport)
+    : transport_(std::move(transport)),
       reconnection_ticket_(""),
       participant_id_(""),
       reconnection_attempted_(0),
       is_reconnection_(false),
-      outgoing_message_id_(1) {}
+      room_resync_supported_(false),
+      outgoing_message_id_(1),
+      ack_timeout_ms_(kDefaultAckTimeout),
+      max_in_flight_messages_(kDefaultMaxInFlightMessages),
+      next_timeout_check_ms_(0),
+      session_grace_period_ms_(0),
+      logged_out_(false),
+      session_kept_(false),
+      kept_session_id_(0),
+      ice_candidate_batch_window_ms_(0) {}
 ConferenceSocketSignalingChannel::~ConferenceSocketSignalingChannel() {
-  delete socket_client_;
+  // Listeners may be running on transport's thread until it is destroyed.
+  transport_.reset();
 }
 void ConferenceSocketSignalingChannel::AddObserver(
     ConferenceSocketSignalingChannelObserver& observer) {
@@ -130,29 +169,33 @@ void ConferenceSocketSignalingChannel::Connect(
   rtc::GetStringFromJsonObject(json_token, "host", &host);
   std::weak_ptr<ConferenceSocketSignalingChannel> weak_this =
       shared_from_this();
-  socket_client_->socket();
-  socket_client_->set_reconnect_attempts(kReconnectionAttempts);
-  socket_client_->set_reconnect_delay(kReconnectionDelay);
-  socket_client_->set_socket_close_listener(
-      [weak_this](std::string const& nsp) {
-        RTC_LOG(LS_INFO) << "Socket.IO disconnected.";
-        auto that = weak_this.lock();
-        if (that && (that->reconnection_attempted_ >= kReconnectionAttempts ||
-                     that->disconnect_complete_)) {
-          that->TriggerOnServerDisconnected();
-        }
-      });
-  socket_client_->set_fail_listener([weak_this]() {
+  transport_->SetReconnectAttempts(kReconnectionAttempts);
+  auto backoff = std::make_shared<owt::base::ExponentialBackoff>(
+      kReconnectionInitialDelay, kReconnectionMaxDelay, kReconnectionJitter);
+  transport_->SetReconnectDelay(
+      [backoff](unsigned attempt) { return backoff->Delay(attempt); });
+  transport_->SetCloseListener([weak_this]() {
+    RTC_LOG(LS_INFO) << "Socket.IO disconnected.";
+    auto that = weak_this.lock();
+    // Disconnection is already reported when logged out.
+    if (that && !that->logged_out_ &&
+        (that->reconnection_attempted_ >= kReconnectionAttempts ||
+                 that->disconnect_complete_)) {
+      that->TriggerOnServerDisconnected();
+    }
+  });
+  transport_->SetFailListener([weak_this]() {
     RTC_LOG(LS_ERROR) << "Socket.IO connection failed.";
     auto that = weak_this.lock();
     if (that) {
       that->DropQueuedMessages();
-      if (that->reconnection_attempted_ >= kReconnectionAttempts) {
+      if (!that->logged_out_ &&
+          that->reconnection_attempted_ >= kReconnectionAttempts) {
         that->TriggerOnServerDisconnected();
       }
     }
   });
-  socket_client_->set_reconnecting_listener([weak_this]() {
+  transport_->SetReconnectingListener([weak_this]() {
     RTC_LOG(LS_INFO) << "Socket.IO reconnecting.";
     auto that = weak_this.lock();
     if (that) {
@@ -164,96 +207,21 @@ void ConferenceSocketSignalingChannel::Connect(
       }
     }
   });
-  socket_client_->set_open_listener([=](void) {
+  transport_->SetOpenListener([=](void) {
     // At this time the connect failure callback is still in pending list. No
     // need to add a new entry in the pending list.
     if (!is_reconnection_) {
-      owt::base::SysInfo sys_info(owt::base::SysInfo::GetInstance());
-      sio::message::ptr login_message = sio::object_message::create();
-      login_message->get_map()["token"] = sio::string_message::create(token);
-      sio::message::ptr ua_message = sio::object_message::create();
-      sio::message::ptr sdk_message = sio::object_message::create();
-      sdk_message->get_map()["type"] =
-          sio::string_message::create(sys_info.sdk.type);
-      sdk_message->get_map()["version"] =
-          sio::string_message::create(sys_info.sdk.version);
-      ua_message->get_map()["sdk"] = sdk_message;
-      sio::message::ptr os_message = sio::object_message::create();
-      os_message->get_map()["name"] =
-          sio::string_message::create(sys_info.os.name);
-      os_message->get_map()["version"] =
-          sio::string_message::create(sys_info.os.version);
-      ua_message->get_map()["os"] = os_message;
-      sio::message::ptr runtime_message = sio::object_message::create();
-      runtime_message->get_map()["name"] =
-          sio::string_message::create(sys_info.runtime.name);
-      runtime_message->get_map()["version"] =
-          sio::string_message::create(sys_info.runtime.version);
-      ua_message->get_map()["runtime"] = runtime_message;
-      login_message->get_map()["userAgent"] = ua_message;
-      std::string protocol_version = SIGNALING_PROTOCOL_VERSION;
-      login_message->get_map()["protocol"] = sio::string_message::create(protocol_version);
-      Emit("login", login_message,
-           [=](sio::message::list const& msg) {
-             connect_failure_callback_ = nullptr;
-             if (msg.size() < 2) {
-               RTC_LOG(LS_ERROR) << "Received unknown message while sending token.";
-               if (on_failure != nullptr) {
-                 std::unique_ptr<Exception> e(new Exception(
-                     ExceptionType::kConferenceInvalidParam,
-                     "Received unknown message from server."));
-                 on_failure(std::move(e));
-               }
-               return;
-             }
-             sio::message::ptr ack =
-                 msg.at(0);  // The first element indicates the state.
-             std::string state = ack->get_string();
-             if (state == "error" || state == "timeout") {
-               RTC_LOG(LS_ERROR) << "Server returns " << state
-                             << " while joining a conference.";
-               if (on_failure != nullptr) {
-                 std::unique_ptr<Exception> e(new Exception(
-                     ExceptionType::kConferenceInvalidParam,
-                     "Received error message from server."));
-                 on_failure(std::move(e));
-               }
-               return;
-             }
-             // in signaling protocol 1.0.0, the response contains following info:
-             // {id: string(participantid),
-             //  user: string(userid),
-             //  role: string(participantrole),
-             //  permission: object(permission),
-             //  room: object(RoomInfo),
-             //  reconnectonTicket: undefined or string(ReconnecionTicket).}
-             // At present client SDK will only save reconnection ticket and participantid
-             // and ignoring other info.
-             sio::message::ptr message = msg.at(1);
-             auto reconnection_ticket_ptr =
-                 message->get_map()["reconnectionTicket"];
-             if (reconnection_ticket_ptr) {
-               OnReconnectionTicket(reconnection_ticket_ptr->get_string());
-             }
-             auto participant_id_ptr = message->get_map()["id"];
-             if (participant_id_ptr) {
-               participant_id_ = participant_id_ptr->get_string();
-             }
-             if (on_success != nullptr) {
-               on_success(message);
-             }
-           },
-           on_failure);
+      Login(token, on_success, on_failure);
       is_reconnection_ = false;
       reconnection_attempted_ = 0;
     } else {
-      socket_client_->socket()->emit(
+      transport_->Emit(
           kEventNameRelogin, reconnection_ticket_, [&](sio::message::list const& msg) {
             if (msg.size() < 2) {
               RTC_LOG(LS_WARNING)
                   << "Received unknown message while reconnection ticket.";
               reconnection_attempted_ = kReconnectionAttempts;
-              socket_client_->close();
+              transport_->Close();
               return;
             }
             sio::message::ptr ack =
@@ -264,21 +232,36 @@ void ConferenceSocketSignalingChannel::Connect(
                   << "Server returns " << state
                   << " when relogin. Maybe an invalid reconnection ticket.";
               reconnection_attempted_ = kReconnectionAttempts;
-              socket_client_->close();
+              transport_->Close();
               return;
             }
-            // The second element is room info, please refer to MCU
-            // erizoController's implementation for detailed message format.
+            // The second element is a reconnection ticket. Servers advertising
+            // roomResync capability on login send an object with the ticket
+            // and current room info instead:
+            // {reconnectionTicket: string, room: object(RoomInfo)}.
             sio::message::ptr message = msg.at(1);
             if (message->get_flag() == sio::message::flag_string) {
               OnReconnectionTicket(message->get_string());
+            } else if (room_resync_supported_ &&
+                       message->get_flag() == sio::message::flag_object) {
+              auto ticket = message->get_map()["reconnectionTicket"];
+              if (ticket && ticket->get_flag() == sio::message::flag_string) {
+                OnReconnectionTicket(ticket->get_string());
+              }
+              auto room = message->get_map()["room"];
+              if (room && room->get_flag() == sio::message::flag_object) {
+                for (auto it = observers_.begin(); it != observers_.end();
+                     ++it) {
+                  (*it)->OnRoomResync(room);
+                }
+              }
             }
             RTC_LOG(LS_VERBOSE) << "Reconnection success";
             DrainQueuedMessages();
           });
     }
   });
-  socket_client_->socket()->on(
+  transport_->On(
       kEventNameStreamMessage,
       sio::socket::event_listener_aux(
           [&](std::string const& name, sio::message::ptr const& data,
@@ -316,7 +299,7 @@ void ConferenceSocketSignalingChannel::Connect(
               }
             }
           }));
-  socket_client_->socket()->on(
+  transport_->On(
       kEventNameOnCustomMessage,
       sio::socket::event_listener_aux(
           [&](std::string const& name, sio::message::ptr const& data,
@@ -333,7 +316,7 @@ void ConferenceSocketSignalingChannel::Connect(
               (*it)->OnCustomMessage(from, message, to);
             }
           }));
-  socket_client_->socket()->on(
+  transport_->On(
       kEventNameOnUserPresence,
       sio::socket::event_listener_aux([&](
           std::string const& name, sio::message::ptr const& data, bool is_ack,
@@ -367,7 +350,7 @@ void ConferenceSocketSignalingChannel::Connect(
           RTC_NOTREACHED();
         }
       }));
-  socket_client_->socket()->on(
+  transport_->On(
       kEventNameOnSignalingMessage,
       sio::socket::event_listener_aux(
           [&](std::string const& name, sio::message::ptr const& data,
@@ -377,18 +360,18 @@ void ConferenceSocketSignalingChannel::Connect(
               (*it)->OnSignalingMessage(data);
             }
           }));
-  socket_client_->socket()->on(
+  transport_->On(
       kEventNameOnDrop,
       sio::socket::event_listener_aux(
           [&](std::string const& name, sio::message::ptr const& data,
               bool is_ack, sio::message::list& ack_resp) {
             RTC_LOG(LS_INFO) << "Received drop message.";
-            socket_client_->set_reconnect_attempts(0);
+            transport_->SetReconnectAttempts(0);
             for (auto it = observers_.begin(); it != observers_.end(); ++it) {
               (*it)->OnServerDisconnected();
             }
           }));
-  socket_client_->socket()->on(
+  transport_->On(
       kEventNameConnectionFailed,
       sio::socket::event_listener_aux(
           [&](std::string const& name, sio::message::ptr const& data,
@@ -399,12 +382,120 @@ void ConferenceSocketSignalingChannel::Connect(
           }));
   // Store |on_failure| so it can be invoked if connect failed.
   connect_failure_callback_ = on_failure;
-  socket_client_->connect(scheme.append(host));
+  const std::string url(scheme.append(host));
+  // Connection kept after last Disconnect is either reused or closed.
+  ++kept_session_id_;
+  const bool kept_session = session_kept_.exchange(false);
+  logged_out_ = false;
+  if (kept_session) {
+    reconnection_attempted_ = 0;
+    if (url == url_ && transport_->Opened()) {
+      RTC_LOG(LS_INFO) << "Reuse connection kept after logout.";
+      transport_->SetReconnectAttempts(kReconnectionAttempts);
+      Login(token, on_success, on_failure);
+      return;
+    }
+    transport_->Close();
+  }
+  url_ = url;
+  transport_->Connect(url);
+}
+void ConferenceSocketSignalingChannel::Login(
+    const std::string& token,
+    std::function<void(sio::message::ptr room_info)> on_success,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  owt::base::SysInfo sys_info(owt::base::SysInfo::GetInstance());
+  sio::message::ptr login_message = sio::object_message::create();
+  login_message->get_map()["token"] = sio::string_message::create(token);
+  sio::message::ptr ua_message = sio::object_message::create();
+  sio::message::ptr sdk_message = sio::object_message::create();
+  sdk_message->get_map()["type"] =
+      sio::string_message::create(sys_info.sdk.type);
+  sdk_message->get_map()["version"] =
+      sio::string_message::create(sys_info.sdk.version);
+  ua_message->get_map()["sdk"] = sdk_message;
+  sio::message::ptr os_message = sio::object_message::create();
+  os_message->get_map()["name"] =
+      sio::string_message::create(sys_info.os.name);
+  os_message->get_map()["version"] =
+      sio::string_message::create(sys_info.os.version);
+  ua_message->get_map()["os"] = os_message;
+  sio::message::ptr runtime_message = sio::object_message::create();
+  runtime_message->get_map()["name"] =
+      sio::string_message::create(sys_info.runtime.name);
+  runtime_message->get_map()["version"] =
+      sio::string_message::create(sys_info.runtime.version);
+  ua_message->get_map()["runtime"] = runtime_message;
+  login_message->get_map()["userAgent"] = ua_message;
+  std::string protocol_version = SIGNALING_PROTOCOL_VERSION;
+  login_message->get_map()["protocol"] = sio::string_message::create(protocol_version);
+  Emit("login", login_message,
+       [=](sio::message::list const& msg) {
+         connect_failure_callback_ = nullptr;
+         if (msg.size() < 2) {
+           RTC_LOG(LS_ERROR) << "Received unknown message while sending token.";
+           if (on_failure != nullptr) {
+             std::unique_ptr<Exception> e(new Exception(
+                 ExceptionType::kConferenceInvalidParam,
+                 "Received unknown message from server."));
+             on_failure(std::move(e));
+           }
+           return;
+         }
+         sio::message::ptr ack =
+             msg.at(0);  // The first element indicates the state.
+         std::string state = ack->get_string();
+         if (state == "error" || state == "timeout") {
+           RTC_LOG(LS_ERROR) << "Server returns " << state
+                         << " while joining a conference.";
+           if (on_failure != nullptr) {
+             std::unique_ptr<Exception> e(new Exception(
+                 ExceptionType::kConferenceInvalidParam,
+                 "Received error message from server."));
+             on_failure(std::move(e));
+           }
+           return;
+         }
+         // in signaling protocol 1.0.0, the response contains following info:
+         // {id: string(participantid),
+         //  user: string(userid),
+         //  role: string(participantrole),
+         //  permission: object(permission),
+         //  room: object(RoomInfo),
+         //  reconnectonTicket: undefined or string(ReconnecionTicket).}
+         // Servers able to resync room state on relogin also send
+         //  capabilities: {roomResync: true}.
+         // At present client SDK will only save reconnection ticket, participantid
+         // and capabilities, and ignoring other info.
+         sio::message::ptr message = msg.at(1);
+         auto reconnection_ticket_ptr =
+             message->get_map()["reconnectionTicket"];
+         if (reconnection_ticket_ptr) {
+           OnReconnectionTicket(reconnection_ticket_ptr->get_string());
+         }
+         auto participant_id_ptr = message->get_map()["id"];
+         if (participant_id_ptr) {
+           participant_id_ = participant_id_ptr->get_string();
+         }
+         auto capabilities = message->get_map()["capabilities"];
+         if (capabilities &&
+             capabilities->get_flag() == sio::message::flag_object) {
+           auto room_resync = capabilities->get_map()["roomResync"];
+           room_resync_supported_ =
+               room_resync &&
+               room_resync->get_flag() == sio::message::flag_boolean &&
+               room_resync->get_bool();
+         }
+         if (on_success != nullptr) {
+           on_success(message);
+         }
+       },
+       on_failure);
 }
 void ConferenceSocketSignalingChannel::Disconnect(
     std::function<void()> on_success,
     std::function<void(std::unique_ptr<Exception>)> on_failure) {
-  if (!socket_client_->opened() && reconnection_attempted_ == 0 && on_failure) {
+  if (!transport_->Opened() && reconnection_attempted_ == 0 && on_failure) {
     // Socket.IO is not connected and not reconnecting.
     std::unique_ptr<Exception> e(new Exception(
         ExceptionType::kConferenceInvalidSession, "Socket.IO is not connected."));
@@ -414,15 +505,46 @@ void ConferenceSocketSignalingChannel::Disconnect(
   }
   reconnection_attempted_ = kReconnectionAttempts;
   disconnect_complete_ = on_success;
-  if (socket_client_->opened()) {
+  if (transport_->Opened()) {
+    const int grace_period_ms = session_grace_period_ms_;
     // Clear all pending failure callbacks after successful disconnect, don't check resp.
-    socket_client_->socket()->emit(kEventNameLogout, nullptr,
-                                   [=](sio::message::list const& msg) {
-                                     DropQueuedMessages();
-                                     socket_client_->close();
-                                   });
+    transport_->Emit(kEventNameLogout, nullptr,
+                     [=](sio::message::list const& msg) {
+                       DropQueuedMessages();
+                       if (grace_period_ms <= 0) {
+                         transport_->Close();
+                         return;
+                       }
+                       KeepSession(grace_period_ms);
+                     });
   }
 }
+void ConferenceSocketSignalingChannel::SetSessionGracePeriod(
+    int grace_period_ms) {
+  session_grace_period_ms_ = std::max(grace_period_ms, 0);
+}
+void ConferenceSocketSignalingChannel::KeepSession(int grace_period_ms) {
+  // Server does not reconnect a participant logged out, so connection is not
+  // recovered if it is lost in grace period.
+  transport_->SetReconnectAttempts(0);
+  const int session_id = ++kept_session_id_;
+  logged_out_ = true;
+  session_kept_ = true;
+  TriggerOnServerDisconnected();
+  std::weak_ptr<ConferenceSocketSignalingChannel> weak_this =
+      shared_from_this();
+  owt::base::TimerService::Get()->Schedule(
+      [weak_this, session_id]() {
+        auto that = weak_this.lock();
+        if (!that || that->kept_session_id_ != session_id ||
+            !that->session_kept_.exchange(false)) {
+          return;
+        }
+        RTC_LOG(LS_INFO) << "Close connection kept after logout.";
+        that->transport_->Close();
+      },
+      grace_period_ms);
+}
 void ConferenceSocketSignalingChannel::SendSubscriptionUpdateMessage(
   sio::message::ptr options,
   std::function<void()> on_success,
@@ -442,13 +564,47 @@ void ConferenceSocketSignalingChannel::SendInitializationMessage(
     std::string subscribe_stream_label,
     std::function<void(std::string)> on_success,
     std::function<void(std::unique_ptr<Exception>)> on_failure) {
-  sio::message::list message_list;
-  message_list.push(options);
   std::string event_name;
   if (publish_stream_label != "")
     event_name = kEventNamePublish;
   else if (subscribe_stream_label != "")
     event_name = kEventNameSubscribe;
+  std::function<void(sio::message::ptr)> on_result = nullptr;
+  if (on_success && (event_name == kEventNamePublish ||
+                     event_name == kEventNameSubscribe)) {
+    on_result = [on_success](sio::message::ptr result) {
+      // Notify PeerConnectionChannel.
+      on_success(result->get_map()["id"]->get_string());
+    };
+  }
+  SendSessionMessage(event_name, options, on_result, on_failure);
+}
+void ConferenceSocketSignalingChannel::SendSubscribeMessage(
+    sio::message::ptr options,
+    std::function<void(std::string session_id, std::string transport_id)>
+        on_success,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  std::function<void(sio::message::ptr)> on_result = nullptr;
+  if (on_success) {
+    on_result = [on_success](sio::message::ptr result) {
+      std::string transport_id;
+      auto transport_id_message = result->get_map()["transportId"];
+      if (transport_id_message &&
+          transport_id_message->get_flag() == sio::message::flag_string) {
+        transport_id = transport_id_message->get_string();
+      }
+      on_success(result->get_map()["id"]->get_string(), transport_id);
+    };
+  }
+  SendSessionMessage(kEventNameSubscribe, options, on_result, on_failure);
+}
+void ConferenceSocketSignalingChannel::SendSessionMessage(
+    const std::string& event_name,
+    sio::message::ptr options,
+    std::function<void(sio::message::ptr result)> on_success,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  sio::message::list message_list;
+  message_list.push(options);
   Emit(event_name, message_list,
        [=](sio::message::list const& msg) {
          RTC_LOG(LS_INFO) << "Received ack from server.";
@@ -474,12 +630,7 @@ void ConferenceSocketSignalingChannel::SendInitializationMessage(
              RTC_DCHECK(false);
              return;
            }
-           std::string session_id = msg.at(1)->get_map()["id"]->get_string();
-           if (event_name == kEventNamePublish || event_name == kEventNameSubscribe) {
-             // Notify PeerConnectionChannel.
-             on_success(session_id);
-             return;
-           }
+           on_success(msg.at(1));
            return;
          } else if (message->get_string() == "error" && msg.at(1) != nullptr &&
                     msg.at(1)->get_flag() == sio::message::flag_string) {
@@ -695,18 +846,19 @@ void ConferenceSocketSignalingChannel::OnReconnectionTicket(
                     << "seconds";
     std::weak_ptr<ConferenceSocketSignalingChannel> weak_this =
         shared_from_this();
-    std::thread([weak_this, delay]() {
-      std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-      auto that = weak_this.lock();
-      if (!that) {
-        return;
-      }
-      that->RefreshReconnectionTicket();
-    }).detach();
+    owt::base::TimerService::Get()->Schedule(
+        [weak_this]() {
+          auto that = weak_this.lock();
+          if (!that || that->logged_out_) {
+            return;
+          }
+          that->RefreshReconnectionTicket();
+        },
+        delay);
   }
 }
 void ConferenceSocketSignalingChannel::RefreshReconnectionTicket() {
-  socket_client_->socket()->emit(
+  transport_->Emit(
       kEventNameRefreshReconnectionTicket, nullptr,
       [=](sio::message::list const& ack) {
         if (ack.size() != 2) {
@@ -733,92 +885,217 @@ void ConferenceSocketSignalingChannel::TriggerOnServerDisconnected() {
     (*it)->OnServerDisconnected();
   }
 }
+void ConferenceSocketSignalingChannel::SetAckTimeout(int timeout_ms) {
+  ack_timeout_ms_ = std::max(timeout_ms, 0);
+}
+void ConferenceSocketSignalingChannel::SetMaxInFlightMessages(
+    size_t max_in_flight_messages) {
+  max_in_flight_messages_ = max_in_flight_messages;
+  // Window may be enlarged.
+  EmitWaitingMessages();
+}
+void ConferenceSocketSignalingChannel::SetIceCandidateBatchWindow(
+    int window_ms) {
+  ice_candidate_batch_window_ms_ = std::max(window_ms, 0);
+}
+void ConferenceSocketSignalingChannel::DisableIceCandidateBatching() {
+  if (ice_candidate_batch_window_ms_.exchange(0) != 0) {
+    RTC_LOG(LS_WARNING) << "Server does not accept batched ICE candidates.";
+  }
+}
+SignalingAckStats ConferenceSocketSignalingChannel::GetAckStats() const {
+  std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+  SignalingAckStats stats(ack_stats_);
+  stats.in_flight_messages = unacked_messages_.size();
+  stats.queued_messages = waiting_messages_.size();
+  return stats;
+}
 void ConferenceSocketSignalingChannel::Emit(
     const std::string& name,
     const sio::message::list& message,
-    const std::function<void(sio::message::list const&)> ack,
-    const std::function<void(std::unique_ptr<Exception>)>
-        on_failure) {
-  int message_id(0);
+    std::function<void(sio::message::list const&)> ack,
+    std::function<void(std::unique_ptr<Exception>)> on_failure) {
+  const int timeout_ms = ack_timeout_ms_;
   {
-    std::lock_guard<std::mutex> lock(outgoing_message_mutex_);
-    message_id = outgoing_message_id_++;
+    // IDs are assigned in queue order, so un-acked messages are re-emitted in
+    // the order they were sent.
+    std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+    OutgoingMessagePtr outgoing_message = std::make_shared<OutgoingMessage>(
+        outgoing_message_id_++,
+        timeout_ms > 0 ? rtc::TimeMillis() + timeout_ms : 0, name, message,
+        std::move(ack), std::move(on_failure));
+    if (outgoing_message->deadline_ms != 0)
+      ScheduleAckTimeoutCheck(outgoing_message->deadline_ms);
+    waiting_messages_.push_back(std::move(outgoing_message));
+  }
+  EmitWaitingMessages();
+}
+void ConferenceSocketSignalingChannel::EmitWaitingMessages() {
+  std::lock_guard<std::recursive_mutex> emit_lock(emit_mutex_);
+  std::vector<OutgoingMessagePtr> batch;
+  {
+    // Messages must be recorded before they are emitted, as ack may come
+    // from Socket.IO's thread before emit returns.
+    std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+    const size_t max_in_flight_messages = max_in_flight_messages_;
+    const int64_t now = rtc::TimeMillis();
+    while (!waiting_messages_.empty() &&
+           (max_in_flight_messages == 0 ||
+            unacked_messages_.size() < max_in_flight_messages)) {
+      OutgoingMessagePtr outgoing_message =
+          std::move(waiting_messages_.front());
+      waiting_messages_.pop_front();
+      unacked_messages_[outgoing_message->id] = {outgoing_message, now};
+      batch.push_back(std::move(outgoing_message));
+    }
+  }
+  if (batch.empty())
+    return;
+  if (batch.size() > 1) {
+    RTC_LOG(LS_VERBOSE) << "Emit " << batch.size() << " messages in a batch.";
   }
-#if 0
-  std::string sio_name = "signaling";
-  sio::message::ptr request_name = sio::string_message::create(name);
-  sio::message::list new_message(message);
-  new_message.insert(0, request_name);
-#endif
-  // SioMessage sio_message(message_id, sio_name, new_message, ack, on_failure);
-  SioMessage sio_message(message_id, name, message, ack, on_failure);
-  outgoing_messages_.push(sio_message);
   std::weak_ptr<ConferenceSocketSignalingChannel> weak_this =
       shared_from_this();
-  socket_client_->socket()->emit(
-      name, message, [weak_this, message_id](sio::message::list const& msg) {
-        RTC_LOG(LS_INFO) << "Received ack for message ID: " << message_id;
-        auto that = weak_this.lock();
-        if (!that) {
-          RTC_LOG(LS_WARNING) << "Signaling channel was destroyed before ack.";
-          return;
-        }
-        std::function<void(sio::message::list const&)> callback(nullptr);
-        {
-          std::lock_guard<std::mutex> lock(that->outgoing_message_mutex_);
-          if (that->outgoing_messages_.empty()) {
-            //RTC_NOTREACHED();
+  for (const auto& outgoing_message : batch) {
+    const int message_id = outgoing_message->id;
+    transport_->Emit(
+        outgoing_message->name, outgoing_message->message,
+        [weak_this, message_id](sio::message::list const& msg) {
+          auto that = weak_this.lock();
+          if (!that) {
+            RTC_LOG(LS_WARNING)
+                << "Signaling channel was destroyed before ack.";
             return;
           }
-          /*RTC_DCHECK_EQ(message_id, that->outgoing_messages_.front().id)
-              << "Unordered Socket.IO message.";*/
-          while (that->outgoing_messages_.front().id < message_id) {
-            RTC_LOG(LS_WARNING) << "Potential unordered Socket.IO message.";
-            that->outgoing_messages_.pop();
-          }
-          if (that->outgoing_messages_.front().id > message_id) {
-            RTC_LOG(LS_ERROR) << "Original message for " << message_id
-                          << " is not found.";
-          }
-          callback = that->outgoing_messages_.front().ack;
-          that->outgoing_messages_.pop();
-        }
-        if (callback) {
-          callback(msg);
-        }
-      });
+          that->OnOutgoingMessageAck(message_id, msg);
+        });
+  }
+}
+void ConferenceSocketSignalingChannel::OnOutgoingMessageAck(
+    int message_id,
+    sio::message::list const& msg) {
+  RTC_LOG(LS_INFO) << "Received ack for message ID: " << message_id;
+  OutgoingMessagePtr outgoing_message;
+  {
+    std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+    auto it = unacked_messages_.find(message_id);
+    if (it == unacked_messages_.end()) {
+      RTC_LOG(LS_WARNING) << "Original message for " << message_id
+                          << " is not found. It may have timed out.";
+      return;
+    }
+    const int64_t rtt = rtc::TimeMillis() - it->second.sent_time_ms;
+    ack_stats_.smoothed_rtt_ms =
+        ack_stats_.acked_messages == 0
+            ? rtt
+            : (7 * ack_stats_.smoothed_rtt_ms + rtt) / 8;
+    ack_stats_.max_rtt_ms = std::max(ack_stats_.max_rtt_ms, rtt);
+    ack_stats_.acked_messages++;
+    outgoing_message = std::move(it->second.message);
+    unacked_messages_.erase(it);
+  }
+  if (outgoing_message->ack) {
+    outgoing_message->ack(msg);
+  }
+  EmitWaitingMessages();
+}
+void ConferenceSocketSignalingChannel::ScheduleAckTimeoutCheck(
+    int64_t deadline_ms) {
+  if (next_timeout_check_ms_ != 0 && next_timeout_check_ms_ <= deadline_ms)
+    return;
+  next_timeout_check_ms_ = deadline_ms;
+  std::weak_ptr<ConferenceSocketSignalingChannel> weak_this =
+      shared_from_this();
+  owt::base::TimerService::Get()->Schedule(
+      [weak_this]() {
+        auto that = weak_this.lock();
+        if (that)
+          that->OnAckTimeoutCheck();
+      },
+      deadline_ms - rtc::TimeMillis());
+}
+void ConferenceSocketSignalingChannel::OnAckTimeoutCheck() {
+  std::vector<OutgoingMessagePtr> timed_out_messages;
+  {
+    std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+    const int64_t now = rtc::TimeMillis();
+    int64_t next_deadline_ms = 0;
+    auto timed_out = [&](const OutgoingMessagePtr& outgoing_message) {
+      const int64_t deadline_ms = outgoing_message->deadline_ms;
+      if (deadline_ms == 0)
+        return false;
+      if (deadline_ms <= now) {
+        timed_out_messages.push_back(outgoing_message);
+        return true;
+      }
+      if (next_deadline_ms == 0 || deadline_ms < next_deadline_ms)
+        next_deadline_ms = deadline_ms;
+      return false;
+    };
+    for (auto it = unacked_messages_.begin(); it != unacked_messages_.end();) {
+      if (timed_out(it->second.message))
+        it = unacked_messages_.erase(it);
+      else
+        ++it;
+    }
+    waiting_messages_.erase(std::remove_if(waiting_messages_.begin(),
+                                           waiting_messages_.end(), timed_out),
+                            waiting_messages_.end());
+    ack_stats_.timed_out_messages += timed_out_messages.size();
+    next_timeout_check_ms_ = 0;
+    if (next_deadline_ms != 0)
+      ScheduleAckTimeoutCheck(next_deadline_ms);
+  }
+  if (timed_out_messages.empty())
+    return;
+  for (auto& timed_out_message : timed_out_messages) {
+    RTC_LOG(LS_WARNING) << "Message " << timed_out_message->id << " ("
+                        << timed_out_message->name << ") timed out.";
+    if (timed_out_message->on_failure != nullptr) {
+      std::unique_ptr<Exception> e(
+          new Exception(ExceptionType::kConferenceTimeout,
+                        "No response from server in time."));
+      timed_out_message->on_failure(std::move(e));
+    }
+  }
+  EmitWaitingMessages();
 }
 void ConferenceSocketSignalingChannel::DropQueuedMessages() {
-  // TODO(jianjunz): Trigger on_failure in another thread. In current
-  // implementation, failure callback MUST NOT acquire
-  // |outgoing_message_mutex_|. Otherwise, deadlock may happen.
-  std::lock_guard<std::mutex> lock(outgoing_message_mutex_);
-  while (!outgoing_messages_.empty()) {
-    if (outgoing_messages_.front().on_failure != nullptr) {
+  std::vector<OutgoingMessagePtr> dropped_messages;
+  {
+    std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+    for (auto& unacked_message : unacked_messages_)
+      dropped_messages.push_back(std::move(unacked_message.second.message));
+    unacked_messages_.clear();
+    dropped_messages.insert(dropped_messages.end(), waiting_messages_.begin(),
+                            waiting_messages_.end());
+    waiting_messages_.clear();
+  }
+  // Failure callbacks are invoked without holding |unacked_messages_mutex_|,
+  // so they can send messages.
+  for (auto& dropped_message : dropped_messages) {
+    if (dropped_message->on_failure != nullptr) {
       std::unique_ptr<Exception> e(new Exception(
           ExceptionType::kConferenceInvalidSession,
           "Failed to delivery message."));
-      outgoing_messages_.front().on_failure(std::move(e));
+      dropped_message->on_failure(std::move(e));
     }
-    outgoing_messages_.pop();
   }
 }
 void ConferenceSocketSignalingChannel::DrainQueuedMessages() {
-  std::queue<SioMessage> temp_queue;
   {
-    std::lock_guard<std::mutex> lock(outgoing_message_mutex_);
-    std::swap(temp_queue, outgoing_messages_);
-  }
-  RTC_LOG(LS_INFO) << "outgoing_messages_ number after swap: "
-               << outgoing_messages_.size();
-  while (!temp_queue.empty()) {
-    auto sio_message = temp_queue.front();
-    // MUST release |outgoing_message_mutex_| before Emit because Emit acquires
-    // mutex.
-    Emit(sio_message.name, sio_message.message, sio_message.ack,
-         sio_message.on_failure);
-    temp_queue.pop();
+    std::lock_guard<std::mutex> lock(unacked_messages_mutex_);
+    RTC_LOG(LS_INFO) << "Re-emit " << unacked_messages_.size()
+                     << " un-acked messages.";
+    // Messages keep their IDs and deadlines, and are emitted again in their
+    // original order before messages queued meanwhile.
+    for (auto it = unacked_messages_.rbegin(); it != unacked_messages_.rend();
+         ++it) {
+      waiting_messages_.push_front(std::move(it->second.message));
+    }
+    unacked_messages_.clear();
   }
+  EmitWaitingMessages();
 }
 sio::message::ptr ConferenceSocketSignalingChannel::ResolutionMessage(
     const owt::base::Resolution& resolution) {
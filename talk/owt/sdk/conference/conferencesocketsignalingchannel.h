@@ -3,13 +3,17 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef conference_ConferenceSocketSignalingChannel_h
 #define conference_ConferenceSocketSignalingChannel_h
+#include <atomic>
+#include <deque>
+#include <map>
 #include <memory>
 #include <future>
-#include <queue>
+#include <mutex>
 #include <random>
 #include <unordered_map>
-#include "talk/owt/include/sio_client.h"
+#include <vector>
 #include "talk/owt/include/sio_message.h"
+#include "talk/owt/sdk/conference/signalingtransportinterface.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/conferenceclient.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/user.h"
 namespace owt {
@@ -21,10 +25,39 @@ struct SignalingSubscriptionAck {
   explicit SignalingSubscriptionAck(const std::string& id) : id(id) {}
   explicit SignalingSubscriptionAck() : id("") {}
 };
+// Statistics of acks for messages sent to conference server.
+struct SignalingAckStats {
+  SignalingAckStats()
+      : acked_messages(0),
+        timed_out_messages(0),
+        in_flight_messages(0),
+        queued_messages(0),
+        smoothed_rtt_ms(0),
+        max_rtt_ms(0) {}
+  // Messages acked or timed out since the channel is created.
+  uint64_t acked_messages;
+  uint64_t timed_out_messages;
+  // Messages emitted but not acked, and messages waiting for a slot in the
+  // in-flight window.
+  size_t in_flight_messages;
+  size_t queued_messages;
+  // Time between emitting a message and receiving its ack. Smoothed as TCP
+  // does for its RTT (RFC 6298), so recent acks weigh more.
+  int64_t smoothed_rtt_ms;
+  int64_t max_rtt_ms;
+};
 class ConferenceSocketSignalingChannel
     : public std::enable_shared_from_this<ConferenceSocketSignalingChannel> {
  public:
+  typedef std::function<std::unique_ptr<SignalingTransportInterface>()>
+      TransportFactory;
+  // Sets the factory of transports used by channels created afterwards with
+  // the default constructor, e.g. by ConferenceClient. Transports connect to
+  // conference server through Socket.IO if no factory is set.
+  static void SetTransportFactory(TransportFactory factory);
   explicit ConferenceSocketSignalingChannel();
+  explicit ConferenceSocketSignalingChannel(
+      std::unique_ptr<SignalingTransportInterface> transport);
   virtual ~ConferenceSocketSignalingChannel();
   virtual void AddObserver(ConferenceSocketSignalingChannelObserver& observer);
   virtual void RemoveObserver(
@@ -42,6 +75,14 @@ class ConferenceSocketSignalingChannel
       std::string subcribe_stream_label,
       std::function<void(std::string)> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure);
+  // Sends a subscribe request. |on_success| receives subscription ID and the
+  // ID of the transport carrying it, which is empty if server does not share
+  // transports among sessions.
+  virtual void SendSubscribeMessage(
+      sio::message::ptr options,
+      std::function<void(std::string session_id, std::string transport_id)>
+          on_success,
+      std::function<void(std::unique_ptr<Exception>)> on_failure);
   virtual void SendSdp(
       sio::message::ptr message,
       std::function<void()> on_success,
@@ -79,41 +120,95 @@ class ConferenceSocketSignalingChannel
   virtual void Disconnect(
       std::function<void()> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure);
+  // Messages sent afterwards fail with kConferenceTimeout if they are not
+  // acked in |timeout_ms| since they are sent, including time spent in queue
+  // and reconnecting. 0 means waiting forever.
+  void SetAckTimeout(int timeout_ms);
+  // Limits messages emitted but not acked to |max_in_flight_messages|. Others
+  // are queued, and emitted in order when acks arrive. 0 means no limit.
+  void SetMaxInFlightMessages(size_t max_in_flight_messages);
+  SignalingAckStats GetAckStats() const;
+  // Keeps connection to conference server open for |grace_period_ms| after
+  // Disconnect, so a Connect to the same server in this period only needs to
+  // login. 0 closes connection on Disconnect.
+  void SetSessionGracePeriod(int grace_period_ms);
+  // True if connection is kept after Disconnect, and not yet closed.
+  bool IsSessionKept() const { return session_kept_; }
+  // ICE candidates gathered in |window_ms| are sent in one "candidates"
+  // message. 0 sends a "candidate" message for each of them.
+  void SetIceCandidateBatchWindow(int window_ms);
+  // Returns 0 if candidates are not batched.
+  int IceCandidateBatchWindow() const { return ice_candidate_batch_window_ms_; }
+  // Called when server rejects batched candidates. Candidates are sent one by
+  // one afterwards.
+  void DisableIceCandidateBatching();
  protected:
   virtual void OnEmitAck(
       sio::message::list const& msg,
       std::function<void()> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure);
  private:
-  class SioMessage final {
-   public:
-    explicit SioMessage(
-        const int id,
+  // A message to be emitted. It is immutable once created, so the outgoing
+  // queue, the unacknowledged list and the emitting thread share it instead
+  // of copying its payload and callbacks.
+  struct OutgoingMessage {
+    OutgoingMessage(
+        int id,
+        int64_t deadline_ms,
         const std::string& name,
         const sio::message::list& message,
-        const std::function<void(sio::message::list const&)> ack,
-        const std::function<void(std::unique_ptr<Exception>)>
-            on_failure)
+        std::function<void(sio::message::list const&)> ack,
+        std::function<void(std::unique_ptr<Exception>)> on_failure)
         : id(id),
+          deadline_ms(deadline_ms),
           name(name),
           message(message),
-          ack(ack),
-          on_failure(on_failure){};
+          ack(std::move(ack)),
+          on_failure(std::move(on_failure)) {}
     const int id;
+    // Time in rtc::TimeMillis() when message times out, or 0 if it never
+    // times out.
+    const int64_t deadline_ms;
     const std::string name;
     const sio::message::list message;
     const std::function<void(sio::message::list const&)> ack;
     const std::function<void(std::unique_ptr<Exception>)> on_failure;
   };
+  typedef std::shared_ptr<const OutgoingMessage> OutgoingMessagePtr;
+  struct InFlightMessage {
+    OutgoingMessagePtr message;
+    int64_t sent_time_ms;
+  };
+  static std::unique_ptr<SignalingTransportInterface> CreateTransport();
+  // Sends a publish or subscribe request. |on_success| receives the result
+  // object in server's ack.
+  void SendSessionMessage(
+      const std::string& event_name,
+      sio::message::ptr options,
+      std::function<void(sio::message::ptr result)> on_success,
+      std::function<void(std::unique_ptr<Exception>)> on_failure);
+  void Login(const std::string& token,
+             std::function<void(sio::message::ptr room_info)> on_success,
+             std::function<void(std::unique_ptr<Exception>)> on_failure);
+  // Reports disconnection after logout, and closes connection if it is not
+  // reused by Connect in |grace_period_ms|.
+  void KeepSession(int grace_period_ms);
   /// Fires upon a new ticket is received.
   void OnReconnectionTicket(const std::string& ticket);
   void RefreshReconnectionTicket();
   void TriggerOnServerDisconnected();
   void Emit(const std::string& name,
             const sio::message::list& message,
-            const std::function<void(sio::message::list const&)> ack,
-            const std::function<void(std::unique_ptr<Exception>)>
-                on_failure);
+            std::function<void(sio::message::list const&)> ack,
+            std::function<void(std::unique_ptr<Exception>)> on_failure);
+  // Emits queued messages while the in-flight window allows.
+  void EmitWaitingMessages();
+  void OnOutgoingMessageAck(int message_id, sio::message::list const& msg);
+  // Checks for timeout at |deadline_ms| if no earlier check is scheduled.
+  // Called with |unacked_messages_mutex_| held.
+  void ScheduleAckTimeoutCheck(int64_t deadline_ms);
+  // Fails messages whose deadline has passed.
+  void OnAckTimeoutCheck();
   // Clean message queue and triggered failure callback for all queued messages.
   void DropQueuedMessages();
   // Re-emit queued message.
@@ -121,7 +216,7 @@ class ConferenceSocketSignalingChannel
   // Convert an resolution object to a sio message.
   sio::message::ptr ResolutionMessage(
       const owt::base::Resolution& resolution);
-  sio::client* socket_client_;
+  std::unique_ptr<SignalingTransportInterface> transport_;
   std::vector<ConferenceSocketSignalingChannelObserver*> observers_;
   std::function<void(std::unique_ptr<Exception>)>
       connect_failure_callback_;
@@ -130,11 +225,40 @@ class ConferenceSocketSignalingChannel
   std::string participant_id_;
   int reconnection_attempted_;
   bool is_reconnection_;
-  // Messages may be lost if during Socket.IO reconnection. We maintain a
-  // message queue here so we can emit un-acked messages after connected.
-  std::queue<SioMessage> outgoing_messages_;
+  // True if server advertised roomResync capability on login, so room info in
+  // relogin ack is used to resync room state.
+  std::atomic<bool> room_resync_supported_;
+  // Guarded by |unacked_messages_mutex_|.
   int outgoing_message_id_;
-  std::mutex outgoing_message_mutex_;
+  // Messages may be lost if during Socket.IO reconnection. We keep emitted
+  // messages here until they are acked, so we can emit un-acked messages
+  // after connected. Ordered by message ID.
+  std::map<int, InFlightMessage> unacked_messages_;
+  // Messages waiting for a slot in the in-flight window, in order.
+  std::deque<OutgoingMessagePtr> waiting_messages_;
+  // Guards above two containers, |outgoing_message_id_|, |ack_stats_| and
+  // |next_timeout_check_ms_|.
+  mutable std::mutex unacked_messages_mutex_;
+  // Held while moving messages from |waiting_messages_| to the transport, so
+  // they are emitted in order. Recursive as an ack may arrive during emit.
+  std::recursive_mutex emit_mutex_;
+  std::atomic<int> ack_timeout_ms_;
+  std::atomic<size_t> max_in_flight_messages_;
+  SignalingAckStats ack_stats_;
+  // Time of the earliest timeout check scheduled, or 0 if there is none.
+  int64_t next_timeout_check_ms_;
+  // URL of conference server connected by last Connect.
+  std::string url_;
+  std::atomic<int> session_grace_period_ms_;
+  // True if logged out without closing connection, so disconnection is already
+  // reported when connection is closed.
+  std::atomic<bool> logged_out_;
+  // True if connection is kept for reusing after logout.
+  std::atomic<bool> session_kept_;
+  // Incremented when a connection is kept or its reuse is attempted, so an
+  // expiration timer only closes the connection it was scheduled for.
+  std::atomic<int> kept_session_id_;
+  std::atomic<int> ice_candidate_batch_window_ms_;
 };
 }
 }
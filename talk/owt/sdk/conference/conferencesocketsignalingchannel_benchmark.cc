@@ -0,0 +1,196 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+// Throughput of the outgoing message path of ConferenceSocketSignalingChannel,
+// for bursts of ICE candidate sized messages sent from several threads. The
+// channel is connected to a fake transport which acks on its own thread, so
+// only the SDK side of the path is measured.
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/signalingtransportinterface.h"
+#include "talk/owt/sdk/test/benchmark.h"
+#include "webrtc/rtc_base/third_party/base64/base64.h"
+namespace owt {
+namespace conference {
+namespace {
+// Stands in for Socket.IO client. Like Socket.IO client, it hands frames to
+// its own network thread, where acks are invoked. Server acks immediately, so
+// the number of un-acked messages stays small as it does with a real server.
+class FakeTransport : public SignalingTransportInterface {
+ public:
+  FakeTransport()
+      : opened_(false),
+        stopped_(false),
+        acked_(0),
+        thread_([this]() { Run(); }) {}
+  // Returns after all acks are delivered.
+  ~FakeTransport() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    wake_up_.notify_one();
+    thread_.join();
+  }
+  void SetOpenListener(const ConnectionListener& listener) override {
+    open_listener_ = listener;
+  }
+  void SetFailListener(const ConnectionListener& listener) override {}
+  void SetReconnectingListener(const ConnectionListener& listener) override {}
+  void SetCloseListener(const ConnectionListener& listener) override {}
+  void SetReconnectAttempts(int attempts) override {}
+  void SetReconnectDelay(const ReconnectDelayFunction& delay) override {}
+  void On(const std::string& event,
+          const sio::socket::event_listener_aux& listener) override {}
+  void Connect(const std::string& uri) override {
+    Post([this]() {
+      opened_ = true;
+      open_listener_();
+    });
+  }
+  void Emit(const std::string& name,
+            const sio::message::list& message,
+            const AckListener& ack) override {
+    sio::message::list response(sio::string_message::create("ok"));
+    if (name == "login") {
+      sio::message::ptr login_result = sio::object_message::create();
+      login_result->get_map()["id"] =
+          sio::string_message::create("participant-id");
+      response.push(login_result);
+    }
+    Post([this, ack, response]() {
+      ack(response);
+      {
+        std::lock_guard<std::mutex> lock(acked_mutex_);
+        acked_++;
+      }
+      acked_changed_.notify_all();
+    });
+  }
+  void Close() override { opened_ = false; }
+  bool Opened() const override { return opened_; }
+  // Waits until |count| messages, including login, are acked.
+  void WaitForAcks(uint64_t count) {
+    std::unique_lock<std::mutex> lock(acked_mutex_);
+    acked_changed_.wait(lock, [this, count]() { return acked_ >= count; });
+  }
+ private:
+  void Post(std::function<void()> frame) {
+    bool was_empty = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      was_empty = frames_.empty();
+      frames_.push_back(std::move(frame));
+    }
+    if (was_empty)
+      wake_up_.notify_one();
+  }
+  void Run() {
+    std::vector<std::function<void()>> frames;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_up_.wait(lock, [this]() { return stopped_ || !frames_.empty(); });
+        if (frames_.empty() && stopped_)
+          return;
+        std::swap(frames, frames_);
+      }
+      for (auto& frame : frames)
+        frame();
+      frames.clear();
+    }
+  }
+  ConnectionListener open_listener_;
+  std::atomic<bool> opened_;
+  std::mutex mutex_;
+  std::condition_variable wake_up_;
+  bool stopped_;
+  std::vector<std::function<void()>> frames_;
+  std::mutex acked_mutex_;
+  std::condition_variable acked_changed_;
+  uint64_t acked_;
+  std::thread thread_;
+};
+sio::message::ptr CandidateMessage(int id) {
+  sio::message::ptr candidate = sio::object_message::create();
+  candidate->get_map()["type"] = sio::string_message::create("candidate");
+  candidate->get_map()["candidate"] = sio::string_message::create(
+      "candidate:1 1 udp 2122260223 192.168.1.2 5" + std::to_string(id) +
+      " typ host generation 0 ufrag abcd network-id 1");
+  candidate->get_map()["sdpMid"] = sio::string_message::create("0");
+  candidate->get_map()["sdpMLineIndex"] = sio::int_message::create(0);
+  sio::message::ptr message = sio::object_message::create();
+  message->get_map()["id"] = sio::string_message::create("session-id");
+  message->get_map()["signaling"] = candidate;
+  return message;
+}
+// Connects a channel to |transport| and waits until it logs in.
+std::shared_ptr<ConferenceSocketSignalingChannel> Connect(
+    std::unique_ptr<FakeTransport> transport) {
+  auto channel =
+      std::make_shared<ConferenceSocketSignalingChannel>(std::move(transport));
+  std::mutex mutex;
+  std::condition_variable logged_in_changed;
+  bool logged_in = false;
+  channel->Connect(rtc::Base64::Encode("{\"host\":\"localhost\"}"),
+                   [&](sio::message::ptr room_info) {
+                     std::lock_guard<std::mutex> lock(mutex);
+                     logged_in = true;
+                     logged_in_changed.notify_all();
+                   },
+                   nullptr);
+  std::unique_lock<std::mutex> lock(mutex);
+  logged_in_changed.wait(lock, [&logged_in]() { return logged_in; });
+  return channel;
+}
+// Sends |messages_per_thread| messages from each of |threads| threads.
+void SendBurst(ConferenceSocketSignalingChannel* channel,
+               int threads,
+               int messages_per_thread) {
+  std::vector<std::thread> senders;
+  for (int i = 0; i < threads; i++) {
+    senders.emplace_back([channel, messages_per_thread]() {
+      for (int j = 0; j < messages_per_thread; j++) {
+        // Callbacks capture as much state as the ones of the SDK do. Success
+        // callback is null, as the channel runs it on a new thread.
+        std::string session_id("session-id");
+        channel->SendSdp(CandidateMessage(j), nullptr,
+                         [session_id](std::unique_ptr<Exception>) {});
+      }
+    });
+  }
+  for (auto& thread : senders)
+    thread.join();
+}
+}  // namespace
+OWT_BENCHMARK(SignalingOutgoingThroughput) {
+  const int kMessagesPerThread = 5000;
+  for (int threads : {1, 4, 8}) {
+    const uint64_t messages = threads * kMessagesPerThread;
+    SignalingAckStats stats;
+    owt::test::MeasureAndReport(
+        std::to_string(threads) + " sending thread(s)", 10, messages,
+        [threads, messages, &stats]() {
+          std::unique_ptr<FakeTransport> transport(new FakeTransport());
+          FakeTransport* fake_transport = transport.get();
+          auto channel = Connect(std::move(transport));
+          SendBurst(channel.get(), threads, kMessagesPerThread);
+          // Login is acked as well.
+          fake_transport->WaitForAcks(messages + 1);
+          stats = channel->GetAckStats();
+        });
+    printf("  %-48s %12lld ms max RTT\n", "",
+           static_cast<long long>(stats.max_rtt_ms));
+  }
+}
+}  // namespace conference
+}  // namespace owt
@@ -0,0 +1,112 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/localconferenceserver.h"
+#include "talk/owt/sdk/test/latch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/rtc_base/third_party/base64/base64.h"
+namespace owt {
+namespace conference {
+using owt::test::Latch;
+class ConferenceSocketSignalingChannelTest : public testing::Test {
+ protected:
+  // Connects |channel_| to a server which holds acks of text messages.
+  void SetUp() override {
+    LocalConferenceServer::Options options;
+    options.issue_reconnection_tickets = false;
+    options.hold_ack = [](const std::string& name) { return name == "text"; };
+    server_ = LocalConferenceServer::Create(options);
+    channel_ = std::make_shared<ConferenceSocketSignalingChannel>(
+        server_->CreateTransport());
+    Latch joined(1);
+    channel_->Connect(
+        rtc::Base64::Encode("{\"host\":\"localhost\"}"),
+        [&joined](sio::message::ptr room_info) { joined.Signal(); }, nullptr);
+    ASSERT_TRUE(joined.Wait());
+  }
+  void TearDown() override { channel_.reset(); }
+  // Waits until server holds |count| acks.
+  bool WaitForHeldAcks(size_t count) {
+    for (int i = 0; i < 500; i++) {
+      if (server_->HeldAckCount() == count)
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+  std::shared_ptr<LocalConferenceServer> server_;
+  std::shared_ptr<ConferenceSocketSignalingChannel> channel_;
+};
+TEST_F(ConferenceSocketSignalingChannelTest, FailsMessageNotAckedInTime) {
+  channel_->SetAckTimeout(100);
+  std::mutex mutex;
+  std::vector<ExceptionType> failures;
+  Latch failed(1);
+  channel_->SendCustomMessage("hello", "", nullptr,
+                              [&](std::unique_ptr<Exception> e) {
+                                {
+                                  std::lock_guard<std::mutex> lock(mutex);
+                                  failures.push_back(e->Type());
+                                }
+                                failed.Signal();
+                              });
+  ASSERT_TRUE(failed.Wait());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(std::vector<ExceptionType>({ExceptionType::kConferenceTimeout}),
+              failures);
+  }
+  SignalingAckStats stats = channel_->GetAckStats();
+  EXPECT_EQ(1u, stats.timed_out_messages);
+  EXPECT_EQ(0u, stats.in_flight_messages);
+  // A late ack is ignored.
+  server_->ReleaseHeldAcks();
+  EXPECT_EQ(0u, server_->HeldAckCount());
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(1u, failures.size());
+}
+TEST_F(ConferenceSocketSignalingChannelTest, QueuesMessagesBeyondWindow) {
+  channel_->SetMaxInFlightMessages(64);
+  Latch sent(65);
+  for (int i = 0; i < 65; i++) {
+    channel_->SendCustomMessage(std::to_string(i), "",
+                                [&sent]() { sent.Signal(); }, nullptr);
+  }
+  ASSERT_TRUE(WaitForHeldAcks(64));
+  SignalingAckStats stats = channel_->GetAckStats();
+  EXPECT_EQ(64u, stats.in_flight_messages);
+  EXPECT_EQ(1u, stats.queued_messages);
+  // Message 65 is emitted once an ack frees a slot.
+  server_->ReleaseHeldAcks();
+  ASSERT_TRUE(WaitForHeldAcks(1));
+  stats = channel_->GetAckStats();
+  EXPECT_EQ(1u, stats.in_flight_messages);
+  EXPECT_EQ(0u, stats.queued_messages);
+  server_->ReleaseHeldAcks();
+  EXPECT_TRUE(sent.Wait());
+  EXPECT_EQ(0u, channel_->GetAckStats().in_flight_messages);
+}
+TEST_F(ConferenceSocketSignalingChannelTest, MeasuresAckRoundTripTime) {
+  const uint64_t acked_messages = channel_->GetAckStats().acked_messages;
+  Latch sent(1);
+  channel_->SendCustomMessage("hello", "", [&sent]() { sent.Signal(); },
+                              nullptr);
+  ASSERT_TRUE(WaitForHeldAcks(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  server_->ReleaseHeldAcks();
+  ASSERT_TRUE(sent.Wait());
+  SignalingAckStats stats = channel_->GetAckStats();
+  EXPECT_EQ(acked_messages + 1, stats.acked_messages);
+  EXPECT_GE(stats.max_rtt_ms, 100);
+  EXPECT_GT(stats.smoothed_rtt_ms, 0);
+  EXPECT_LE(stats.smoothed_rtt_ms, stats.max_rtt_ms);
+}
+}  // namespace conference
+}  // namespace owt
@@ -5,7 +5,7 @@
 #include "webrtc/rtc_base/third_party/base64/base64.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/logging.h"
-#include "webrtc/rtc_base/task_queue.h"
+#include "talk/owt/sdk/base/callbackexecutor.h"
 #include "talk/owt/sdk/base/stringutils.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/conferenceclient.h"
 #include "talk/owt/sdk/include/cpp/owt/conference/conferencesubscription.h"
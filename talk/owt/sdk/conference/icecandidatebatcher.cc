@@ -0,0 +1,150 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/conference/icecandidatebatcher.h"
+#include "webrtc/rtc_base/logging.h"
+namespace owt {
+namespace conference {
+IceCandidateBatcher::IceCandidateBatcher(
+    std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel)
+    : signaling_channel_(signaling_channel),
+      end_of_candidates_(false),
+      negotiating_(false),
+      flush_timer_(owt::base::TimerService::kInvalidTimerId),
+      messages_sent_(0) {
+  RTC_CHECK(signaling_channel_);
+}
+IceCandidateBatcher::~IceCandidateBatcher() {
+  owt::base::TimerService::Get()->Cancel(flush_timer_);
+}
+void IceCandidateBatcher::SetId(const std::string& id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  id_ = id;
+}
+// TODO(jianlin): New signaling protocol defines candidate as
+// a string instead of object. Need to double check with server
+// side implementation before we switch to it.
+void IceCandidateBatcher::AddCandidate(
+    const webrtc::IceCandidateInterface* candidate) {
+  std::string candidate_string;
+  candidate->ToString(&candidate_string);
+  candidate_string.insert(0, "a=");
+  sio::message::ptr candidate_message = sio::object_message::create();
+  candidate_message->get_map()["sdpMLineIndex"] =
+      sio::int_message::create(candidate->sdp_mline_index());
+  candidate_message->get_map()["sdpMid"] =
+      sio::string_message::create(candidate->sdp_mid());
+  candidate_message->get_map()["candidate"] =
+      sio::string_message::create(candidate_string);
+  const int batch_window_ms = signaling_channel_->IceCandidateBatchWindow();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    candidates_.push_back(candidate_message);
+    if (negotiating_)
+      return;
+    if (batch_window_ms > 0) {
+      if (flush_timer_ == owt::base::TimerService::kInvalidTimerId) {
+        std::weak_ptr<IceCandidateBatcher> weak_this = shared_from_this();
+        flush_timer_ = owt::base::TimerService::Get()->Schedule(
+            [weak_this]() {
+              if (auto that = weak_this.lock())
+                that->Flush();
+            },
+            batch_window_ms);
+      }
+      return;
+    }
+  }
+  Flush();
+}
+void IceCandidateBatcher::EndOfCandidates() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    end_of_candidates_ = true;
+    if (negotiating_)
+      return;
+  }
+  Flush();
+}
+void IceCandidateBatcher::SetNegotiating(bool negotiating) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    negotiating_ = negotiating;
+  }
+  if (!negotiating)
+    Flush();
+}
+void IceCandidateBatcher::Clear() {
+  owt::base::TimerService::TimerId flush_timer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    candidates_.clear();
+    end_of_candidates_ = false;
+    flush_timer = flush_timer_;
+    flush_timer_ = owt::base::TimerService::kInvalidTimerId;
+  }
+  owt::base::TimerService::Get()->Cancel(flush_timer);
+}
+void IceCandidateBatcher::Flush() {
+  std::string id;
+  std::vector<sio::message::ptr> candidates;
+  bool end_of_candidates = false;
+  owt::base::TimerService::TimerId flush_timer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = id_;
+    candidates.swap(candidates_);
+    end_of_candidates = end_of_candidates_;
+    end_of_candidates_ = false;
+    flush_timer = flush_timer_;
+    flush_timer_ = owt::base::TimerService::kInvalidTimerId;
+  }
+  // No-op if it is called by the timer.
+  owt::base::TimerService::Get()->Cancel(flush_timer);
+  if (signaling_channel_->IceCandidateBatchWindow() == 0) {
+    // End-of-candidates cannot be told in "candidate" messages.
+    SendOneByOne(id, candidates);
+    return;
+  }
+  if (candidates.empty() && !end_of_candidates)
+    return;
+  sio::message::ptr message = sio::object_message::create();
+  message->get_map()["id"] = sio::string_message::create(id);
+  sio::message::ptr sdp_message = sio::object_message::create();
+  sdp_message->get_map()["type"] = sio::string_message::create("candidates");
+  sio::message::ptr candidates_message = sio::array_message::create();
+  candidates_message->get_vector() = candidates;
+  sdp_message->get_map()["candidates"] = candidates_message;
+  if (end_of_candidates) {
+    sdp_message->get_map()["endOfCandidates"] =
+        sio::bool_message::create(true);
+  }
+  message->get_map()["signaling"] = sdp_message;
+  messages_sent_++;
+  std::weak_ptr<IceCandidateBatcher> weak_this = shared_from_this();
+  signaling_channel_->SendSdp(
+      message, nullptr,
+      [weak_this, id, candidates](std::unique_ptr<Exception> e) {
+        auto that = weak_this.lock();
+        if (!that || e->Type() == ExceptionType::kConferenceTimeout)
+          return;
+        that->signaling_channel_->DisableIceCandidateBatching();
+        that->SendOneByOne(id, candidates);
+      });
+}
+void IceCandidateBatcher::SendOneByOne(
+    const std::string& id,
+    const std::vector<sio::message::ptr>& candidates) {
+  for (auto& candidate : candidates) {
+    sio::message::ptr message = sio::object_message::create();
+    message->get_map()["id"] = sio::string_message::create(id);
+    sio::message::ptr sdp_message = sio::object_message::create();
+    sdp_message->get_map()["type"] = sio::string_message::create("candidate");
+    sdp_message->get_map()["candidate"] = candidate;
+    message->get_map()["signaling"] = sdp_message;
+    messages_sent_++;
+    signaling_channel_->SendSdp(message, nullptr, nullptr);
+  }
+}
+}  // namespace conference
+}  // namespace owt
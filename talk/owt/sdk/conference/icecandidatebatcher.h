@@ -0,0 +1,58 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_CONFERENCE_ICECANDIDATEBATCHER_H_
+#define OWT_CONFERENCE_ICECANDIDATEBATCHER_H_
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "talk/owt/sdk/base/timerservice.h"
+#include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "webrtc/api/jsep.h"
+namespace owt {
+namespace conference {
+// Sends ICE candidates of a PeerConnection to MCU. Candidates gathered within
+// ConferenceSocketSignalingChannel::IceCandidateBatchWindow are sent in one
+// "candidates" message, which also tells end-of-candidates once gathering is
+// complete. Candidates are sent one by one if the window is 0, or after MCU
+// rejects a batch. Candidates gathered during a negotiation are held until it
+// completes.
+class IceCandidateBatcher
+    : public std::enable_shared_from_this<IceCandidateBatcher> {
+ public:
+  explicit IceCandidateBatcher(
+      std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel);
+  ~IceCandidateBatcher();
+  // Sets the session or transport ID candidates are sent for.
+  void SetId(const std::string& id);
+  void AddCandidate(const webrtc::IceCandidateInterface* candidate);
+  // Called when gathering is complete.
+  void EndOfCandidates();
+  // Held candidates are sent when it is set to false.
+  void SetNegotiating(bool negotiating);
+  // Drops candidates not sent yet, e.g. before an ICE restart.
+  void Clear();
+  // Number of messages sent, including candidates resent one by one after a
+  // batch is rejected.
+  int MessagesSent() const { return messages_sent_; }
+ private:
+  // Sends candidates gathered so far.
+  void Flush();
+  // Sends |candidates| one by one.
+  void SendOneByOne(const std::string& id,
+                    const std::vector<sio::message::ptr>& candidates);
+  std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel_;
+  std::mutex mutex_;
+  // Following members are guarded by |mutex_|.
+  std::string id_;
+  std::vector<sio::message::ptr> candidates_;
+  bool end_of_candidates_;
+  bool negotiating_;
+  owt::base::TimerService::TimerId flush_timer_;
+  std::atomic<int> messages_sent_;
+};
+}  // namespace conference
+}  // namespace owt
+#endif  // OWT_CONFERENCE_ICECANDIDATEBATCHER_H_
@@ -0,0 +1,190 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "talk/owt/sdk/conference/icecandidatebatcher.h"
+#include "talk/owt/sdk/conference/localconferenceserver.h"
+#include "talk/owt/sdk/test/latch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/rtc_base/third_party/base64/base64.h"
+#include "webrtc/rtc_base/timeutils.h"
+namespace owt {
+namespace conference {
+namespace {
+using owt::test::Latch;
+std::unique_ptr<webrtc::IceCandidateInterface> Candidate(int port) {
+  return std::unique_ptr<webrtc::IceCandidateInterface>(
+      webrtc::CreateIceCandidate(
+          "0", 0,
+          "candidate:1 1 udp 2122260223 192.168.1.2 " + std::to_string(port) +
+              " typ host generation 0",
+          nullptr));
+}
+}  // namespace
+class IceCandidateBatcherTest : public testing::Test {
+ protected:
+  // Starts a server which records candidate messages, and connects a channel
+  // to it. |batch_window_ms| is set to the channel.
+  void Start(int batch_window_ms, bool accept_batched_candidates) {
+    LocalConferenceServer::Options options;
+    options.issue_reconnection_tickets = false;
+    options.accept_batched_candidates = accept_batched_candidates;
+    options.on_candidates = [this](sio::message::ptr signaling) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      messages_.push_back(signaling);
+      if (latch_)
+        latch_->Signal();
+    };
+    server_ = LocalConferenceServer::Create(options);
+    channel_ = std::make_shared<ConferenceSocketSignalingChannel>(
+        server_->CreateTransport());
+    channel_->SetIceCandidateBatchWindow(batch_window_ms);
+    Latch joined(1);
+    channel_->Connect(
+        rtc::Base64::Encode("{\"host\":\"localhost\"}"),
+        [&joined](sio::message::ptr room_info) { joined.Signal(); }, nullptr);
+    ASSERT_TRUE(joined.Wait());
+    batcher_ = std::make_shared<IceCandidateBatcher>(channel_);
+    batcher_->SetId(Publish());
+  }
+  void TearDown() override {
+    Expect(nullptr);
+    batcher_.reset();
+    channel_.reset();
+  }
+  // Returns ID of a new publication, which candidates are sent for.
+  std::string Publish() {
+    sio::message::ptr options = sio::object_message::create();
+    sio::message::ptr media = sio::object_message::create();
+    sio::message::ptr video = sio::object_message::create();
+    video->get_map()["source"] = sio::string_message::create("camera");
+    media->get_map()["video"] = video;
+    media->get_map()["audio"] = sio::bool_message::create(false);
+    options->get_map()["media"] = media;
+    std::mutex mutex;
+    std::string id;
+    Latch published(1);
+    channel_->SendInitializationMessage(
+        options, "label", "",
+        [&](std::string session_id) {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = session_id;
+          }
+          published.Signal();
+        },
+        nullptr);
+    EXPECT_TRUE(published.Wait());
+    std::lock_guard<std::mutex> lock(mutex);
+    return id;
+  }
+  // |latch| is signaled for each candidate message received by server.
+  void Expect(Latch* latch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latch_ = latch;
+  }
+  // Waits for |latch|, and returns all candidate messages received so far.
+  std::vector<sio::message::ptr> WaitForMessages(Latch* latch) {
+    EXPECT_TRUE(latch->Wait());
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+  size_t MessageCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_.size();
+  }
+  static std::string Type(sio::message::ptr signaling) {
+    return signaling->get_map()["type"]->get_string();
+  }
+  std::shared_ptr<LocalConferenceServer> server_;
+  std::shared_ptr<ConferenceSocketSignalingChannel> channel_;
+  std::shared_ptr<IceCandidateBatcher> batcher_;
+  // Guards following members.
+  std::mutex mutex_;
+  std::vector<sio::message::ptr> messages_;
+  Latch* latch_ = nullptr;
+};
+TEST_F(IceCandidateBatcherTest, SendsCandidatesOfWindowInOneMessage) {
+  Start(100, true);
+  Latch received(1);
+  Expect(&received);
+  for (int i = 0; i < 3; i++)
+    batcher_->AddCandidate(Candidate(50000 + i).get());
+  auto messages = WaitForMessages(&received);
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ("candidates", Type(messages[0]));
+  EXPECT_EQ(3u, messages[0]->get_map()["candidates"]->get_vector().size());
+  EXPECT_EQ(0u, messages[0]->get_map().count("endOfCandidates"));
+  EXPECT_EQ(1, batcher_->MessagesSent());
+}
+TEST_F(IceCandidateBatcherTest, FlushesWhenWindowEnds) {
+  const int kWindowMs = 300;
+  Start(kWindowMs, true);
+  Latch received(1);
+  Expect(&received);
+  const int64_t start_ms = rtc::TimeMillis();
+  batcher_->AddCandidate(Candidate(50000).get());
+  std::this_thread::sleep_for(std::chrono::milliseconds(kWindowMs / 3));
+  batcher_->AddCandidate(Candidate(50001).get());
+  auto messages = WaitForMessages(&received);
+  EXPECT_GE(rtc::TimeMillis() - start_ms, kWindowMs);
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ(2u, messages[0]->get_map()["candidates"]->get_vector().size());
+}
+TEST_F(IceCandidateBatcherTest, SendsEndOfCandidatesWithoutWaiting) {
+  // Window ends after Latch::Wait gives up.
+  Start(60 * 1000, true);
+  Latch received(1);
+  Expect(&received);
+  batcher_->AddCandidate(Candidate(50000).get());
+  batcher_->EndOfCandidates();
+  auto messages = WaitForMessages(&received);
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ(1u, messages[0]->get_map()["candidates"]->get_vector().size());
+  EXPECT_TRUE(messages[0]->get_map()["endOfCandidates"]->get_bool());
+}
+TEST_F(IceCandidateBatcherTest, HoldsCandidatesWhileNegotiating) {
+  Start(0, true);
+  Latch received(2);
+  Expect(&received);
+  batcher_->SetNegotiating(true);
+  batcher_->AddCandidate(Candidate(50000).get());
+  batcher_->AddCandidate(Candidate(50001).get());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(0u, MessageCount());
+  batcher_->SetNegotiating(false);
+  auto messages = WaitForMessages(&received);
+  ASSERT_EQ(2u, messages.size());
+  EXPECT_EQ("candidate", Type(messages[0]));
+  EXPECT_EQ("candidate", Type(messages[1]));
+  EXPECT_EQ(2, batcher_->MessagesSent());
+}
+TEST_F(IceCandidateBatcherTest, ResendsOneByOneIfBatchIsRejected) {
+  Start(50, false);
+  // The rejected batch, then its candidates one by one.
+  Latch received(3);
+  Expect(&received);
+  batcher_->AddCandidate(Candidate(50000).get());
+  batcher_->AddCandidate(Candidate(50001).get());
+  auto messages = WaitForMessages(&received);
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ("candidates", Type(messages[0]));
+  EXPECT_EQ("candidate", Type(messages[1]));
+  EXPECT_EQ("candidate", Type(messages[2]));
+  EXPECT_EQ(3, batcher_->MessagesSent());
+  EXPECT_EQ(0, channel_->IceCandidateBatchWindow());
+  // Later candidates are not batched.
+  Latch received_later(1);
+  Expect(&received_later);
+  batcher_->AddCandidate(Candidate(50002).get());
+  messages = WaitForMessages(&received_later);
+  ASSERT_EQ(4u, messages.size());
+  EXPECT_EQ("candidate", Type(messages[3]));
+}
+}  // namespace conference
+}  // namespace owt
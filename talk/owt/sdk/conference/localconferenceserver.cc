@@ -0,0 +1,681 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/conference/localconferenceserver.h"
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/json.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/third_party/base64/base64.h"
+#include "webrtc/rtc_base/timeutils.h"
+namespace owt {
+namespace conference {
+namespace {
+const char kSetupActpass[] = "a=setup:actpass";
+const char kSetupActive[] = "a=setup:active";
+std::string AnswerWithOffer(const std::string& offer) {
+  std::string answer(offer);
+  size_t pos = 0;
+  while ((pos = answer.find(kSetupActpass, pos)) != std::string::npos) {
+    answer.replace(pos, sizeof(kSetupActpass) - 1, kSetupActive);
+    pos += sizeof(kSetupActive) - 1;
+  }
+  return answer;
+}
+bool IsObject(const sio::message::ptr& message) {
+  return message && message->get_flag() == sio::message::flag_object;
+}
+// Returns |key| of |object| if it is a string, or an empty string.
+std::string StringMember(const sio::message::ptr& object,
+                         const std::string& key) {
+  if (!IsObject(object))
+    return "";
+  auto it = object->get_map().find(key);
+  if (it == object->get_map().end() || !it->second ||
+      it->second->get_flag() != sio::message::flag_string) {
+    return "";
+  }
+  return it->second->get_string();
+}
+// Returns |key| of |object| if it is an object, or nullptr.
+sio::message::ptr ObjectMember(const sio::message::ptr& object,
+                               const std::string& key) {
+  if (!IsObject(object))
+    return nullptr;
+  auto it = object->get_map().find(key);
+  if (it == object->get_map().end() || !IsObject(it->second))
+    return nullptr;
+  return it->second;
+}
+void SetError(sio::message::list* ack, const std::string& reason) {
+  *ack = sio::message::list("error");
+  ack->push(sio::string_message::create(reason));
+}
+sio::message::list OkAck() {
+  return sio::message::list("ok");
+}
+}  // namespace
+struct LocalConferenceServer::Connection {
+  Connection() : detached(false), opened(false) {}
+  // Guards everything but |opened| and |participant_id|, and is held while
+  // listeners run, so a transport being destroyed waits for a listener
+  // running on server's thread.
+  std::recursive_mutex mutex;
+  bool detached;
+  SignalingTransportInterface::ConnectionListener open_listener;
+  SignalingTransportInterface::ConnectionListener reconnecting_listener;
+  SignalingTransportInterface::ConnectionListener close_listener;
+  std::map<std::string, sio::socket::event_listener_aux> event_listeners;
+  std::atomic<bool> opened;
+  // Accessed on server's thread only.
+  std::string participant_id;
+  // Invokes |function| unless the transport is gone.
+  template <typename Function>
+  void Invoke(Function&& function) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!detached)
+      function();
+  }
+  void DeliverEvent(const std::string& name, sio::message::ptr data) {
+    Invoke([&]() {
+      auto it = event_listeners.find(name);
+      if (it == event_listeners.end())
+        return;
+      sio::message::list ack_response;
+      it->second(name, data, false, ack_response);
+    });
+  }
+};
+class LocalConferenceServer::Transport : public SignalingTransportInterface {
+ public:
+  explicit Transport(std::shared_ptr<LocalConferenceServer> server)
+      : server_(std::move(server)), connection_(new Connection()) {}
+  ~Transport() override {
+    {
+      std::lock_guard<std::recursive_mutex> lock(connection_->mutex);
+      connection_->detached = true;
+    }
+    server_->Close(connection_);
+  }
+  void SetOpenListener(const ConnectionListener& listener) override {
+    std::lock_guard<std::recursive_mutex> lock(connection_->mutex);
+    connection_->open_listener = listener;
+  }
+  // Connection to a local server never fails.
+  void SetFailListener(const ConnectionListener& listener) override {}
+  void SetReconnectingListener(const ConnectionListener& listener) override {
+    std::lock_guard<std::recursive_mutex> lock(connection_->mutex);
+    connection_->reconnecting_listener = listener;
+  }
+  void SetCloseListener(const ConnectionListener& listener) override {
+    std::lock_guard<std::recursive_mutex> lock(connection_->mutex);
+    connection_->close_listener = listener;
+  }
+  void SetReconnectAttempts(int attempts) override {}
+  void SetReconnectDelay(const ReconnectDelayFunction& delay) override {}
+  void On(const std::string& event,
+          const sio::socket::event_listener_aux& listener) override {
+    std::lock_guard<std::recursive_mutex> lock(connection_->mutex);
+    connection_->event_listeners[event] = listener;
+  }
+  void Connect(const std::string& uri) override {
+    server_->Connect(connection_);
+  }
+  void Emit(const std::string& name,
+            const sio::message::list& message,
+            const AckListener& ack) override {
+    server_->Emit(connection_, name, message, ack);
+  }
+  void Close() override { server_->Close(connection_); }
+  bool Opened() const override { return connection_->opened; }
+ private:
+  std::shared_ptr<LocalConferenceServer> server_;
+  std::shared_ptr<Connection> connection_;
+};
+LocalConferenceServer::Options::Options()
+    : issue_reconnection_tickets(true),
+      reconnection_ticket_lifetime_ms(10 * 60 * 1000),
+      room_info_on_relogin(false),
+      advertise_room_resync(true),
+      share_subscription_transports(false),
+      accept_batched_candidates(true),
+      answer_generator(AnswerWithOffer) {}
+std::shared_ptr<LocalConferenceServer> LocalConferenceServer::Create(
+    const Options& options) {
+  return std::shared_ptr<LocalConferenceServer>(
+      new LocalConferenceServer(options));
+}
+LocalConferenceServer::LocalConferenceServer(const Options& options)
+    : options_(options),
+      room_id_("local-room"),
+      next_id_(1),
+      queue_(new rtc::TaskQueue("LocalConferenceServerQueue")) {}
+LocalConferenceServer::~LocalConferenceServer() {
+  RTC_DCHECK(!queue_->IsCurrent());
+  // Stop handling messages before members are destroyed.
+  queue_.reset();
+}
+std::unique_ptr<SignalingTransportInterface>
+LocalConferenceServer::CreateTransport() {
+  return std::unique_ptr<SignalingTransportInterface>(
+      new Transport(shared_from_this()));
+}
+size_t LocalConferenceServer::ParticipantCount() {
+  size_t count = 0;
+  Invoke([this, &count]() { count = participants_.size(); });
+  return count;
+}
+size_t LocalConferenceServer::HeldAckCount() {
+  size_t count = 0;
+  Invoke([this, &count]() { count = held_acks_.size(); });
+  return count;
+}
+void LocalConferenceServer::ReleaseHeldAcks() {
+  queue_->PostTask([this]() {
+    std::vector<HeldAck> held_acks;
+    held_acks.swap(held_acks_);
+    for (const auto& held_ack : held_acks) {
+      held_ack.connection->Invoke(
+          [&held_ack]() { held_ack.ack(held_ack.message); });
+    }
+    FlushEvents();
+  });
+}
+void LocalConferenceServer::DropConnection(const std::string& participant_id) {
+  Invoke([this, &participant_id]() {
+    auto participant = participants_.find(participant_id);
+    if (participant == participants_.end())
+      return;
+    std::shared_ptr<Connection> connection = participant->second.connection;
+    if (!connection->opened.exchange(false))
+      return;
+    connection->Invoke([&connection]() {
+      if (connection->reconnecting_listener)
+        connection->reconnecting_listener();
+    });
+  });
+}
+void LocalConferenceServer::RestoreConnection(
+    const std::string& participant_id) {
+  Invoke([this, &participant_id]() {
+    auto participant = participants_.find(participant_id);
+    if (participant == participants_.end())
+      return;
+    std::shared_ptr<Connection> connection = participant->second.connection;
+    if (connection->opened.exchange(true))
+      return;
+    connection->Invoke([&connection]() {
+      if (connection->open_listener)
+        connection->open_listener();
+    });
+  });
+}
+void LocalConferenceServer::Invoke(std::function<void()> task) {
+  RTC_DCHECK(!queue_->IsCurrent());
+  rtc::Event done(false, false);
+  queue_->PostTask([&task, &done]() {
+    task();
+    done.Set();
+  });
+  done.Wait(rtc::Event::kForever);
+}
+void LocalConferenceServer::Connect(std::shared_ptr<Connection> connection) {
+  queue_->PostTask([connection]() {
+    connection->opened = true;
+    connection->Invoke([&connection]() {
+      if (connection->open_listener)
+        connection->open_listener();
+    });
+  });
+}
+void LocalConferenceServer::Emit(
+    std::shared_ptr<Connection> connection,
+    const std::string& name,
+    const sio::message::list& message,
+    const SignalingTransportInterface::AckListener& ack) {
+  queue_->PostTask([this, connection, name, message, ack]() {
+    if (!connection->opened) {
+      // Socket.IO drops messages emitted while disconnected.
+      RTC_LOG(LS_WARNING) << "Dropped " << name << " from closed connection.";
+      return;
+    }
+    sio::message::list ack_message;
+    OnMessage(connection, name, message, &ack_message);
+    if (ack && options_.hold_ack && options_.hold_ack(name)) {
+      HeldAck held_ack;
+      held_ack.connection = connection;
+      held_ack.ack = ack;
+      held_ack.message = ack_message;
+      held_acks_.push_back(std::move(held_ack));
+    } else if (ack) {
+      connection->Invoke([&ack, &ack_message]() { ack(ack_message); });
+    }
+    FlushEvents();
+  });
+}
+void LocalConferenceServer::Close(std::shared_ptr<Connection> connection) {
+  queue_->PostTask([this, connection]() {
+    // A dropped connection is closed without being reopened.
+    if (!connection->opened && connection->participant_id.empty())
+      return;
+    Leave(connection);
+    FlushEvents();
+    connection->opened = false;
+    connection->Invoke([&connection]() {
+      if (connection->close_listener)
+        connection->close_listener();
+    });
+  });
+}
+void LocalConferenceServer::OnMessage(
+    const std::shared_ptr<Connection>& connection,
+    const std::string& name,
+    const sio::message::list& message,
+    sio::message::list* ack) {
+  sio::message::ptr data = message.size() > 0 ? message.at(0) : nullptr;
+  if (name == "login") {
+    OnLogin(connection, data, ack);
+    return;
+  } else if (name == "relogin") {
+    OnRelogin(connection, data, ack);
+    return;
+  }
+  if (connection->participant_id.empty()) {
+    SetError(ack, "Not logged in.");
+    return;
+  }
+  if (name == "logout") {
+    Leave(connection);
+    *ack = OkAck();
+  } else if (name == "publish") {
+    OnPublish(connection, data, ack);
+  } else if (name == "subscribe") {
+    OnSubscribe(connection, data, ack);
+  } else if (name == "soac") {
+    OnSoac(connection, data, ack);
+  } else if (name == "unpublish" || name == "unsubscribe" ||
+             name == "stream-control" || name == "subscription-control") {
+    // Only publications can be controlled by stream-control.
+    const std::string session_id = StringMember(data, "id");
+    auto session = sessions_.find(session_id);
+    if (session == sessions_.end() ||
+        session->second.owner != connection->participant_id ||
+        session->second.is_publication !=
+            (name == "unpublish" || name == "stream-control")) {
+      SetError(ack, "Session does not exist.");
+      return;
+    }
+    if (name == "unpublish" || name == "unsubscribe")
+      RemoveSession(session_id);
+    *ack = OkAck();
+  } else if (name == "text") {
+    OnText(connection, data, ack);
+  } else if (name == "refreshReconnectionTicket") {
+    *ack = sio::message::list("success");
+    ack->push(sio::string_message::create(
+        IssueReconnectionTicket(connection->participant_id)));
+  } else {
+    RTC_LOG(LS_WARNING) << "Local conference server does not support "
+                        << name;
+    SetError(ack, "Unsupported message.");
+  }
+}
+void LocalConferenceServer::OnLogin(
+    const std::shared_ptr<Connection>& connection,
+    sio::message::ptr login,
+    sio::message::list* ack) {
+  if (!connection->participant_id.empty()) {
+    SetError(ack, "Already logged in.");
+    return;
+  }
+  if (StringMember(login, "token").empty()) {
+    SetError(ack, "Invalid token.");
+    return;
+  }
+  Participant participant;
+  participant.id = "participant-" + std::to_string(next_id_++);
+  participant.user = "user-" + participant.id;
+  participant.role = "presenter";
+  participant.connection = connection;
+  connection->participant_id = participant.id;
+  sio::message::ptr result = ParticipantInfo(participant);
+  result->get_map()["permission"] = sio::object_message::create();
+  result->get_map()["room"] = RoomInfo();
+  if (options_.room_info_on_relogin && options_.advertise_room_resync) {
+    sio::message::ptr capabilities = sio::object_message::create();
+    capabilities->get_map()["roomResync"] = sio::bool_message::create(true);
+    result->get_map()["capabilities"] = capabilities;
+  }
+  if (options_.issue_reconnection_tickets) {
+    result->get_map()["reconnectionTicket"] = sio::string_message::create(
+        IssueReconnectionTicket(participant.id));
+  }
+  *ack = OkAck();
+  ack->push(result);
+  sio::message::ptr join = sio::object_message::create();
+  join->get_map()["action"] = sio::string_message::create("join");
+  join->get_map()["data"] = ParticipantInfo(participant);
+  Broadcast("participant", join, participant.id);
+  participants_[participant.id] = participant;
+}
+void LocalConferenceServer::OnRelogin(
+    const std::shared_ptr<Connection>& connection,
+    sio::message::ptr ticket,
+    sio::message::list* ack) {
+  if (!ticket || ticket->get_flag() != sio::message::flag_string) {
+    SetError(ack, "Invalid reconnection ticket.");
+    return;
+  }
+  auto it = reconnection_tickets_.find(ticket->get_string());
+  if (it == reconnection_tickets_.end()) {
+    SetError(ack, "Invalid reconnection ticket.");
+    return;
+  }
+  auto participant = participants_.find(it->second);
+  reconnection_tickets_.erase(it);
+  if (participant == participants_.end()) {
+    SetError(ack, "Participant has left.");
+    return;
+  }
+  participant->second.connection->participant_id.clear();
+  participant->second.connection = connection;
+  connection->participant_id = participant->first;
+  sio::message::ptr new_ticket = sio::string_message::create(
+      IssueReconnectionTicket(participant->first));
+  *ack = OkAck();
+  if (options_.room_info_on_relogin) {
+    sio::message::ptr result = sio::object_message::create();
+    result->get_map()["reconnectionTicket"] = new_ticket;
+    result->get_map()["room"] = RoomInfo();
+    ack->push(result);
+  } else {
+    ack->push(new_ticket);
+  }
+}
+void LocalConferenceServer::OnPublish(
+    const std::shared_ptr<Connection>& connection,
+    sio::message::ptr options,
+    sio::message::list* ack) {
+  sio::message::ptr media = ObjectMember(options, "media");
+  if (!media) {
+    SetError(ack, "Invalid publication options.");
+    return;
+  }
+  const std::string session_id = "stream-" + std::to_string(next_id_++);
+  sio::message::ptr stream_media = sio::object_message::create();
+  sio::message::ptr audio = ObjectMember(media, "audio");
+  if (audio) {
+    sio::message::ptr audio_info = sio::object_message::create();
+    audio_info->get_map()["source"] =
+        sio::string_message::create(StringMember(audio, "source"));
+    sio::message::ptr format = sio::object_message::create();
+    format->get_map()["codec"] = sio::string_message::create("opus");
+    format->get_map()["sampleRate"] = sio::int_message::create(48000);
+    format->get_map()["channelNum"] = sio::int_message::create(2);
+    audio_info->get_map()["format"] = format;
+    stream_media->get_map()["audio"] = audio_info;
+  }
+  sio::message::ptr video = ObjectMember(media, "video");
+  if (video) {
+    sio::message::ptr video_info = sio::object_message::create();
+    video_info->get_map()["source"] =
+        sio::string_message::create(StringMember(video, "source"));
+    sio::message::ptr format = sio::object_message::create();
+    format->get_map()["codec"] = sio::string_message::create("vp8");
+    video_info->get_map()["format"] = format;
+    sio::message::ptr parameters = ObjectMember(video, "parameters");
+    if (parameters)
+      video_info->get_map()["parameters"] = parameters;
+    stream_media->get_map()["video"] = video_info;
+  }
+  sio::message::ptr publication_info = sio::object_message::create();
+  publication_info->get_map()["owner"] =
+      sio::string_message::create(connection->participant_id);
+  publication_info->get_map()["type"] = sio::string_message::create("webrtc");
+  sio::message::ptr attributes = ObjectMember(options, "attributes");
+  publication_info->get_map()["attributes"] =
+      attributes ? attributes : sio::object_message::create();
+  publication_info->get_map()["inViews"] = sio::array_message::create();
+  Session session;
+  session.owner = connection->participant_id;
+  session.is_publication = true;
+  session.ready = false;
+  session.stream_info = sio::object_message::create();
+  session.stream_info->get_map()["id"] =
+      sio::string_message::create(session_id);
+  session.stream_info->get_map()["type"] =
+      sio::string_message::create("forward");
+  session.stream_info->get_map()["media"] = stream_media;
+  session.stream_info->get_map()["info"] = publication_info;
+  sessions_[session_id] = session;
+  sio::message::ptr result = sio::object_message::create();
+  result->get_map()["id"] = sio::string_message::create(session_id);
+  *ack = OkAck();
+  ack->push(result);
+}
+void LocalConferenceServer::OnSubscribe(
+    const std::shared_ptr<Connection>& connection,
+    sio::message::ptr options,
+    sio::message::list* ack) {
+  sio::message::ptr media = ObjectMember(options, "media");
+  if (!media) {
+    SetError(ack, "Invalid subscription options.");
+    return;
+  }
+  for (const char* kind : {"audio", "video"}) {
+    sio::message::ptr track = ObjectMember(media, kind);
+    if (track && streams_.find(StringMember(track, "from")) == streams_.end()) {
+      SetError(ack, "Stream does not exist.");
+      return;
+    }
+  }
+  const std::string session_id = "subscription-" + std::to_string(next_id_++);
+  Session session;
+  session.owner = connection->participant_id;
+  session.is_publication = false;
+  session.ready = false;
+  if (options_.share_subscription_transports) {
+    // A subscription is carried by the transport it asks for if it is one of
+    // the subscriber's, or by a new one named after it.
+    const std::string transport_id =
+        StringMember(ObjectMember(options, "transport"), "id");
+    session.transport_id = session_id;
+    for (const auto& entry : sessions_) {
+      if (!transport_id.empty() && !entry.second.is_publication &&
+          entry.second.owner == session.owner &&
+          entry.second.transport_id == transport_id) {
+        session.transport_id = transport_id;
+        break;
+      }
+    }
+  }
+  sessions_[session_id] = session;
+  sio::message::ptr result = sio::object_message::create();
+  result->get_map()["id"] = sio::string_message::create(session_id);
+  if (!session.transport_id.empty()) {
+    result->get_map()["transportId"] =
+        sio::string_message::create(session.transport_id);
+  }
+  *ack = OkAck();
+  ack->push(result);
+}
+void LocalConferenceServer::OnSoac(
+    const std::shared_ptr<Connection>& connection,
+    sio::message::ptr soac,
+    sio::message::list* ack) {
+  const std::string session_id = StringMember(soac, "id");
+  auto it = sessions_.find(session_id);
+  if (it == sessions_.end() ||
+      it->second.owner != connection->participant_id) {
+    SetError(ack, "Session does not exist.");
+    return;
+  }
+  Session& session = it->second;
+  sio::message::ptr signaling = ObjectMember(soac, "signaling");
+  const std::string type = StringMember(signaling, "type");
+  if ((type == "candidate" || type == "candidates") &&
+      options_.on_candidates) {
+    options_.on_candidates(signaling);
+  }
+  if (type == "candidates" && !options_.accept_batched_candidates) {
+    SetError(ack, "Unknown signaling type.");
+    return;
+  }
+  *ack = OkAck();
+  // Candidates are accepted but not used, as no media is relayed.
+  if (type != "offer")
+    return;
+  const Participant& owner = participants_[session.owner];
+  sio::message::ptr answer = sio::object_message::create();
+  answer->get_map()["type"] = sio::string_message::create("answer");
+  answer->get_map()["sdp"] = sio::string_message::create(
+      options_.answer_generator(StringMember(signaling, "sdp")));
+  sio::message::ptr progress = sio::object_message::create();
+  progress->get_map()["id"] = sio::string_message::create(session_id);
+  progress->get_map()["status"] = sio::string_message::create("soac");
+  progress->get_map()["data"] = answer;
+  Send(owner, "progress", progress);
+  if (session.ready)
+    return;
+  session.ready = true;
+  sio::message::ptr ready = sio::object_message::create();
+  ready->get_map()["id"] = sio::string_message::create(session_id);
+  ready->get_map()["status"] = sio::string_message::create("ready");
+  Send(owner, "progress", ready);
+  if (session.is_publication) {
+    streams_[session_id] = session.stream_info;
+    sio::message::ptr add = sio::object_message::create();
+    add->get_map()["id"] = sio::string_message::create(session_id);
+    add->get_map()["status"] = sio::string_message::create("add");
+    add->get_map()["data"] = session.stream_info;
+    Broadcast("stream", add, "");
+  }
+}
+void LocalConferenceServer::OnText(
+    const std::shared_ptr<Connection>& connection,
+    sio::message::ptr text,
+    sio::message::list* ack) {
+  const std::string to = StringMember(text, "to");
+  sio::message::ptr message = sio::object_message::create();
+  message->get_map()["from"] =
+      sio::string_message::create(connection->participant_id);
+  message->get_map()["message"] =
+      sio::string_message::create(StringMember(text, "message"));
+  if (to == "all") {
+    message->get_map()["to"] = sio::string_message::create("all");
+    Broadcast("text", message, connection->participant_id);
+  } else {
+    auto receiver = participants_.find(to);
+    if (receiver == participants_.end()) {
+      SetError(ack, "Receiver does not exist.");
+      return;
+    }
+    message->get_map()["to"] = sio::string_message::create("me");
+    Send(receiver->second, "text", message);
+  }
+  *ack = OkAck();
+}
+void LocalConferenceServer::RemoveSession(const std::string& session_id) {
+  sessions_.erase(session_id);
+  if (streams_.erase(session_id) == 0)
+    return;
+  sio::message::ptr remove = sio::object_message::create();
+  remove->get_map()["id"] = sio::string_message::create(session_id);
+  remove->get_map()["status"] = sio::string_message::create("remove");
+  Broadcast("stream", remove, "");
+}
+void LocalConferenceServer::Leave(
+    const std::shared_ptr<Connection>& connection) {
+  const std::string participant_id = connection->participant_id;
+  if (participant_id.empty())
+    return;
+  connection->participant_id.clear();
+  participants_.erase(participant_id);
+  for (auto it = reconnection_tickets_.begin();
+       it != reconnection_tickets_.end();) {
+    if (it->second == participant_id)
+      it = reconnection_tickets_.erase(it);
+    else
+      ++it;
+  }
+  std::vector<std::string> owned_sessions;
+  for (const auto& session : sessions_) {
+    if (session.second.owner == participant_id)
+      owned_sessions.push_back(session.first);
+  }
+  for (const auto& session_id : owned_sessions)
+    RemoveSession(session_id);
+  sio::message::ptr leave = sio::object_message::create();
+  leave->get_map()["action"] = sio::string_message::create("leave");
+  leave->get_map()["data"] = sio::string_message::create(participant_id);
+  Broadcast("participant", leave, participant_id);
+}
+std::string LocalConferenceServer::IssueReconnectionTicket(
+    const std::string& participant_id) {
+  Json::Value ticket;
+  ticket["participantId"] = participant_id;
+  ticket["ticketId"] = std::to_string(next_id_++);
+  ticket["notAfter"] = std::to_string(
+      rtc::TimeMillis() + options_.reconnection_ticket_lifetime_ms);
+  Json::FastWriter writer;
+  std::string encoded = rtc::Base64::Encode(writer.write(ticket));
+  reconnection_tickets_[encoded] = participant_id;
+  return encoded;
+}
+sio::message::ptr LocalConferenceServer::ParticipantInfo(
+    const Participant& participant) const {
+  sio::message::ptr info = sio::object_message::create();
+  info->get_map()["id"] = sio::string_message::create(participant.id);
+  info->get_map()["user"] = sio::string_message::create(participant.user);
+  info->get_map()["role"] = sio::string_message::create(participant.role);
+  return info;
+}
+sio::message::ptr LocalConferenceServer::RoomInfo() const {
+  sio::message::ptr room = sio::object_message::create();
+  room->get_map()["id"] = sio::string_message::create(room_id_);
+  room->get_map()["views"] = sio::array_message::create();
+  sio::message::ptr participants = sio::array_message::create();
+  for (const auto& participant : participants_) {
+    participants->get_vector().push_back(ParticipantInfo(participant.second));
+  }
+  room->get_map()["participants"] = participants;
+  sio::message::ptr streams = sio::array_message::create();
+  for (const auto& stream : streams_) {
+    streams->get_vector().push_back(stream.second);
+  }
+  room->get_map()["streams"] = streams;
+  return room;
+}
+void LocalConferenceServer::Broadcast(const std::string& event,
+                                      sio::message::ptr data,
+                                      const std::string& except) {
+  for (const auto& participant : participants_) {
+    if (participant.first != except)
+      Send(participant.second, event, data);
+  }
+}
+void LocalConferenceServer::Send(const Participant& participant,
+                                 const std::string& event,
+                                 sio::message::ptr data) {
+  if (!participant.connection)
+    return;
+  Event pending_event;
+  pending_event.connection = participant.connection;
+  pending_event.name = event;
+  pending_event.data = data;
+  pending_events_.push_back(std::move(pending_event));
+}
+void LocalConferenceServer::FlushEvents() {
+  std::vector<Event> events;
+  events.swap(pending_events_);
+  for (const auto& event : events) {
+    // Events to a dropped connection are lost.
+    if (event.connection->opened)
+      event.connection->DeliverEvent(event.name, event.data);
+  }
+}
+}  // namespace conference
+}  // namespace owt
@@ -0,0 +1,177 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_CONFERENCE_LOCALCONFERENCESERVER_H_
+#define OWT_CONFERENCE_LOCALCONFERENCESERVER_H_
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "webrtc/rtc_base/task_queue.h"
+#include "talk/owt/sdk/conference/signalingtransportinterface.h"
+namespace owt {
+namespace conference {
+// An in-process stand-in for a conference server. It speaks the part of the
+// signaling protocol used by ConferenceClient: login, relogin, logout,
+// publish, unpublish, subscribe, unsubscribe, soac, text, stream-control,
+// subscription-control and refreshReconnectionTicket, and it sends stream,
+// participant, text and progress events. No media is relayed, so it is meant
+// for measuring signaling, e.g. connection setup cost and event fan-out,
+// without a real server. A participant leaves as soon as its transport is
+// closed, and connections are only dropped by DropConnection.
+// It is only built into test and benchmark targets.
+//
+// All messages are handled on the server's own thread, which also invokes
+// listeners and acks of all connected transports, like Socket.IO client's
+// network thread does. Transports keep their server alive, and the last
+// reference to a server must not be released on its own thread.
+class LocalConferenceServer
+    : public std::enable_shared_from_this<LocalConferenceServer> {
+ public:
+  struct Options {
+    Options();
+    // Reconnection tickets are issued on login if true.
+    bool issue_reconnection_tickets;
+    // Lifetime of reconnection tickets.
+    int reconnection_ticket_lifetime_ms;
+    // Relogin is acknowledged with {reconnectionTicket, room} instead of a
+    // ticket only if true, so clients can resync room state. Login result
+    // advertises it as roomResync capability.
+    bool room_info_on_relogin;
+    // If false, roomResync capability is not advertised even if room info is
+    // sent on relogin, as by servers which do not support room resync.
+    bool advertise_room_resync;
+    // Subscriptions of a participant asking for the same transport share it,
+    // and subscribe is acknowledged with {id, transportId} if true.
+    bool share_subscription_transports;
+    // "candidates" messages carrying a batch of ICE candidates are rejected
+    // if false, as they are by servers not supporting batching.
+    bool accept_batched_candidates;
+    // Called on server's thread with signaling of "candidate" and
+    // "candidates" messages received, including rejected ones.
+    std::function<void(sio::message::ptr signaling)> on_candidates;
+    // Creates answer SDP for an offer received in soac message. By default,
+    // offer is answered with itself, with setup attribute changed to active.
+    std::function<std::string(const std::string& offer)> answer_generator;
+    // Acks of messages whose name it returns true for are held until
+    // ReleaseHeldAcks, so tests can control when they arrive. Called on
+    // server's thread.
+    std::function<bool(const std::string& name)> hold_ack;
+  };
+  static std::shared_ptr<LocalConferenceServer> Create(const Options& options);
+  ~LocalConferenceServer();
+  // Creates a transport connected to this server. It can be used by
+  // ConferenceSocketSignalingChannel in place of a Socket.IO connection.
+  std::unique_ptr<SignalingTransportInterface> CreateTransport();
+  // Number of participants in the room. For tests and benchmarks only, as it
+  // blocks until server's thread is idle.
+  size_t ParticipantCount();
+  // Number of acks held by Options::hold_ack. Blocks like ParticipantCount.
+  size_t HeldAckCount();
+  // Sends held acks in the order their messages were received.
+  void ReleaseHeldAcks();
+  // Drops connection of |participant_id| as a network failure would. The
+  // participant stays in the room, and events are not delivered to it until
+  // RestoreConnection reopens the connection, where it is expected to
+  // relogin. Both block until the connection's listeners return.
+  void DropConnection(const std::string& participant_id);
+  void RestoreConnection(const std::string& participant_id);
+ private:
+  class Transport;
+  struct Connection;
+  struct Participant {
+    std::string id;
+    std::string user;
+    std::string role;
+    std::shared_ptr<Connection> connection;
+  };
+  // A publication or a subscription.
+  struct Session {
+    std::string owner;
+    bool is_publication;
+    bool ready;
+    // Transport carrying a subscription, if transports are shared.
+    std::string transport_id;
+    // Stream info of a publication, sent to participants once it is ready.
+    sio::message::ptr stream_info;
+  };
+  struct Event {
+    std::shared_ptr<Connection> connection;
+    std::string name;
+    sio::message::ptr data;
+  };
+  struct HeldAck {
+    std::shared_ptr<Connection> connection;
+    SignalingTransportInterface::AckListener ack;
+    sio::message::list message;
+  };
+  explicit LocalConferenceServer(const Options& options);
+  // Called on transport's thread.
+  void Connect(std::shared_ptr<Connection> connection);
+  void Emit(std::shared_ptr<Connection> connection,
+            const std::string& name,
+            const sio::message::list& message,
+            const SignalingTransportInterface::AckListener& ack);
+  void Close(std::shared_ptr<Connection> connection);
+  // Runs |task| on |queue_| and waits for it.
+  void Invoke(std::function<void()> task);
+  // All methods below are called on |queue_|.
+  void OnMessage(const std::shared_ptr<Connection>& connection,
+                 const std::string& name,
+                 const sio::message::list& message,
+                 sio::message::list* ack);
+  void OnLogin(const std::shared_ptr<Connection>& connection,
+               sio::message::ptr login,
+               sio::message::list* ack);
+  void OnRelogin(const std::shared_ptr<Connection>& connection,
+                 sio::message::ptr ticket,
+                 sio::message::list* ack);
+  void OnPublish(const std::shared_ptr<Connection>& connection,
+                 sio::message::ptr options,
+                 sio::message::list* ack);
+  void OnSubscribe(const std::shared_ptr<Connection>& connection,
+                   sio::message::ptr options,
+                   sio::message::list* ack);
+  void OnSoac(const std::shared_ptr<Connection>& connection,
+              sio::message::ptr soac,
+              sio::message::list* ack);
+  void OnText(const std::shared_ptr<Connection>& connection,
+              sio::message::ptr text,
+              sio::message::list* ack);
+  // Removes |session_id| and, if it is a published stream, tells the others.
+  void RemoveSession(const std::string& session_id);
+  // Removes participant of |connection| and everything it owns.
+  void Leave(const std::shared_ptr<Connection>& connection);
+  std::string IssueReconnectionTicket(const std::string& participant_id);
+  sio::message::ptr ParticipantInfo(const Participant& participant) const;
+  sio::message::ptr RoomInfo() const;
+  // Sends |event| to all participants except |except|.
+  void Broadcast(const std::string& event,
+                 sio::message::ptr data,
+                 const std::string& except);
+  // Queues |event| to |participant|. Queued events are sent after the ack of
+  // message being handled.
+  void Send(const Participant& participant,
+            const std::string& event,
+            sio::message::ptr data);
+  void FlushEvents();
+  const Options options_;
+  const std::string room_id_;
+  int next_id_;
+  // Keyed by participant ID.
+  std::map<std::string, Participant> participants_;
+  // Publications and subscriptions, keyed by session ID.
+  std::map<std::string, Session> sessions_;
+  // Stream info of published streams which are ready, keyed by stream ID.
+  std::map<std::string, sio::message::ptr> streams_;
+  // Participant ID for each valid reconnection ticket.
+  std::map<std::string, std::string> reconnection_tickets_;
+  std::vector<Event> pending_events_;
+  std::vector<HeldAck> held_acks_;
+  // Must be the last member, so it is destroyed before others.
+  std::unique_ptr<rtc::TaskQueue> queue_;
+};
+}  // namespace conference
+}  // namespace owt
+#endif  // OWT_CONFERENCE_LOCALCONFERENCESERVER_H_
@@ -0,0 +1,143 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+// Signaling cost of joining a conference and of fanning out stream events to
+// participants. ConferenceSocketSignalingChannel instances are connected to
+// LocalConferenceServer, so the full client side signaling path is measured
+// without a network or a real conference server.
+#include <memory>
+#include <string>
+#include <vector>
+#include "talk/owt/sdk/conference/conferencesocketsignalingchannel.h"
+#include "talk/owt/sdk/conference/localconferenceserver.h"
+#include "talk/owt/sdk/test/benchmark.h"
+#include "talk/owt/sdk/test/latch.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/third_party/base64/base64.h"
+namespace owt {
+namespace conference {
+namespace {
+// Counts stream events received by a participant.
+class StreamEventObserver : public ConferenceSocketSignalingChannelObserver {
+ public:
+  void SetLatch(owt::test::Latch* latch) { latch_ = latch; }
+  void OnUserJoined(std::shared_ptr<sio::message> user) override {}
+  void OnUserLeft(std::shared_ptr<sio::message> user) override {}
+  void OnStreamAdded(std::shared_ptr<sio::message> stream) override {
+    latch_->Signal();
+  }
+  void OnStreamRemoved(std::shared_ptr<sio::message> stream) override {
+    latch_->Signal();
+  }
+  void OnStreamUpdated(std::shared_ptr<sio::message> stream) override {}
+  void OnServerDisconnected() override {}
+  void OnCustomMessage(std::string& from,
+                       std::string& message,
+                       std::string& to) override {}
+  void OnSignalingMessage(std::shared_ptr<sio::message> message) override {}
+  void OnStreamError(std::shared_ptr<sio::message> stream) override {}
+  void OnStreamId(const std::string& id, const std::string& label) override {}
+  void OnSubscriptionId(const std::string& subscription_id,
+                        const std::string& stream_id) override {}
+  void OnRoomResync(std::shared_ptr<sio::message> room_info) override {}
+ private:
+  owt::test::Latch* latch_ = nullptr;
+};
+const char kOfferSdp[] =
+    "v=0\r\no=- 0 2 IN IP4 127.0.0.1\r\ns=-\r\nt=0 0\r\n"
+    "a=group:BUNDLE 0\r\nm=video 9 UDP/TLS/RTP/SAVPF 96\r\n"
+    "c=IN IP4 0.0.0.0\r\na=mid:0\r\na=setup:actpass\r\n"
+    "a=ice-ufrag:abcd\r\na=ice-pwd:abcdefghijklmnopqrstuvwx\r\n"
+    "a=sendonly\r\na=rtpmap:96 VP8/90000\r\n";
+std::string Token() {
+  return rtc::Base64::Encode("{\"host\":\"localhost\"}");
+}
+LocalConferenceServer::Options ServerOptions() {
+  LocalConferenceServer::Options options;
+  // Reconnection is not measured.
+  options.issue_reconnection_tickets = false;
+  return options;
+}
+// Joins |count| participants concurrently and waits until all of them have
+// joined.
+std::vector<std::shared_ptr<ConferenceSocketSignalingChannel>> Join(
+    std::shared_ptr<LocalConferenceServer> server,
+    int count) {
+  std::vector<std::shared_ptr<ConferenceSocketSignalingChannel>> channels;
+  owt::test::Latch joined(count);
+  for (int i = 0; i < count; i++) {
+    channels.push_back(std::make_shared<ConferenceSocketSignalingChannel>(
+        server->CreateTransport()));
+    channels.back()->Connect(
+        Token(), [&joined](sio::message::ptr room_info) { joined.Signal(); },
+        nullptr);
+  }
+  RTC_CHECK(joined.Wait());
+  return channels;
+}
+}  // namespace
+OWT_BENCHMARK(LocalConferenceJoin) {
+  for (int participants : {1, 10, 100, 500}) {
+    std::vector<std::shared_ptr<ConferenceSocketSignalingChannel>> joined;
+    owt::test::MeasureAndReport(
+        std::to_string(participants) + " participant(s) join", 5,
+        participants, [participants, &joined]() {
+          auto channels =
+              Join(LocalConferenceServer::Create(ServerOptions()), participants);
+          // Destroyed after measurement, as leaving is not measured.
+          joined.insert(joined.end(), channels.begin(), channels.end());
+        });
+  }
+}
+OWT_BENCHMARK(LocalConferenceStreamFanOut) {
+  for (int participants : {10, 100, 500}) {
+    // Outlives channels, as leaving participants notify the others.
+    std::vector<std::unique_ptr<StreamEventObserver>> observers;
+    auto server = LocalConferenceServer::Create(ServerOptions());
+    auto publisher = Join(server, 1).front();
+    auto channels = Join(server, participants);
+    for (auto& channel : channels) {
+      observers.emplace_back(new StreamEventObserver());
+      channel->AddObserver(*observers.back());
+    }
+    // Each iteration publishes a stream and unpublishes it, so every
+    // participant receives an add and a remove event.
+    owt::test::MeasureAndReport(
+        "publish to " + std::to_string(participants) + " participant(s)", 20,
+        2 * participants, [participants, &publisher, &observers]() {
+          owt::test::Latch added(participants);
+          owt::test::Latch removed(participants);
+          for (auto& observer : observers)
+            observer->SetLatch(&added);
+          sio::message::ptr options = sio::object_message::create();
+          sio::message::ptr media = sio::object_message::create();
+          sio::message::ptr video = sio::object_message::create();
+          video->get_map()["source"] = sio::string_message::create("camera");
+          media->get_map()["video"] = video;
+          media->get_map()["audio"] = sio::bool_message::create(false);
+          options->get_map()["media"] = media;
+          // Set before stream is added, so it is visible after |added|.
+          std::string stream_id;
+          publisher->SendInitializationMessage(
+              options, "label", "",
+              [&publisher, &stream_id](std::string id) {
+                stream_id = id;
+                sio::message::ptr offer = sio::object_message::create();
+                offer->get_map()["type"] = sio::string_message::create("offer");
+                offer->get_map()["sdp"] = sio::string_message::create(kOfferSdp);
+                sio::message::ptr soac = sio::object_message::create();
+                soac->get_map()["id"] = sio::string_message::create(id);
+                soac->get_map()["signaling"] = offer;
+                publisher->SendSdp(soac, nullptr, nullptr);
+              },
+              nullptr);
+          RTC_CHECK(added.Wait());
+          for (auto& observer : observers)
+            observer->SetLatch(&removed);
+          publisher->SendStreamEvent("unpublish", stream_id, nullptr, nullptr);
+          RTC_CHECK(removed.Wait());
+        });
+  }
+}
+}  // namespace conference
+}  // namespace owt
@@ -0,0 +1,544 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/conference/signalingmessagedecoder.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "talk/owt/sdk/base/mediautils.h"
+#include "webrtc/rtc_base/arraysize.h"
+#include "webrtc/rtc_base/logging.h"
+using namespace owt::base;
+namespace owt {
+namespace conference {
+namespace {
+// Decodes the value of a member into |Target|. Returns false if the value
+// makes the whole message invalid. Values of optional members with a wrong
+// type are ignored instead.
+template <typename Target>
+struct Field {
+  const char* name;
+  bool (*decode)(const sio::message::ptr& value, Target* target);
+};
+bool IsObject(const sio::message::ptr& message) {
+  return message && message->get_flag() == sio::message::flag_object;
+}
+bool IsArray(const sio::message::ptr& message) {
+  return message && message->get_flag() == sio::message::flag_array;
+}
+// Walks the members of |object| once, decoding each of them with the field of
+// the same name in |schema|. Fields in a schema must be sorted by name, as
+// members of an object message are, so both are walked side by side.
+template <typename Target, size_t N>
+bool DecodeObject(const sio::message::ptr& object,
+                  const Field<Target> (&schema)[N],
+                  Target* target) {
+  if (!IsObject(object))
+    return false;
+  size_t i = 0;
+  for (const auto& member : object->get_map()) {
+    int order = -1;
+    while (i < N && (order = strcmp(schema[i].name, member.first.c_str())) < 0)
+      i++;
+    if (i == N)
+      break;
+    if (order == 0 && member.second &&
+        !schema[i].decode(member.second, target))
+      return false;
+  }
+  return true;
+}
+// Decodes each object in |array| with |schema|, and passes it to |append|.
+template <typename Target, size_t N, typename Append>
+bool DecodeArray(const sio::message::ptr& array,
+                 const Field<Target> (&schema)[N],
+                 Append append) {
+  if (!IsArray(array))
+    return true;
+  for (const auto& element : array->get_vector()) {
+    Target target;
+    if (!DecodeObject(element, schema, &target) || !append(target))
+      return false;
+  }
+  return true;
+}
+bool GetString(const sio::message::ptr& value, std::string* result) {
+  if (value->get_flag() != sio::message::flag_string)
+    return false;
+  *result = value->get_string();
+  return true;
+}
+bool GetNumber(const sio::message::ptr& value, double* result) {
+  if (value->get_flag() == sio::message::flag_integer) {
+    *result = static_cast<double>(value->get_int());
+    return true;
+  } else if (value->get_flag() == sio::message::flag_double) {
+    *result = value->get_double();
+    return true;
+  }
+  return false;
+}
+// Appends numbers in |array| to |results|, ignoring other elements.
+template <typename T>
+void GetNumbers(const sio::message::ptr& array, std::vector<T>* results) {
+  if (!IsArray(array))
+    return;
+  double number = 0;
+  for (const auto& element : array->get_vector()) {
+    if (element && GetNumber(element, &number))
+      results->push_back(static_cast<T>(number));
+  }
+}
+struct ResolutionInfo {
+  ResolutionInfo() : width(0), height(0) {}
+  bool IsValid() const { return width > 0 && height > 0; }
+  Resolution ToResolution() const {
+    return Resolution(static_cast<unsigned long>(width),
+                      static_cast<unsigned long>(height));
+  }
+  double width;
+  double height;
+};
+const Field<ResolutionInfo> kResolutionSchema[] = {
+    {"height",
+     [](const sio::message::ptr& value, ResolutionInfo* resolution) {
+       GetNumber(value, &resolution->height);
+       return true;
+     }},
+    {"width",
+     [](const sio::message::ptr& value, ResolutionInfo* resolution) {
+       GetNumber(value, &resolution->width);
+       return true;
+     }},
+};
+struct AudioFormatInfo {
+  AudioFormatInfo() : sample_rate(0), channel_num(0) {}
+  AudioCodecParameters ToCodecParameters() const {
+    return AudioCodecParameters(MediaUtils::GetAudioCodecFromString(codec),
+                                static_cast<unsigned long>(channel_num),
+                                static_cast<unsigned long>(sample_rate));
+  }
+  std::string codec;
+  double sample_rate;
+  double channel_num;
+};
+// Codec is required for every audio format.
+const Field<AudioFormatInfo> kAudioFormatSchema[] = {
+    {"channelNum",
+     [](const sio::message::ptr& value, AudioFormatInfo* format) {
+       GetNumber(value, &format->channel_num);
+       return true;
+     }},
+    {"codec",
+     [](const sio::message::ptr& value, AudioFormatInfo* format) {
+       if (!GetString(value, &format->codec) || format->codec.empty()) {
+         RTC_LOG(LS_ERROR) << "Invalid codec name in audio info.";
+         return false;
+       }
+       return true;
+     }},
+    {"sampleRate",
+     [](const sio::message::ptr& value, AudioFormatInfo* format) {
+       GetNumber(value, &format->sample_rate);
+       return true;
+     }},
+};
+bool DecodeAudioFormat(const sio::message::ptr& value,
+                       AudioFormatInfo* format) {
+  if (!DecodeObject(value, kAudioFormatSchema, format) ||
+      format->codec.empty()) {
+    RTC_LOG(LS_ERROR) << "Invalid audio format info in media info.";
+    return false;
+  }
+  return true;
+}
+struct AudioContext {
+  AudioContext(StreamInfoMessage* info) : info(info), has_format(false) {}
+  StreamInfoMessage* info;
+  bool has_format;
+};
+const Field<AudioContext> kOptionalAudioSchema[] = {
+    {"format",
+     [](const sio::message::ptr& value, AudioContext* context) {
+       if (!IsArray(value))
+         return true;
+       auto& codecs = context->info->subscription_capabilities.audio.codecs;
+       for (const auto& element : value->get_vector()) {
+         AudioFormatInfo format;
+         if (!DecodeAudioFormat(element, &format))
+           return false;
+         if (format.codec == "nellymoser")
+           format.codec = "asao";
+         codecs.push_back(format.ToCodecParameters());
+       }
+       return true;
+     }},
+};
+// Main format comes before optional ones in both schema and capabilities.
+const Field<AudioContext> kAudioSchema[] = {
+    {"format",
+     [](const sio::message::ptr& value, AudioContext* context) {
+       AudioFormatInfo format;
+       if (!DecodeAudioFormat(value, &format))
+         return false;
+       context->has_format = true;
+       AudioCodecParameters codec = format.ToCodecParameters();
+       context->info->publication_settings.audio.codec = codec;
+       context->info->subscription_capabilities.audio.codecs.push_back(codec);
+       return true;
+     }},
+    {"optional",
+     [](const sio::message::ptr& value, AudioContext* context) {
+       return !IsObject(value) ||
+              DecodeObject(value, kOptionalAudioSchema, context);
+     }},
+    {"source",
+     [](const sio::message::ptr& value, AudioContext* context) {
+       GetString(value, &context->info->audio_source);
+       return true;
+     }},
+};
+struct VideoFormatInfo {
+  VideoCodecParameters ToCodecParameters() const {
+    return VideoCodecParameters(MediaUtils::GetVideoCodecFromString(codec),
+                                profile);
+  }
+  std::string codec;
+  std::string profile;
+};
+// Codec is required for every video format.
+const Field<VideoFormatInfo> kVideoFormatSchema[] = {
+    {"codec",
+     [](const sio::message::ptr& value, VideoFormatInfo* format) {
+       if (!GetString(value, &format->codec) || format->codec.empty()) {
+         RTC_LOG(LS_ERROR) << "Invalid codec name in video info.";
+         return false;
+       }
+       return true;
+     }},
+    {"profile",
+     [](const sio::message::ptr& value, VideoFormatInfo* format) {
+       GetString(value, &format->profile);
+       return true;
+     }},
+};
+bool DecodeVideoFormat(const sio::message::ptr& value,
+                       VideoFormatInfo* format) {
+  if (!DecodeObject(value, kVideoFormatSchema, format) ||
+      format->codec.empty()) {
+    RTC_LOG(LS_ERROR) << "Invalid video format info.";
+    return false;
+  }
+  return true;
+}
+struct VideoParametersInfo {
+  VideoParametersInfo()
+      : has_frame_rate(false),
+        frame_rate(0),
+        bitrate(0),
+        has_keyframe_interval(false),
+        keyframe_interval(0) {}
+  ResolutionInfo resolution;
+  bool has_frame_rate;
+  double frame_rate;
+  double bitrate;
+  bool has_keyframe_interval;
+  double keyframe_interval;
+};
+const Field<VideoParametersInfo> kVideoParametersSchema[] = {
+    {"bitrate",
+     [](const sio::message::ptr& value, VideoParametersInfo* parameters) {
+       GetNumber(value, &parameters->bitrate);
+       return true;
+     }},
+    {"framerate",
+     [](const sio::message::ptr& value, VideoParametersInfo* parameters) {
+       parameters->has_frame_rate = GetNumber(value, &parameters->frame_rate);
+       return true;
+     }},
+    {"keyFrameInterval",
+     [](const sio::message::ptr& value, VideoParametersInfo* parameters) {
+       parameters->has_keyframe_interval =
+           GetNumber(value, &parameters->keyframe_interval);
+       return true;
+     }},
+    {"resolution",
+     [](const sio::message::ptr& value, VideoParametersInfo* parameters) {
+       if (IsObject(value))
+         DecodeObject(value, kResolutionSchema, &parameters->resolution);
+       return true;
+     }},
+};
+struct VideoContext {
+  VideoContext(StreamInfoMessage* info) : info(info), has_format(false) {}
+  VideoSubscriptionCapabilities& capabilities() {
+    return info->subscription_capabilities.video;
+  }
+  StreamInfoMessage* info;
+  bool has_format;
+};
+const Field<VideoContext> kOptionalVideoParametersSchema[] = {
+    {"bitrate",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       if (!IsArray(value))
+         return true;
+       // Bitrate multipliers are in the form of "x1.0".
+       for (const auto& element : value->get_vector()) {
+         if (!element || element->get_flag() != sio::message::flag_string)
+           continue;
+         const std::string& multiplier = element->get_string();
+         if (multiplier.size() > 1 && multiplier[0] == 'x') {
+           context->capabilities().bitrate_multipliers.push_back(
+               strtod(multiplier.c_str() + 1, nullptr));
+         }
+       }
+       return true;
+     }},
+    {"framerate",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       GetNumbers(value, &context->capabilities().frame_rates);
+       return true;
+     }},
+    {"keyFrameInterval",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       GetNumbers(value, &context->capabilities().keyframe_intervals);
+       return true;
+     }},
+    {"resolution",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       auto& resolutions = context->capabilities().resolutions;
+       DecodeArray(value, kResolutionSchema,
+                   [&resolutions](const ResolutionInfo& resolution) {
+                     if (resolution.IsValid())
+                       resolutions.push_back(resolution.ToResolution());
+                     return true;
+                   });
+       return true;
+     }},
+};
+const Field<VideoContext> kOptionalVideoSchema[] = {
+    {"format",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       if (!IsArray(value))
+         return true;
+       auto& codecs = context->capabilities().codecs;
+       for (const auto& element : value->get_vector()) {
+         VideoFormatInfo format;
+         if (!DecodeVideoFormat(element, &format))
+           return false;
+         codecs.push_back(format.ToCodecParameters());
+       }
+       return true;
+     }},
+    {"parameters",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       return !IsObject(value) ||
+              DecodeObject(value, kOptionalVideoParametersSchema, context);
+     }},
+};
+// Main format comes before optional ones in schema, but main parameters come
+// after them, so they are inserted in front of optional capabilities.
+const Field<VideoContext> kVideoSchema[] = {
+    {"format",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       VideoFormatInfo format;
+       if (!DecodeVideoFormat(value, &format))
+         return false;
+       context->has_format = true;
+       VideoPublicationSettings& settings =
+           context->info->publication_settings.video;
+       settings.codec = format.ToCodecParameters();
+       context->capabilities().codecs.push_back(settings.codec);
+       return true;
+     }},
+    {"optional",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       return !IsObject(value) ||
+              DecodeObject(value, kOptionalVideoSchema, context);
+     }},
+    {"parameters",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       VideoParametersInfo parameters;
+       if (!IsObject(value) ||
+           !DecodeObject(value, kVideoParametersSchema, &parameters))
+         return true;
+       VideoPublicationSettings& settings =
+           context->info->publication_settings.video;
+       VideoSubscriptionCapabilities& capabilities = context->capabilities();
+       if (parameters.resolution.IsValid()) {
+         settings.resolution = parameters.resolution.ToResolution();
+         capabilities.resolutions.insert(capabilities.resolutions.begin(),
+                                         settings.resolution);
+       }
+       if (parameters.has_frame_rate) {
+         settings.frame_rate = parameters.frame_rate;
+         capabilities.frame_rates.insert(capabilities.frame_rates.begin(),
+                                         settings.frame_rate);
+       }
+       settings.bitrate = static_cast<unsigned long>(parameters.bitrate);
+       if (parameters.has_keyframe_interval) {
+         settings.keyframe_interval =
+             static_cast<unsigned long>(parameters.keyframe_interval);
+         capabilities.keyframe_intervals.insert(
+             capabilities.keyframe_intervals.begin(),
+             settings.keyframe_interval);
+       }
+       return true;
+     }},
+    {"source",
+     [](const sio::message::ptr& value, VideoContext* context) {
+       GetString(value, &context->info->video_source);
+       return true;
+     }},
+};
+bool DecodeAudio(const sio::message::ptr& value, StreamInfoMessage* info) {
+  AudioContext context(info);
+  if (!DecodeObject(value, kAudioSchema, &context))
+    return false;
+  if (!context.has_format) {
+    RTC_LOG(LS_ERROR) << "Invalid audio format info in media info.";
+    return false;
+  }
+  info->has_audio = true;
+  return true;
+}
+bool DecodeVideo(const sio::message::ptr& value, StreamInfoMessage* info) {
+  VideoContext context(info);
+  if (!DecodeObject(value, kVideoSchema, &context))
+    return false;
+  if (!context.has_format) {
+    RTC_LOG(LS_ERROR) << "Invalid video format info.";
+    return false;
+  }
+  info->has_video = true;
+  return true;
+}
+struct StreamInfoContext {
+  StreamInfoContext(StreamInfoMessage* info)
+      : info(info), has_media(false), has_info(false) {}
+  StreamInfoMessage* info;
+  bool has_media;
+  bool has_info;
+};
+// Audio or video is absent if it is not an object, e.g. false.
+const Field<StreamInfoMessage> kMediaSchema[] = {
+    {"audio",
+     [](const sio::message::ptr& value, StreamInfoMessage* info) {
+       return !IsObject(value) || DecodeAudio(value, info);
+     }},
+    {"video",
+     [](const sio::message::ptr& value, StreamInfoMessage* info) {
+       return !IsObject(value) || DecodeVideo(value, info);
+     }},
+};
+// Publication info of forward streams, or view info of mixed streams.
+const Field<StreamInfoMessage> kPublicationInfoSchema[] = {
+    {"attributes",
+     [](const sio::message::ptr& value, StreamInfoMessage* info) {
+       if (!IsObject(value)) {
+         RTC_LOG(LS_WARNING) << "Incorrect attribute format.";
+         return true;
+       }
+       for (const auto& attribute : value->get_map()) {
+         if (attribute.second &&
+             attribute.second->get_flag() == sio::message::flag_string)
+           info->attributes[attribute.first] = attribute.second->get_string();
+       }
+       return true;
+     }},
+    {"label",
+     [](const sio::message::ptr& value, StreamInfoMessage* info) {
+       GetString(value, &info->view);
+       return true;
+     }},
+    {"owner",
+     [](const sio::message::ptr& value, StreamInfoMessage* info) {
+       GetString(value, &info->owner_id);
+       return true;
+     }},
+};
+const Field<StreamInfoContext> kStreamInfoSchema[] = {
+    {"id",
+     [](const sio::message::ptr& value, StreamInfoContext* context) {
+       return GetString(value, &context->info->id);
+     }},
+    {"info",
+     [](const sio::message::ptr& value, StreamInfoContext* context) {
+       context->has_info = IsObject(value);
+       return !context->has_info ||
+              DecodeObject(value, kPublicationInfoSchema, context->info);
+     }},
+    {"media",
+     [](const sio::message::ptr& value, StreamInfoContext* context) {
+       context->has_media = IsObject(value);
+       return !context->has_media ||
+              DecodeObject(value, kMediaSchema, context->info);
+     }},
+    {"type",
+     [](const sio::message::ptr& value, StreamInfoContext* context) {
+       return GetString(value, &context->info->type);
+     }},
+};
+struct ParticipantInfoContext {
+  ParticipantInfoContext(ParticipantInfoMessage* info)
+      : info(info), members(0) {}
+  ParticipantInfoMessage* info;
+  // Number of required members found.
+  int members;
+};
+// All members are required.
+const Field<ParticipantInfoContext> kParticipantInfoSchema[] = {
+    {"id",
+     [](const sio::message::ptr& value, ParticipantInfoContext* context) {
+       context->members++;
+       return GetString(value, &context->info->id);
+     }},
+    {"role",
+     [](const sio::message::ptr& value, ParticipantInfoContext* context) {
+       context->members++;
+       return GetString(value, &context->info->role);
+     }},
+    {"user",
+     [](const sio::message::ptr& value, ParticipantInfoContext* context) {
+       context->members++;
+       return GetString(value, &context->info->user);
+     }},
+};
+}  // namespace
+StreamInfoMessage::StreamInfoMessage()
+    : has_audio(false),
+      has_video(false),
+      publication_settings(),
+      subscription_capabilities() {}
+bool DecodeStreamInfo(const sio::message::ptr& message,
+                      StreamInfoMessage* info) {
+  StreamInfoContext context(info);
+  if (!DecodeObject(message, kStreamInfoSchema, &context) ||
+      info->id.empty()) {
+    RTC_LOG(LS_ERROR) << "Invalid stream info.";
+    return false;
+  }
+  if (!context.has_media) {
+    RTC_LOG(LS_ERROR) << "Invalid media info from stream " << info->id
+                      << ", this stream will be ignored.";
+    return false;
+  }
+  if (info->type != "forward" && info->type != "mixed") {
+    RTC_LOG(LS_ERROR) << "Invalid stream type.";
+    return false;
+  }
+  if (info->type == "forward" && !context.has_info) {
+    RTC_LOG(LS_ERROR) << "Invalid publication info from stream " << info->id
+                      << ", this stream will be ignored.";
+    return false;
+  }
+  return true;
+}
+bool DecodeParticipantInfo(const sio::message::ptr& message,
+                           ParticipantInfoMessage* info) {
+  ParticipantInfoContext context(info);
+  return DecodeObject(message, kParticipantInfoSchema, &context) &&
+         context.members == arraysize(kParticipantInfoSchema);
+}
+}  // namespace conference
+}  // namespace owt
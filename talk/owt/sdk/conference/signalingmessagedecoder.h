@@ -0,0 +1,48 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_CONFERENCE_SIGNALINGMESSAGEDECODER_H_
+#define OWT_CONFERENCE_SIGNALINGMESSAGEDECODER_H_
+#include <string>
+#include <unordered_map>
+#include "talk/owt/include/sio_message.h"
+#include "talk/owt/sdk/include/cpp/owt/base/options.h"
+namespace owt {
+namespace conference {
+// Stream info sent by conference server in room info and stream events.
+struct StreamInfoMessage {
+  StreamInfoMessage();
+  std::string id;
+  // "forward" or "mixed".
+  std::string type;
+  // Participant ID of the publisher of a forward stream.
+  std::string owner_id;
+  // Label of the view of a mixed stream.
+  std::string view;
+  std::unordered_map<std::string, std::string> attributes;
+  bool has_audio;
+  bool has_video;
+  std::string audio_source;
+  std::string video_source;
+  owt::base::PublicationSettings publication_settings;
+  owt::base::SubscriptionCapabilities subscription_capabilities;
+};
+// Participant info sent by conference server in room info and participant
+// events.
+struct ParticipantInfoMessage {
+  std::string id;
+  std::string user;
+  std::string role;
+};
+// Decoders turn messages straight into structs. Each object in a message is
+// walked once, and its members are dispatched by a per object schema, so
+// looking up a member never searches or modifies the message. Members not in
+// schema are ignored. Return false if a required member is missing or has a
+// wrong type, in which case |*info| should not be used.
+bool DecodeStreamInfo(const sio::message::ptr& message,
+                      StreamInfoMessage* info);
+bool DecodeParticipantInfo(const sio::message::ptr& message,
+                           ParticipantInfoMessage* info);
+}  // namespace conference
+}  // namespace owt
+#endif  // OWT_CONFERENCE_SIGNALINGMESSAGEDECODER_H_
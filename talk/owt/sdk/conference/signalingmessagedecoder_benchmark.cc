@@ -0,0 +1,313 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+// Cost of decoding stream info in a room snapshot with thousands of forward
+// streams, as received on joining a large conference. Lookups by
+// sio::message's map operator[], as ConferenceClient did before
+// DecodeStreamInfo was introduced, are compared with the single-pass decoder.
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "talk/owt/sdk/base/mediautils.h"
+#include "talk/owt/sdk/conference/signalingmessagedecoder.h"
+#include "talk/owt/sdk/test/benchmark.h"
+namespace owt {
+namespace conference {
+using namespace owt::base;
+namespace {
+sio::message::ptr StreamInfo(int index) {
+  sio::message::ptr audio_format = sio::object_message::create();
+  audio_format->get_map()["codec"] = sio::string_message::create("opus");
+  audio_format->get_map()["sampleRate"] = sio::int_message::create(48000);
+  audio_format->get_map()["channelNum"] = sio::int_message::create(2);
+  sio::message::ptr audio = sio::object_message::create();
+  audio->get_map()["source"] = sio::string_message::create("mic");
+  audio->get_map()["format"] = audio_format;
+  sio::message::ptr optional_audio_formats = sio::array_message::create();
+  for (const char* codec : {"isac", "g722", "pcma", "pcmu"}) {
+    sio::message::ptr format = sio::object_message::create();
+    format->get_map()["codec"] = sio::string_message::create(codec);
+    optional_audio_formats->get_vector().push_back(format);
+  }
+  sio::message::ptr optional_audio = sio::object_message::create();
+  optional_audio->get_map()["format"] = optional_audio_formats;
+  audio->get_map()["optional"] = optional_audio;
+  sio::message::ptr video_format = sio::object_message::create();
+  video_format->get_map()["codec"] = sio::string_message::create("vp8");
+  sio::message::ptr resolution = sio::object_message::create();
+  resolution->get_map()["width"] = sio::int_message::create(1280);
+  resolution->get_map()["height"] = sio::int_message::create(720);
+  sio::message::ptr parameters = sio::object_message::create();
+  parameters->get_map()["resolution"] = resolution;
+  parameters->get_map()["framerate"] = sio::int_message::create(30);
+  parameters->get_map()["bitrate"] = sio::int_message::create(2000);
+  parameters->get_map()["keyFrameInterval"] = sio::int_message::create(100);
+  sio::message::ptr video = sio::object_message::create();
+  video->get_map()["source"] = sio::string_message::create("camera");
+  video->get_map()["format"] = video_format;
+  video->get_map()["parameters"] = parameters;
+  sio::message::ptr optional_video_formats = sio::array_message::create();
+  for (const char* codec : {"vp9", "h264"}) {
+    sio::message::ptr format = sio::object_message::create();
+    format->get_map()["codec"] = sio::string_message::create(codec);
+    optional_video_formats->get_vector().push_back(format);
+  }
+  sio::message::ptr optional_resolutions = sio::array_message::create();
+  sio::message::ptr optional_frame_rates = sio::array_message::create();
+  sio::message::ptr optional_bitrates = sio::array_message::create();
+  for (int i = 1; i <= 3; i++) {
+    sio::message::ptr optional_resolution = sio::object_message::create();
+    optional_resolution->get_map()["width"] =
+        sio::int_message::create(1280 / (i + 1));
+    optional_resolution->get_map()["height"] =
+        sio::int_message::create(720 / (i + 1));
+    optional_resolutions->get_vector().push_back(optional_resolution);
+    optional_frame_rates->get_vector().push_back(
+        sio::int_message::create(30 / (i + 1)));
+    optional_bitrates->get_vector().push_back(
+        sio::string_message::create("x0." + std::to_string(i * 2)));
+  }
+  sio::message::ptr optional_parameters = sio::object_message::create();
+  optional_parameters->get_map()["resolution"] = optional_resolutions;
+  optional_parameters->get_map()["framerate"] = optional_frame_rates;
+  optional_parameters->get_map()["bitrate"] = optional_bitrates;
+  sio::message::ptr optional_video = sio::object_message::create();
+  optional_video->get_map()["format"] = optional_video_formats;
+  optional_video->get_map()["parameters"] = optional_parameters;
+  video->get_map()["optional"] = optional_video;
+  sio::message::ptr media = sio::object_message::create();
+  media->get_map()["audio"] = audio;
+  media->get_map()["video"] = video;
+  sio::message::ptr attributes = sio::object_message::create();
+  attributes->get_map()["name"] =
+      sio::string_message::create("camera " + std::to_string(index));
+  sio::message::ptr info = sio::object_message::create();
+  info->get_map()["owner"] =
+      sio::string_message::create("participant-" + std::to_string(index));
+  info->get_map()["type"] = sio::string_message::create("webrtc");
+  info->get_map()["attributes"] = attributes;
+  sio::message::ptr stream = sio::object_message::create();
+  stream->get_map()["id"] =
+      sio::string_message::create("stream-" + std::to_string(index));
+  stream->get_map()["type"] = sio::string_message::create("forward");
+  stream->get_map()["media"] = media;
+  stream->get_map()["info"] = info;
+  return stream;
+}
+std::vector<sio::message::ptr> RoomSnapshot(int streams) {
+  std::vector<sio::message::ptr> snapshot;
+  for (int i = 0; i < streams; i++)
+    snapshot.push_back(StreamInfo(i));
+  return snapshot;
+}
+// Lookups of the previous ConferenceClient::ParseStreamInfo, without its
+// logging. Missing members are inserted to the message by operator[].
+bool LegacyParseStreamInfo(sio::message::ptr stream_info,
+                           StreamInfoMessage* result) {
+  result->id = stream_info->get_map()["id"]->get_string();
+  auto media_info = stream_info->get_map()["media"];
+  if (media_info == nullptr ||
+      media_info->get_flag() != sio::message::flag_object)
+    return false;
+  result->type = stream_info->get_map()["type"]->get_string();
+  auto pub_info = stream_info->get_map()["info"];
+  if (pub_info == nullptr || pub_info->get_flag() != sio::message::flag_object)
+    return false;
+  result->owner_id = pub_info->get_map()["owner"]->get_string();
+  if (pub_info->get_map().find("attributes") != pub_info->get_map().end()) {
+    auto attribute_map = pub_info->get_map()["attributes"]->get_map();
+    for (auto const& attribute_pair : attribute_map)
+      result->attributes[attribute_pair.first] =
+          attribute_pair.second->get_string();
+  }
+  auto audio_info = media_info->get_map()["audio"];
+  if (audio_info != nullptr &&
+      audio_info->get_flag() == sio::message::flag_object) {
+    auto audio_source_obj = audio_info->get_map()["source"];
+    if (audio_source_obj != nullptr &&
+        audio_source_obj->get_flag() == sio::message::flag_string)
+      result->audio_source = audio_source_obj->get_string();
+    auto audio_format_obj = audio_info->get_map()["format"];
+    if (audio_format_obj == nullptr ||
+        audio_format_obj->get_flag() != sio::message::flag_object)
+      return false;
+    auto sample_rate_obj = audio_format_obj->get_map()["sampleRate"];
+    auto codec_obj = audio_format_obj->get_map()["codec"];
+    auto channel_num_obj = audio_format_obj->get_map()["channelNum"];
+    if (codec_obj == nullptr ||
+        codec_obj->get_flag() != sio::message::flag_string)
+      return false;
+    result->has_audio = true;
+    AudioCodecParameters audio_codec_param(
+        MediaUtils::GetAudioCodecFromString(codec_obj->get_string()),
+        channel_num_obj ? channel_num_obj->get_int() : 0,
+        sample_rate_obj ? sample_rate_obj->get_int() : 0);
+    result->publication_settings.audio.codec = audio_codec_param;
+    result->subscription_capabilities.audio.codecs.push_back(
+        audio_codec_param);
+    auto audio_format_obj_optional = audio_info->get_map()["optional"];
+    if (audio_format_obj_optional != nullptr &&
+        audio_format_obj_optional->get_flag() == sio::message::flag_object) {
+      auto audio_format_optional =
+          audio_format_obj_optional->get_map()["format"];
+      if (audio_format_optional != nullptr &&
+          audio_format_optional->get_flag() == sio::message::flag_array) {
+        auto formats = audio_format_optional->get_vector();
+        for (auto it = formats.begin(); it != formats.end(); ++it) {
+          auto optional_sample_rate_obj = (*it)->get_map()["sampleRate"];
+          auto optional_codec_obj = (*it)->get_map()["codec"];
+          auto optional_channel_num_obj = (*it)->get_map()["channelNum"];
+          if (optional_codec_obj == nullptr ||
+              optional_codec_obj->get_flag() != sio::message::flag_string)
+            return false;
+          result->subscription_capabilities.audio.codecs.push_back(
+              AudioCodecParameters(
+                  MediaUtils::GetAudioCodecFromString(
+                      optional_codec_obj->get_string()),
+                  optional_channel_num_obj
+                      ? optional_channel_num_obj->get_int()
+                      : 0,
+                  optional_sample_rate_obj
+                      ? optional_sample_rate_obj->get_int()
+                      : 0));
+        }
+      }
+    }
+  }
+  auto video_info = media_info->get_map()["video"];
+  if (video_info != nullptr &&
+      video_info->get_flag() == sio::message::flag_object) {
+    auto video_source_obj = video_info->get_map()["source"];
+    if (video_source_obj != nullptr &&
+        video_source_obj->get_flag() == sio::message::flag_string)
+      result->video_source = video_source_obj->get_string();
+    auto video_format_obj = video_info->get_map()["format"];
+    if (video_format_obj == nullptr ||
+        video_format_obj->get_flag() != sio::message::flag_object)
+      return false;
+    result->has_video = true;
+    auto& settings = result->publication_settings.video;
+    auto& capabilities = result->subscription_capabilities.video;
+    std::string profile_name;
+    auto profile_name_obj = video_format_obj->get_map()["profile"];
+    if (profile_name_obj != nullptr &&
+        profile_name_obj->get_flag() == sio::message::flag_string)
+      profile_name = profile_name_obj->get_string();
+    settings.codec = VideoCodecParameters(
+        MediaUtils::GetVideoCodecFromString(
+            video_format_obj->get_map()["codec"]->get_string()),
+        profile_name);
+    capabilities.codecs.push_back(settings.codec);
+    auto video_params_obj = video_info->get_map()["parameters"];
+    if (video_params_obj != nullptr &&
+        video_params_obj->get_flag() == sio::message::flag_object) {
+      auto main_resolution = video_params_obj->get_map()["resolution"];
+      if (main_resolution != nullptr &&
+          main_resolution->get_flag() == sio::message::flag_object) {
+        settings.resolution =
+            Resolution(main_resolution->get_map()["width"]->get_int(),
+                       main_resolution->get_map()["height"]->get_int());
+        capabilities.resolutions.push_back(settings.resolution);
+      }
+      auto main_frame_rate = video_params_obj->get_map()["framerate"];
+      if (main_frame_rate != nullptr) {
+        settings.frame_rate = main_frame_rate->get_int();
+        capabilities.frame_rates.push_back(settings.frame_rate);
+      }
+      auto main_bitrate = video_params_obj->get_map()["bitrate"];
+      if (main_bitrate != nullptr)
+        settings.bitrate = main_bitrate->get_int();
+      auto main_keyframe_interval =
+          video_params_obj->get_map()["keyFrameInterval"];
+      if (main_keyframe_interval != nullptr) {
+        settings.keyframe_interval = main_keyframe_interval->get_int();
+        capabilities.keyframe_intervals.push_back(settings.keyframe_interval);
+      }
+    }
+    auto optional_video_obj = video_info->get_map()["optional"];
+    if (optional_video_obj != nullptr &&
+        optional_video_obj->get_flag() == sio::message::flag_object) {
+      auto optional_video_format_obj = optional_video_obj->get_map()["format"];
+      if (optional_video_format_obj != nullptr &&
+          optional_video_format_obj->get_flag() == sio::message::flag_array) {
+        auto formats = optional_video_format_obj->get_vector();
+        for (auto it = formats.begin(); it != formats.end(); ++it) {
+          std::string optional_profile_name;
+          auto optional_profile_name_obj = (*it)->get_map()["profile"];
+          if (optional_profile_name_obj != nullptr &&
+              optional_profile_name_obj->get_flag() ==
+                  sio::message::flag_string)
+            optional_profile_name = optional_profile_name_obj->get_string();
+          capabilities.codecs.push_back(VideoCodecParameters(
+              MediaUtils::GetVideoCodecFromString(
+                  (*it)->get_map()["codec"]->get_string()),
+              optional_profile_name));
+        }
+      }
+      auto optional_video_params_obj =
+          optional_video_obj->get_map()["parameters"];
+      if (optional_video_params_obj != nullptr &&
+          optional_video_params_obj->get_flag() == sio::message::flag_object) {
+        auto resolution_obj = optional_video_params_obj->get_map()["resolution"];
+        if (resolution_obj != nullptr &&
+            resolution_obj->get_flag() == sio::message::flag_array) {
+          auto resolutions = resolution_obj->get_vector();
+          for (auto it = resolutions.begin(); it != resolutions.end(); ++it)
+            capabilities.resolutions.push_back(
+                Resolution((*it)->get_map()["width"]->get_int(),
+                           (*it)->get_map()["height"]->get_int()));
+        }
+        auto framerate_obj = optional_video_params_obj->get_map()["framerate"];
+        if (framerate_obj != nullptr &&
+            framerate_obj->get_flag() == sio::message::flag_array) {
+          auto framerates = framerate_obj->get_vector();
+          for (auto it = framerates.begin(); it != framerates.end(); ++it)
+            capabilities.frame_rates.push_back((*it)->get_int());
+        }
+        auto bitrate_obj = optional_video_params_obj->get_map()["bitrate"];
+        if (bitrate_obj != nullptr &&
+            bitrate_obj->get_flag() == sio::message::flag_array) {
+          auto bitrates = bitrate_obj->get_vector();
+          for (auto it = bitrates.begin(); it != bitrates.end(); ++it)
+            capabilities.bitrate_multipliers.push_back(
+                std::stod((*it)->get_string().substr(1)));
+        }
+        auto keyframe_interval_obj =
+            optional_video_params_obj->get_map()["keyFrameInterval"];
+        if (keyframe_interval_obj != nullptr &&
+            keyframe_interval_obj->get_flag() == sio::message::flag_array) {
+          auto keyframe_intervals = keyframe_interval_obj->get_vector();
+          for (auto it = keyframe_intervals.begin();
+               it != keyframe_intervals.end(); ++it)
+            capabilities.keyframe_intervals.push_back((*it)->get_int());
+        }
+      }
+    }
+  }
+  return true;
+}
+}  // namespace
+OWT_BENCHMARK(StreamInfoDecoding) {
+  const int kStreams = 5000;
+  // Legacy lookups insert missing members, so each path has its own snapshot.
+  std::vector<sio::message::ptr> legacy_snapshot = RoomSnapshot(kStreams);
+  std::vector<sio::message::ptr> snapshot = RoomSnapshot(kStreams);
+  owt::test::MeasureAndReport(
+      "map lookups, " + std::to_string(kStreams) + " streams", 20, kStreams,
+      [&legacy_snapshot]() {
+        for (const auto& stream : legacy_snapshot) {
+          StreamInfoMessage info;
+          LegacyParseStreamInfo(stream, &info);
+        }
+      });
+  owt::test::MeasureAndReport(
+      "single-pass decoder, " + std::to_string(kStreams) + " streams", 20,
+      kStreams, [&snapshot]() {
+        for (const auto& stream : snapshot) {
+          StreamInfoMessage info;
+          DecodeStreamInfo(stream, &info);
+        }
+      });
+}
+}  // namespace conference
+}  // namespace owt
@@ -0,0 +1,169 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/conference/signalingmessagedecoder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+namespace owt {
+namespace conference {
+using owt::base::AudioCodec;
+using owt::base::Resolution;
+using owt::base::VideoCodec;
+static sio::message::ptr String(const std::string& value) {
+  return sio::string_message::create(value);
+}
+static sio::message::ptr Int(int value) {
+  return sio::int_message::create(value);
+}
+static sio::message::ptr Object(
+    std::initializer_list<std::pair<const std::string, sio::message::ptr>>
+        members) {
+  sio::message::ptr object = sio::object_message::create();
+  for (const auto& member : members)
+    object->get_map()[member.first] = member.second;
+  return object;
+}
+static sio::message::ptr Array(std::initializer_list<sio::message::ptr> items) {
+  sio::message::ptr array = sio::array_message::create();
+  for (const auto& item : items)
+    array->get_vector().push_back(item);
+  return array;
+}
+static sio::message::ptr ForwardStream() {
+  return Object(
+      {{"id", String("stream-1")},
+       {"type", String("forward")},
+       {"media",
+        Object({{"audio",
+                 Object({{"source", String("mic")},
+                         {"format", Object({{"codec", String("opus")},
+                                            {"sampleRate", Int(48000)},
+                                            {"channelNum", Int(2)}})},
+                         {"optional",
+                          Object({{"format",
+                                   Array({Object({{"codec", String("pcmu")}}),
+                                          Object({{"codec",
+                                                   String("nellymoser")}})})}})}})},
+                {"video",
+                 Object({{"source", String("camera")},
+                         {"format", Object({{"codec", String("h264")},
+                                            {"profile", String("CB")}})},
+                         {"parameters",
+                          Object({{"resolution", Object({{"width", Int(640)},
+                                                         {"height", Int(480)}})},
+                                  {"framerate",
+                                   sio::double_message::create(30.0)},
+                                  {"bitrate", Int(500)},
+                                  {"keyFrameInterval", Int(100)}})},
+                         {"optional",
+                          Object({{"format",
+                                   Array({Object({{"codec", String("vp8")}})})},
+                                  {"parameters",
+                                   Object({{"resolution",
+                                            Array({Object({{"width", Int(320)},
+                                                           {"height",
+                                                            Int(240)}})})},
+                                           {"framerate", Array({Int(15)})},
+                                           {"bitrate", Array({String("x0.8")})},
+                                           {"keyFrameInterval",
+                                            Array({Int(30)})}})}})}})}})},
+       {"info", Object({{"owner", String("participant-1")},
+                        {"type", String("webrtc")},
+                        {"attributes", Object({{"key", String("value")},
+                                               {"ignored", Int(1)}})}})}});
+}
+TEST(SignalingMessageDecoderTest, DecodesForwardStream) {
+  StreamInfoMessage info;
+  ASSERT_TRUE(DecodeStreamInfo(ForwardStream(), &info));
+  EXPECT_EQ("stream-1", info.id);
+  EXPECT_EQ("forward", info.type);
+  EXPECT_EQ("participant-1", info.owner_id);
+  ASSERT_EQ(1u, info.attributes.size());
+  EXPECT_EQ("value", info.attributes["key"]);
+  EXPECT_TRUE(info.has_audio);
+  EXPECT_TRUE(info.has_video);
+  EXPECT_EQ("mic", info.audio_source);
+  EXPECT_EQ("camera", info.video_source);
+  const auto& audio_codec = info.publication_settings.audio.codec;
+  EXPECT_EQ(AudioCodec::kOpus, audio_codec.name);
+  EXPECT_EQ(48000u, audio_codec.clock_rate);
+  EXPECT_EQ(2u, audio_codec.channel_count);
+  const auto& audio_codecs = info.subscription_capabilities.audio.codecs;
+  ASSERT_EQ(3u, audio_codecs.size());
+  EXPECT_EQ(AudioCodec::kPcmu, audio_codecs[1].name);
+  EXPECT_EQ(AudioCodec::kAsao, audio_codecs[2].name);
+  const auto& video = info.publication_settings.video;
+  EXPECT_EQ(VideoCodec::kH264, video.codec.name);
+  EXPECT_EQ("CB", video.codec.profile);
+  EXPECT_EQ(Resolution(640, 480), video.resolution);
+  EXPECT_EQ(30.0, video.frame_rate);
+  EXPECT_EQ(500u, video.bitrate);
+  EXPECT_EQ(100u, video.keyframe_interval);
+  const auto& capabilities = info.subscription_capabilities.video;
+  ASSERT_EQ(2u, capabilities.codecs.size());
+  EXPECT_EQ(VideoCodec::kVp8, capabilities.codecs[1].name);
+  ASSERT_EQ(2u, capabilities.resolutions.size());
+  EXPECT_EQ(Resolution(320, 240), capabilities.resolutions[1]);
+  EXPECT_EQ(std::vector<double>({30.0, 15.0}), capabilities.frame_rates);
+  EXPECT_EQ(std::vector<double>({0.8}), capabilities.bitrate_multipliers);
+  EXPECT_EQ(std::vector<unsigned long>({100, 30}),
+            capabilities.keyframe_intervals);
+}
+TEST(SignalingMessageDecoderTest, DecodesMixedStreamWithoutAudio) {
+  StreamInfoMessage info;
+  ASSERT_TRUE(DecodeStreamInfo(
+      Object({{"id", String("mixed")},
+              {"type", String("mixed")},
+              {"info", Object({{"label", String("common")}})},
+              {"media",
+               Object({{"audio", sio::bool_message::create(false)},
+                       {"video", Object({{"format",
+                                          Object({{"codec", String("vp8")}})}})}})}}),
+      &info));
+  EXPECT_EQ("common", info.view);
+  EXPECT_FALSE(info.has_audio);
+  EXPECT_TRUE(info.has_video);
+  EXPECT_TRUE(info.subscription_capabilities.video.resolutions.empty());
+}
+TEST(SignalingMessageDecoderTest, RejectsInvalidStreams) {
+  StreamInfoMessage info;
+  // No media.
+  EXPECT_FALSE(DecodeStreamInfo(
+      Object({{"id", String("s")}, {"type", String("mixed")}}), &info));
+  // Unknown type.
+  EXPECT_FALSE(DecodeStreamInfo(Object({{"id", String("s")},
+                                        {"type", String("unknown")},
+                                        {"media", Object({})}}),
+                                &info));
+  // Forward stream without publication info.
+  EXPECT_FALSE(DecodeStreamInfo(Object({{"id", String("s")},
+                                        {"type", String("forward")},
+                                        {"media", Object({})}}),
+                                &info));
+  // Video without codec.
+  EXPECT_FALSE(DecodeStreamInfo(
+      Object({{"id", String("s")},
+              {"type", String("mixed")},
+              {"media", Object({{"video", Object({{"format", Object({})}})}})}}),
+      &info));
+  EXPECT_FALSE(DecodeStreamInfo(String("s"), &info));
+  EXPECT_FALSE(DecodeStreamInfo(nullptr, &info));
+}
+TEST(SignalingMessageDecoderTest, DecodesParticipant) {
+  ParticipantInfoMessage info;
+  ASSERT_TRUE(DecodeParticipantInfo(Object({{"id", String("participant-1")},
+                                            {"user", String("user")},
+                                            {"role", String("presenter")}}),
+                                    &info));
+  EXPECT_EQ("participant-1", info.id);
+  EXPECT_EQ("user", info.user);
+  EXPECT_EQ("presenter", info.role);
+  EXPECT_FALSE(DecodeParticipantInfo(
+      Object({{"id", String("participant-1")}, {"user", String("user")}}),
+      &info));
+  EXPECT_FALSE(DecodeParticipantInfo(Object({{"id", String("participant-1")},
+                                             {"user", String("user")},
+                                             {"role", Int(1)}}),
+                                     &info));
+}
+}  // namespace conference
+}  // namespace owt
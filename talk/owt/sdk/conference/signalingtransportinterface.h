@@ -0,0 +1,44 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_CONFERENCE_SIGNALINGTRANSPORTINTERFACE_H_
+#define OWT_CONFERENCE_SIGNALINGTRANSPORTINTERFACE_H_
+#include <functional>
+#include <string>
+#include "talk/owt/include/sio_message.h"
+#include "talk/owt/include/sio_socket.h"
+namespace owt {
+namespace conference {
+// Carries signaling messages between ConferenceSocketSignalingChannel and a
+// conference server. It is the subset of Socket.IO client used by the channel,
+// so the channel works the same way over a real Socket.IO connection and over
+// an in-process server. Listeners and acks may be invoked on any thread, but
+// not concurrently with each other.
+class SignalingTransportInterface {
+ public:
+  typedef std::function<void()> ConnectionListener;
+  typedef std::function<void(sio::message::list const&)> AckListener;
+  // Returns the delay in milliseconds before reconnection attempt |attempt|,
+  // counted from 0 since connection is lost.
+  typedef std::function<unsigned(unsigned attempt)> ReconnectDelayFunction;
+  virtual ~SignalingTransportInterface() {}
+  // Listeners should be set before Connect.
+  virtual void SetOpenListener(const ConnectionListener& listener) = 0;
+  virtual void SetFailListener(const ConnectionListener& listener) = 0;
+  virtual void SetReconnectingListener(const ConnectionListener& listener) = 0;
+  virtual void SetCloseListener(const ConnectionListener& listener) = 0;
+  virtual void SetReconnectAttempts(int attempts) = 0;
+  virtual void SetReconnectDelay(const ReconnectDelayFunction& delay) = 0;
+  // Registers |listener| for events named |event| sent by server.
+  virtual void On(const std::string& event,
+                  const sio::socket::event_listener_aux& listener) = 0;
+  virtual void Connect(const std::string& uri) = 0;
+  virtual void Emit(const std::string& name,
+                    const sio::message::list& message,
+                    const AckListener& ack) = 0;
+  virtual void Close() = 0;
+  virtual bool Opened() const = 0;
+};
+}  // namespace conference
+}  // namespace owt
+#endif  // OWT_CONFERENCE_SIGNALINGTRANSPORTINTERFACE_H_
@@ -0,0 +1,82 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include "talk/owt/sdk/conference/siosignalingtransport.h"
+#include <algorithm>
+#include <cmath>
+namespace owt {
+namespace conference {
+SioSignalingTransport::SioSignalingTransport() : client_(new sio::client()) {
+  // Create the default namespace socket, so event listeners can be registered
+  // before connecting.
+  client_->socket();
+  // Invoked right after the delay of attempt |attempts_made| is determined.
+  client_->set_reconnect_listener(
+      [this](unsigned attempts_made, unsigned delay) {
+        ScheduleReconnectDelay(attempts_made + 1);
+      });
+  // sio::client counts attempts from 0 again after a connection is opened.
+  client_->set_open_listener([this]() {
+    ScheduleReconnectDelay(0);
+    if (open_listener_)
+      open_listener_();
+  });
+}
+SioSignalingTransport::~SioSignalingTransport() {}
+void SioSignalingTransport::SetOpenListener(
+    const ConnectionListener& listener) {
+  open_listener_ = listener;
+}
+void SioSignalingTransport::SetFailListener(
+    const ConnectionListener& listener) {
+  client_->set_fail_listener(listener);
+}
+void SioSignalingTransport::SetReconnectingListener(
+    const ConnectionListener& listener) {
+  client_->set_reconnecting_listener(listener);
+}
+void SioSignalingTransport::SetCloseListener(
+    const ConnectionListener& listener) {
+  client_->set_socket_close_listener(
+      [listener](std::string const& nsp) { listener(); });
+}
+void SioSignalingTransport::SetReconnectAttempts(int attempts) {
+  client_->set_reconnect_attempts(attempts);
+}
+void SioSignalingTransport::SetReconnectDelay(
+    const ReconnectDelayFunction& delay) {
+  reconnect_delay_ = delay;
+  ScheduleReconnectDelay(0);
+}
+void SioSignalingTransport::ScheduleReconnectDelay(unsigned attempt) {
+  if (!reconnect_delay_)
+    return;
+  // sio::client waits min(base * 1.5^attempt, max) before an attempt, with
+  // attempt capped at 32. Base and max are chosen so the result is |delay|.
+  const unsigned delay = reconnect_delay_(attempt);
+  const double growth = std::pow(1.5, std::min(attempt, 32u));
+  client_->set_reconnect_delay_max(delay);
+  client_->set_reconnect_delay(std::max(
+      1u, static_cast<unsigned>(std::ceil(static_cast<double>(delay) / growth))));
+}
+void SioSignalingTransport::On(
+    const std::string& event,
+    const sio::socket::event_listener_aux& listener) {
+  client_->socket()->on(event, listener);
+}
+void SioSignalingTransport::Connect(const std::string& uri) {
+  client_->connect(uri);
+}
+void SioSignalingTransport::Emit(const std::string& name,
+                                 const sio::message::list& message,
+                                 const AckListener& ack) {
+  client_->socket()->emit(name, message, ack);
+}
+void SioSignalingTransport::Close() {
+  client_->close();
+}
+bool SioSignalingTransport::Opened() const {
+  return client_->opened();
+}
+}  // namespace conference
+}  // namespace owt
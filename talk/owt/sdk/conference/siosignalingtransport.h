@@ -0,0 +1,41 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_CONFERENCE_SIOSIGNALINGTRANSPORT_H_
+#define OWT_CONFERENCE_SIOSIGNALINGTRANSPORT_H_
+#include <memory>
+#include "talk/owt/include/sio_client.h"
+#include "talk/owt/sdk/conference/signalingtransportinterface.h"
+namespace owt {
+namespace conference {
+// Signaling transport over a Socket.IO connection to a conference server.
+class SioSignalingTransport : public SignalingTransportInterface {
+ public:
+  SioSignalingTransport();
+  ~SioSignalingTransport() override;
+  void SetOpenListener(const ConnectionListener& listener) override;
+  void SetFailListener(const ConnectionListener& listener) override;
+  void SetReconnectingListener(const ConnectionListener& listener) override;
+  void SetCloseListener(const ConnectionListener& listener) override;
+  void SetReconnectAttempts(int attempts) override;
+  void SetReconnectDelay(const ReconnectDelayFunction& delay) override;
+  void On(const std::string& event,
+          const sio::socket::event_listener_aux& listener) override;
+  void Connect(const std::string& uri) override;
+  void Emit(const std::string& name,
+            const sio::message::list& message,
+            const AckListener& ack) override;
+  void Close() override;
+  bool Opened() const override;
+ private:
+  // Sets the delay sio::client waits before reconnection attempt |attempt|.
+  void ScheduleReconnectDelay(unsigned attempt);
+  ConnectionListener open_listener_;
+  ReconnectDelayFunction reconnect_delay_;
+  // Must be the last member, as its thread invokes listeners which use other
+  // members until it is destroyed.
+  std::unique_ptr<sio::client> client_;
+};
+}  // namespace conference
+}  // namespace owt
+#endif  // OWT_CONFERENCE_SIOSIGNALINGTRANSPORT_H_
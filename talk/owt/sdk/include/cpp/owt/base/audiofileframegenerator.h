@@ -0,0 +1,52 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOFILEFRAMEGENERATOR_H_
+#define OWT_BASE_AUDIOFILEFRAMEGENERATOR_H_
+#include <memory>
+#include <string>
+#include "owt/base/framegeneratorinterface.h"
+namespace owt {
+namespace base {
+/**
+ @brief Creates audio frame generators which play a PCM file in a loop.
+ @details The file is memory-mapped, and the mapping is shared by all
+ generators reading the same file, so many streams can play it at different
+ offsets with little memory and CPU cost. Audio loops without gap at the end of
+ the file. Frames are handed to SDK in place instead of being copied.
+*/
+class AudioFileFrameGenerator {
+ public:
+  /**
+   @brief Create a generator for a WAV file.
+   @details 16 bit integer and 32 bit float PCM WAV files are supported.
+   @param path Path of the WAV file.
+   @param start_offset_ms Position where the generator starts to play, in
+   milliseconds. It wraps around if it is longer than the file.
+   @return The generator, or nullptr if the file cannot be opened or its format
+   is not supported.
+   */
+  static std::unique_ptr<AudioFrameGeneratorInterface> CreateFromWavFile(
+      const std::string& path,
+      int start_offset_ms = 0);
+  /**
+   @brief Create a generator for a headerless PCM file.
+   @param path Path of the PCM file.
+   @param format Sample format of the file.
+   @param sample_rate Sample rate of the file. It must be a multiple of 100.
+   @param channel_number Number of interleaved channels of the file.
+   @param start_offset_ms Position where the generator starts to play, in
+   milliseconds. It wraps around if it is longer than the file.
+   @return The generator, or nullptr if the file cannot be opened or the
+   format is not supported.
+   */
+  static std::unique_ptr<AudioFrameGeneratorInterface> CreateFromRawFile(
+      const std::string& path,
+      AudioSampleFormat format,
+      int sample_rate,
+      int channel_number,
+      int start_offset_ms = 0);
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOFILEFRAMEGENERATOR_H_
@@ -0,0 +1,36 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOFRAMESINKINTERFACE_H_
+#define OWT_BASE_AUDIOFRAMESINKINTERFACE_H_
+#include "stdint.h"
+namespace owt {
+namespace base {
+/**
+ @brief Frame sink interface for audio.
+ @details It is the playout counterpart of AudioFrameGeneratorInterface. SDK
+ invokes it every 10ms with the mix of all decoded remote audio, so audio can
+ be consumed without an audio output device. Sample rate and channel numbers
+ cannot be changed once the sink is created. Only 16 bit little-endian PCM is
+ supported.
+*/
+class AudioFrameSinkInterface {
+ public:
+  /**
+   @brief Consume frames of the last 10ms.
+   @details It is invoked on SDK's playout thread. Implementations should
+   return quickly, otherwise playout falls behind.
+   @param buffer Points to the start address of frame data. The memory is
+   owned by SDK and only valid during this call.
+   @param size Size of frame data in bytes.
+   */
+  virtual void OnFramesFor10Ms(const uint8_t* buffer, const uint32_t size) = 0;
+  /// Get sample rate of frames expected by the sink.
+  virtual int GetSampleRate() = 0;
+  /// Get numbers of channel of frames expected by the sink.
+  virtual int GetChannelNumber() = 0;
+  virtual ~AudioFrameSinkInterface() {}
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOFRAMESINKINTERFACE_H_
@@ -0,0 +1,35 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_BASE_AUDIOLEVELOBSERVERINTERFACE_H_
+#define OWT_BASE_AUDIOLEVELOBSERVERINTERFACE_H_
+namespace owt {
+namespace base {
+/// Level of captured audio over a metering interval.
+struct AudioLevel {
+  /// RMS level in dBFS, in range [-127, 0].
+  int rms_dbfs = -127;
+  /// Level of the loudest sample in dBFS, in range [-127, 0].
+  int peak_dbfs = -127;
+  /// Whether voice is detected in the interval.
+  bool voice_active = false;
+};
+/**
+ @brief Observer of captured audio level.
+ @details Level is measured on audio capturing thread for each 10ms chunk, and
+ reported once per metering interval, so it can drive UI and active speaker
+ logic without polling statistics.
+*/
+class AudioLevelObserverInterface {
+ public:
+  /**
+   @brief Invoked with audio level of the last metering interval.
+   @details It is invoked on SDK's audio capturing thread. Implementations
+   should return quickly and must not block, otherwise capturing falls behind.
+   */
+  virtual void OnAudioLevel(const AudioLevel& level) = 0;
+  virtual ~AudioLevelObserverInterface() {}
+};
+}  // namespace base
+}  // namespace owt
+#endif  // OWT_BASE_AUDIOLEVELOBSERVERINTERFACE_H_
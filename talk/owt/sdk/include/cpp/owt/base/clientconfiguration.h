@@ -13,7 +13,8 @@ namespace base{
 struct ClientConfiguration {
   enum class CandidateNetworkPolicy : int { kAll = 1, kLowCost };
   ClientConfiguration()
-       : candidate_network_policy(CandidateNetworkPolicy::kAll) {};
+       : candidate_network_policy(CandidateNetworkPolicy::kAll),
+         ice_restart_on_network_change(false) {};
   /// List of ICE servers
   std::vector<IceServer> ice_servers;
   /**
@@ -23,6 +24,13 @@ struct ClientConfiguration {
    network experience. Default policy is collecting all candidates.
    */
   CandidateNetworkPolicy candidate_network_policy;
+  /**
+   @brief Restart ICE when local network addresses or routes change.
+   @details It recovers connections quickly after network handovers, e.g. from
+   Wi-Fi to Ethernet, instead of waiting for ICE to time out. It only works on
+   iOS and Linux. Remote endpoints must support ICE restart. Default is false.
+   */
+  bool ice_restart_on_network_change;
 };
 }
 }
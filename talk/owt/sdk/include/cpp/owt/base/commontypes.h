@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef OWT_BASE_COMMONTYPES_H_
 #define OWT_BASE_COMMONTYPES_H_
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -142,6 +143,31 @@ struct EnumClassHash {
     return static_cast<std::size_t>(t);
   }
 };
+/**
+ @brief Statistics of the threads running callbacks and observer events.
+ @details Callbacks and events of all clients in a process share 2 to 4
+ threads, depending on the number of CPUs. High queue latency means
+ callbacks run too long, or block.
+*/
+struct CallbackExecutorStats {
+  CallbackExecutorStats()
+      : threads(0),
+        tasks_run(0),
+        tasks_stolen(0),
+        average_queue_latency_us(0),
+        max_queue_latency_us(0) {}
+  /// Number of threads.
+  size_t threads;
+  /// Callbacks and events run.
+  uint64_t tasks_run;
+  /// Callbacks and events run by another thread than the one they were
+  /// queued to, because that thread was busy.
+  uint64_t tasks_stolen;
+  /// Time from queuing a callback or an event to running it, in
+  /// microseconds.
+  int64_t average_queue_latency_us;
+  int64_t max_queue_latency_us;
+};
 }  // namespace base
 }  // namespace owt
 #endif  // OWT_BASE_COMMONTYPES_H_
@@ -29,7 +29,8 @@ enum class ExceptionType : int {
   kConferenceInvalidParam,
   kConferenceNotSupported,
   kConferenceInvalidToken,
-  kConferenceInvalidSession
+  kConferenceInvalidSession,
+  kConferenceTimeout
 };
 /// Class for exceptions
 class Exception {
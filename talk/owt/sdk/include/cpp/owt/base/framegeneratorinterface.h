@@ -6,10 +6,19 @@
 #include "stdint.h"
 namespace owt {
 namespace base {
+/// Sample format of PCM audio frames.
+enum class AudioSampleFormat : int {
+  kInt16 = 1,  ///< Interleaved 16 bit little-endian integer.
+  kFloat32,    ///< Interleaved 32 bit float in range [-1, 1].
+};
 /**
  @brief frame generator interface for audio
- @details Sample rate and channel numbers cannot be changed once the generator is
- created. Currently, only 16 bit little-endian PCM is supported.
+ @details Sample rate, channel numbers and sample format cannot be changed once
+ the generator is created. Frames can be 16 bit integer or 32 bit float PCM,
+ at any sample rate which is a multiple of 100Hz and with any number of
+ channels. SDK converts them to the format used by WebRTC on its capturing
+ thread, so applications do not need to convert or resample them. Audio with
+ more than 2 channels is downmixed to mono.
 */
 class AudioFrameGeneratorInterface {
  public:
@@ -28,8 +37,68 @@ class AudioFrameGeneratorInterface {
   virtual int GetSampleRate() = 0;
   /// Get numbers of channel for frames generated.
   virtual int GetChannelNumber() = 0;
+  /// Get sample format for frames generated. Default is 16 bit integer.
+  virtual AudioSampleFormat GetSampleFormat() {
+    return AudioSampleFormat::kInt16;
+  }
+  /**
+   @brief Get frames for next 10ms without copying them.
+   @details Generators which already hold audio in memory can return a pointer
+   to it, so SDK reads it in place. If it returns nullptr, SDK calls
+   GenerateFramesForNext10Ms instead.
+   @param size Size of frame data expected in bytes.
+   @return Pointer to |size| bytes of frame data, which is owned by generator
+   and valid until next call, or nullptr if it is not supported.
+   */
+  virtual const uint8_t* ReadFramesForNext10Ms(const uint32_t size) {
+    return nullptr;
+  }
   virtual ~AudioFrameGeneratorInterface(){};
 };
+/// Counters of a push mode audio input.
+struct AudioFrameWriterStats {
+  /// Number of 10ms chunks replaced by silence because not enough audio was
+  /// buffered.
+  uint64_t underruns = 0;
+  /// Number of writes dropped because the buffer was full.
+  uint64_t overruns = 0;
+  /// Duration of buffered audio dropped to stay below the maximum latency.
+  uint64_t dropped_ms = 0;
+  /// Duration of audio currently buffered.
+  int buffered_ms = 0;
+};
+/**
+ @brief Writer for push mode audio input.
+ @details Instead of being pulled every 10ms, audio is written by the
+ application in packets of any duration, e.g. 20ms or 40ms packets received
+ from network. Data is buffered in a lock-free ring buffer and consumed every
+ 10ms by SDK's capturing thread. Only 16 bit little-endian PCM is supported.
+ WriteFrames must not be called by more than one thread at the same time.
+*/
+class AudioFrameWriterInterface {
+ public:
+  /**
+   @brief Write audio frames.
+   @param buffer Points to the start address of frame data.
+   @param size Size of frame data in bytes. It must be a multiple of
+   channel number * 2.
+   @return false if data is not accepted because buffer is full or |size| is
+   invalid.
+   */
+  virtual bool WriteFrames(const uint8_t* buffer, const uint32_t size) = 0;
+  /// Get sample rate of frames to be written.
+  virtual int GetSampleRate() = 0;
+  /// Get numbers of channel of frames to be written.
+  virtual int GetChannelNumber() = 0;
+  /// Get the amount of audio buffered before it starts to be consumed.
+  virtual int GetTargetLatencyMs() = 0;
+  /// Get the maximum amount of audio buffered. Older audio is dropped when
+  /// buffer grows beyond it.
+  virtual int GetMaxLatencyMs() = 0;
+  /// Get counters of the writer.
+  virtual AudioFrameWriterStats GetStats() = 0;
+  virtual ~AudioFrameWriterInterface() {}
+};
 /**
  @brief frame generator interface for users to generates frame.
  FrameGeneratorInterface is the virtual class to implement its own frame generator.
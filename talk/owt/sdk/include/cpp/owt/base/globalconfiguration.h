@@ -4,6 +4,9 @@
 #ifndef OWT_BASE_GLOBALCONFIGURATION_H_
 #define OWT_BASE_GLOBALCONFIGURATION_H_
 #include <memory>
+#include <vector>
+#include "owt/base/audioframesinkinterface.h"
+#include "owt/base/audiolevelobserverinterface.h"
 #include "owt/base/framegeneratorinterface.h"
 #if defined(WEBRTC_WIN) || defined(WEBRTC_LINUX)
 #include "owt/base/videodecoderinterface.h"
@@ -39,6 +42,42 @@ struct AudioProcessingSettings {
   bool AEC3Enabled;
 };
 /** @endcond */
+/// Scheduling priority of threads.
+enum class ThreadPriority : int {
+  kLow = 1,
+  kNormal,
+  kHigh,
+  kRealtime,
+};
+/**
+ @brief Threads of PeerConnection factories.
+ @details A factory runs its PeerConnections' media on one worker thread and
+ their packets on one network thread. With more than one factory shard,
+ subscriptions in conference mode are assigned to shards in turn, so a client
+ with many streams can use more than one core. Local streams and other
+ PeerConnections always use the first shard. So do all PeerConnections if
+ customized audio or customized video decoder is enabled, as they only apply
+ to the first shard. Other shards are destroyed after all ConferenceClient
+ instances are destroyed and their PeerConnections are closed.
+*/
+struct PeerConnectionThreadingSettings {
+  PeerConnectionThreadingSettings()
+      : factory_shards(1),
+        worker_thread_priority(ThreadPriority::kNormal),
+        network_thread_priority(ThreadPriority::kNormal) {}
+  /// Number of factories. Default is 1.
+  int factory_shards;
+  /// CPUs worker threads run on. Worker thread of shard i runs on
+  /// worker_thread_cpus[i % size]. Empty means any CPU. Ignored on iOS.
+  std::vector<int> worker_thread_cpus;
+  /// CPUs network threads run on, in the same way as |worker_thread_cpus|.
+  std::vector<int> network_thread_cpus;
+  /// Priority of worker threads. Priorities higher than normal may require
+  /// privileges on Linux.
+  ThreadPriority worker_thread_priority;
+  /// Priority of network threads.
+  ThreadPriority network_thread_priority;
+};
 /**
  @brief configuration of global using.
  GlobalConfiguration class of setting for encoded frame and hardware accecleartion configuration.
@@ -71,7 +110,10 @@ class GlobalConfiguration {
    @brief This function sets the audio input to be an instance of
    AudioFrameGeneratorInterface.
    @details When it is enabled, SDK will not capture audio from mic. This means
-   you cannot create LocalStream other than LocalCustomizedStream.
+   you cannot create LocalStream other than LocalCustomizedStream. If it is
+   enabled with a null |audio_frame_generator|, no audio is captured by audio
+   device at all. Use this mode when each LocalStream gets its own
+   AudioFrameGeneratorInterface, so microphone audio is not mixed into them.
    @param enabled Customized audio input is enabled or not.
    @param audio_frame_generator An implementation which feeds audio frames to
    SDK.
@@ -79,12 +121,74 @@ class GlobalConfiguration {
   static void SetCustomizedAudioInputEnabled(
       bool enabled,
       std::unique_ptr<AudioFrameGeneratorInterface> audio_frame_generator) {
+      audio_frame_writer_.reset();
+      customized_audio_input_enabled_ = enabled;
       if (enabled) {
           audio_frame_generator_ = std::move(audio_frame_generator);
       } else {
           audio_frame_generator_.reset(nullptr);
       }
   }
+  /**
+   @brief This function enables push mode customized audio input.
+   @details Like SetCustomizedAudioInputEnabled, SDK will not capture audio
+   from mic. Instead of pulling from an AudioFrameGeneratorInterface every
+   10ms, SDK consumes audio written to the returned writer. It replaces any
+   audio frame generator set before. Call SetCustomizedAudioInputEnabled(false,
+   nullptr) to disable it.
+   @param sample_rate Sample rate of audio to be written. It must be a multiple
+   of 100.
+   @param channel_number Number of channels of audio to be written.
+   @param target_latency_ms Amount of audio buffered before SDK starts to
+   consume it, at start and after each underrun.
+   @param max_latency_ms Maximum amount of audio buffered. Older audio is
+   dropped when buffer grows beyond it.
+   @return The writer application writes audio frames to.
+   */
+  static std::shared_ptr<AudioFrameWriterInterface>
+  EnableCustomizedAudioPushInput(int sample_rate,
+                                 int channel_number,
+                                 int target_latency_ms = 20,
+                                 int max_latency_ms = 200);
+  /**
+   @brief This function sets the audio output to be an instance of
+   AudioFrameSinkInterface.
+   @details When it is enabled, SDK will not play audio with speaker. Mixed
+   audio of all remote streams is handed to |audio_frame_sink| every 10ms
+   instead, so no audio device is required. If customized audio input is not
+   enabled at the same time, SDK will not capture audio from mic either.
+   @param enabled Customized audio output is enabled or not.
+   @param audio_frame_sink An implementation which consumes audio frames from
+   SDK.
+   */
+  static void SetCustomizedAudioOutputEnabled(
+      bool enabled,
+      std::unique_ptr<AudioFrameSinkInterface> audio_frame_sink) {
+    if (enabled) {
+      audio_frame_sink_ = std::move(audio_frame_sink);
+    } else {
+      audio_frame_sink_.reset(nullptr);
+    }
+  }
+  /**
+   @brief This function sets the observer of customized audio input level.
+   @details Level and voice activity of audio from customized audio input are
+   measured on SDK's capturing thread and reported every |interval_ms|, so
+   application does not need to poll statistics for them. It only takes
+   effect for customized audio input, and must be called before creating any
+   stream or client. Streams with their own audio frame generator are metered
+   by the observer passed to LocalStream::Create instead.
+   @param observer Observer of audio level. It must outlive SDK. Pass nullptr
+   to stop metering.
+   @param interval_ms Interval between two reports in milliseconds. It is
+   rounded down to a multiple of 10.
+   */
+  static void SetCustomizedAudioLevelObserver(
+      AudioLevelObserverInterface* observer,
+      int interval_ms = 100) {
+    audio_level_observer_ = observer;
+    audio_level_interval_ms_ = interval_ms;
+  }
 #if defined(WEBRTC_WIN) || defined(WEBRTC_LINUX)
   /**
    @brief This function sets the customized video decoder to decode the encoded images.
@@ -127,6 +231,15 @@ class GlobalConfiguration {
   static void SetNSEnabled(bool enabled) {
     audio_processing_settings_.NSEnabled = enabled;
   }
+  /**
+  @brief This function sets threads of PeerConnection factories.
+  @details It must be called before creating any stream or client.
+  @param settings Threading settings.
+  */
+  static void SetPeerConnectionThreadingSettings(
+      const PeerConnectionThreadingSettings& settings) {
+    threading_settings_ = settings;
+  }
  private:
   GlobalConfiguration() {}
   virtual ~GlobalConfiguration() {}
@@ -152,7 +265,15 @@ class GlobalConfiguration {
    @return true or false.
    */
   static bool GetCustomizedAudioInputEnabled() {
-    return audio_frame_generator_ ? true : false;
+    return customized_audio_input_enabled_;
+  }
+  /**
+   @brief This function gets whether the customized audio output is enabled or
+   not.
+   @return true or false.
+   */
+  static bool GetCustomizedAudioOutputEnabled() {
+    return audio_frame_sink_ ? true : false;
   }
   /**
    @brief This function gets whether auto echo cancellation is enabled or not.
@@ -188,13 +309,36 @@ class GlobalConfiguration {
   static std::unique_ptr<AudioFrameGeneratorInterface> GetAudioFrameGenerator(){
     return std::move(audio_frame_generator_);
   }
+  /**
+   @brief This function returns push mode audio input writer.
+   */
+  static std::shared_ptr<AudioFrameWriterInterface> GetAudioFrameWriter() {
+    return audio_frame_writer_;
+  }
+  /**
+   @brief This function returns audio frame sink.
+   */
+  static std::unique_ptr<AudioFrameSinkInterface> GetAudioFrameSink() {
+    return std::move(audio_frame_sink_);
+  }
+  static AudioLevelObserverInterface* GetAudioLevelObserver() {
+    return audio_level_observer_;
+  }
+  static int GetAudioLevelIntervalMs() {
+    return audio_level_interval_ms_;
+  }
   // Encoded video frame flag.
    /**
    * Default is false. If it is set to true, only streams with encoded frame can
    * be published.
    */
   static bool encoded_frame_;
+  static bool customized_audio_input_enabled_;
   static std::unique_ptr<AudioFrameGeneratorInterface> audio_frame_generator_;
+  static std::shared_ptr<AudioFrameWriterInterface> audio_frame_writer_;
+  static std::unique_ptr<AudioFrameSinkInterface> audio_frame_sink_;
+  static AudioLevelObserverInterface* audio_level_observer_;
+  static int audio_level_interval_ms_;
 #if defined(WEBRTC_WIN) || defined(WEBRTC_LINUX)
   /**
    @brief This function returns flag indicating whether customized video decoder is enabled or not
@@ -216,6 +360,10 @@ class GlobalConfiguration {
   static std::unique_ptr<VideoDecoderInterface> video_decoder_;
 #endif
   static AudioProcessingSettings audio_processing_settings_;
+  static const PeerConnectionThreadingSettings& GetThreadingSettings() {
+    return threading_settings_;
+  }
+  static PeerConnectionThreadingSettings threading_settings_;
 };
 }
 }
@@ -31,6 +31,8 @@ class MediaConstraintsImpl;
 class CustomizedFramesCapturer;
 class BasicDesktopCapturer;
 class VideoFrameGeneratorInterface;
+class AudioFrameGeneratorInterface;
+class AudioLevelObserverInterface;
 #if defined(WEBRTC_MAC)
 class ObjcVideoCapturerInterface;
 #endif
@@ -204,6 +206,33 @@ class LocalStream : public Stream {
   static std::shared_ptr<LocalStream> Create(
       std::shared_ptr<LocalCustomizedStreamParameters> parameters,
       std::unique_ptr<VideoFrameGeneratorInterface> framer);
+  /**
+    @brief Initialize a LocalCustomizedStream with its own audio frame generator.
+    @details Audio of this stream is pulled from |audio_generator| instead of
+    audio device, so different streams can carry different audio. Call
+    GlobalConfiguration::SetCustomizedAudioInputEnabled(true, nullptr) before
+    creating any stream if microphone audio should not be mixed in.
+    @param parameters Parameters for creating the stream. The stream will not
+    be impacted if changing parameters after it is created.
+    @param audio_generator Pointer to an instance implemented
+    AudioFrameGeneratorInterface. This instance will be destroyed by SDK when
+    stream is closed.
+    @param video_generator Pointer to an instance implemented
+    VideoFrameGeneratorInterface. It can be nullptr if video is not enabled.
+    @param audio_level_observer Observer of level of audio from
+    |audio_generator|. It is invoked on SDK's audio pacing thread every
+    |audio_level_interval_ms|, and must outlive the stream. It can be nullptr.
+    @param audio_level_interval_ms Interval between two level reports in
+    milliseconds. It is rounded down to a multiple of 10.
+    @return Pointer to created LocalStream, or nullptr if audio is enabled
+    but |audio_generator| is nullptr or its format is not supported.
+  */
+  static std::shared_ptr<LocalStream> Create(
+      std::shared_ptr<LocalCustomizedStreamParameters> parameters,
+      std::unique_ptr<AudioFrameGeneratorInterface> audio_generator,
+      std::unique_ptr<VideoFrameGeneratorInterface> video_generator,
+      AudioLevelObserverInterface* audio_level_observer = nullptr,
+      int audio_level_interval_ms = 100);
   /**
     @briefInitialize a local customized stream with parameters and encoder interface.
     @details The input of the video stream MUST be encoded frame if initializing with
@@ -238,6 +267,13 @@ class LocalStream : public Stream {
      explicit LocalStream(
          std::shared_ptr<LocalCustomizedStreamParameters> parameters,
          std::unique_ptr<VideoFrameGeneratorInterface> framer);
+     explicit LocalStream(
+         std::shared_ptr<LocalCustomizedStreamParameters> parameters,
+         std::unique_ptr<AudioFrameGeneratorInterface> audio_generator,
+         std::unique_ptr<VideoFrameGeneratorInterface> video_generator,
+         AudioLevelObserverInterface* audio_level_observer,
+         int audio_level_interval_ms,
+         int& error_code);
      explicit LocalStream(
          std::shared_ptr<LocalCustomizedStreamParameters> parameters,
          VideoEncoderInterface* encoder);
@@ -4,6 +4,7 @@
 #ifndef OWT_CONFERENCE_CONFERENCECLIENT_H_
 #define OWT_CONFERENCE_CONFERENCECLIENT_H_
 #include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -28,6 +29,8 @@ namespace webrtc{
 namespace owt {
 namespace base {
   struct PeerConnectionChannelConfiguration;
+  class PeerConnectionPool;
+  class TaskSequence;
 }
 }
 namespace owt {
@@ -40,9 +43,145 @@ using namespace owt::base;
   Changing this configuration does NOT impact ConferenceClient already
   created.
 */
-struct ConferenceClientConfiguration : ClientConfiguration {};
+struct ConferenceClientConfiguration : ClientConfiguration {
+  ConferenceClientConfiguration()
+      : batch_notifications(false),
+        notification_batch_window_ms(50),
+        max_notification_batch_size(500),
+        signaling_timeout_ms(30000),
+        max_pending_signaling_requests(64),
+        session_grace_period_ms(0),
+        multiplex_subscriptions(false),
+        peer_connection_pool_low_watermark(0),
+        peer_connection_pool_high_watermark(0),
+        ice_candidate_batch_window_ms(0) {}
+  /**
+   @brief Deliver participant joined and stream added events in batches.
+   @details When it is true, ConferenceClientObserver::OnParticipantsJoined and
+   ConferenceClientObserver::OnStreamsAdded are triggered instead of
+   OnParticipantJoined and OnStreamAdded. It reduces the number of callbacks
+   when many participants join or publish at the same time, e.g. when a large
+   conference starts. Default is false.
+   */
+  bool batch_notifications;
+  /// Events happened within this time after the first event of a batch are
+  /// delivered together.
+  int notification_batch_window_ms;
+  /// Maximum number of participants or streams delivered in one callback.
+  /// A batch is delivered without waiting for the window once it is full.
+  size_t max_notification_batch_size;
+  /**
+   @brief Time to wait for conference server's response to a request, in
+   milliseconds.
+   @details A request without response in time fails with
+   ExceptionType::kConferenceTimeout. 0 means waiting forever. Default is 30
+   seconds.
+   */
+  int signaling_timeout_ms;
+  /**
+   @brief Maximum number of requests waiting for conference server's response.
+   @details Further requests are queued, and sent in order when responses
+   arrive, so an overloaded server is not flooded. 0 means no limit. Default
+   is 64.
+   */
+  size_t max_pending_signaling_requests;
+  /**
+   @brief Time to keep the session after ConferenceClient::Leave, in
+   milliseconds.
+   @details Connection to conference server and conference state are kept for
+   this period. Joining a conference on the same server in this period takes a
+   single round trip, and ConferenceInfo is updated with changes instead of
+   being rebuilt, so existing RemoteStream and Participant instances remain
+   valid. 0 closes the session on Leave. Default is 0.
+   */
+  int session_grace_period_ms;
+  /**
+   @brief Carry subscriptions over a single PeerConnection.
+   @details When it is true, subscriptions share one PeerConnection, so
+   subscribing many streams does not create a PeerConnection, an ICE agent and
+   a DTLS handshake for each of them. It requires conference server's support
+   for sharing transports. Otherwise, or if codecs are specified in
+   SubscribeOptions, a PeerConnection is created for each subscription.
+   Publications are not affected. Default is false.
+   */
+  bool multiplex_subscriptions;
+  /**
+   @brief Number of idle PeerConnections below which the pool is refilled.
+   @details PeerConnections for subscriptions are created and gather ICE
+   candidates ahead of demand after ConferenceClient::Join is called, so
+   subscribing doesn't wait for them. The pool is refilled to
+   |peer_connection_pool_high_watermark| when it has fewer idle
+   PeerConnections than this value. Default is 0.
+   */
+  size_t peer_connection_pool_low_watermark;
+  /// Number of idle PeerConnections kept in the pool. 0 disables the pool.
+  /// Default is 0.
+  size_t peer_connection_pool_high_watermark;
+  /**
+   @brief Time to collect ICE candidates for one signaling message, in
+   milliseconds.
+   @details Candidates gathered in this window, and those gathered before
+   negotiation completes, are sent to conference server in a single
+   "candidates" message with end-of-candidates. Candidates are sent one by
+   one if server rejects such messages. 0 sends a message for each
+   candidate. Default is 0.
+   */
+  int ice_candidate_batch_window_ms;
+};
+/// Summary of samples of a measurement.
+struct SampleStats {
+  /// Number of samples.
+  uint64_t count = 0;
+  /// Sum of samples.
+  int64_t sum = 0;
+  /// Smallest and largest sample. 0 if there is no sample.
+  int64_t min = 0;
+  int64_t max = 0;
+};
+/// Statistics of a ConferenceClient since it was created.
+struct ConferenceClientStats {
+  /// Time from subscribing to the first decoded video frame in milliseconds,
+  /// for subscriptions with a PeerConnection taken from the pool, and created
+  /// on demand. Subscriptions sharing a PeerConnection are not measured.
+  SampleStats time_to_first_frame_pooled_ms;
+  SampleStats time_to_first_frame_unpooled_ms;
+  /// Time from the first offer of a PeerConnection to ICE connected in
+  /// milliseconds.
+  SampleStats time_to_connect_ms;
+  /// ICE candidate messages sent by a PeerConnection before ICE is connected.
+  SampleStats ice_candidate_messages;
+  /// Number of idle PeerConnections in the pool.
+  size_t pooled_peer_connections = 0;
+  /// Threads running callbacks of all clients in the process.
+  CallbackExecutorStats callback_executor;
+};
+/// A stream to be published by ConferenceClient::PublishBatch.
+struct PublishRequest {
+  std::shared_ptr<LocalStream> stream;
+  PublishOptions options;
+};
+/// Result of a publication made by ConferenceClient::PublishBatch.
+struct PublishResult {
+  /// The publication, or nullptr if publishing failed.
+  std::shared_ptr<ConferencePublication> publication;
+  /// Reason of the failure, or nullptr if publishing succeeded.
+  std::shared_ptr<const Exception> exception;
+};
+/// A stream to be subscribed by ConferenceClient::SubscribeBatch.
+struct SubscribeRequest {
+  std::shared_ptr<RemoteStream> stream;
+  SubscribeOptions options;
+};
+/// Result of a subscription made by ConferenceClient::SubscribeBatch.
+struct SubscribeResult {
+  /// The subscription, or nullptr if subscribing failed.
+  std::shared_ptr<ConferenceSubscription> subscription;
+  /// Reason of the failure, or nullptr if subscribing succeeded.
+  std::shared_ptr<const Exception> exception;
+};
 class RemoteMixedStream;
 class ConferencePeerConnectionChannel;
+class ConferenceSharedPeerConnectionChannel;
 class ConferenceSocketSignalingChannel;
 /**
   @brief Observer interface for participant
@@ -58,6 +197,7 @@ class ParticipantObserver {
 };
 /// Participant represents one conference client in a conference room.
 class Participant {
+  friend class ConferenceClient;
   friend class ConferenceInfo;
   public:
     Participant(std::string id, std::string role, std::string user_id)
@@ -102,12 +242,28 @@ class ConferenceInfo {
     virtual ~ConferenceInfo() {}
     /// Current remote streams in the conference.
     std::vector<std::shared_ptr<RemoteStream>> RemoteStreams() const {
-      return remote_streams_;
+      return *RemoteStreamsSnapshot();
     }
+    /**
+      @brief Current remote streams in the conference.
+      @details The returned list is never modified, so it can be kept and
+      shared without copying. Changes of the conference are reflected in lists
+      returned afterwards.
+    */
+    std::shared_ptr<const std::vector<std::shared_ptr<RemoteStream>>>
+    RemoteStreamsSnapshot() const;
     /// Current participant list in the conference.
     std::vector<std::shared_ptr<Participant>> Participants() const {
-      return participants_;
+      return *ParticipantsSnapshot();
     }
+    /**
+      @brief Current participant list in the conference.
+      @details The returned list is never modified, so it can be kept and
+      shared without copying. Changes of the conference are reflected in lists
+      returned afterwards.
+    */
+    std::shared_ptr<const std::vector<std::shared_ptr<Participant>>>
+    ParticipantsSnapshot() const;
     /// Conference ID.
     std::string Id() const { return id_; }
     /// The participant info of current conference client.
@@ -132,13 +288,29 @@ class ConferenceInfo {
     // Trigger stream mute/unmute events
     void TriggerOnStreamMuteOrUnmute(const std::string& stream_id, owt::base::TrackKind track_kind, bool muted); 
   private:
-    bool ParticipantPresent(const std::string& participant_id);
-    bool RemoteStreamPresent(const std::string& stream_id);
+    // Participant or remote stream with |id|, or null if it is not present.
+    std::shared_ptr<Participant> FindParticipant(const std::string& id) const;
+    std::shared_ptr<RemoteStream> FindRemoteStream(const std::string& id) const;
     std::string id_;                           // Unique id that identifies the conference.
+    // Participants and remote streams are kept in lists in the order they are
+    // added, and indexed by ID. Snapshots returned to applications are built
+    // from lists when they are requested after a change, and are reset by
+    // changes. Mutexes are only held for constant time operations and
+    // snapshot building, never during observer callbacks.
     mutable std::mutex participants_mutex_;
-    std::vector<std::shared_ptr<Participant>> participants_;    // Participants in the conference
+    std::list<std::shared_ptr<Participant>> participants_;    // Participants in the conference
+    std::unordered_map<std::string,
+                       std::list<std::shared_ptr<Participant>>::iterator>
+        participant_index_;
+    mutable std::shared_ptr<const std::vector<std::shared_ptr<Participant>>>
+        participants_snapshot_;
     mutable std::mutex remote_streams_mutex_;
-    std::vector<std::shared_ptr<RemoteStream>> remote_streams_; // Remote streams in the conference.
+    std::list<std::shared_ptr<RemoteStream>> remote_streams_; // Remote streams in the conference.
+    std::unordered_map<std::string,
+                       std::list<std::shared_ptr<RemoteStream>>::iterator>
+        remote_stream_index_;
+    mutable std::shared_ptr<const std::vector<std::shared_ptr<RemoteStream>>>
+        remote_streams_snapshot_;
     std::shared_ptr<Participant> self_;                           // Self participant in the conference.
 };
 /** @cond */
@@ -158,6 +330,9 @@ class ConferenceSocketSignalingChannelObserver {
   virtual void OnStreamId(const std::string& id, const std::string& label) = 0;
   virtual void OnSubscriptionId(const std::string& subscription_id,
                                 const std::string& stream_id) = 0;
+  // Triggered with current room info after reconnected, if server advertised
+  // roomResync capability on login.
+  virtual void OnRoomResync(std::shared_ptr<sio::message> room_info) = 0;
 };
 // ConferencePeerConnectionChannel callback interface.
 // Usually, ConferenceClient should implement these methods and notify
@@ -170,6 +345,10 @@ class ConferencePeerConnectionChannelObserver {
   virtual void OnStreamError(
       std::shared_ptr<Stream> stream,
       std::shared_ptr<const Exception> exception) = 0;
+  // Triggered when the first video frame of a subscription is decoded.
+  virtual void OnFirstFrame(int elapsed_ms, bool pooled) {}
+  // Triggered when ICE is connected for the first time.
+  virtual void OnConnected(int elapsed_ms, int candidate_messages) {}
 };
 /** @endcond */
 /// Observer for OWTConferenceClient.
@@ -202,13 +381,35 @@ class ConferenceClientObserver {
     @param user The user joined.
   */
   virtual void OnParticipantJoined(std::shared_ptr<Participant>){};
+  /**
+    @brief Triggers when participants joined conference, if
+    ConferenceClientConfiguration::batch_notifications is true.
+    @param participants The participants joined, in the order they joined.
+  */
+  virtual void OnParticipantsJoined(
+      std::vector<std::shared_ptr<Participant>> participants){};
+  /**
+    @brief Triggers when streams are added, if
+    ConferenceClientConfiguration::batch_notifications is true.
+    @param streams The streams added, in the order they were added. Mixed
+    streams are RemoteMixedStream instances.
+  */
+  virtual void OnStreamsAdded(
+      std::vector<std::shared_ptr<RemoteStream>> streams){};
   /**
     @brief Triggers when server is disconnected.
   */
   virtual void OnServerDisconnected(){};
 };
 
-/// An asynchronous class for app to communicate with a conference in MCU.
+/**
+  @brief An asynchronous class for app to communicate with a conference in MCU.
+  @details Callbacks and observer events of all clients run on a shared pool
+  of 2 to 4 threads. They should return quickly. A callback blocking on
+  another one, e.g. waiting for a callback of another client, holds a thread
+  of the pool, and a few of them starve all clients. Queue latency of the
+  pool is reported by GetClientStats.
+*/
 class ConferenceClient final
     : ConferenceSocketSignalingChannelObserver,
       ConferencePeerConnectionChannelObserver,
@@ -281,6 +482,28 @@ class ConferenceClient final
       const SubscribeOptions& options,
       std::function<void(std::shared_ptr<ConferenceSubscription>)> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure);
+  /**
+    @brief Publish several streams to the current room.
+    @details A convenience wrapper which calls Publish for each request, and
+    collects their results into one callback.
+    @param requests Streams to be published and their options.
+    @param on_complete Invoked once all publications succeed or fail, with
+    results in the order of |requests|.
+  */
+  void PublishBatch(
+      const std::vector<PublishRequest>& requests,
+      std::function<void(std::vector<PublishResult>)> on_complete);
+  /**
+    @brief Subscribe several streams from the current room.
+    @details A convenience wrapper which calls Subscribe for each request,
+    and collects their results into one callback.
+    @param requests Streams to be subscribed and their options.
+    @param on_complete Invoked once all subscriptions succeed or fail, with
+    results in the order of |requests|.
+  */
+  void SubscribeBatch(
+      const std::vector<SubscribeRequest>& requests,
+      std::function<void(std::vector<SubscribeResult>)> on_complete);
   /**
     @brief Send messsage to all participants in the conference.
     @param message The message to be sent.
@@ -318,10 +541,13 @@ class ConferenceClient final
                           const std::string& publish_stream_label) override;
   virtual void OnSubscriptionId(const std::string& subscription_id,
                                 const std::string& stream_id) override;
+  virtual void OnRoomResync(std::shared_ptr<sio::message> room_info) override;
   // Implementing ConferencePeerConnectionChannelObserver.
   virtual void OnStreamError(
       std::shared_ptr<Stream> stream,
       std::shared_ptr<const Exception> exception) override;
+  virtual void OnFirstFrame(int elapsed_ms, bool pooled) override;
+  virtual void OnConnected(int elapsed_ms, int candidate_messages) override;
   // Provide access for Publication and Subscription instances.
   /**
     @brief Un-publish the stream from the current room.
@@ -360,6 +586,8 @@ class ConferenceClient final
       std::function<void(
           const std::vector<const webrtc::StatsReport*>& reports)> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure);
+  /// Get statistics of this client, e.g. how long subscriptions take.
+  ConferenceClientStats GetClientStats() const;
   /**
     @brief Mute a session's track specified by |track_kind|.
   */
@@ -401,15 +629,37 @@ class ConferenceClient final
   void TriggerOnStreamAdded(std::shared_ptr<sio::message> stream_info, bool joining = false);
   void TriggerOnStreamRemoved(std::shared_ptr<sio::message> stream_info);
   void TriggerOnStreamUpdated(std::shared_ptr<sio::message> stream_info);
+  // Removes a participant or a remote stream, and returns a function notifying
+  // its observers. RemoveStream returns nullptr if |id| is unknown.
+  std::function<void()> RemoveParticipant(const std::string& participant_id);
+  std::function<void()> RemoveStream(const std::string& id);
+  // Updates participants and remote streams to match |room_info|, keeping
+  // instances of those still present. Joined participants and added streams
+  // are not notified if |joining|. Returns functions notifying participants
+  // left and streams removed, so callers decide when they are triggered.
+  std::vector<std::function<void()>> ApplyRoomInfo(
+      std::shared_ptr<sio::message> room_info,
+      bool joining);
   void TriggerOnStreamError(std::shared_ptr<Stream> stream,
                             std::shared_ptr<const Exception> exception);
   // Return true if |user_info| is correct, and |*participant| points to the participant
   // object
   bool ParseUser(std::shared_ptr<sio::message> user_info, Participant** participant) const;
   void ParseStreamInfo(std::shared_ptr<sio::message> stream_info, bool joining = false);
-  std::unordered_map<std::string, std::string> AttributesFromStreamInfo(
-      std::shared_ptr<sio::message> stream_info);
   std::function<void()> RunInEventQueue(std::function<void()> func);
+  // Notify observers of a joined participant or an added stream, in batches
+  // if notifications are batched.
+  void NotifyParticipantJoined(std::shared_ptr<Participant> participant);
+  void NotifyStreamAdded(std::shared_ptr<RemoteStream> stream,
+                         bool mixed);
+  // Remove a participant or a stream not delivered yet from pending batches.
+  void CancelParticipantJoined(const std::string& participant_id);
+  void CancelStreamAdded(const std::string& stream_id);
+  // Schedule delivery of pending batches in |delay_ms|. Called with
+  // |pending_notifications_mutex_| held.
+  void ScheduleNotificationFlush(int delay_ms);
+  // Deliver pending batches to observers. Runs on |event_queue_|.
+  void FlushNotifications();
   // Check if all characters are base 64 allowed or '='.
   bool IsBase64EncodedString(const std::string str) const;
   /// Add an observer for conferenc client.
@@ -420,7 +670,7 @@ class ConferenceClient final
   ConferenceClientConfiguration configuration_;
   // Queue for callbacks and events. Shared among ConferenceClient and all of
   // it's ConferencePeerConnectionChannel.
-  std::shared_ptr<rtc::TaskQueue> event_queue_;
+  std::shared_ptr<TaskSequence> event_queue_;
   std::shared_ptr<ConferenceSocketSignalingChannel> signaling_channel_;
   std::mutex observer_mutex_;
   bool signaling_channel_connected_;
@@ -435,6 +685,12 @@ class ConferenceClient final
       subscribe_pcs_;
   // Key is subscription ID, value is streamID.
   std::unordered_map<std::string, std::string> subscribe_id_label_map_;
+  // PeerConnection shared by subscriptions if |multiplex_subscriptions| is
+  // enabled.
+  std::shared_ptr<ConferenceSharedPeerConnectionChannel>
+      shared_subscription_channel_;
+  // Idle PeerConnections for subscriptions.
+  std::shared_ptr<PeerConnectionPool> peer_connection_pool_;
   mutable std::mutex subscribe_pcs_mutex_;
   // Key is the stream ID(publication ID or mixed stream ID).
   std::unordered_map<std::string, std::shared_ptr<RemoteStream>>
@@ -448,6 +704,14 @@ class ConferenceClient final
   std::vector<std::reference_wrapper<ConferenceClientObserver>> observers_;
   mutable std::mutex stream_update_observer_mutex_;
   std::vector <std::reference_wrapper<ConferenceStreamUpdateObserver>> stream_update_observers_;
+  // Events waiting to be delivered, if notifications are batched.
+  std::mutex pending_notifications_mutex_;
+  std::vector<std::shared_ptr<Participant>> pending_joined_participants_;
+  std::vector<std::shared_ptr<RemoteStream>> pending_added_streams_;
+  // True if a flush is posted to |event_queue_| and has not started.
+  bool notification_flush_scheduled_;
+  mutable std::mutex client_stats_mutex_;
+  ConferenceClientStats client_stats_;
 };
 }
 }
@@ -9,15 +9,13 @@
 #include "owt/base/mediaconstraints.h"
 #include "owt/base/publication.h"
 #include "owt/conference/streamupdateobserver.h"
-namespace rtc {
-  class TaskQueue;
-}
 namespace webrtc{
   class StatsReport;
 }
 namespace owt {
 namespace base {
 struct ConnectionStats;
+class TaskSequence;
 }
 namespace conference {
 class ConferenceClient;
@@ -62,7 +60,7 @@ class ConferencePublication : public Publication, public ConferenceStreamUpdateO
     mutable std::mutex observer_mutex_;
     std::vector<std::reference_wrapper<PublicationObserver>> observers_;
     std::weak_ptr<ConferenceClient> conference_client_;   // Weak ref to associated conference client
-    std::shared_ptr<rtc::TaskQueue> event_queue_;
+    std::shared_ptr<TaskSequence> event_queue_;
 };
 } // namespace conference
 } // namespace owt
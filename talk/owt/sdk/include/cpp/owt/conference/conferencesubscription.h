@@ -12,13 +12,13 @@
 #include "owt/base/exception.h"
 #include "owt/conference/streamupdateobserver.h"
 #include "owt/conference/subscribeoptions.h"
-namespace rtc {
-  class TaskQueue;
-}
 namespace webrtc{
   class StatsReport;
 }
 namespace owt {
+namespace base {
+class TaskSequence;
+}
 namespace conference {
 class ConferenceClient;
 using namespace owt::base;
@@ -69,7 +69,7 @@ class ConferenceSubscription : public ConferenceStreamUpdateObserver,
     mutable std::mutex observer_mutex_;
     std::vector<std::reference_wrapper<SubscriptionObserver>> observers_;
     std::weak_ptr<ConferenceClient>  conference_client_;   // Weak ref to associated conference client
-    std::shared_ptr<rtc::TaskQueue> event_queue_;
+    std::shared_ptr<TaskSequence> event_queue_;
 };
 
 } // namespace conference
@@ -17,12 +17,10 @@
 #include "owt/p2p/p2psignalingsenderinterface.h"
 #include "owt/base/clientconfiguration.h"
 #include "owt/base/globalconfiguration.h"
-namespace rtc {
-  class TaskQueue;
-}
 namespace owt {
 namespace base {
   struct PeerConnectionChannelConfiguration;
+  class TaskSequence;
 }
 namespace p2p{
 /**
@@ -58,7 +56,14 @@ class P2PClientObserver {
    */
   virtual void OnServerDisconnected(){};
 };
-/// An async client for P2P WebRTC sessions
+/**
+ @brief An async client for P2P WebRTC sessions
+ @details Callbacks and observer events of all clients run on a shared pool
+ of 2 to 4 threads. They should return quickly. A callback blocking on
+ another one, e.g. waiting for a callback of another client, holds a thread
+ of the pool, and a few of them starve all clients. Queue latency of the
+ pool is reported by GetCallbackExecutorStats.
+*/
 class P2PClient final
     : protected P2PSignalingSenderInterface,
       protected P2PSignalingChannelObserver,
@@ -187,6 +192,10 @@ class P2PClient final
       const std::string& target_id,
       std::function<void(std::shared_ptr<owt::base::ConnectionStats>)> on_success,
       std::function<void(std::unique_ptr<Exception>)> on_failure);
+  /**
+   @brief Get statistics of the threads running callbacks of all clients.
+   */
+  owt::base::CallbackExecutorStats GetCallbackExecutorStats() const;
   /** @cond */
   void SetLocalId(const std::string& local_id);
   /** @endcond */
@@ -218,7 +227,7 @@ class P2PClient final
   owt::base::PeerConnectionChannelConfiguration GetPeerConnectionChannelConfiguration();
   // Queue for callbacks and events. Shared among P2PClient and all of it's
   // P2PPeerConnectionChannel.
-  std::shared_ptr<rtc::TaskQueue> event_queue_;
+  std::shared_ptr<owt::base::TaskSequence> event_queue_;
   std::shared_ptr<P2PSignalingChannelInterface> signaling_channel_;
   std::unordered_map<std::string, std::shared_ptr<P2PPeerConnectionChannel>>
       pc_channels_;
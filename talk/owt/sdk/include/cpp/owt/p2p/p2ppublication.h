@@ -8,10 +8,10 @@
 #include "owt/base/commontypes.h"
 #include "owt/base/mediaconstraints.h"
 #include "owt/base/publication.h"
-namespace rtc {
-class TaskQueue;
-}
 namespace owt {
+namespace base {
+class TaskSequence;
+}
 namespace p2p {
 using namespace owt::base;
 class P2PClient;
@@ -43,7 +43,7 @@ class P2PPublication : public Publication {
   std::string target_id_;
   std::shared_ptr<LocalStream> local_stream_;
   std::weak_ptr<P2PClient> p2p_client_;   // Weak ref to associated p2p client
-  std::shared_ptr<rtc::TaskQueue> event_queue_;
+  std::shared_ptr<TaskSequence> event_queue_;
   mutable std::mutex observer_mutex_;
   std::vector<std::reference_wrapper<PublicationObserver>> observers_;
   bool ended_;
@@ -18,7 +18,7 @@
 #import <WebRTC/RTCLogging.h>
 #include "talk/owt/sdk/p2p/p2ppeerconnectionchannel.h"
 @implementation OWTP2PPeerConnectionChannel {
-  owt::p2p::P2PPeerConnectionChannel* _nativeChannel;
+  std::shared_ptr<owt::p2p::P2PPeerConnectionChannel> _nativeChannel;
   NSString* _remoteId;
 }
 - (instancetype)initWithConfiguration:(OWTP2PClientConfiguration*)config
@@ -53,7 +53,7 @@
   for (OWTVideoEncodingParameters* videoEncoding in config.video) {
     nativeConfig.video.push_back(videoEncoding.nativeVideoEncodingParameters);
   }
-  _nativeChannel = new owt::p2p::P2PPeerConnectionChannel(
+  _nativeChannel = std::make_shared<owt::p2p::P2PPeerConnectionChannel>(
       nativeConfig, nativeLocalId, nativeRemoteId, sender);
   return self;
 }
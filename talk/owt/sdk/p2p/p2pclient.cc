@@ -8,7 +8,7 @@
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/json.h"
 #include "webrtc/rtc_base/logging.h"
-#include "webrtc/rtc_base/task_queue.h"
+#include "talk/owt/sdk/base/callbackexecutor.h"
 #include "talk/owt/sdk/base/eventtrigger.h"
 #include "talk/owt/sdk/base/stringutils.h"
 #include "talk/owt/sdk/include/cpp/owt/base/stream.h"
@@ -25,7 +25,7 @@ enum IcsP2PError : int {
 P2PClient::P2PClient(
     P2PClientConfiguration& configuration,
     std::shared_ptr<P2PSignalingChannelInterface> signaling_channel)
-    : event_queue_(new rtc::TaskQueue("P2PClientEventQueue")),
+    : event_queue_(new TaskSequence("P2PClientEventQueue")),
       signaling_channel_(signaling_channel),
       configuration_(configuration) {
   RTC_CHECK(signaling_channel_);
@@ -176,6 +176,9 @@ void P2PClient::GetConnectionStats(
   auto pcc = GetPeerConnectionChannel(target_id);
   pcc->GetConnectionStats(on_success, on_failure);
 }
+owt::base::CallbackExecutorStats P2PClient::GetCallbackExecutorStats() const {
+  return CallbackExecutor::Get()->GetStats();
+}
 void P2PClient::SetLocalId(const std::string& local_id) {
   local_id_ = local_id;
 }
@@ -326,6 +329,8 @@ PeerConnectionChannelConfiguration P2PClient::GetPeerConnectionChannelConfigurat
                 kCandidateNetworkPolicyLowCost
           : webrtc::PeerConnectionInterface::CandidateNetworkPolicy::
                 kCandidateNetworkPolicyAll;
+  config.ice_restart_on_network_change =
+      configuration_.ice_restart_on_network_change;
   for (auto codec : configuration_.video_encodings) {
     config.video.push_back(VideoEncodingParameters(codec));
   }
@@ -78,7 +78,7 @@ P2PPeerConnectionChannel::P2PPeerConnectionChannel(
     const std::string& local_id,
     const std::string& remote_id,
     P2PSignalingSenderInterface* sender,
-    std::shared_ptr<rtc::TaskQueue> event_queue)
+    std::shared_ptr<TaskSequence> event_queue)
     : PeerConnectionChannel(configuration),
       signaling_sender_(sender),
       local_id_(local_id),
@@ -89,6 +89,7 @@ P2PPeerConnectionChannel::P2PPeerConnectionChannel(
       last_disconnect_(
           std::chrono::time_point<std::chrono::system_clock>::max()),
       reconnect_timeout_(10),
+      reconnect_timer_(TimerService::kInvalidTimerId),
       message_seq_num_(0),
       remote_side_supports_plan_b_(false),
       remote_side_supports_remove_stream_(false),
@@ -113,14 +114,22 @@ P2PPeerConnectionChannel::P2PPeerConnectionChannel(
           local_id,
           remote_id,
           sender,
-          std::shared_ptr<rtc::TaskQueue>(
-              new rtc::TaskQueue("PeerConnectionChannelEventQueue"))) {}
+          std::make_shared<TaskSequence>(
+              "PeerConnectionChannelEventQueue")) {}
 P2PPeerConnectionChannel::~P2PPeerConnectionChannel() {
+  // Events are ignored from now on. Closing PeerConnection waits for events
+  // being handled, so the reconnect timer cannot be scheduled again after it
+  // is cancelled.
+  ended_ = true;
+  if (peer_connection_)
+    peer_connection_->Close();
+  // Drops the check if it is not run yet.
+  TimerService::Get()->Cancel(
+      reconnect_timer_.exchange(TimerService::kInvalidTimerId));
   if (set_remote_sdp_task_)
     delete set_remote_sdp_task_;
   if (signaling_sender_)
     delete signaling_sender_;
-  ended_ = true;
 }
 void P2PPeerConnectionChannel::Publish(
     std::shared_ptr<LocalStream> stream,
@@ -639,6 +648,8 @@ void P2PPeerConnectionChannel::OnNegotiationNeeded() {
 void P2PPeerConnectionChannel::OnIceConnectionChange(
     PeerConnectionInterface::IceConnectionState new_state) {
   RTC_LOG(LS_INFO) << "Ice connection state changed: " << new_state;
+  if (ended_)
+    return;
   switch (new_state) {
     case webrtc::PeerConnectionInterface::kIceConnectionConnected:
     case webrtc::PeerConnectionInterface::kIceConnectionCompleted:
@@ -648,20 +659,33 @@ void P2PPeerConnectionChannel::OnIceConnectionChange(
       last_disconnect_ =
           std::chrono::time_point<std::chrono::system_clock>::max();
       break;
-    case webrtc::PeerConnectionInterface::kIceConnectionDisconnected:
+    case webrtc::PeerConnectionInterface::kIceConnectionDisconnected: {
       last_disconnect_ = std::chrono::system_clock::now();
-      // Check state after a period of time.
-      std::thread([this]() {
-        std::this_thread::sleep_for(std::chrono::seconds(reconnect_timeout_));
-        if (std::chrono::system_clock::now() - last_disconnect_ >=
-            std::chrono::seconds(reconnect_timeout_)) {
-          RTC_LOG(LS_INFO) << "Detect reconnection failed, stop this session.";
-          Stop(nullptr, nullptr);
-        } else {
-          RTC_LOG(LS_INFO) << "Detect reconnection succeed.";
-        }
-      }).detach();
+      // Check state after a period of time. Only the last disconnection is
+      // checked. Stop may block, so it runs on |event_queue_| instead of
+      // timer thread.
+      std::weak_ptr<P2PPeerConnectionChannel> weak_this = shared_from_this();
+      std::shared_ptr<TaskSequence> event_queue = event_queue_;
+      TimerService::TimerId timer = TimerService::Get()->Schedule(
+          [weak_this, event_queue]() {
+            event_queue->PostTask([weak_this]() {
+              auto that = weak_this.lock();
+              if (!that || that->ended_)
+                return;
+              if (std::chrono::system_clock::now() - that->last_disconnect_ >=
+                  std::chrono::seconds(that->reconnect_timeout_)) {
+                RTC_LOG(LS_INFO)
+                    << "Detect reconnection failed, stop this session.";
+                that->Stop(nullptr, nullptr);
+              } else {
+                RTC_LOG(LS_INFO) << "Detect reconnection succeed.";
+              }
+            });
+          },
+          reconnect_timeout_ * 1000);
+      TimerService::Get()->Cancel(reconnect_timer_.exchange(timer));
       break;
+    }
     case webrtc::PeerConnectionInterface::kIceConnectionClosed:
       CleanLastPeerConnection();
       break;
@@ -685,6 +709,15 @@ void P2PPeerConnectionChannel::OnIceGatheringChange(
     PeerConnectionInterface::IceGatheringState new_state) {
   RTC_LOG(LS_INFO) << "Ice gathering state changed: " << new_state;
 }
+void P2PPeerConnectionChannel::OnNetworksChanged() {
+  if (!configuration_.ice_restart_on_network_change ||
+      session_state_ != kSessionStateConnected) {
+    return;
+  }
+  RTC_LOG(LS_INFO) << "Restart ICE after networks changed.";
+  RestartIceInNextOffer();
+  OnNegotiationNeeded();
+}
 void P2PPeerConnectionChannel::OnIceCandidate(
     const webrtc::IceCandidateInterface* candidate) {
   RTC_LOG(LS_INFO) << "On ice candidate";
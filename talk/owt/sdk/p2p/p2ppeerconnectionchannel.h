@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #ifndef WOOGEEN_P2P_P2PPEERCONNECTIONCHANNEL_H_
 #define WOOGEEN_P2P_P2PPEERCONNECTIONCHANNEL_H_
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -11,13 +12,14 @@
 #include "talk/owt/sdk/base/mediaconstraintsimpl.h"
 #include "talk/owt/sdk/base/peerconnectiondependencyfactory.h"
 #include "talk/owt/sdk/base/peerconnectionchannel.h"
+#include "talk/owt/sdk/base/timerservice.h"
 #include "talk/owt/sdk/include/cpp/owt/base/stream.h"
 #include "talk/owt/sdk/include/cpp/owt/base/exception.h"
 #include "talk/owt/sdk/include/cpp/owt/p2p/p2psignalingsenderinterface.h"
 #include "talk/owt/sdk/include/cpp/owt/p2p/p2psignalingreceiverinterface.h"
 #include "webrtc/rtc_base/json.h"
 #include "webrtc/rtc_base/messagehandler.h"
-#include "webrtc/rtc_base/task_queue.h"
+#include "talk/owt/sdk/base/callbackexecutor.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 namespace owt {
 namespace p2p {
@@ -36,15 +38,17 @@ class P2PPeerConnectionChannelObserver {
 };
 // An instance of P2PPeerConnectionChannel manages a session for a specified
 // remote client.
-class P2PPeerConnectionChannel : public P2PSignalingReceiverInterface,
-                                 public PeerConnectionChannel {
+class P2PPeerConnectionChannel
+    : public P2PSignalingReceiverInterface,
+      public PeerConnectionChannel,
+      public std::enable_shared_from_this<P2PPeerConnectionChannel> {
  public:
   explicit P2PPeerConnectionChannel(
       PeerConnectionChannelConfiguration configuration,
       const std::string& local_id,
       const std::string& remote_id,
       P2PSignalingSenderInterface* sender,
-      std::shared_ptr<rtc::TaskQueue> event_queue);
+      std::shared_ptr<TaskSequence> event_queue);
   // If event_queue is not provided, a new event queue will be used. That means,
   // a new thread will be created for each P2PPeerConnection. Currently, iOS
   // SDK's RTCP2PPeerConnection is a pure Obj-C file, so it does not maintain
@@ -115,6 +119,7 @@ class P2PPeerConnectionChannel : public P2PSignalingReceiverInterface,
   virtual void OnIceGatheringChange(
       PeerConnectionInterface::IceGatheringState new_state) override;
   virtual void OnIceCandidate(const webrtc::IceCandidateInterface* candidate) override;
+  virtual void OnNetworksChanged() override;
   // DataChannelObserver
   virtual void OnDataChannelStateChange() override;
   virtual void OnDataChannelMessage(const webrtc::DataBuffer& buffer) override;
@@ -195,6 +200,9 @@ class P2PPeerConnectionChannel : public P2PSignalingReceiverInterface,
       last_disconnect_;  // Last time |peer_connection_| changes its state to
                          // "disconnect"
   int reconnect_timeout_;  // Unit: second
+  // Checks reconnection after the last disconnection. It holds a weak
+  // reference, so channels must be owned by std::shared_ptr.
+  std::atomic<TimerService::TimerId> reconnect_timer_;
   long message_seq_num_; // Message ID to be sent through data channel
   std::vector<std::shared_ptr<std::string>> pending_messages_;  // Messages need
                                                                 // to be sent
@@ -213,7 +221,7 @@ class P2PPeerConnectionChannel : public P2PSignalingReceiverInterface,
   bool remote_side_supports_continual_ice_gathering_;
   std::mutex is_creating_offer_mutex_;
   // Queue for callbacks and events.
-  std::shared_ptr<rtc::TaskQueue> event_queue_;
+  std::shared_ptr<TaskSequence> event_queue_;
   std::mutex failure_callbacks_mutex_;
   std::unordered_map<std::string, std::function<void(std::unique_ptr<Exception>)>> failure_callbacks_;
   std::shared_ptr<LocalStream> latest_local_stream_;
@@ -222,7 +230,9 @@ class P2PPeerConnectionChannel : public P2PSignalingReceiverInterface,
   bool ua_sent_;
   bool stop_send_needed_;
   bool remote_side_offline_;
-  bool ended_;
+  // Set when the channel is being destroyed. Read on PeerConnection's
+  // signaling thread.
+  std::atomic<bool> ended_;
 };
 }
 }
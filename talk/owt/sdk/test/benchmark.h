@@ -0,0 +1,29 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_TEST_BENCHMARK_H_
+#define OWT_TEST_BENCHMARK_H_
+#include <stdint.h>
+#include <functional>
+#include <string>
+namespace owt {
+namespace test {
+typedef void (*BenchmarkFunction)();
+// Registers a benchmark run by woogeen_benchmarks. Use OWT_BENCHMARK instead.
+bool RegisterBenchmark(const char* name, BenchmarkFunction function);
+// Runs |function| |iterations| times, and prints average time per iteration
+// and, if |items_per_iteration| is not 0, items processed per second.
+void MeasureAndReport(const std::string& label,
+                      int iterations,
+                      uint64_t items_per_iteration,
+                      const std::function<void()>& function);
+}  // namespace test
+}  // namespace owt
+// Defines a benchmark. Benchmarks whose name contains the first command line
+// argument are run, or all of them if there is no argument.
+#define OWT_BENCHMARK(name)                                      \
+  static void name();                                            \
+  static bool name##_registered =                                \
+      owt::test::RegisterBenchmark(#name, name);                 \
+  static void name()
+#endif  // OWT_TEST_BENCHMARK_H_
@@ -0,0 +1,50 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#include <stdio.h>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include "talk/owt/sdk/test/benchmark.h"
+namespace owt {
+namespace test {
+static std::vector<std::pair<std::string, BenchmarkFunction>>& Benchmarks() {
+  static std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+  return benchmarks;
+}
+bool RegisterBenchmark(const char* name, BenchmarkFunction function) {
+  Benchmarks().push_back(std::make_pair(std::string(name), function));
+  return true;
+}
+void MeasureAndReport(const std::string& label,
+                      int iterations,
+                      uint64_t items_per_iteration,
+                      const std::function<void()>& function) {
+  // Warm up caches and allocators.
+  function();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    function();
+  double elapsed_us = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+  double per_iteration_us = elapsed_us / iterations;
+  if (items_per_iteration) {
+    printf("  %-48s %12.1f us/iter %14.0f items/s\n", label.c_str(),
+           per_iteration_us, items_per_iteration / per_iteration_us * 1e6);
+  } else {
+    printf("  %-48s %12.1f us/iter\n", label.c_str(), per_iteration_us);
+  }
+}
+}  // namespace test
+}  // namespace owt
+int main(int argc, char* argv[]) {
+  std::string filter = argc > 1 ? argv[1] : "";
+  for (const auto& benchmark : owt::test::Benchmarks()) {
+    if (benchmark.first.find(filter) == std::string::npos)
+      continue;
+    printf("%s\n", benchmark.first.c_str());
+    benchmark.second();
+  }
+  return 0;
+}
@@ -0,0 +1,33 @@
+// Copyright (C) <2018> Intel Corporation
+//
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OWT_TEST_LATCH_H_
+#define OWT_TEST_LATCH_H_
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+namespace owt {
+namespace test {
+// Blocks until Signal is called |count| times.
+class Latch {
+ public:
+  explicit Latch(int count) : count_(count) {}
+  void Signal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--count_ == 0)
+      done_.notify_all();
+  }
+  // Returns false if it is not signaled enough times in 5 seconds.
+  bool Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return done_.wait_for(lock, std::chrono::seconds(5),
+                          [this] { return count_ <= 0; });
+  }
+ private:
+  std::mutex mutex_;
+  std::condition_variable done_;
+  int count_;
+};
+}  // namespace test
+}  // namespace owt
+#endif  // OWT_TEST_LATCH_H_